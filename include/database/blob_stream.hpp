@@ -0,0 +1,119 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOB_STREAM_HPP
+#define BLOB_STREAM_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <iosfwd>
+#include <cstddef>
+
+namespace oos {
+
+/**
+ * @class blob_stream
+ * @brief Reads or writes one blob column value in chunks
+ *
+ * A blob_stream is a handle on the blob column of
+ * one row. It is created by database::open_blob()
+ * for reading or by database::create_blob() for
+ * writing. The data is transferred in chunks, so
+ * large values never have to be held in memory
+ * as a whole.
+ *
+ * A writing stream must be closed to complete
+ * the value. The destructor closes the stream
+ * as well but can't report errors.
+ */
+class OOS_API blob_stream
+{
+public:
+  typedef std::size_t size_type;  /**< Shortcut for the size type. */
+
+  enum { CHUNK_SIZE = 64 * 1024 };
+
+  virtual ~blob_stream();
+
+  /**
+   * Returns the size of the blob value. For a
+   * writing stream it is the number of written
+   * or reserved bytes.
+   *
+   * @return The size of the blob value.
+   */
+  virtual size_type size() const = 0;
+
+  /**
+   * Reads the next len bytes of the blob value
+   * into the given buffer.
+   *
+   * @param buf The buffer to read into.
+   * @param len The size of the buffer.
+   * @return The number of read bytes, zero at the end.
+   */
+  virtual size_type read(char *buf, size_type len) = 0;
+
+  /**
+   * Appends len bytes to the blob value.
+   *
+   * @param buf The bytes to write.
+   * @param len The number of bytes to write.
+   */
+  virtual void write(const char *buf, size_type len) = 0;
+
+  /**
+   * Completes a writing stream and releases
+   * the handle.
+   */
+  virtual void close() = 0;
+
+  /**
+   * Reads the rest of the blob value and
+   * writes it to the given stream in chunks
+   * of CHUNK_SIZE bytes.
+   *
+   * @param out The stream to write to.
+   * @return The number of read bytes.
+   */
+  size_type read(std::ostream &out);
+
+  /**
+   * Writes the content of the given stream
+   * to the blob value in chunks of CHUNK_SIZE
+   * bytes.
+   *
+   * @param in The stream to read from.
+   * @return The number of written bytes.
+   */
+  size_type write(std::istream &in);
+};
+
+}
+
+#endif /* BLOB_STREAM_HPP */
@@ -32,6 +32,7 @@
 #endif
 
 #include "database/types.hpp"
+#include "database/blob_stream.hpp"
 #include "database/action.hpp"
 #include "database/transaction.hpp"
 
@@ -162,6 +163,16 @@ public:
    */
   void load(const prototype_node &node);
 
+  /**
+   * load a single object of a specific
+   * table based on a prototype node
+   *
+   * @param node The node representing the table to read
+   * @param id The id of the object to read.
+   * @return The loaded object or NULL.
+   */
+  object* load(const prototype_node &node, long id);
+
   /**
    * Checks if a specific table was loaded.
    * 
@@ -179,6 +190,34 @@ public:
    */
   result* execute(const std::string &sql);
 
+  /**
+   * Opens the blob column of the row with the
+   * given id for reading in chunks. The caller
+   * must delete the returned stream. The default
+   * implementation throws a database_exception.
+   *
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id of the row.
+   * @return The reading blob_stream.
+   */
+  virtual blob_stream* open_blob(const std::string &table, const std::string &column, long id);
+
+  /**
+   * Opens the blob column of the row with the
+   * given id for writing a new value of the given
+   * size in chunks. The caller must close and
+   * delete the returned stream. The default
+   * implementation throws a database_exception.
+   *
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id of the row.
+   * @param size The size of the new value.
+   * @return The writing blob_stream.
+   */
+  virtual blob_stream* create_blob(const std::string &table, const std::string &column, long id, blob_stream::size_type size);
+
   /**
    * The interface for the create table action.
    */
@@ -0,0 +1,118 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MYSQL_BLOB_STREAM_HPP
+#define MYSQL_BLOB_STREAM_HPP
+
+#ifdef WIN32
+  #ifdef oos_mysql_EXPORTS
+    #define OOS_MYSQL_API __declspec(dllexport)
+  #else
+    #define OOS_MYSQL_API __declspec(dllimport)
+  #endif
+  #pragma warning(disable: 4355)
+#else
+  #define OOS_MYSQL_API
+#endif
+
+#include "database/blob_stream.hpp"
+
+#ifdef WIN32
+#include <winsock2.h>
+#include <mysql.h>
+#else
+#include <mysql/mysql.h>
+#endif
+
+#include <string>
+
+namespace oos {
+
+namespace mysql {
+
+class mysql_database;
+
+/**
+ * @class mysql_blob_stream
+ * @brief Incremental blob i/o for mysql
+ *
+ * A reading stream selects the blob column of one
+ * row with a prepared statement bound without a
+ * result buffer and copies the value chunk by chunk
+ * with mysql_stmt_fetch_column().
+ *
+ * A writing stream prepares an update of the blob
+ * column and sends the value chunk by chunk with
+ * mysql_stmt_send_long_data(). The update is
+ * executed when the stream is closed.
+ */
+class OOS_MYSQL_API mysql_blob_stream : public blob_stream
+{
+public:
+  /**
+   * Opens the blob column of the row
+   * with the given id for reading.
+   *
+   * @param db The mysql database.
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id of the row.
+   */
+  mysql_blob_stream(mysql_database &db, const std::string &table, const std::string &column, long id);
+
+  /**
+   * Opens the blob column of the row with the
+   * given id for writing a value of the given size.
+   *
+   * @param db The mysql database.
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id of the row.
+   * @param size The size of the new value.
+   */
+  mysql_blob_stream(mysql_database &db, const std::string &table, const std::string &column, long id, size_type size);
+  virtual ~mysql_blob_stream();
+
+  virtual size_type size() const;
+  virtual size_type read(char *buf, size_type len);
+  virtual void write(const char *buf, size_type len);
+  virtual void close();
+
+private:
+  mysql_blob_stream(const mysql_blob_stream&);
+  mysql_blob_stream& operator=(const mysql_blob_stream&);
+
+  void prepare(const std::string &sql);
+  void check(int ret, const char *source);
+  void release();
+
+private:
+  MYSQL_STMT *stmt_;
+  bool writable_;
+  std::string sql_;
+  long long id_;
+  unsigned long length_;
+  my_bool is_null_;
+  size_type size_;
+  size_type pos_;
+};
+
+}
+
+}
+
+#endif /* MYSQL_BLOB_STREAM_HPP */
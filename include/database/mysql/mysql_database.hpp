@@ -82,6 +82,29 @@ public:
   
   virtual const char* type_string(data_type_t type) const;
 
+  /**
+   * Opens a mysql_blob_stream reading the blob
+   * column of the row with the given id.
+   *
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id of the row.
+   * @return The reading blob_stream.
+   */
+  virtual blob_stream* open_blob(const std::string &table, const std::string &column, long id);
+
+  /**
+   * Opens a mysql_blob_stream writing the blob
+   * column of the row with the given id.
+   *
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id of the row.
+   * @param size The size of the new value.
+   * @return The writing blob_stream.
+   */
+  virtual blob_stream* create_blob(const std::string &table, const std::string &column, long id, blob_stream::size_type size);
+
   /**
    * Return the raw pointer to the sqlite3
    * database struct.
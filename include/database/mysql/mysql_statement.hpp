@@ -56,6 +56,7 @@ public:
 
   virtual void clear();
   virtual result* execute();
+  virtual unsigned long execute_update();
   virtual void prepare(const sql &s);
   virtual void reset();
   
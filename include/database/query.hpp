@@ -271,6 +271,18 @@ public:
    */
   query& where(const condition &c);
 
+  /**
+   * Adds a where clause checking the given
+   * column against count host values:
+   * WHERE column IN (?, ?, ...)
+   *
+   * @param column The name of the column.
+   * @param type The data type of the values.
+   * @param count The number of host values.
+   * @return A reference to the query.
+   */
+  query& where_in(const std::string &column, data_type_t type, unsigned long count);
+
   /**
    * Adds an and clause condition to the where
    * clause.
@@ -0,0 +1,254 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERY_CURSOR_HPP
+#define QUERY_CURSOR_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+namespace oos {
+
+class session;
+class database;
+class statement;
+class object;
+struct prototype_node;
+
+/**
+ * @class query_cursor
+ * @brief Pages through all rows of a prototype table
+ *
+ * The query_cursor reads the rows of a prototype
+ * table page by page using keyset pagination:
+ *
+ * @code
+ * SELECT ... FROM <table> WHERE id>? ORDER BY id LIMIT(<page size>)
+ * @endcode
+ *
+ * The statement is prepared once and each page
+ * binds the last id of the previous page. Unlike
+ * an offset based paging each page costs the same
+ * no matter how deep the cursor already is, and
+ * only the objects of the current page are held
+ * in memory.
+ *
+ * The objects of a page are created with the
+ * producer of the prototype and owned by the
+ * cursor. They aren't inserted into any
+ * object_store, so object pointer fields only
+ * carry the id of the referenced object and
+ * containers stay empty. The objects are deleted
+ * when the next page is fetched.
+ *
+ * The cursor holds a prepared statement of the
+ * database and must be destroyed before the
+ * database is closed.
+ *
+ * The iterator walks over all rows and fetches
+ * the next page when the end of the current
+ * page is reached.
+ *
+ * @code
+ * query_cursor cursor(db, *node, 500);
+ * for (query_cursor::iterator i = cursor.begin(); i != cursor.end(); ++i) {
+ *   export_object(*i);
+ * }
+ * @endcode
+ */
+class OOS_API query_cursor
+{
+public:
+  typedef std::vector<object*> t_object_vector; /**< Shortcut to the page vector. */
+  typedef t_object_vector::size_type size_type; /**< Shortcut to the size type. */
+
+  /**
+   * @class iterator
+   * @brief Walks over all rows of a query_cursor
+   *
+   * The iterator is a single pass input iterator.
+   * Incrementing it behind the last object of the
+   * current page fetches the next page, which
+   * deletes the objects of the current page.
+   */
+  class OOS_API iterator : public std::iterator<std::input_iterator_tag, object*>
+  {
+  public:
+    iterator();
+
+    /**
+     * Returns the current object.
+     *
+     * @return The current object.
+     */
+    object* operator*() const;
+
+    /**
+     * Moves to the next object and fetches
+     * the next page if necessary.
+     *
+     * @return The moved iterator.
+     */
+    iterator& operator++();
+
+    /**
+     * Compares two iterators.
+     *
+     * @param x The iterator to compare with.
+     * @return True if both iterators are at the same position.
+     */
+    bool operator==(const iterator &x) const;
+
+    /**
+     * Compares two iterators.
+     *
+     * @param x The iterator to compare with.
+     * @return True if the iterators are at different positions.
+     */
+    bool operator!=(const iterator &x) const;
+
+  private:
+    friend class query_cursor;
+
+    iterator(query_cursor *cursor, size_type index);
+
+  private:
+    query_cursor *cursor_;
+    size_type index_;
+  };
+
+  /**
+   * Creates a cursor over the table of the
+   * given prototype with the given page size.
+   *
+   * @param s The session to read from.
+   * @param node The prototype of the table.
+   * @param page_size The maximum number of objects per page.
+   */
+  query_cursor(session &s, const prototype_node &node, size_type page_size = 100);
+
+  /**
+   * Creates a cursor over the table of the
+   * given prototype with the given page size.
+   *
+   * @param db The database to read from.
+   * @param node The prototype of the table.
+   * @param page_size The maximum number of objects per page.
+   */
+  query_cursor(database &db, const prototype_node &node, size_type page_size = 100);
+
+  ~query_cursor();
+
+  /**
+   * Fetches the page following the last
+   * fetched id. The objects of the previous
+   * page are deleted.
+   *
+   * @return False if there are no more rows.
+   */
+  bool fetch();
+
+  /**
+   * Returns the objects of the current page.
+   *
+   * @return The objects of the current page.
+   */
+  const t_object_vector& page() const;
+
+  /**
+   * Starts the cursor again behind the
+   * given id. The current page is deleted.
+   *
+   * @param after_id The first fetched id is greater than this id.
+   */
+  void rewind(long after_id = 0);
+
+  /**
+   * Returns an iterator to the first object
+   * of the current page. If no page was
+   * fetched yet the first page is fetched.
+   *
+   * @return The iterator to the first object.
+   */
+  iterator begin();
+
+  /**
+   * Returns the end iterator.
+   *
+   * @return The end iterator.
+   */
+  iterator end();
+
+  /**
+   * Returns the id of the last fetched object.
+   *
+   * @return The id of the last fetched object.
+   */
+  long last_id() const;
+
+  /**
+   * Returns the maximum number of objects
+   * per page.
+   *
+   * @return The page size.
+   */
+  size_type page_size() const;
+
+  /**
+   * Returns the number of fetched pages
+   * since creation or the last rewind.
+   *
+   * @return The number of fetched pages.
+   */
+  unsigned long pages() const;
+
+private:
+  // copying not permitted
+  query_cursor(const query_cursor&);
+  query_cursor& operator=(const query_cursor&);
+
+  void prepare();
+  void clear_page();
+
+private:
+  database &db_;
+  const prototype_node &node_;
+  size_type page_size_;
+  statement *stmt_;
+  t_object_vector page_;
+  long last_id_;
+  unsigned long pages_;
+  bool exhausted_;
+};
+
+}
+
+#endif /* QUERY_CURSOR_HPP */
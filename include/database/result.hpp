@@ -33,6 +33,8 @@
 
 #include "object/object_atomizer.hpp"
 
+#include <string>
+
 #ifdef WIN32
 #include <memory>
 #else
@@ -89,8 +91,64 @@ public:
   
   virtual int transform_index(int index) const = 0;
 
+  /*
+   * marks the result as traced, the fetch
+   * durations are summed up and handed to
+   * the installed sql_tracer when the result
+   * is destroyed
+   */
+  void trace(const std::string &sql, unsigned long params);
+
+protected:
+  /*
+   * counts a fetched row, the rows fetched
+   * by the result are added to the metrics
+   * when the result is destroyed
+   */
+  void count_row()
+  {
+    ++rows_fetched_;
+  }
+
+  /*
+   * measures one fetch of a traced result,
+   * backends create a fetch_timer at the
+   * beginning of fetch
+   */
+  class fetch_timer
+  {
+  public:
+    explicit fetch_timer(result &r)
+      : result_(r)
+      , start_(r.traced_ ? now() : 0)
+    {}
+    ~fetch_timer()
+    {
+      if (start_) {
+        result_.fetch_duration_ += now() - start_;
+      }
+    }
+
+  private:
+    fetch_timer(const fetch_timer&);
+    fetch_timer& operator=(const fetch_timer&);
+
+    result &result_;
+    unsigned long long start_;
+  };
+
+private:
+  static unsigned long long now();
+
 protected:
   int result_index;
+
+private:
+  size_type rows_fetched_;
+  bool traced_;
+  std::string trace_sql_;
+  unsigned long trace_params_;
+  unsigned long long fetch_duration_;
 };
 
 typedef std::tr1::shared_ptr<result> result_ptr;
@@ -33,6 +33,7 @@
 
 #include "object/object_ptr.hpp"
 #include "object/object_store.hpp"
+#include "object/object_loader.hpp"
 
 #include "tools/library.hpp"
 
@@ -58,8 +59,10 @@ class database;
  * available by a concrete database implementation.
  * All objects in the given object_store will be made
  * persistent.
+ * The session also reloads objects evicted by the
+ * object_store when a memory budget is set.
  */
-class OOS_API session
+class OOS_API session : public object_loader
 {
 public:
   /**
@@ -260,6 +263,9 @@ private:
 
   object* load(const std::string &type, int id = 0);
 
+  virtual object* load(const prototype_node &node, long id);
+  virtual bool is_dirty(long id) const;
+
   void begin(transaction &tr);
   void commit(transaction &tr);
   void rollback();
@@ -0,0 +1,305 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SQL_TRACER_HPP
+#define SQL_TRACER_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+namespace oos {
+
+/**
+ * @struct sql_trace_event
+ * @brief Describes one traced database call
+ *
+ * A sql_trace_event is handed to the installed
+ * sql_tracer after a statement was prepared,
+ * bound or executed and after a result was
+ * fetched. The sql text is only valid while
+ * the tracer is called.
+ */
+struct OOS_API sql_trace_event
+{
+  /**
+   * @enum phase_t
+   * @brief The traced phase of a statement
+   */
+  enum phase_t {
+    TRACE_PREPARE = 0, /**< The statement was prepared. */
+    TRACE_BIND,        /**< An object was bound to the statement. */
+    TRACE_EXECUTE,     /**< The statement was executed. */
+    TRACE_FETCH        /**< The rows of a result were fetched. */
+  };
+
+  sql_trace_event()
+    : phase(TRACE_PREPARE), sql(""), params(0), rows(0), duration(0)
+  {}
+
+  phase_t phase;                /**< The traced phase. */
+  const char *sql;              /**< The sql text of the statement. */
+  unsigned long params;         /**< The number of bound parameters. */
+  unsigned long rows;           /**< The affected or fetched rows. */
+  unsigned long long duration;  /**< The duration in nanoseconds. */
+
+  /**
+   * Returns the name of the given phase.
+   *
+   * @param phase The phase.
+   * @return The name of the phase.
+   */
+  static const char* phase_name(phase_t phase);
+};
+
+/**
+ * @class sql_tracer
+ * @brief Interface of a tracer of database calls
+ *
+ * An installed sql_tracer is called from all
+ * database backends after each prepare, object
+ * bind and execute of a statement and once for
+ * each traced result when the result is destroyed.
+ * The fetch event holds the number of fetched
+ * rows and the summed duration of all fetches.
+ *
+ * The tracer is called from the thread using the
+ * statement, so it must be thread safe when
+ * several threads use the database. A tracer
+ * must not throw, it may be called from the
+ * destructor of a result.
+ *
+ * While no tracer is installed each traced call
+ * costs one load and branch.
+ */
+class OOS_API sql_tracer
+{
+public:
+  virtual ~sql_tracer() {}
+
+  /**
+   * Called for each traced database call.
+   *
+   * @param event The traced call.
+   */
+  virtual void trace(const sql_trace_event &event) = 0;
+
+  /**
+   * Installs the given tracer and returns the
+   * tracer installed before. A null tracer
+   * disables tracing. An uninstalled tracer
+   * may only be destroyed when no database
+   * call is running anymore.
+   *
+   * @param tracer The tracer to install or null.
+   * @return The tracer installed before.
+   */
+  static sql_tracer* install(sql_tracer *tracer);
+
+  /**
+   * Returns the installed tracer or null.
+   *
+   * @return The installed tracer.
+   */
+  static sql_tracer* installed();
+
+  /**
+   * Returns true if a tracer is installed.
+   *
+   * @return True if tracing is enabled.
+   */
+  static bool enabled()
+  {
+    return tracer_ != 0;
+  }
+
+private:
+  static sql_tracer * volatile tracer_;
+};
+
+/**
+ * @class slow_statement_log
+ * @brief A sql_tracer keeping slow and sampled statements
+ *
+ * The slow_statement_log keeps each traced call
+ * taking at least the threshold in a ring buffer
+ * of slow statements and writes it to the output
+ * stream if one is set. Additionally every n-th
+ * traced call, where n is the sample rate, is
+ * kept in a second ring buffer of recent statements,
+ * so the usual statements can be compared with
+ * the slow ones.
+ *
+ * Both ring buffers hold up to capacity entries,
+ * the oldest entries are overwritten. Threshold
+ * and sample rate may be changed at any time.
+ */
+class OOS_API slow_statement_log : public sql_tracer
+{
+public:
+  /**
+   * @struct entry
+   * @brief A kept database call
+   */
+  struct entry
+  {
+    entry()
+      : phase(sql_trace_event::TRACE_PREPARE), params(0), rows(0), duration(0)
+    {}
+
+    sql_trace_event::phase_t phase;  /**< The traced phase. */
+    std::string sql;                 /**< The sql text of the statement. */
+    unsigned long params;            /**< The number of bound parameters. */
+    unsigned long rows;              /**< The affected or fetched rows. */
+    unsigned long long duration;     /**< The duration in nanoseconds. */
+  };
+
+  typedef std::vector<entry> t_entry_vector;     /**< Shortcut to the entry vector. */
+  typedef t_entry_vector::size_type size_type;   /**< Shortcut to the size type. */
+
+  /**
+   * Creates a slow_statement_log.
+   *
+   * @param threshold The minimum duration of a slow call in nanoseconds.
+   * @param capacity The capacity of each ring buffer.
+   * @param sample_rate Keep every n-th call as recent statement, zero keeps none.
+   */
+  explicit slow_statement_log(unsigned long long threshold, size_type capacity = 64, unsigned long sample_rate = 0);
+  virtual ~slow_statement_log();
+
+  virtual void trace(const sql_trace_event &event);
+
+  /**
+   * Sets the minimum duration of a slow call.
+   *
+   * @param threshold The threshold in nanoseconds.
+   */
+  void threshold(unsigned long long threshold);
+
+  /**
+   * Returns the minimum duration of a slow call.
+   *
+   * @return The threshold in nanoseconds.
+   */
+  unsigned long long threshold() const;
+
+  /**
+   * Sets the sample rate of recent statements.
+   *
+   * @param sample_rate Keep every n-th call, zero keeps none.
+   */
+  void sample_rate(unsigned long sample_rate);
+
+  /**
+   * Returns the sample rate of recent statements.
+   *
+   * @return The sample rate.
+   */
+  unsigned long sample_rate() const;
+
+  /**
+   * Sets the stream each slow call is written
+   * to. A null stream disables the output.
+   *
+   * @param out The output stream or null.
+   */
+  void output(std::ostream *out);
+
+  /**
+   * Returns the kept slow calls, the
+   * oldest call first.
+   *
+   * @return The slow calls.
+   */
+  t_entry_vector slow_statements() const;
+
+  /**
+   * Returns the kept sampled calls, the
+   * oldest call first.
+   *
+   * @return The sampled calls.
+   */
+  t_entry_vector recent_statements() const;
+
+  /**
+   * Returns the number of traced calls.
+   *
+   * @return The number of traced calls.
+   */
+  unsigned long long traced() const;
+
+  /**
+   * Returns the number of slow calls including
+   * the ones already overwritten.
+   *
+   * @return The number of slow calls.
+   */
+  unsigned long long slow_count() const;
+
+  /**
+   * Removes all kept calls and
+   * resets the counters.
+   */
+  void clear();
+
+private:
+  /// @cond OOS_DEV
+  struct ring
+  {
+    explicit ring(size_type capacity);
+
+    void push(const sql_trace_event &event);
+    t_entry_vector entries() const;
+    void clear();
+
+    t_entry_vector buffer;
+    size_type next;
+    bool full;
+  };
+  /// @endcond
+
+  void lock() const;
+  void unlock() const;
+
+private:
+  unsigned long long threshold_;
+  unsigned long sample_rate_;
+  std::ostream *out_;
+
+  ring slow_;
+  ring recent_;
+  unsigned long long traced_;
+  unsigned long long slow_count_;
+  mutable volatile int lock_;
+};
+
+}
+
+#endif /* SQL_TRACER_HPP */
@@ -0,0 +1,101 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SQLITE_BLOB_STREAM_HPP
+#define SQLITE_BLOB_STREAM_HPP
+
+#ifdef WIN32
+  #ifdef oos_sqlite_EXPORTS
+    #define OOS_SQLITE_API __declspec(dllexport)
+  #else
+    #define OOS_SQLITE_API __declspec(dllimport)
+  #endif
+  #pragma warning(disable: 4355)
+#else
+  #define OOS_SQLITE_API
+#endif
+
+#include "database/blob_stream.hpp"
+
+#include <string>
+
+struct sqlite3_blob;
+
+namespace oos {
+
+namespace sqlite {
+
+class sqlite_database;
+
+/**
+ * @class sqlite_blob_stream
+ * @brief Incremental blob i/o for sqlite
+ *
+ * The stream reads and writes the blob value
+ * directly with sqlite3_blob_read() and
+ * sqlite3_blob_write(). Sqlite can't change the
+ * size of a blob through the handle, so a writing
+ * stream is opened on a value of the final size
+ * (see sqlite_database::create_blob()) and can't
+ * write behind its end.
+ */
+class OOS_SQLITE_API sqlite_blob_stream : public blob_stream
+{
+public:
+  /**
+   * Opens the blob column of the row
+   * with the given rowid.
+   *
+   * @param db The sqlite database.
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param rowid The rowid of the row.
+   * @param writable True if the stream writes.
+   */
+  sqlite_blob_stream(sqlite_database &db, const std::string &table, const std::string &column, long rowid, bool writable);
+  virtual ~sqlite_blob_stream();
+
+  virtual size_type size() const;
+  virtual size_type read(char *buf, size_type len);
+  virtual void write(const char *buf, size_type len);
+  virtual void close();
+
+  /**
+   * Moves the stream to the same column of
+   * another row. This is faster than opening
+   * a new stream.
+   *
+   * @param rowid The rowid of the new row.
+   */
+  void reopen(long rowid);
+
+private:
+  sqlite_blob_stream(const sqlite_blob_stream&);
+  sqlite_blob_stream& operator=(const sqlite_blob_stream&);
+
+private:
+  sqlite_database &db_;
+  sqlite3_blob *blob_;
+  size_type size_;
+  size_type pos_;
+};
+
+}
+
+}
+
+#endif /* SQLITE_BLOB_STREAM_HPP */
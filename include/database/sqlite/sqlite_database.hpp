@@ -79,6 +79,30 @@ public:
 
   virtual const char* type_string(data_type_t type) const;
 
+  /**
+   * Opens a sqlite_blob_stream on the blob
+   * column of the row with the given id.
+   *
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id (rowid) of the row.
+   * @return The reading blob_stream.
+   */
+  virtual blob_stream* open_blob(const std::string &table, const std::string &column, long id);
+
+  /**
+   * Sets the blob column of the row with the
+   * given id to size zero bytes and opens a
+   * writing sqlite_blob_stream on it.
+   *
+   * @param table The name of the table.
+   * @param column The name of the blob column.
+   * @param id The id (rowid) of the row.
+   * @param size The size of the new value.
+   * @return The writing blob_stream.
+   */
+  virtual blob_stream* create_blob(const std::string &table, const std::string &column, long id, blob_stream::size_type size);
+
 protected:
   virtual void on_open(const std::string &db);
   virtual void on_close();
@@ -55,6 +55,15 @@ public:
   virtual result* execute() = 0;
 
   virtual void reset() = 0;
+
+  /*
+   * executes a statement which doesn't return
+   * rows (insert, update or delete) and returns
+   * the number of affected rows. backends override
+   * it to skip creating a result object, the
+   * default deletes the result of execute().
+   */
+  virtual unsigned long execute_update();
   
   int bind(object_atomizable *o);
 
@@ -71,6 +80,21 @@ public:
 protected:
   void str(const std::string &s);
 
+  /*
+   * backends call trace_start() before and
+   * trace_prepare(), trace_execute() or
+   * trace_update() after preparing or executing
+   * the statement. the
+   * calls count the metrics when metrics are
+   * enabled and hand the duration to the
+   * installed sql_tracer. trace_start() returns
+   * zero when no tracer is installed.
+   */
+  static unsigned long long trace_start();
+  void trace_prepare(unsigned long long start);
+  result* trace_execute(result *res, unsigned long long start);
+  void trace_update(unsigned long rows, unsigned long long start);
+
 protected:
   int host_index;
 
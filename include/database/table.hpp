@@ -49,6 +49,7 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 namespace oos {
 
@@ -78,12 +79,25 @@ public:
   virtual void prepare();
   void create();
   void load(object_store &ostore);
+  object* load(object_store &ostore, long id);
   void insert(object *obj);
   void update(object *obj);
   void remove(object *obj);
   void remove(long id);
   void drop();
 
+  /*
+   * updated objects and ids of deleted objects
+   * are queued at commit and written at once
+   * with flush_updates() and flush_removes()
+   */
+  void queue_update(object *obj);
+  void flush_updates();
+  void discard_updates();
+  void queue_remove(long id);
+  void flush_removes();
+  void discard_removes();
+
   bool is_loaded() const;
 
   template < class T >
@@ -100,6 +114,39 @@ protected:
 
 private:
   friend class relation_filler;
+  friend class plan_builder;
+
+  /*
+   * the decoding plan holds one field entry for
+   * each object pointer and container field in
+   * the order the object deserializes its fields.
+   * the prototype_node, the table and the relation
+   * slot of each field are resolved once, so the
+   * rows are decoded without prototype, table or
+   * relation lookups. a table without pointer and
+   * container fields skips the second pass over
+   * the fields of each loaded object.
+   */
+  struct field_plan
+  {
+    enum kind_t {
+      FIELD_POINTER = 0,
+      FIELD_CONTAINER
+    };
+
+    field_plan()
+      : kind(FIELD_POINTER), node(0), target(0), relation(0)
+    {}
+
+    kind_t kind;
+    const prototype_node *node;  // prototype of the pointer or container
+    table *target;               // table of the container prototype
+    object_map_t *relation;      // relation slot filled or read per row
+  };
+  typedef std::vector<field_plan> t_field_plan_vector;
+
+  void build_plan(object_store &ostore);
+  table* find_table(const std::string &type) const;
 
   database &db_;
   const prototype_node &node_;
@@ -109,6 +156,21 @@ private:
   statement *update_;
   statement *delete_;
   statement *select_;
+  statement *select_id_;
+
+  /*
+   * the queued ids are deleted with
+   * DELETE ... WHERE id IN (?, ...) statements
+   * for a few fixed chunk sizes. each chunk
+   * statement is prepared once on first use and
+   * the queued ids are split greedily into the
+   * largest chunks, the rest is deleted one by one.
+   */
+  enum { DELETE_CHUNK_COUNT = 3 };
+  static const unsigned long delete_chunk_size_[DELETE_CHUNK_COUNT];
+  statement *delete_chunk_[DELETE_CHUNK_COUNT];
+  std::vector<long> removed_;
+  std::vector<object*> updated_;
   
   // temp data while loading
   object *object_;
@@ -116,6 +178,10 @@ private:
   
   bool prepared_;
 
+  t_field_plan_vector plan_;
+  t_field_plan_vector::size_type plan_index_;
+  bool planned_;
+
   bool is_loaded_;
   relation_data_t relation_data;
 };
@@ -119,6 +119,18 @@ public:
    */
   void rollback();
 
+  /**
+   * @brief Returns true if an object was touched.
+   *
+   * Returns true if the object with the given id
+   * was inserted, updated or deleted within this
+   * transaction and isn't committed yet.
+   *
+   * @param id The id of the object.
+   * @return True if the object is dirty.
+   */
+  bool is_dirty(long id) const;
+
   /**
    * Returns the underlaying pointer to the database.
    *
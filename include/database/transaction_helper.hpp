@@ -115,6 +115,7 @@ class action_remover : public action_visitor
 public:
   action_remover(transaction::action_list_t &action_list)
     : action_list_(action_list)
+    , obj_(0)
     , id_(0)
   {}
   virtual ~action_remover() {}
@@ -47,7 +47,7 @@ public:
   {
     value<T> *v = dynamic_cast<value<T>* >(this);
     if (v) {
-      return v->get<T>();
+      return v->template get<T>();
     } else {
       throw std::bad_cast();
     }
@@ -18,8 +18,15 @@
 #ifndef GENERIC_JSON_PARSER_HPP
 #define GENERIC_JSON_PARSER_HPP
 
+#include "json/json_scan.hpp"
+#include "json/json_numeric.hpp"
+
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
 
 namespace oos {
 
@@ -35,6 +42,15 @@ namespace oos {
  * a method of parser class T is called.
  * The parser class decides what it will do
  * with the given information.
+ *
+ * Numbers without fraction and exponent which
+ * fit into 64 bit are passed to on_integer(),
+ * all other numbers to on_number().
+ *
+ * The input is either a stream or a contiguous
+ * character buffer. Buffers are scanned in
+ * blocks (see json_scan.hpp) and are much
+ * faster to parse than streams.
  */
 template < class T >
 class generic_json_parser
@@ -62,11 +78,33 @@ protected:
    */
   void parse_json(std::istream &in);
 
+  /**
+   * @brief Parse the json character buffer.
+   *
+   * Parse the json character buffer and call
+   * the appropiate callbacks interally. The
+   * buffer doesn't need to be null terminated.
+   *
+   * @param str The json character buffer
+   * @param len The length of the buffer
+   */
+  void parse_json(const char *str, std::size_t len);
+
+private:
+  void parse_json_object(const char *&cur, const char *end);
+  void parse_json_array(const char *&cur, const char *end);
+  const std::string& parse_json_string(const char *&cur, const char *end);
+  void parse_json_number(const char *&cur, const char *end);
+  bool parse_json_bool(const char *&cur, const char *end);
+  void parse_json_null(const char *&cur, const char *end);
+  void parse_json_value(const char *&cur, const char *end);
+  void parse_json_literal(const char *&cur, const char *end, const char *literal, std::size_t len);
+
 private:
   void parse_json_object(std::istream &in);
   void parse_json_array(std::istream &in);
   std::string parse_json_string(std::istream &in);
-  double parse_json_number(std::istream &in);
+  void parse_json_number(std::istream &in);
   bool parse_json_bool(std::istream &in);
   void parse_json_null(std::istream &in);
   void parse_json_value(std::istream &in);
@@ -74,6 +112,9 @@ private:
 private:
   T *handler_;
 
+  // reused for all strings of a buffer and numbers of a stream
+  std::string string_value_;
+
   static const char *null_string;
   static const char *true_string;
   static const char *false_string;
@@ -326,19 +367,26 @@ generic_json_parser<T>::parse_json_string(std::istream &in)
 }
 
 template < class T >
-double
+void
 generic_json_parser<T>::parse_json_number(std::istream &in)
 {
   // skip white
   in >> std::ws;
 
-  double value;
-  in >> value;
-  
-  char c = in.peek();
-  
+  // collect the characters of the number into the reused string buffer
+  std::string &buf = string_value_;
+  buf.clear();
+  int c = in.peek();
+  while (isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+    buf.push_back(static_cast<char>(in.get()));
+    c = in.peek();
+  }
+
   switch (c) {
     case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
     case ',':
     case ']':
     case '}':
@@ -347,7 +395,21 @@ generic_json_parser<T>::parse_json_number(std::istream &in)
       // TODO: throw json_error instead
       throw std::logic_error("invalid json character");
   }
-  return value;
+
+  bool is_integer = false;
+  long long integer = 0;
+  double real = 0.0;
+  const char *first = buf.data();
+  const char *last = first + buf.size();
+  if (json_parse_number(first, last, is_integer, integer, real) != last) {
+    // TODO: throw json_error instead
+    throw std::logic_error("invalid json number");
+  }
+  if (is_integer) {
+    handler_->on_integer(integer);
+  } else {
+    handler_->on_number(real);
+  }
 }
 
 template < class T >
@@ -471,7 +533,7 @@ generic_json_parser<T>::parse_json_value(std::istream &in)
     case '7':
     case '8':
     case '9':
-      handler_->on_number(parse_json_number(in));
+      parse_json_number(in);
       break;
     case 't':
     case 'f':
@@ -487,6 +549,307 @@ generic_json_parser<T>::parse_json_value(std::istream &in)
   }
 }
 
+
+template < class T >
+void
+generic_json_parser<T>::parse_json(const char *str, std::size_t len)
+{
+  const char *cur = str;
+  const char *end = str + len;
+
+  // eat whitespace
+  cur = json_skip_whitespace(cur, end);
+
+  if (cur == end) {
+    // TODO: throw json_error instead
+    throw std::logic_error("invalid stream");
+  }
+
+  switch (*cur) {
+    case '{':
+      parse_json_object(cur, end);
+      break;
+    case '[':
+      parse_json_array(cur, end);
+      break;
+    default:
+      // TODO: throw json_error instead
+      throw std::logic_error("root must be either array '[]' or object '{}'");
+  }
+
+  // skip white
+  cur = json_skip_whitespace(cur, end);
+
+  // no characters after closing parenthesis are aloud
+  if (cur != end) {
+    // TODO: throw json_error instead
+    throw std::logic_error("no characters are allowed after closed root node");
+  }
+}
+
+template < class T >
+void
+generic_json_parser<T>::parse_json_object(const char *&cur, const char *end)
+{
+  // skip '{'
+  ++cur;
+
+  handler_->on_begin_object();
+
+  cur = json_skip_whitespace(cur, end);
+  if (cur != end && *cur == '}') {
+    ++cur;
+    handler_->on_end_object();
+    // empty object
+    return;
+  }
+
+  char c(0);
+  do {
+    cur = json_skip_whitespace(cur, end);
+
+    handler_->on_object_key(parse_json_string(cur, end));
+
+    // read colon
+    cur = json_skip_whitespace(cur, end);
+    if (cur == end || *cur != ':') {
+      // TODO: throw json_error instead
+      throw std::logic_error("character isn't colon");
+    }
+    ++cur;
+
+    parse_json_value(cur, end);
+
+    cur = json_skip_whitespace(cur, end);
+    c = (cur != end ? *cur++ : 0);
+  } while (c == ',');
+
+  if (c != '}') {
+    // TODO: throw json_error instead
+    throw std::logic_error("not a valid object closing bracket");
+  }
+
+  handler_->on_end_object();
+}
+
+template < class T >
+void
+generic_json_parser<T>::parse_json_array(const char *&cur, const char *end)
+{
+  // skip '['
+  ++cur;
+
+  handler_->on_begin_array();
+
+  cur = json_skip_whitespace(cur, end);
+  if (cur != end && *cur == ']') {
+    ++cur;
+    handler_->on_end_array();
+    // empty array
+    return;
+  }
+
+  char c(0);
+  do {
+    parse_json_value(cur, end);
+
+    cur = json_skip_whitespace(cur, end);
+    c = (cur != end ? *cur++ : 0);
+  } while (c == ',');
+
+  if (c != ']') {
+    // TODO: throw json_error instead
+    throw std::logic_error("not a valid array closing bracket");
+  }
+
+  handler_->on_end_array();
+}
+
+template < class T >
+const std::string&
+generic_json_parser<T>::parse_json_string(const char *&cur, const char *end)
+{
+  if (cur == end || *cur != '"') {
+    // TODO: throw json_error instead
+    throw std::logic_error("invalid json character");
+  }
+  ++cur;
+
+  string_value_.clear();
+  for (;;) {
+    // copy everything up to the next quote or escape at once
+    const char *special = json_find_string_special(cur, end);
+    string_value_.append(cur, special);
+    cur = special;
+    if (cur == end) {
+      // TODO: throw json_error instead
+      throw std::logic_error("unterminated json string");
+    }
+    if (*cur++ == '"') {
+      break;
+    }
+    // handle escape sequence
+    if (cur == end) {
+      // TODO: throw json_error instead
+      throw std::logic_error("invalid json character");
+    }
+    char c = *cur++;
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        string_value_.push_back(c);
+        break;
+      case 'b':
+        string_value_.push_back('\b');
+        break;
+      case 'f':
+        string_value_.push_back('\f');
+        break;
+      case 'n':
+        string_value_.push_back('\n');
+        break;
+      case 'r':
+        string_value_.push_back('\r');
+        break;
+      case 't':
+        string_value_.push_back('\t');
+        break;
+      case 'u':
+        // keep the four hex digits
+        string_value_.push_back('\\');
+        string_value_.push_back('u');
+        for (int i = 0; i < 4; ++i) {
+          if (cur == end || !isxdigit(*cur)) {
+            // TODO: throw json_error instead
+            throw std::logic_error("invalid json character");
+          }
+          string_value_.push_back(*cur++);
+        }
+        break;
+      default:
+        // TODO: throw json_error instead
+        throw std::logic_error("invalid json character");
+    }
+  }
+  return string_value_;
+}
+
+template < class T >
+void
+generic_json_parser<T>::parse_json_number(const char *&cur, const char *end)
+{
+  bool is_integer = false;
+  long long integer = 0;
+  double real = 0.0;
+  const char *last = json_parse_number(cur, end, is_integer, integer, real);
+  if (!last) {
+    // TODO: throw json_error instead
+    throw std::logic_error("invalid json number");
+  }
+  cur = last;
+
+  if (cur != end) {
+    switch (*cur) {
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+      case ',':
+      case ']':
+      case '}':
+        break;
+      default:
+        // TODO: throw json_error instead
+        throw std::logic_error("invalid json character");
+    }
+  }
+
+  if (is_integer) {
+    handler_->on_integer(integer);
+  } else {
+    handler_->on_number(real);
+  }
+}
+
+template < class T >
+void
+generic_json_parser<T>::parse_json_literal(const char *&cur, const char *end, const char *literal, std::size_t len)
+{
+  if (std::size_t(end - cur) < len || std::memcmp(cur, literal, len) != 0) {
+    // TODO: throw json_error instead
+    throw std::logic_error("invalid literal character");
+  }
+  cur += len;
+}
+
+template < class T >
+bool
+generic_json_parser<T>::parse_json_bool(const char *&cur, const char *end)
+{
+  if (*cur == 't') {
+    parse_json_literal(cur, end, true_string, 4);
+    return true;
+  } else {
+    parse_json_literal(cur, end, false_string, 5);
+    return false;
+  }
+}
+
+template < class T >
+void
+generic_json_parser<T>::parse_json_null(const char *&cur, const char *end)
+{
+  parse_json_literal(cur, end, null_string, 4);
+}
+
+template < class T >
+void
+generic_json_parser<T>::parse_json_value(const char *&cur, const char *end)
+{
+  cur = json_skip_whitespace(cur, end);
+
+  if (cur == end) {
+    throw std::logic_error("invalid stream");
+  }
+
+  switch (*cur) {
+    case '{':
+      parse_json_object(cur, end);
+      break;
+    case '[':
+      parse_json_array(cur, end);
+      break;
+    case '"':
+      handler_->on_string(parse_json_string(cur, end));
+      break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      parse_json_number(cur, end);
+      break;
+    case 't':
+    case 'f':
+      handler_->on_bool(parse_json_bool(cur, end));
+      break;
+    case 'n':
+      parse_json_null(cur, end);
+      handler_->on_null();
+      break;
+    default:
+      // TODO: throw json_error instead
+      throw std::logic_error("unknown json type");
+  }
+}
+
 }
 
 #endif /* GENERIC_JSON_PARSER_HPP */
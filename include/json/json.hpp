@@ -26,5 +26,9 @@
 #include "json/json_bool.hpp"
 #include "json/json_null.hpp"
 #include "json/json_parser.hpp"
+#include "json/json_node.hpp"
+#include "json/json_document.hpp"
+#include "json/json_reader.hpp"
+#include "json/json_writer.hpp"
 
 #endif /* JSON_HPP */
\ No newline at end of file
@@ -82,7 +82,7 @@ public:
   ~json_array();
 
   virtual bool parse(std::istream &in);
-  virtual void print(std::ostream &out) const;
+  virtual void write(json_writer &writer) const;
 
   /**
    * Return the begin iterator
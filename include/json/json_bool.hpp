@@ -59,7 +59,7 @@ public:
   virtual ~json_bool(void);
 
   virtual bool parse(std::istream &in);
-  virtual void print(std::ostream &out) const;
+  virtual void write(json_writer &writer) const;
 
   /**
    * Return the current value.
@@ -0,0 +1,177 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_DOCUMENT_HPP
+#define JSON_DOCUMENT_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include "json/generic_json_parser.hpp"
+#include "json/json_node.hpp"
+
+#include "tools/arena.hpp"
+
+#ifdef WIN32
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @class json_document
+ * @brief A compact read-only json structure
+ *
+ * The json_document is an alternative to the
+ * json_value structure created by the json_parser.
+ * All values of a parsed document live in one
+ * arena as 16 byte nodes. Strings are copied into
+ * the arena, object keys are interned, so each
+ * distinct key is stored once. Objects are flat
+ * arrays of key/value nodes; objects with many
+ * members get a hash index. Integers are kept
+ * as 64 bit integers.
+ *
+ * The whole structure is freed in one step when
+ * the document is cleared, parses the next input
+ * or is destroyed. Access is read-only through
+ * json_node handles.
+ *
+ * @code
+ * json_document doc;
+ * json_node root = doc.parse(buf, len);
+ * double d = root["values"][2].as_number();
+ * @endcode
+ */
+class OOS_API json_document : public generic_json_parser<json_document>
+{
+public:
+  /**
+   * Creates an empty json_document.
+   */
+  json_document();
+  virtual ~json_document();
+
+  /**
+   * @brief parse a character buffer.
+   *
+   * Parses a character buffer of the given
+   * length and returns the root node. The
+   * previous content of the document is freed.
+   *
+   * @param str The json character buffer.
+   * @param len The length of the buffer.
+   * @return The root node.
+   */
+  json_node parse(const char *str, size_t len);
+
+  /**
+   * @brief parse a const character string.
+   *
+   * @param str The json const character string.
+   * @return The root node.
+   */
+  json_node parse(const char *str);
+
+  /**
+   * @brief parse a std::string.
+   *
+   * @param str The json std::string.
+   * @return The root node.
+   */
+  json_node parse(const std::string &str);
+
+  /**
+   * @brief parse an input stream.
+   *
+   * @param in The json input stream.
+   * @return The root node.
+   */
+  json_node parse(std::istream &in);
+
+  /**
+   * Returns the root node of the document. If
+   * nothing was parsed a null node is returned.
+   *
+   * @return The root node.
+   */
+  json_node root() const;
+
+  /**
+   * Frees all nodes of the document at once.
+   */
+  void clear();
+
+  /**
+   * Returns the number of bytes reserved
+   * for the nodes and strings.
+   *
+   * @return The memory usage of the document.
+   */
+  size_t memory_usage() const;
+
+  /// @cond OOS_DEV //
+  void on_begin_object();
+  void on_object_key(const std::string &key);
+  void on_end_object();
+
+  void on_begin_array();
+  void on_end_array();
+
+  void on_string(const std::string &value);
+  void on_number(double value);
+  void on_integer(long long value);
+  void on_bool(bool value);
+  void on_null();
+  /// @endcond OOS_DEV //
+
+private:
+  void reset();
+  void push(unsigned int type, unsigned int size);
+  void end_container(unsigned int type);
+
+private:
+  arena arena_;
+  const json_node_data *root_;
+
+  // nodes of the open arrays and objects
+  std::vector<json_node_data> values_;
+  std::vector<size_t> frames_;
+
+  typedef std::tr1::unordered_map<std::string, const char*> t_key_map;
+  t_key_map keys_;
+};
+
+}
+
+#endif /* JSON_DOCUMENT_HPP */
@@ -0,0 +1,263 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_NODE_HPP
+#define JSON_NODE_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include "json/json_value.hpp"
+
+#include <string>
+#include <iostream>
+#include <cstddef>
+
+namespace oos {
+
+/// @cond OOS_DEV
+
+/*
+ * The node of a json_document. Each node takes
+ * 16 bytes: the type, a size (string length or
+ * number of array elements or object members)
+ * and the value itself. Array elements and object
+ * members (key node followed by value node) are
+ * stored contiguously in the arena of the document.
+ * Large objects append a hash index to their
+ * members.
+ */
+struct json_node_data
+{
+  enum {
+    TYPE_MASK = 0xff,
+    HASHED = 0x100,       // object has a hash index
+    INTEGER = 0x200,      // number is an integer
+    HASH_THRESHOLD = 16   // minimum members for a hash index
+  };
+
+  // FNV-1a hash of a key
+  static unsigned int hash(const char *key, size_t len)
+  {
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+      h = (h ^ static_cast<unsigned char>(key[i])) * 16777619u;
+    }
+    return h;
+  }
+
+  // number of index slots for the given number of members
+  static size_t hash_capacity(size_t members)
+  {
+    size_t capacity = 1;
+    while (capacity < 2 * members) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  unsigned int type;
+  unsigned int size;
+  union {
+    double number;
+    long long integer;
+    const char *str;
+    const json_node_data *first;
+  };
+};
+
+/// @endcond
+
+/**
+ * @class json_node
+ * @brief Read-only handle to a value of a json_document
+ *
+ * A json_node refers to a value inside a json_document.
+ * It provides the same read access as json_value
+ * (key and index operator, size, output operator)
+ * but never modifies the document. A json_node
+ * is as small as a pointer and is only valid as
+ * long as its json_document isn't cleared or
+ * destroyed.
+ *
+ * Accessing a value with the wrong type or a
+ * missing key throws a std::logic_error.
+ */
+class OOS_API json_node
+{
+public:
+  /**
+   * @enum type_t
+   * @brief The type of a json_node
+   */
+  enum type_t {
+    JSON_NULL = 0, /**< The null value. */
+    JSON_BOOL,     /**< A boolean value. */
+    JSON_NUMBER,   /**< A number value. */
+    JSON_STRING,   /**< A string value. */
+    JSON_ARRAY,    /**< An array. */
+    JSON_OBJECT    /**< An object. */
+  };
+
+  /**
+   * Creates a null json_node.
+   */
+  json_node();
+
+  /**
+   * Creates a json_node for the given node data.
+   *
+   * @param data The node data.
+   */
+  explicit json_node(const json_node_data *data);
+
+  /**
+   * Returns the type of the node.
+   *
+   * @return The type of the node.
+   */
+  type_t type() const;
+
+  bool is_null() const;   /**< True if the node is null. */
+  bool is_bool() const;   /**< True if the node is a boolean. */
+  bool is_number() const; /**< True if the node is a number. */
+  bool is_integer() const; /**< True if the node is an integer number. */
+  bool is_string() const; /**< True if the node is a string. */
+  bool is_array() const;  /**< True if the node is an array. */
+  bool is_object() const; /**< True if the node is an object. */
+
+  /**
+   * Returns the member of an object node
+   * with the given key.
+   *
+   * @param key The key of the member.
+   * @return The member node.
+   * @throw std::logic_error If the node isn't an object or the key is missing.
+   */
+  json_node operator[](const std::string &key) const;
+
+  /**
+   * Returns the element of an array
+   * node at the given index.
+   *
+   * @param index The index of the element.
+   * @return The element node.
+   * @throw std::logic_error If the node isn't an array or the index is invalid.
+   */
+  json_node operator[](size_t index) const;
+
+  /**
+   * Looks up a member of an object node. If there is
+   * no such member or the node isn't an object a
+   * null node is returned.
+   *
+   * @param key The key of the member.
+   * @param len The length of the key.
+   * @param found Set to true if the member was found.
+   * @return The member node.
+   */
+  json_node find(const char *key, size_t len, bool &found) const;
+
+  /**
+   * Returns true if the node is an object
+   * containing the given key.
+   *
+   * @param key The key to check.
+   * @return True if the key exists.
+   */
+  bool contains(const std::string &key) const;
+
+  /**
+   * Returns the number of array elements or
+   * object members or the length of a string.
+   *
+   * @return The size of the node.
+   */
+  size_t size() const;
+
+  /**
+   * Returns the key of the object member
+   * at the given position.
+   *
+   * @param index The position of the member.
+   * @return The key of the member.
+   */
+  std::string key(size_t index) const;
+
+  /**
+   * Returns the value of the object member
+   * at the given position.
+   *
+   * @param index The position of the member.
+   * @return The value of the member.
+   */
+  json_node value(size_t index) const;
+
+  bool as_bool() const;          /**< Returns the boolean value. */
+  double as_number() const;      /**< Returns the number value. */
+  long long as_integer() const;  /**< Returns the number value as integer. */
+  std::string as_string() const; /**< Returns the string value. */
+
+  /**
+   * Returns the null terminated characters
+   * of a string node without copying them.
+   *
+   * @return The characters of the string.
+   */
+  const char* c_str() const;
+
+  /**
+   * Creates a json_value structure with
+   * the content of the node.
+   *
+   * @return The created json_value.
+   */
+  json_value to_value() const;
+
+  /**
+   * Print the json_node to the given stream
+   * in the same format as a json_value.
+   *
+   * @param str The stream to print on.
+   * @param node The node to print.
+   * @return The modified stream.
+   */
+  friend OOS_API std::ostream& operator<<(std::ostream &str, const json_node &node);
+
+private:
+  const char* type_name() const;
+  const json_node_data* member(const char *key, size_t len) const;
+
+private:
+  friend class json_writer;
+
+  const json_node_data *data_;
+};
+
+}
+
+#endif /* JSON_NODE_HPP */
@@ -51,7 +51,7 @@ public:
   virtual ~json_null(void);
 
   virtual bool parse(std::istream &in);
-  virtual void print(std::ostream &out) const;
+  virtual void write(json_writer &writer) const;
 
 private:
   static const char *null_string;
@@ -46,6 +46,11 @@ namespace oos {
  * @class json_number
  * @brief Representing json number type
  * 
+ * A json_number holds either a 64 bit integer
+ * or a double. Integers are kept exactly and
+ * are printed without fraction, doubles are
+ * printed with the shortest representation
+ * which reads back to the same value.
  */
 class OOS_API json_number : public json_type
 {
@@ -58,6 +63,14 @@ public:
    * @param val The value of json_bool.
    */
   json_number(double val);
+
+  /**
+   * Create a new json_number value and
+   * initialize it with the given integer.
+   * 
+   * @param val The integer value.
+   */
+  json_number(long long val);
   
   /**
    * Copy from given json_number.
@@ -89,6 +102,14 @@ public:
    */
   json_number& operator=(double val);
 
+  /**
+   * Assign from given integer.
+   * 
+   * @param val The integer to assign from.
+   * @return Initialized json_number.
+   */
+  json_number& operator=(long long val);
+
   /**
    * Assign from given json_value.
    * 
@@ -107,7 +128,7 @@ public:
   bool operator<(const json_number &x) const;
 
   virtual bool parse(std::istream &in);
-  virtual void print(std::ostream &out) const;
+  virtual void write(json_writer &writer) const;
 
   /**
    * Return the current value.
@@ -123,7 +144,32 @@ public:
    */
   void value(double val);
 
+  /**
+   * Returns true if the number
+   * is an integer.
+   * 
+   * @return True if the number is an integer.
+   */
+  bool is_integer() const;
+
+  /**
+   * Return the current value as integer.
+   * A double value is truncated.
+   * 
+   * @return The current integer value.
+   */
+  long long integer() const;
+
+  /**
+   * Set a new integer value.
+   * 
+   * @param val The integer to set.
+   */
+  void integer(long long val);
+
 private:
+  bool is_integer_;
+  long long integer_;
   double value_;
 };
 
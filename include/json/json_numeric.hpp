@@ -0,0 +1,88 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_NUMERIC_HPP
+#define JSON_NUMERIC_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <cstddef>
+
+namespace oos {
+
+/**
+ * @brief Parses a json number.
+ *
+ * Parses the json number at the beginning of
+ * [first, last) independent of the current locale.
+ * Numbers without fraction and exponent which fit
+ * into 64 bit are returned as integer, all other
+ * numbers are converted to the nearest double.
+ *
+ * @param first The start of the character buffer.
+ * @param last The end of the character buffer.
+ * @param is_integer Set to true if the number is an integer.
+ * @param integer The integer value.
+ * @param real The double value.
+ * @return The end of the number or NULL if it isn't valid.
+ */
+OOS_API const char* json_parse_number(const char *first, const char *last, bool &is_integer, long long &integer, double &real);
+
+/**
+ * Size of the character buffer needed
+ * by the format functions.
+ */
+enum { JSON_NUMBER_BUFFER_SIZE = 32 };
+
+/**
+ * @brief Formats a double.
+ *
+ * Writes the shortest decimal representation of
+ * the given double which converts back to the
+ * same double. Whole numbers keep a trailing ".0"
+ * so they are read back as doubles. Not finite
+ * values are written as null.
+ *
+ * @param value The double to format.
+ * @param buf The buffer of JSON_NUMBER_BUFFER_SIZE characters.
+ * @return The number of written characters.
+ */
+OOS_API std::size_t json_format_number(double value, char *buf);
+
+/**
+ * @brief Formats an integer.
+ *
+ * @param value The integer to format.
+ * @param buf The buffer of JSON_NUMBER_BUFFER_SIZE characters.
+ * @return The number of written characters.
+ */
+OOS_API std::size_t json_format_integer(long long value, char *buf);
+
+}
+
+#endif /* JSON_NUMERIC_HPP */
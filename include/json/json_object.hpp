@@ -75,7 +75,7 @@ public:
   virtual ~json_object();
 
   virtual bool parse(std::istream &in);
-  virtual void print(std::ostream &out) const;
+  virtual void write(json_writer &writer) const;
 
   /**
    * Removes every children of the json_object.
@@ -0,0 +1,218 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_OBJECT_READER_HPP
+#define JSON_OBJECT_READER_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4355)
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include "object/object_atomizer.hpp"
+
+#include "json/json_reader.hpp"
+
+#include <iostream>
+#include <typeinfo>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace oos {
+
+class object;
+class object_store;
+class object_base_ptr;
+class varchar_base;
+class object_container;
+
+/**
+ * @class json_object_reader
+ * @brief Reads objects from json
+ *
+ * The json_object_reader is an object_reader
+ * which fills objects from json objects as
+ * written by the json_object_writer. The input
+ * is read with a json_reader, so no json_value
+ * structure is built. The members of the current
+ * json object are collected in a small table
+ * which is reused for all objects; the fields
+ * are looked up by name. Members without a
+ * matching field are ignored, fields without
+ * a matching member keep their value.
+ *
+ * An object_ptr or object_ref is resolved by
+ * the id of the referenced object, an
+ * object_container gets the items of the ids
+ * in its json array. Referenced objects which
+ * aren't part of the object_store yet are
+ * resolved like the object_serializer does:
+ * a proxy is created for the id and filled
+ * once the object is inserted. Therefore
+ * referenced objects should be imported
+ * before the objects referencing them.
+ *
+ * With import() a json array of objects is
+ * read in chunks and each object is inserted
+ * into the object_store.
+ */
+class OOS_API json_object_reader : public generic_object_reader<json_object_reader>
+{
+public:
+  /**
+   * Creates a json_object_reader resolving
+   * references within the given object_store.
+   *
+   * @param ostore The object_store of the objects.
+   */
+  explicit json_object_reader(object_store &ostore);
+  virtual ~json_object_reader();
+
+  /**
+   * Fills the given object from the given
+   * json object. The object isn't inserted
+   * into the object_store.
+   *
+   * @param o The object to fill.
+   * @param str The json character buffer.
+   * @param len The length of the buffer.
+   * @throws std::logic_error If the input isn't a json object.
+   */
+  void deserialize(object *o, const char *str, std::size_t len);
+
+  /**
+   * Reads a json array of objects of the given
+   * type from the stream and inserts each object
+   * into the object_store. A single json object
+   * is accepted as well.
+   *
+   * @param type The type of the objects.
+   * @param in The stream to read from.
+   * @return The number of inserted objects.
+   * @throws object_exception If the type is unknown.
+   * @throws std::logic_error If the input isn't valid.
+   */
+  std::size_t import(const char *type, std::istream &in);
+
+  /**
+   * Reads a json array of objects of the given
+   * type from the buffer and inserts each object
+   * into the object_store.
+   *
+   * @param type The type of the objects.
+   * @param str The json character buffer.
+   * @param len The length of the buffer.
+   * @return The number of inserted objects.
+   */
+  std::size_t import(const char *type, const char *str, std::size_t len);
+
+  /**
+   * Reads a json array of objects of type T
+   * from the stream and inserts each object
+   * into the object_store.
+   *
+   * @tparam T The type of the objects.
+   * @param in The stream to read from.
+   * @return The number of inserted objects.
+   */
+  template < class T >
+  std::size_t import(std::istream &in)
+  {
+    return import(typeid(T).name(), in);
+  }
+
+  /**
+   * Reads a json array of objects of type T
+   * from the buffer and inserts each object
+   * into the object_store.
+   *
+   * @tparam T The type of the objects.
+   * @param str The json character buffer.
+   * @param len The length of the buffer.
+   * @return The number of inserted objects.
+   */
+  template < class T >
+  std::size_t import(const char *str, std::size_t len)
+  {
+    return import(typeid(T).name(), str, len);
+  }
+
+  /// @cond OOS_DEV
+  void read_value(const char *id, char &x);
+  void read_value(const char *id, float &x);
+  void read_value(const char *id, double &x);
+  void read_value(const char *id, short &x);
+  void read_value(const char *id, int &x);
+  void read_value(const char *id, long &x);
+  void read_value(const char *id, unsigned char &x);
+  void read_value(const char *id, unsigned short &x);
+  void read_value(const char *id, unsigned int &x);
+  void read_value(const char *id, unsigned long &x);
+  void read_value(const char *id, bool &x);
+  void read_value(const char *id, char *&x, int s);
+  void read_value(const char *id, std::string &x);
+  void read_value(const char *id, varchar_base &x);
+  void read_value(const char *id, object_base_ptr &x);
+  void read_value(const char *id, object_container &x);
+  /// @endcond
+
+private:
+  enum { CHUNK_SIZE = 64 * 1024 };
+
+  struct member
+  {
+    std::string key;
+    json_reader::token_t type;
+    std::string str;
+    double number;
+    long long integer;
+    bool boolean;
+    std::vector<long> ids;
+  };
+
+  void reset();
+  bool next_object(json_reader &reader);
+  std::size_t insert_objects(json_reader &reader, const char *type);
+  const member* find(const char *id);
+  long long integer(const member *m, long long def);
+
+private:
+  object_store &ostore_;
+
+  // members of the current json object, reused
+  std::vector<member> members_;
+  std::size_t count_;
+  std::size_t next_;
+
+  // nesting depth of the objects to read
+  std::size_t object_depth_;
+  member *current_;
+};
+
+}
+
+#endif /* JSON_OBJECT_READER_HPP */
@@ -0,0 +1,166 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_OBJECT_WRITER_HPP
+#define JSON_OBJECT_WRITER_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4355)
+#else
+  #define OOS_API
+#endif
+
+#include "object/object_atomizer.hpp"
+#include "object/object_view.hpp"
+
+#include "json/json_writer.hpp"
+
+#include <iostream>
+#include <string>
+#include <cstddef>
+
+namespace oos {
+
+class object;
+class object_base_ptr;
+class varchar_base;
+class object_container;
+
+/**
+ * @class json_object_writer
+ * @brief Writes objects as json
+ *
+ * The json_object_writer is an object_writer
+ * which writes the fields of an object directly
+ * as a compact json object without building a
+ * json_value structure:
+ *
+ * @code
+ * {"id":1,"name":"George","friend":7,"books":[3,4]}
+ * @endcode
+ *
+ * Characters, strings and varchars are written
+ * as json strings, all numbers as json numbers
+ * and booleans as json booleans. An object_ptr
+ * or object_ref is written as the id of the
+ * referenced object or null, an object_container
+ * as an array of the ids of its items.
+ *
+ * The output goes to a json_writer, a string or
+ * a stream. A whole object_view is written as a
+ * json array of objects. The output can be read
+ * again with the json_object_reader.
+ */
+class OOS_API json_object_writer : public generic_object_writer<json_object_writer>
+{
+public:
+  /**
+   * Creates a json_object_writer.
+   */
+  json_object_writer();
+  virtual ~json_object_writer();
+
+  /**
+   * Writes the given object as json
+   * object to the given json_writer.
+   *
+   * @param o The object to write.
+   * @param writer The json_writer to write to.
+   */
+  void serialize(const object *o, json_writer &writer);
+
+  /**
+   * Appends the given object as json
+   * object to the given string.
+   *
+   * @param o The object to write.
+   * @param out The string to append to.
+   */
+  void serialize(const object *o, std::string &out);
+
+  /**
+   * Writes all objects of the given view
+   * as json array to the given json_writer.
+   *
+   * @tparam T The type of the objects.
+   * @param view The objects to write.
+   * @param writer The json_writer to write to.
+   * @return The number of written objects.
+   */
+  template < class T >
+  std::size_t serialize(const object_view<T> &view, json_writer &writer)
+  {
+    std::size_t count = 0;
+    writer.begin_array();
+    for (typename object_view<T>::const_iterator i = view.begin(); i != view.end(); ++i, ++count) {
+      serialize((*i).get(), writer);
+    }
+    writer.end_array();
+    return count;
+  }
+
+  /**
+   * Writes all objects of the given view
+   * as json array to the given stream.
+   * The output is written to the stream
+   * in blocks.
+   *
+   * @tparam T The type of the objects.
+   * @param view The objects to write.
+   * @param out The stream to write to.
+   * @return The number of written objects.
+   */
+  template < class T >
+  std::size_t serialize(const object_view<T> &view, std::ostream &out)
+  {
+    json_writer writer(out, json_writer::FORMAT_COMPACT);
+    return serialize(view, writer);
+  }
+
+  /// @cond OOS_DEV
+  template < class V >
+  void write_value(const char *id, const V &x)
+  {
+    writer_->key(id);
+    writer_->value(x);
+  }
+
+  void write_value(const char *id, char x);
+  void write_value(const char *id, const char *x, int s);
+  void write_value(const char *id, const std::string &x);
+  void write_value(const char *id, const varchar_base &x);
+  void write_value(const char *id, const object_base_ptr &x);
+  void write_value(const char *id, const object_container &x);
+  /// @endcond
+
+private:
+  void write_container_item(object *o);
+
+private:
+  json_writer *writer_;
+};
+
+}
+
+#endif /* JSON_OBJECT_WRITER_HPP */
@@ -93,6 +93,31 @@ public:
    */
   json_value parse(std::string &str);
 
+  /**
+   * @brief parse a character buffer.
+   *
+   * Parses a character buffer of the given
+   * length and returns a json_value object
+   * representing the json structure. The
+   * buffer doesn't need to be null terminated.
+   *
+   * @param str The json character buffer.
+   * @param len The length of the buffer.
+   * @return A json_value structure.
+   */
+  json_value parse(const char *str, std::size_t len);
+
+  /**
+   * @brief parse a json file.
+   *
+   * Maps the given file into memory and
+   * parses its content.
+   *
+   * @param filename The name of the json file.
+   * @return A json_value structure.
+   */
+  json_value parse_file(const char *filename);
+
   /// @cond OOS_DEV //
   void on_begin_object();
   void on_object_key(const std::string &key);
@@ -103,10 +128,14 @@ public:
 
   void on_string(const std::string &value);
   void on_number(double value);
+  void on_integer(long long value);
   void on_bool(bool value);
   void on_null();
   /// @endcond OOS_DEV //
 
+private:
+  void reset();
+
 private:
   json_value value_;
 
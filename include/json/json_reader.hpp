@@ -0,0 +1,273 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_READER_HPP
+#define JSON_READER_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace oos {
+
+/**
+ * @class json_reader
+ * @brief Reads a json stream token by token
+ *
+ * The json_reader is a pull parser for json
+ * documents of any size. The input is handed
+ * over in chunks of any size with feed() and
+ * the tokens are taken one by one with next().
+ * When the chunks are used up next() returns
+ * TOKEN_NEED_MORE and the next chunk must be
+ * fed. After the last chunk finish() must be
+ * called; next() returns TOKEN_END once the
+ * document is complete.
+ *
+ * No structure is built. The reader only keeps
+ * the nesting of the open arrays and objects
+ * and the bytes of a token which is split between
+ * two chunks, so the memory stays constant even
+ * for arrays of millions of records.
+ *
+ * Strings and keys are returned as views (see
+ * data() and length()) into the fed chunk. Only
+ * strings with escape sequences are decoded into
+ * an internal buffer. A view is valid until the
+ * next call to next() or feed(). A fed chunk must
+ * stay valid until next() returned TOKEN_NEED_MORE,
+ * then the unread rest is copied.
+ *
+ * @code
+ * json_reader reader;
+ * char buf[4096];
+ * while (in.read(buf, sizeof(buf)) || in.gcount()) {
+ *   reader.feed(buf, in.gcount());
+ *   json_reader::token_t t;
+ *   while ((t = reader.next()) != json_reader::TOKEN_NEED_MORE) {
+ *     // handle token t
+ *   }
+ * }
+ * reader.finish();
+ * // handle the remaining tokens up to TOKEN_END
+ * @endcode
+ *
+ * Errors in the input are reported with
+ * a std::logic_error.
+ */
+class OOS_API json_reader
+{
+public:
+  /**
+   * @enum token_t
+   * @brief The tokens returned by next()
+   */
+  enum token_t {
+    TOKEN_NEED_MORE = 0, /**< The next chunk is needed. */
+    TOKEN_END,           /**< The document is complete. */
+    TOKEN_BEGIN_OBJECT,  /**< An object begins. */
+    TOKEN_END_OBJECT,    /**< An object ends. */
+    TOKEN_BEGIN_ARRAY,   /**< An array begins. */
+    TOKEN_END_ARRAY,     /**< An array ends. */
+    TOKEN_KEY,           /**< The key of an object member. */
+    TOKEN_STRING,        /**< A string value. */
+    TOKEN_NUMBER,        /**< A real number value. */
+    TOKEN_INTEGER,       /**< A 64 bit integer value. */
+    TOKEN_BOOL,          /**< A boolean value. */
+    TOKEN_NULL           /**< The null value. */
+  };
+
+  /**
+   * Creates a json_reader without input.
+   */
+  json_reader();
+  ~json_reader();
+
+  /**
+   * @brief Hands the next chunk of input to the reader.
+   *
+   * The chunk isn't copied. It must stay valid
+   * until next() returns TOKEN_NEED_MORE.
+   *
+   * @param data The chunk.
+   * @param len The length of the chunk.
+   * @throws std::logic_error If finish() was called.
+   */
+  void feed(const char *data, std::size_t len);
+
+  /**
+   * Tells the reader that there is
+   * no more input.
+   */
+  void finish();
+
+  /**
+   * @brief Reads the next token.
+   *
+   * Reads the next token from the fed input.
+   * If the input ends before the next token is
+   * complete TOKEN_NEED_MORE is returned.
+   *
+   * @return The next token.
+   * @throws std::logic_error If the input isn't valid json.
+   */
+  token_t next();
+
+  /**
+   * Returns the last token read by next().
+   *
+   * @return The last token.
+   */
+  token_t token() const;
+
+  /**
+   * Returns the number of open
+   * arrays and objects.
+   *
+   * @return The current nesting depth.
+   */
+  std::size_t depth() const;
+
+  /**
+   * Returns the characters of the current
+   * string or key. They aren't null terminated.
+   *
+   * @return The characters of the string.
+   */
+  const char* data() const;
+
+  /**
+   * Returns the length of the current
+   * string or key.
+   *
+   * @return The length of the string.
+   */
+  std::size_t length() const;
+
+  /**
+   * Returns a copy of the current string or key.
+   *
+   * @return The current string.
+   */
+  std::string as_string() const;
+
+  /**
+   * Returns the current number. An integer
+   * is converted into a double.
+   *
+   * @return The current number.
+   */
+  double as_number() const;
+
+  /**
+   * Returns the current integer.
+   *
+   * @return The current integer.
+   */
+  long long as_integer() const;
+
+  /**
+   * Returns the current boolean value.
+   *
+   * @return The current boolean value.
+   */
+  bool as_bool() const;
+
+  /**
+   * Returns the number of bytes reserved
+   * for split tokens and decoded strings.
+   *
+   * @return The reserved memory of the reader.
+   */
+  std::size_t memory_usage() const;
+
+  /**
+   * Resets the reader to read
+   * the next document.
+   */
+  void reset();
+
+private:
+  // copying not permitted
+  json_reader(const json_reader&);
+  json_reader& operator=(const json_reader&);
+
+  enum state_t {
+    STATE_ROOT = 0,
+    STATE_FIRST_KEY,
+    STATE_KEY,
+    STATE_COLON,
+    STATE_FIRST_VALUE,
+    STATE_VALUE,
+    STATE_NEXT,
+    STATE_TRAILING,
+    STATE_DONE
+  };
+
+  token_t need_more();
+  token_t begin_container(char c);
+  token_t end_container(char c);
+  token_t read_value();
+  token_t read_string(token_t type);
+  token_t read_number();
+  token_t read_literal(const char *literal, std::size_t len);
+  void decode_string(const char *first, const char *last);
+
+private:
+  const char *cur_;
+  const char *end_;
+  bool external_;
+  bool finished_;
+
+  state_t state_;
+  token_t token_;
+
+  // the open containers, '{' or '['
+  std::vector<char> stack_;
+
+  // unread rest of the previous chunks
+  std::vector<char> buffer_;
+
+  // decoded string with escape sequences
+  std::string string_;
+  // scan position inside a split string
+  std::size_t scan_offset_;
+  bool escaped_;
+
+  const char *str_;
+  std::size_t len_;
+  double number_;
+  long long integer_;
+  bool bool_;
+};
+
+}
+
+#endif /* JSON_READER_HPP */
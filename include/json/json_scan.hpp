@@ -0,0 +1,160 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_SCAN_HPP
+#define JSON_SCAN_HPP
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OOS_JSON_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace oos {
+
+/// @cond OOS_DEV
+
+/*
+ * Helper functions scanning a contiguous json
+ * buffer. Whole blocks of 32 (AVX2) or 16 (SSE2)
+ * bytes are compared at once, the remaining bytes
+ * are scanned one by one. The functions never
+ * read behind the given end of the buffer.
+ */
+
+inline bool json_is_whitespace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline unsigned json_first_bit(unsigned mask)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * Returns the first character in [first, last)
+ * which isn't a json whitespace or last.
+ *
+ * @param first The start of the buffer.
+ * @param last The end of the buffer.
+ * @return The first non whitespace character.
+ */
+inline const char* json_skip_whitespace(const char *first, const char *last)
+{
+  // most tokens are separated by at most one blank
+  if (first == last || !json_is_whitespace(*first)) {
+    return first;
+  }
+  ++first;
+  if (first == last || !json_is_whitespace(*first)) {
+    return first;
+  }
+#if defined(__AVX2__)
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i newline = _mm256_set1_epi8('\n');
+  const __m256i cr = _mm256_set1_epi8('\r');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  while (last - first >= 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, newline)),
+                                 _mm256_or_si256(_mm256_cmpeq_epi8(block, cr), _mm256_cmpeq_epi8(block, tab)));
+    unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(ws));
+    if (mask != 0) {
+      return first + json_first_bit(mask);
+    }
+    first += 32;
+  }
+#elif defined(OOS_JSON_SSE2)
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i tab = _mm_set1_epi8('\t');
+  while (last - first >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, newline)),
+                              _mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, tab)));
+    unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xffff;
+    if (mask != 0) {
+      return first + json_first_bit(mask);
+    }
+    first += 16;
+  }
+#endif
+  while (first != last && json_is_whitespace(*first)) {
+    ++first;
+  }
+  return first;
+}
+
+/**
+ * Returns the first double quote or backslash
+ * in [first, last) or last.
+ *
+ * @param first The start of the buffer.
+ * @param last The end of the buffer.
+ * @return The first double quote or backslash.
+ */
+inline const char* json_find_string_special(const char *first, const char *last)
+{
+#if defined(__AVX2__)
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  while (last - first >= 32) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, backslash));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+    if (mask != 0) {
+      return first + json_first_bit(mask);
+    }
+    first += 32;
+  }
+#elif defined(OOS_JSON_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  while (last - first >= 16) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+    if (mask != 0) {
+      return first + json_first_bit(mask);
+    }
+    first += 16;
+  }
+#endif
+  while (first != last && *first != '"' && *first != '\\') {
+    ++first;
+  }
+  return first;
+}
+
+/// @endcond
+
+}
+
+#endif /* JSON_SCAN_HPP */
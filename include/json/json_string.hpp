@@ -117,14 +117,14 @@ public:
   bool operator<(const json_string &x) const;
 
   virtual bool parse(std::istream &in);
-  virtual void print(std::ostream &out) const;
+  virtual void write(json_writer &writer) const;
 
   /**
    * Return the current value.
    * 
    * @return The current value.
    */
-  std::string value() const;
+  const std::string& value() const;
   
   /**
    * Set a new value.
@@ -38,6 +38,7 @@
 namespace oos {
 
 class json_value;
+class json_writer;
 
 /**
  * @class json_type
@@ -77,11 +78,20 @@ public:
 
   /**
    * Prints the json type (tree) to
-   * a output stream.
+   * a output stream. The output is
+   * written through a json_writer.
    * 
    * @param out The stream to write on.
    */
-  virtual void print(std::ostream &out) const = 0;
+  virtual void print(std::ostream &out) const;
+
+  /**
+   * Writes the json type (tree) to
+   * the given json_writer.
+   * 
+   * @param writer The json_writer to write to.
+   */
+  virtual void write(json_writer &writer) const = 0;
 
   /**
    * Returns a json_value with the given key.
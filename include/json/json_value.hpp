@@ -47,6 +47,7 @@ class json_array;
 class json_number;
 class json_null;
 class json_type;
+class json_writer;
 
 /**
  * @class json_value
@@ -106,6 +107,15 @@ public:
    */
   json_value(int x);
 
+  /**
+   * Creates a new json_value and initializes
+   * it with a 64 bit integer. Internaly an object
+   * of type json_number is created.
+   * 
+   * @param x The integer to initialize from.
+   */
+  json_value(long long x);
+
   /**
    * Creates a new json_value and initializes
    * it with a double. Internaly an object of
@@ -164,6 +174,14 @@ public:
    */
   json_value& operator=(double x);
 
+  /**
+   * Assign from a 64 bit integer value
+   *
+   * @param x The integer value to assign from.
+   * @return The initialized json_value.
+   */
+  json_value& operator=(long long x);
+
   /**
    * Assign from a boolean value
    *
@@ -221,6 +239,14 @@ public:
    */
   size_t size() const;
 
+  /**
+   * Writes the json_value with all its
+   * children to the given json_writer.
+   * 
+   * @param writer The json_writer to write to.
+   */
+  void write(json_writer &writer) const;
+
   /**
    * Creates a json_value from the
    * given input stream.
@@ -0,0 +1,394 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+
+namespace oos {
+
+class json_value;
+class json_node;
+
+/**
+ * @class json_writer
+ * @brief Writes json into a contiguous buffer
+ *
+ * The json_writer writes json tokens into one
+ * contiguous character buffer. Separators between
+ * keys and values are inserted automatically,
+ * strings are escaped and numbers are formatted
+ * without locale (see json_numeric.hpp).
+ *
+ * The output goes to one of these targets:
+ * - a growable buffer owned by the writer
+ *   (see data(), size() and str())
+ * - a buffer of fixed size given by the caller;
+ *   output which doesn't fit is cut off and
+ *   overflow() returns true
+ * - a file descriptor or an output stream; the
+ *   buffer is written to the target whenever
+ *   it is full, on flush() and on destruction
+ *
+ * The format is either the inline format also
+ * used by the stream operators, a compact format
+ * without any blanks or a pretty printed format
+ * with one member per line.
+ *
+ * @code
+ * json_writer writer(json_writer::FORMAT_COMPACT);
+ * writer.begin_object();
+ * writer.key("name");
+ * writer.value("George");
+ * writer.key("values");
+ * writer.value(values);  // a json_value
+ * writer.end_object();
+ * send(writer.data(), writer.size());
+ * @endcode
+ *
+ * Like the json parsers the writer keeps
+ * \\uXXXX sequences in strings as they are.
+ */
+class OOS_API json_writer
+{
+public:
+  /**
+   * @enum format_t
+   * @brief The output format
+   */
+  enum format_t {
+    FORMAT_INLINE = 0, /**< One line with blanks: { "a" : [ 1, 2 ] } */
+    FORMAT_COMPACT,    /**< No blanks at all: {"a":[1,2]} */
+    FORMAT_PRETTY      /**< One member per line, indented. */
+  };
+
+  /**
+   * Creates a json_writer writing into
+   * its own growable buffer.
+   *
+   * @param format The output format.
+   */
+  explicit json_writer(format_t format = FORMAT_INLINE);
+
+  /**
+   * Creates a json_writer writing into the
+   * given buffer. The output isn't null terminated.
+   *
+   * @param buf The output buffer.
+   * @param size The size of the output buffer.
+   * @param format The output format.
+   */
+  json_writer(char *buf, std::size_t size, format_t format = FORMAT_INLINE);
+
+  /**
+   * Creates a json_writer writing
+   * to the given file descriptor.
+   *
+   * @param fd The file descriptor to write to.
+   * @param format The output format.
+   */
+  explicit json_writer(int fd, format_t format = FORMAT_INLINE);
+
+  /**
+   * Creates a json_writer writing
+   * to the given stream.
+   *
+   * @param out The stream to write to.
+   * @param format The output format.
+   */
+  explicit json_writer(std::ostream &out, format_t format = FORMAT_INLINE);
+
+  /**
+   * Writes the buffered output to the file
+   * descriptor or stream and destroys the writer.
+   */
+  ~json_writer();
+
+  /**
+   * Begins a json object.
+   */
+  void begin_object();
+
+  /**
+   * Ends the current json object.
+   */
+  void end_object();
+
+  /**
+   * Begins a json array.
+   */
+  void begin_array();
+
+  /**
+   * Ends the current json array.
+   */
+  void end_array();
+
+  /**
+   * Writes the key of the next object member.
+   *
+   * @param str The characters of the key.
+   * @param len The length of the key.
+   */
+  void key(const char *str, std::size_t len);
+
+  /**
+   * Writes the key of the next object member.
+   *
+   * @param str The null terminated key.
+   */
+  void key(const char *str);
+
+  /**
+   * Writes the key of the next object member.
+   *
+   * @param str The key.
+   */
+  void key(const std::string &str);
+
+  /**
+   * Writes a string value.
+   *
+   * @param str The characters of the string.
+   * @param len The length of the string.
+   */
+  void value(const char *str, std::size_t len);
+
+  /**
+   * Writes a string value.
+   *
+   * @param str The null terminated string.
+   */
+  void value(const char *str);
+
+  /**
+   * Writes a string value.
+   *
+   * @param str The string.
+   */
+  void value(const std::string &str);
+
+  /**
+   * Writes a number value.
+   *
+   * @param x The number.
+   */
+  void value(double x);
+
+  /**
+   * Writes an integer value.
+   *
+   * @param x The integer.
+   */
+  void value(int x);
+
+  /**
+   * Writes an integer value.
+   *
+   * @param x The integer.
+   */
+  void value(unsigned int x);
+
+  /**
+   * Writes an integer value.
+   *
+   * @param x The integer.
+   */
+  void value(long x);
+
+  /**
+   * Writes an integer value.
+   *
+   * @param x The integer.
+   */
+  void value(unsigned long x);
+
+  /**
+   * Writes an integer value.
+   *
+   * @param x The integer.
+   */
+  void value(long long x);
+
+  /**
+   * Writes an integer value.
+   *
+   * @param x The integer.
+   */
+  void value(unsigned long long x);
+
+  /**
+   * Writes a boolean value.
+   *
+   * @param x The boolean value.
+   */
+  void value(bool x);
+
+  /**
+   * Writes a json_value with
+   * all its children.
+   *
+   * @param x The json_value to write.
+   */
+  void value(const json_value &x);
+
+  /**
+   * Writes a json_node of a json_document
+   * with all its children.
+   *
+   * @param x The json_node to write.
+   */
+  void value(const json_node &x);
+
+  /**
+   * Writes a null value.
+   */
+  void null();
+
+  /**
+   * Writes the buffered output to the
+   * file descriptor or stream.
+   */
+  void flush();
+
+  /**
+   * Returns the buffered output.
+   *
+   * @return The buffered output.
+   */
+  const char* data() const;
+
+  /**
+   * Returns the size of the buffered output.
+   *
+   * @return The size of the buffered output.
+   */
+  std::size_t size() const;
+
+  /**
+   * Returns a copy of the buffered output.
+   *
+   * @return The buffered output.
+   */
+  std::string str() const;
+
+  /**
+   * Drops the buffered output and
+   * resets the nesting state.
+   */
+  void clear();
+
+  /**
+   * Returns true if output didn't fit
+   * into the caller's buffer.
+   *
+   * @return True if output was cut off.
+   */
+  bool overflow() const;
+
+  /**
+   * Returns the output format.
+   *
+   * @return The output format.
+   */
+  format_t format() const;
+
+private:
+  // copying not permitted
+  json_writer(const json_writer&);
+  json_writer& operator=(const json_writer&);
+
+  enum target_t {
+    TARGET_BUFFER = 0,
+    TARGET_FIXED,
+    TARGET_FD,
+    TARGET_STREAM
+  };
+
+  enum {
+    INITIAL_SIZE = 256,
+    BLOCK_SIZE = 64 * 1024
+  };
+
+  void put(char c)
+  {
+    if (size_ == capacity_ && !make_room(1)) {
+      overflow_ = true;
+      return;
+    }
+    buf_[size_++] = c;
+  }
+
+  void put(const char *str, std::size_t len)
+  {
+    if (capacity_ - size_ < len && !make_room(len)) {
+      put_slow(str, len);
+      return;
+    }
+    std::memcpy(buf_ + size_, str, len);
+    size_ += len;
+  }
+
+  bool make_room(std::size_t len);
+  void put_slow(const char *str, std::size_t len);
+  void write_target(const char *str, std::size_t len);
+
+  void separate();
+  void newline();
+  void begin_container(char c);
+  void end_container(char c);
+  void string(const char *str, std::size_t len);
+  void node(const json_node &x);
+
+private:
+  target_t target_;
+  format_t format_;
+
+  char *buf_;
+  std::size_t size_;
+  std::size_t capacity_;
+  bool overflow_;
+
+  int fd_;
+  std::ostream *out_;
+
+  // one flag per open container, true while it is empty
+  std::vector<bool> empty_;
+  bool after_key_;
+};
+
+}
+
+#endif /* JSON_WRITER_HPP */
@@ -0,0 +1,215 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHANGE_FEED_HPP
+#define CHANGE_FEED_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include "object/object_observer.hpp"
+
+#include "tools/bounded_queue.hpp"
+
+#include <string>
+#include <cstddef>
+
+namespace oos {
+
+struct prototype_node;
+
+/**
+ * @struct change_record
+ * @brief Describes one change of the object_store
+ *
+ * A change_record holds the operation, the type
+ * and the id of a changed object. If the change_feed
+ * was created with payloads enabled the record also
+ * holds the serialized object (see object_serializer).
+ */
+struct OOS_API change_record
+{
+  /**
+   * @enum operation_t
+   * @brief The operation of a change
+   */
+  enum operation_t {
+    CHANGE_INSERT = 0, /**< The object was inserted. */
+    CHANGE_UPDATE,     /**< The object was updated. */
+    CHANGE_DELETE      /**< The object was deleted. */
+  };
+
+  change_record()
+    : op(CHANGE_INSERT), node(0), id(0)
+  {}
+
+  operation_t op;              /**< The operation. */
+  const prototype_node *node;  /**< The prototype_node of the object. */
+  long id;                     /**< The id of the object. */
+  std::string payload;         /**< The serialized object or empty. */
+};
+
+/**
+ * @class change_feed
+ * @brief Hands object_store changes to consumer threads
+ *
+ * The change_feed is an object_observer which
+ * appends a change_record for each insert, update
+ * and delete to a bounded lock-free queue. The
+ * observer callbacks only copy the record into
+ * the queue, so the thread changing the object_store
+ * never waits for the consumers as long as the
+ * queue isn't full.
+ *
+ * Consumers take the records from their own threads
+ * with try_pop(), pop() or drain(). Several stores
+ * may share one feed.
+ *
+ * When the queue is full the overflow policy decides
+ * whether the writing thread waits for a free slot
+ * or the record is dropped and counted.
+ *
+ * The prototype_node of a record stays valid as long
+ * as the prototype isn't removed from its store.
+ */
+class OOS_API change_feed : public object_observer
+{
+public:
+  typedef bounded_queue<change_record> t_change_queue; /**< Shortcut to the record queue. */
+  typedef t_change_queue::size_type size_type;         /**< Shortcut to the size type. */
+
+  /**
+   * @enum overflow_t
+   * @brief Behaviour when the queue is full
+   */
+  enum overflow_t {
+    BLOCK_ON_FULL = 0, /**< The writer waits for a free slot. */
+    DROP_ON_FULL       /**< The record is dropped and counted. */
+  };
+
+  /**
+   * Creates a change_feed with the given capacity.
+   *
+   * @param capacity The minimum number of queued records.
+   * @param overflow The behaviour when the queue is full.
+   * @param payload If true records hold the serialized object.
+   */
+  explicit change_feed(size_type capacity, overflow_t overflow = BLOCK_ON_FULL, bool payload = false);
+  virtual ~change_feed();
+
+  virtual void on_insert(object *o);
+  virtual void on_update(object *o);
+  virtual void on_delete(object *o);
+
+  /**
+   * Takes the next record if there is one.
+   *
+   * @param record The taken record.
+   * @return False if there was no record.
+   */
+  bool try_pop(change_record &record);
+
+  /**
+   * Takes the next record and waits
+   * while there is none.
+   *
+   * @param record The taken record.
+   */
+  void pop(change_record &record);
+
+  /**
+   * Takes all queued records (or up to max records
+   * if max isn't zero) and calls the given function
+   * for each record.
+   *
+   * @tparam F The type of the function.
+   * @param f The function called with each record.
+   * @param max The maximum number of records or zero.
+   * @return The number of taken records.
+   */
+  template < class F >
+  size_type drain(F f, size_type max = 0)
+  {
+    size_type n = 0;
+    change_record record;
+    while ((max == 0 || n < max) && queue_.try_pop(record)) {
+      f(record);
+      ++n;
+    }
+    return n;
+  }
+
+  /**
+   * Returns the capacity of the queue.
+   *
+   * @return The capacity of the queue.
+   */
+  size_type capacity() const;
+
+  /**
+   * Returns the number of queued records.
+   *
+   * @return The number of queued records.
+   */
+  size_type size() const;
+
+  /**
+   * Returns the number of records dropped
+   * because the queue was full.
+   *
+   * @return The number of dropped records.
+   */
+  unsigned long dropped() const;
+
+  /**
+   * Returns the overflow policy.
+   *
+   * @return The overflow policy.
+   */
+  overflow_t overflow() const;
+
+  /**
+   * Returns true if records hold
+   * the serialized object.
+   *
+   * @return True if payloads are enabled.
+   */
+  bool payload() const;
+
+private:
+  void push(change_record::operation_t op, object *o);
+
+private:
+  t_change_queue queue_;
+  overflow_t overflow_;
+  bool payload_;
+  volatile unsigned long dropped_;
+};
+
+}
+
+#endif /* CHANGE_FEED_HPP */
@@ -0,0 +1,126 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORY_REPORT_HPP
+#define MEMORY_REPORT_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+  #define EXPIMP_TEMPLATE
+#endif
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <cstddef>
+
+namespace oos {
+
+/**
+ * @struct prototype_memory
+ * @brief The memory used by the objects of one prototype
+ *
+ * Holds the memory used by the own objects of a
+ * prototype_node, objects of child prototypes
+ * aren't included. All bytes except the object
+ * bytes are estimates: out of line bytes are the
+ * characters of long strings and the elements of
+ * containers, pointer bytes are the tree nodes of
+ * the object pointer sets and the relation lists
+ * of the object proxies.
+ */
+struct OOS_API prototype_memory
+{
+  prototype_memory();
+
+  std::string type;           /**< The type name of the prototype. */
+  unsigned long objects;      /**< The number of own objects including evicted ones. */
+  unsigned long loaded;       /**< The number of own objects held in memory. */
+  std::size_t object_size;    /**< The size of the concrete type. */
+  std::size_t object_bytes;   /**< The bytes of the loaded objects. */
+  std::size_t heap_bytes;     /**< The estimated out of line bytes of the loaded objects. */
+  std::size_t proxy_bytes;    /**< The bytes of the object proxies and the proxy index. */
+  std::size_t pointer_bytes;  /**< The estimated bytes of the pointer tracking. */
+
+  /**
+   * Returns the sum of all bytes.
+   *
+   * @return The sum of all bytes.
+   */
+  std::size_t total() const;
+};
+
+/**
+ * @class memory_report
+ * @brief The memory used by an object_store
+ *
+ * The memory_report holds the memory of each
+ * prototype of an object_store in the order of
+ * the prototype tree and the memory of the id
+ * map, which is shared by all prototypes.
+ *
+ * @see object_store::memory_usage()
+ */
+class OOS_API memory_report
+{
+public:
+  typedef std::vector<prototype_memory> t_prototype_memory_vector; /**< Shortcut to the prototype vector. */
+
+  memory_report();
+
+  /**
+   * Returns the memory of the given prototype
+   * or null if the type is unknown.
+   *
+   * @param type The type name of the prototype.
+   * @return The memory of the prototype.
+   */
+  const prototype_memory* find(const std::string &type) const;
+
+  /**
+   * Returns the sum of all prototypes
+   * and the id map.
+   *
+   * @return The sum of all bytes.
+   */
+  std::size_t total() const;
+
+  /**
+   * Writes the report as table, one line
+   * per prototype followed by the id map
+   * and the total.
+   *
+   * @param out The stream to write to.
+   */
+  void write(std::ostream &out) const;
+
+  t_prototype_memory_vector prototypes;  /**< The memory of each prototype. */
+  std::size_t id_map_bytes;              /**< The bytes of the id map. */
+};
+
+}
+
+#endif /* MEMORY_REPORT_HPP */
@@ -333,6 +333,7 @@ private:
   friend class relation_filler;
   friend class query;
   friend class database;
+  friend class change_feed;
 
 	long id_;
   object_proxy *proxy_;
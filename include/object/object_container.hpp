@@ -235,6 +235,8 @@ protected:
   friend class object_creator;
   friend class object_deleter;
   friend class object_serializer;
+  friend class json_object_writer;
+  friend class json_object_reader;
   friend class relation_handler;
   friend class relation_filler;
   friend class table;
@@ -0,0 +1,83 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECT_LOADER_HPP
+#define OBJECT_LOADER_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+namespace oos {
+
+class object;
+struct prototype_node;
+
+/**
+ * @class object_loader
+ * @brief Base class for object loader classes
+ *
+ * When the object_store has a memory budget it
+ * evicts unused objects and reloads them on the
+ * next access. An object_loader registered with
+ * the object_store provides the objects to reload
+ * and tells which objects must stay in memory
+ * because they aren't persistent yet.
+ */
+class OOS_API object_loader
+{
+public:
+  virtual ~object_loader() {}
+
+  /**
+   * @brief Loads an object.
+   *
+   * Creates and loads the object of the given
+   * type and id. If there is no such object
+   * NULL is returned.
+   *
+   * @param node The prototype_node of the object.
+   * @param id The id of the object.
+   * @return The loaded object or NULL.
+   */
+  virtual object* load(const prototype_node &node, long id) = 0;
+
+  /**
+   * @brief Returns true if an object is dirty.
+   *
+   * Returns true if the object with the given id
+   * has changes which couldn't be reloaded yet.
+   * Dirty objects are never evicted.
+   *
+   * @param id The id of the object.
+   * @return True if the object is dirty.
+   */
+  virtual bool is_dirty(long id) const = 0;
+};
+
+}
+
+#endif /* OBJECT_LOADER_HPP */
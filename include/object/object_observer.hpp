@@ -18,6 +18,8 @@
 #ifndef OBJECT_OBSERVER_HPP
 #define OBJECT_OBSERVER_HPP
 
+#include <cstddef>
+
 namespace oos {
 
 class object;
@@ -30,6 +32,15 @@ class object;
  * delete actions an observer class instance must be
  * registered with object store.
  * Use this class as base class for all observer classes.
+ *
+ * An observer is either registered for all objects
+ * or only for the objects of a prototype (and its
+ * subtypes).
+ *
+ * Bulk operations of the object_store deliver all
+ * affected objects with one call of on_bulk_insert
+ * or on_bulk_delete. By default these methods call
+ * the single object methods for each object.
  */
 class OOS_API object_observer
 {
@@ -65,6 +76,39 @@ public:
    * @param o The deleted object.
    */
   virtual void on_delete(object *o) = 0;
+
+  /**
+   * @brief Called on bulk insertion.
+   *
+   * Called once with all objects inserted
+   * by a bulk operation of the object_store.
+   *
+   * @param objects The inserted objects.
+   * @param n The number of inserted objects.
+   */
+  virtual void on_bulk_insert(object *const *objects, std::size_t n)
+  {
+    for (std::size_t i = 0; i < n; ++i) {
+      on_insert(objects[i]);
+    }
+  }
+
+  /**
+   * @brief Called on bulk deletion.
+   *
+   * Called once with all objects deleted
+   * by a bulk operation of the object_store.
+   * The objects are deleted after this call.
+   *
+   * @param objects The deleted objects.
+   * @param n The number of deleted objects.
+   */
+  virtual void on_bulk_delete(object *const *objects, std::size_t n)
+  {
+    for (std::size_t i = 0; i < n; ++i) {
+      on_delete(objects[i]);
+    }
+  }
 };
 
 }
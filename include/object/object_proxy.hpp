@@ -214,6 +214,8 @@ struct object_proxy {
 
   object_store *ostore;    /**< The object_store to which the object_proxy belongs. */
   prototype_node *node;    /**< The prototype_node containing the type of the object. */
+  unsigned long index;     /**< The position inside the proxy index of the prototype_node. */
+  bool referenced;         /**< Set on each object access, cleared by the clock sweep of the object cache. */
 
   typedef std::set<object_base_ptr*> ptr_set_t; /**< Shortcut to the object_base_ptr_set. */
   ptr_set_t ptr_set_;      /**< This set contains every object_base_ptr pointing to this object_proxy. */
@@ -0,0 +1,200 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECT_PROXY_MAP_HPP
+#define OBJECT_PROXY_MAP_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <vector>
+#include <cstddef>
+
+namespace oos {
+
+struct object_proxy;
+
+/**
+ * @cond OOS_DEV
+ * @class object_proxy_map
+ * @brief Maps object ids to their object_proxy
+ *
+ * The object_proxy_map is the id lookup table of the
+ * object_store. Because ids are handed out by a sequencer
+ * they are almost dense, so the map stores them in a paged
+ * direct index array: the id selects a page and the slot
+ * inside the page. A page is only allocated once enough ids
+ * of its range are in use. Until then and for all ids out
+ * of the paged range (negative or very sparse ids) the
+ * entries live in an open addressing hash table with linear
+ * probing.
+ */
+class OOS_API object_proxy_map
+{
+public:
+  typedef std::size_t size_type; /**< Shortcut for the size type. */
+
+  object_proxy_map();
+  ~object_proxy_map();
+
+  /**
+   * @brief Finds the object_proxy of an id.
+   *
+   * Returns the object_proxy stored for the
+   * given id or NULL if there is none.
+   *
+   * @param id The id to look for.
+   * @return The object_proxy or NULL.
+   */
+  object_proxy* find(long id) const
+  {
+    unsigned long index = static_cast<unsigned long>(id) >> PAGE_SHIFT;
+    if (id > 0 && index < directory_.size() && directory_[index].slots) {
+      return directory_[index].slots[id & PAGE_MASK];
+    }
+    return hash_find(id);
+  }
+
+  /**
+   * @brief Inserts an object_proxy for an id.
+   *
+   * Inserts the given object_proxy for the given
+   * id. If there is already an object_proxy for
+   * the id or the id is zero nothing is inserted
+   * and false is returned.
+   *
+   * @param id The id of the object_proxy.
+   * @param proxy The object_proxy to insert.
+   * @return True if the object_proxy was inserted.
+   */
+  bool insert(long id, object_proxy *proxy);
+
+  /**
+   * @brief Removes the entry of an id.
+   *
+   * @param id The id to remove.
+   * @return True if an entry was removed.
+   */
+  bool erase(long id);
+
+  /**
+   * Removes all entries and releases the
+   * allocated memory.
+   */
+  void clear();
+
+  /**
+   * @brief Reserves room for n more entries.
+   *
+   * Makes room for n more entries following
+   * the current highest id, so that inserting
+   * them sequentially doesn't reallocate the
+   * page directory.
+   *
+   * @param n The number of entries to reserve.
+   */
+  void reserve(size_type n);
+
+  /**
+   * Returns the number of entries.
+   *
+   * @return The number of entries.
+   */
+  size_type size() const;
+
+  /**
+   * Returns true if there are no entries.
+   *
+   * @return True if the map is empty.
+   */
+  bool empty() const;
+
+  /**
+   * Returns the number of bytes currently
+   * allocated by the map.
+   *
+   * @return The allocated bytes.
+   */
+  size_type memory_usage() const;
+
+private:
+  enum { PAGE_SHIFT = 10, PAGE_SIZE = 1 << PAGE_SHIFT, PAGE_MASK = PAGE_SIZE - 1 };
+  /*
+   * a page is allocated when this count of
+   * entries of its range are in use
+   */
+  enum { PAGE_THRESHOLD = PAGE_SIZE >> 5 };
+  /*
+   * number of pages the directory may always
+   * cover, beyond it must be dense enough
+   */
+  enum { MIN_DIRECTORY_SIZE = 1 << 13 };
+  enum { MIN_HASH_CAPACITY = 16 };
+
+  struct page_entry
+  {
+    page_entry() : slots(0), count(0) {}
+    object_proxy **slots;
+    size_type count;
+  };
+  typedef std::vector<page_entry> t_page_directory;
+
+  struct hash_slot
+  {
+    long id;
+    object_proxy *proxy;
+  };
+
+private:
+  bool in_directory(long id);
+
+  void allocate_page(size_type index);
+  void release_page(size_type index);
+
+  object_proxy* hash_find(long id) const;
+  bool hash_insert(long id, object_proxy *proxy);
+  bool hash_erase(long id);
+  void hash_resize(size_type capacity);
+  size_type hash_index(long id) const;
+
+private:
+  t_page_directory directory_;
+  size_type directory_limit_;
+  size_type pages_;
+
+  hash_slot *hash_;
+  size_type hash_capacity_;
+  size_type hash_size_;
+
+  size_type size_;
+  long max_id_;
+};
+/// @endcond
+
+}
+
+#endif /* OBJECT_PROXY_MAP_HPP */
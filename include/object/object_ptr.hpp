@@ -222,6 +222,7 @@ private:
 
   template < class T > friend class object_ref;
   template < class T > friend class object_ptr;
+  template < class T > friend class untracked_object_ptr;
 
 	long id_;
   object_proxy *proxy_;
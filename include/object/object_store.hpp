@@ -19,8 +19,12 @@
 #define OBJECT_STORE_HPP
 
 #include "object/object_ptr.hpp"
+#include "object/object_proxy_map.hpp"
 
 #include "tools/sequencer.hpp"
+#include "object/memory_report.hpp"
+
+#include "tools/metrics.hpp"
 
 #ifdef WIN32
 #include <memory>
@@ -33,6 +37,7 @@
 #include <string>
 #include <ostream>
 #include <list>
+#include <vector>
 
 #ifdef WIN32
   #ifdef oos_EXPORTS
@@ -55,6 +60,7 @@ struct object_proxy;
 class object_deleter;
 struct prototype_node;
 class object_observer;
+class object_loader;
 class object_container;
 /**
  * @class object_base_producer
@@ -87,6 +93,14 @@ public:
    * @return The classname of the object.
    */
   virtual const char *classname() const = 0;
+
+  /**
+   * Returns the size in bytes of
+   * the produced object.
+   *
+   * @return The size of the object.
+   */
+  virtual std::size_t size() const = 0;
 };
 
 /**
@@ -249,6 +263,14 @@ public:
   virtual const char *classname() const {
     return typeid(T).name();
   }
+  /**
+   * Returns the size of the class which is created
+   * 
+   * @return the size of the produced class
+   */
+  virtual std::size_t size() const {
+    return sizeof(T);
+  }
 };
 
 /**
@@ -268,7 +290,7 @@ public:
 class OOS_API object_store
 {
 private:
-  typedef std::tr1::unordered_map<long, object_proxy*> t_object_proxy_map;
+  typedef object_proxy_map t_object_proxy_map;
   typedef std::tr1::unordered_map<std::string, prototype_node*> t_prototype_map;
 
 public:
@@ -401,6 +423,113 @@ public:
    */
   void clear(bool full = false);
 
+  /**
+   * @brief Reserves room for n objects.
+   *
+   * Prepares the internal id to proxy map
+   * for n more objects, so inserting a large
+   * amount of objects doesn't grow the map
+   * step by step.
+   *
+   * @param n The number of objects to reserve.
+   */
+  void reserve(std::size_t n);
+
+  /**
+   * @brief Sets the memory budget for the objects.
+   *
+   * Once the objects held in memory exceed the
+   * budget, the object_store evicts objects which
+   * aren't referenced, aren't pointed to by any
+   * object_ptr or object_ref and aren't dirty.
+   * Objects holding object pointers or containers
+   * are never evicted, their memory is reported by
+   * cache_pinned(). A budget below that size can't
+   * be reached. An evicted object keeps its
+   * proxy and is reloaded with the object_loader
+   * on the next access. The least recently used
+   * objects are chosen with a clock sweep.
+   * A budget of zero (the default) disables the
+   * eviction.
+   *
+   * @param bytes The memory budget in bytes.
+   */
+  void cache_budget(std::size_t bytes);
+
+  /**
+   * Returns the memory budget in bytes.
+   *
+   * @return The memory budget.
+   */
+  std::size_t cache_budget() const;
+
+  /**
+   * Returns the size in bytes of all
+   * objects currently held in memory.
+   *
+   * @return The size of all loaded objects.
+   */
+  std::size_t cache_size() const;
+
+  /**
+   * Returns the size in bytes of all loaded
+   * objects which are never evicted because
+   * they hold object pointers or containers.
+   *
+   * @return The size of all pinned objects.
+   */
+  std::size_t cache_pinned() const;
+
+  /**
+   * Returns the number of object
+   * accesses served from memory.
+   * Accesses are only counted while
+   * a memory budget is set.
+   *
+   * @return The number of cache hits.
+   */
+  unsigned long cache_hits() const;
+
+  /**
+   * Returns the number of object accesses
+   * which had to reload the object.
+   *
+   * @return The number of cache misses.
+   */
+  unsigned long cache_misses() const;
+
+  /**
+   * Returns the number of evicted objects.
+   *
+   * @return The number of evictions.
+   */
+  unsigned long cache_evictions() const;
+
+  /**
+   * @brief Sets the object_loader.
+   *
+   * The object_loader reloads evicted objects.
+   * Without an object_loader no object is evicted.
+   *
+   * Before the object_loader is replaced the
+   * evicted objects are reloaded with it. An
+   * object which can't be reloaded stays evicted
+   * and is reloaded on the next access once an
+   * object_loader is set again; until then the
+   * access yields NULL. No object is removed
+   * from the object_store.
+   *
+   * @param l The object_loader or NULL.
+   */
+  void loader(object_loader *l);
+
+  /**
+   * Returns the object_loader.
+   *
+   * @return The object_loader or NULL.
+   */
+  object_loader* loader() const;
+
   /**
    * Returns true if the object_store
    * conatins no elements (objects)
@@ -410,11 +539,29 @@ public:
   bool empty() const;
 
   /**
-   * Dump all prototypes to a given stream
+   * Dump all prototypes to a given stream. If memory
+   * is true each prototype also shows the memory
+   * used by its objects (see memory_usage()).
    *
    * @param out The stream to the prototypes dump on.
+   * @param memory If true the memory usage is dumped.
    */
-	void dump_prototypes(std::ostream &out) const;
+	void dump_prototypes(std::ostream &out, bool memory = false) const;
+
+  /**
+   * @brief Returns the memory used by each prototype.
+   *
+   * Walks all object proxies and counts the memory
+   * used by the objects of each prototype, their
+   * proxies and the pointer tracking. Out of line
+   * bytes are estimated by serializing each loaded
+   * object. The walk takes time proportional to the
+   * number of objects and should not be called in
+   * tight loops.
+   *
+   * @return The memory report.
+   */
+  memory_report memory_usage() const;
 
   /**
    * Dump all object to a given stream
@@ -484,24 +631,88 @@ public:
    */
   void remove(object_container &oc);
 
-  /*
+  /**
+   * @brief Inserts a range of objects.
+   *
+   * Inserts all objects of the given range into
+   * the object_store. The observers are notified
+   * once with all inserted objects (including all
+   * created sub objects) after the last insertion.
+   * If an insertion fails the objects inserted so
+   * far stay inserted and are still notified.
+   *
+   * @throw object_exception
+   * @tparam InputIterator Iterator type of the object pointers.
+   * @param first The first object to insert.
+   * @param last The end of the range.
+   */
   template < class InputIterator >
   void insert(InputIterator first, InputIterator last)
   {
-   // std::iterator_traits<InputIterator>::value_type *o = *first;
+    begin_batch();
+    try {
+      while (first != last) {
+        insert_object(*first++, true);
+      }
+    } catch (...) {
+      end_batch();
+      throw;
+    }
+    end_batch();
   }
-  */
   
   /**
    * @brief Register an observer with the object store
    *
+   * The observer is notified about all
+   * objects of all types.
+   *
    * @param observer The object observer to register.
    */
   void register_observer(object_observer *observer);
 
+  /**
+   * @brief Register an observer for a prototype
+   *
+   * The observer is only notified about the objects
+   * of the given prototype. If subtypes is true the
+   * observer is also notified about the objects of
+   * all prototypes derived from the given one.
+   * An observer shouldn't be registered for all objects
+   * and for a prototype at the same time, it would be
+   * notified twice.
+   *
+   * @throw object_exception
+   * @param observer The object observer to register.
+   * @param type The name of the prototype.
+   * @param subtypes If true the observer is notified for all subtypes as well.
+   */
+  void register_observer(object_observer *observer, const char *type, bool subtypes = true);
+
+  /**
+   * @brief Register an observer for a type
+   *
+   * The observer is only notified about the objects
+   * of type T (and of all derived types if subtypes
+   * is true).
+   *
+   * @throw object_exception
+   * @tparam T The type of the objects to observe.
+   * @param observer The object observer to register.
+   * @param subtypes If true the observer is notified for all subtypes as well.
+   */
+  template < class T >
+  void register_observer(object_observer *observer, bool subtypes = true)
+  {
+    register_observer(observer, typeid(T).name(), subtypes);
+  }
+
   /**
    * @brief Unregisters an observer from the object store
    *
+   * Removes all registrations of the observer,
+   * for all objects and for single prototypes.
+   *
    * @param observer The object observer to unregister.
    */
   void unregister_observer(object_observer *observer);
@@ -559,6 +770,30 @@ public:
    */
   void remove_proxy(prototype_node *node, object_proxy *oproxy);
 
+  /**
+   * @brief Returns the object of an object proxy.
+   *
+   * Returns the object of the given object proxy.
+   * If the object was evicted it is reloaded.
+   * The access is only recorded for the clock sweep
+   * and the cache statistics while a memory budget
+   * is set, otherwise the lookup doesn't write.
+   *
+   * @param oproxy The object proxy.
+   * @return The object or NULL.
+   */
+  object* lookup_object(object_proxy *oproxy)
+  {
+    object *o = oproxy->obj;
+    if (!o) {
+      return load_object(oproxy);
+    } else if (cache_budget_ > 0) {
+      oproxy->referenced = true;
+      ++cache_hits_;
+    }
+    return o;
+  }
+
   /**
    * @brief Exchange the sequencer strategy.
    * 
@@ -587,12 +822,49 @@ private:
   void remove(object *o);
 	object* insert_object(object *o, bool notify);
 	void remove_object(object *o, bool notify);
+  void remove_deleted_objects();
 	
   void link_proxy(object_proxy *base, object_proxy *next);
   void unlink_proxy(object_proxy *proxy);
 
   prototype_node* get_prototype(const char *type) const;
 
+  enum notification_t {
+    NOTIFY_INSERT,
+    NOTIFY_UPDATE,
+    NOTIFY_DELETE
+  };
+
+  void notify(notification_t type, object *o);
+  void notify(notification_t type, const std::vector<object*> &objects);
+
+  void begin_batch();
+  void end_batch();
+
+  object* load_object(object_proxy *oproxy);
+  void evict(object_proxy *keep);
+  bool is_evictable(object_proxy *oproxy);
+  void evict_object(object_proxy *oproxy);
+  void restore_evicted();
+  void recount_cache();
+
+  /*
+   * reports the proxies and the estimated
+   * memory of the store to metric snapshots
+   */
+  class store_metrics : public metric_source
+  {
+  public:
+    explicit store_metrics(const object_store &store);
+    virtual ~store_metrics();
+
+    virtual void collect(metrics_snapshot &snapshot) const;
+
+  private:
+    const object_store &store_;
+  };
+  friend class store_metrics;
+
 private:
   prototype_node *root_;
 
@@ -616,11 +888,36 @@ private:
   
   typedef std::list<object_observer*> t_observer_list;
   t_observer_list observer_list_;
+  // count of registrations for single prototypes
+  std::size_t typed_observer_count_;
+
+  // insertions delayed until the end of a bulk operation
+  int batch_depth_;
+  std::vector<object*> batch_inserted_;
 
   object_proxy *first_;
   object_proxy *last_;
   
   object_deleter *object_deleter_;
+
+  object_loader *loader_;
+
+  std::size_t cache_budget_;
+  std::size_t cache_size_;
+  /*
+   * if a sweep couldn't free enough memory
+   * the next sweep waits until the cache
+   * exceeds this size
+   */
+  std::size_t cache_retry_;
+  unsigned long cache_hits_;
+  unsigned long cache_misses_;
+  unsigned long cache_evictions_;
+  // the hand of the clock sweep
+  object_proxy *clock_hand_;
+
+  // declared last to unregister before the store is destroyed
+  store_metrics metrics_;
 };
 
 }
@@ -35,6 +35,185 @@ template < class T > class const_object_view_iterator;
 
 /// @cond OOS_DEV
 
+/**
+ * @brief Finds the first object proxy matching a predicate.
+ *
+ * Walks the contiguous proxy index of the given prototype
+ * node and, if skip_siblings is false, of all its children
+ * nodes (in prototype tree order). Inside a node the
+ * proxies are visited in insertion order. The first object
+ * proxy for which the predicate returns true is returned.
+ *
+ * @tparam Predicate The type of the predicate.
+ * @param node The prototype node to start with.
+ * @param skip_siblings If true only the own object proxies of the node are visited.
+ * @param pred The predicate called with each object proxy.
+ * @return The matching object proxy or NULL.
+ */
+template < class Predicate >
+object_proxy* find_proxy_if(const prototype_node *node, bool skip_siblings, Predicate &pred)
+{
+  const prototype_node *current = node;
+  while (current) {
+    const prototype_node::proxy_vector_t &proxies = current->proxies;
+    prototype_node::proxy_vector_t::size_type size = proxies.size();
+    for (prototype_node::proxy_vector_t::size_type i = 0; i < size; ++i) {
+#ifdef __GNUC__
+      // fetch the proxy some steps ahead
+      if (i + 4 < size) {
+        __builtin_prefetch(proxies[i + 4]);
+      }
+#endif
+      if (proxies[i] && pred(proxies[i])) {
+        return proxies[i];
+      }
+    }
+    if (skip_siblings) {
+      break;
+    }
+    current = current->next_node();
+    if (current && current->depth <= node->depth) {
+      break;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief An object_ptr rebound to one object proxy after another.
+ *
+ * Creating an object_ptr for each visited object proxy
+ * inserts it into and erases it from the pointer set of
+ * the proxy. Instead this class rebinds one object_ptr
+ * to each proxy without registering it there. The bound
+ * object_ptr must not be used after the next bind() or
+ * after the untracked_object_ptr is destroyed; copies of
+ * it are regular tracked object_ptrs.
+ *
+ * @tparam T The object type of the object_ptr.
+ */
+template < class T >
+class untracked_object_ptr
+{
+public:
+  untracked_object_ptr() {}
+  ~untracked_object_ptr()
+  {
+    release();
+  }
+
+  /**
+   * Binds the object_ptr to the given object proxy.
+   *
+   * @param proxy The object proxy to bind.
+   * @return The bound object_ptr.
+   */
+  const object_ptr<T>& bind(object_proxy *proxy)
+  {
+    optr_.proxy_ = proxy;
+    optr_.id_ = proxy->id;
+    return optr_;
+  }
+
+  /**
+   * Unbinds the object_ptr from its object proxy.
+   */
+  void release()
+  {
+    optr_.proxy_ = 0;
+    optr_.id_ = 0;
+  }
+
+private:
+  untracked_object_ptr(const untracked_object_ptr&);
+  untracked_object_ptr& operator=(const untracked_object_ptr&);
+
+private:
+  object_ptr<T> optr_;
+};
+
+/**
+ * @brief Calls a function for a matching object proxy.
+ *
+ * Calls the function with the object_ptr of the object
+ * proxy if the predicate matches. Always returns false
+ * to let find_proxy_if visit all object proxies. The
+ * object_ptr is rebound for each proxy, so predicate
+ * and function must copy it to keep it.
+ *
+ * @tparam T The object type of the object_ptr.
+ * @tparam Function The type of the function.
+ * @tparam Predicate The type of the predicate.
+ */
+template < class T, class Function, class Predicate >
+struct proxy_caller
+{
+  proxy_caller(Function &fun, Predicate &p) : f(fun), pred(p) {}
+  bool operator()(object_proxy *proxy)
+  {
+    const object_ptr<T> &optr = optr_.bind(proxy);
+    if (pred(optr)) {
+      f(optr);
+    }
+    return false;
+  }
+  Function &f;
+  Predicate &pred;
+  untracked_object_ptr<T> optr_;
+};
+
+/**
+ * @brief Matches an object proxy with a predicate.
+ *
+ * The predicate is called with an object_ptr rebound
+ * for each proxy (see untracked_object_ptr).
+ *
+ * @tparam T The object type of the object_ptr.
+ * @tparam Predicate The type of the predicate.
+ */
+template < class T, class Predicate >
+struct proxy_matcher
+{
+  explicit proxy_matcher(Predicate &p) : pred(p) {}
+  bool operator()(object_proxy *proxy)
+  {
+    return pred(optr_.bind(proxy));
+  }
+  Predicate &pred;
+  untracked_object_ptr<T> optr_;
+};
+
+/**
+ * @brief A predicate accepting every object.
+ */
+struct proxy_accept_all
+{
+  template < class T >
+  bool operator()(const T&) const { return true; }
+};
+
+/**
+ * Returns the count of objects of a prototype node
+ * and, if skip_siblings is false, of all its children.
+ *
+ * @param node The prototype node.
+ * @param skip_siblings If true only the own objects are counted.
+ * @return The count of objects.
+ */
+inline size_t proxy_count(const prototype_node *node, bool skip_siblings)
+{
+  size_t count = node->count;
+  if (skip_siblings) {
+    return count;
+  }
+  const prototype_node *current = node->next_node();
+  while (current && current->depth > node->depth) {
+    count += current->count;
+    current = current->next_node();
+  }
+  return count;
+}
+
 /**
  * @class object_view_iterator
  * @brief Iterator class for an object_view
@@ -176,7 +355,7 @@ public:
    */
   pointer operator->() const
   {
-    return static_cast<pointer>(current_->obj);
+    return static_cast<pointer>(current_->ostore->lookup_object(current_));
   }
 
   /**
@@ -196,8 +375,8 @@ public:
    */
   value_type optr() const
   {
-    if (current_->obj)
-      return value_type(current_->obj);
+    if (current_->obj || current_->id)
+      return value_type(current_);
     else
       return value_type();
   }
@@ -388,7 +567,7 @@ public:
    */
   pointer operator->() const
   {
-    return static_cast<pointer>(current_->obj);
+    return static_cast<pointer>(current_->ostore->lookup_object(current_));
   }
 
   /**
@@ -407,8 +586,8 @@ public:
    * @return The iterators underlaying node as object_ptr.
    */
   value_type optr() const {
-    if (current_->obj)
-      return value_type(current_->obj);
+    if (current_->obj || current_->id)
+      return value_type(current_);
     else
       return value_type();
   }
@@ -565,7 +744,7 @@ public:
    * @return The size of the generic_view.
    */
   size_t size() const {
-    return std::distance(begin(), end());
+    return proxy_count(node_.get(), skip_siblings_);
   }
   
   /**
@@ -590,7 +769,12 @@ public:
   template < class Predicate >
   const_iterator find_if(Predicate pred) const
   {
-    return std::find_if(begin(), end(), pred);
+    proxy_matcher<object, Predicate> matcher(pred);
+    object_proxy *proxy = find_proxy_if(node_.get(), skip_siblings_, matcher);
+    if (!proxy) {
+      return end();
+    }
+    return const_iterator(node_, proxy, (skip_siblings_ ? node_->op_marker : node_->op_last));
   }
 
   /**
@@ -603,7 +787,53 @@ public:
   template < class Predicate >
   iterator find_if(Predicate pred)
   {
-    return std::find_if(begin(), end(), pred);
+    proxy_matcher<object, Predicate> matcher(pred);
+    object_proxy *proxy = find_proxy_if(node_.get(), skip_siblings_, matcher);
+    if (!proxy) {
+      return end();
+    }
+    return iterator(node_, proxy, (skip_siblings_ ? node_->op_marker : node_->op_last));
+  }
+
+  /**
+   * @brief Calls a function for each object.
+   *
+   * The objects are visited through the contiguous
+   * proxy indices of the prototype nodes. Within one
+   * type the objects are visited in insertion order.
+   *
+   * @tparam Function The type of the function.
+   * @param f The function called with each object_ptr.
+   * @return The function.
+   */
+  template < class Function >
+  Function for_each(Function f) const
+  {
+    proxy_accept_all pred;
+    proxy_caller<object, Function, proxy_accept_all> caller(f, pred);
+    find_proxy_if(node_.get(), skip_siblings_, caller);
+    return f;
+  }
+
+  /**
+   * @brief Calls a function for each object matching a predicate.
+   *
+   * The objects are visited through the contiguous
+   * proxy indices of the prototype nodes. Within one
+   * type the objects are visited in insertion order.
+   *
+   * @tparam Predicate The type for the predicate.
+   * @tparam Function The type of the function.
+   * @param pred The predicate.
+   * @param f The function called with each matching object_ptr.
+   * @return The function.
+   */
+  template < class Predicate, class Function >
+  Function for_each_if(Predicate pred, Function f) const
+  {
+    proxy_caller<object, Function, Predicate> caller(f, pred);
+    find_proxy_if(node_.get(), skip_siblings_, caller);
+    return f;
   }
 
   /**
@@ -750,7 +980,7 @@ public:
    * @return The size of the object_view.
    */
   size_t size() const {
-    return std::distance(begin(), end());
+    return proxy_count(node_.get(), skip_siblings_);
   }
   
   /**
@@ -775,7 +1005,12 @@ public:
   template < class Predicate >
   const_iterator find_if(Predicate pred) const
   {
-    return std::find_if(begin(), end(), pred);
+    proxy_matcher<T, Predicate> matcher(pred);
+    object_proxy *proxy = find_proxy_if(node_.get(), skip_siblings_, matcher);
+    if (!proxy) {
+      return end();
+    }
+    return const_iterator(node_, proxy, (skip_siblings_ ? node_->op_marker : node_->op_last));
   }
 
   /**
@@ -788,7 +1023,53 @@ public:
   template < class Predicate >
   iterator find_if(Predicate pred)
   {
-    return std::find_if(begin(), end(), pred);
+    proxy_matcher<T, Predicate> matcher(pred);
+    object_proxy *proxy = find_proxy_if(node_.get(), skip_siblings_, matcher);
+    if (!proxy) {
+      return end();
+    }
+    return iterator(node_, proxy, (skip_siblings_ ? node_->op_marker : node_->op_last));
+  }
+
+  /**
+   * @brief Calls a function for each object.
+   *
+   * The objects are visited through the contiguous
+   * proxy indices of the prototype nodes. Within one
+   * type the objects are visited in insertion order.
+   *
+   * @tparam Function The type of the function.
+   * @param f The function called with each object_ptr.
+   * @return The function.
+   */
+  template < class Function >
+  Function for_each(Function f) const
+  {
+    proxy_accept_all pred;
+    proxy_caller<T, Function, proxy_accept_all> caller(f, pred);
+    find_proxy_if(node_.get(), skip_siblings_, caller);
+    return f;
+  }
+
+  /**
+   * @brief Calls a function for each object matching a predicate.
+   *
+   * The objects are visited through the contiguous
+   * proxy indices of the prototype nodes. Within one
+   * type the objects are visited in insertion order.
+   *
+   * @tparam Predicate The type for the predicate.
+   * @tparam Function The type of the function.
+   * @param pred The predicate.
+   * @param f The function called with each matching object_ptr.
+   * @return The function.
+   */
+  template < class Predicate, class Function >
+  Function for_each_if(Predicate pred, Function f) const
+  {
+    proxy_caller<T, Function, Predicate> caller(f, pred);
+    find_proxy_if(node_.get(), skip_siblings_, caller);
+    return f;
   }
 
   /**
@@ -798,7 +1079,7 @@ public:
    */
   const prototype_node* node() const
   {
-    return node_;
+    return node_.get();
   }
 
 private:
@@ -35,13 +35,17 @@
 #include <iostream>
 #include <map>
 #include <list>
+#include <vector>
 #include <memory>
 
 namespace oos {
 
 class object_base_producer;
 class object;
+class object_observer;
 struct object_proxy;
+class metric_counter;
+struct prototype_memory;
 
 /**
  * @struct prototype_node
@@ -174,6 +178,38 @@ public:
    */
   void adjust_right_marker(object_proxy *old_proxy, object_proxy *new_proxy);
 
+  /**
+   * @brief Appends an object proxy to the proxy index.
+   *
+   * Appends the object proxy to the contiguous index
+   * of the nodes own object proxies. The position is
+   * stored in the object proxy.
+   *
+   * @param proxy The object proxy to append.
+   */
+  void push_proxy(object_proxy *proxy);
+
+  /**
+   * @brief Removes an object proxy from the proxy index.
+   *
+   * The slot of the object proxy is cleared. Once
+   * half of the slots are cleared the index is
+   * compacted, keeping the order of the proxies.
+   *
+   * @param proxy The object proxy to remove.
+   */
+  void erase_proxy(object_proxy *proxy);
+
+  /**
+   * Prints the node in graphviz layout to the stream.
+   * If memory isn't null the memory usage of the
+   * node is added to the node label.
+   *
+   * @param os The ostream to write to.
+   * @param memory The memory usage of the node or null.
+   */
+  void dump(std::ostream &os, const prototype_memory *memory = 0) const;
+
   /**
    * Prints the node in graphviz layout to the stream.
    * 
@@ -185,6 +221,9 @@ public:
 
   typedef std::pair<prototype_node*, std::string> prototype_field_info_t;    /**< Shortcut for prototype fieldname pair. */
   typedef std::map<std::string, prototype_field_info_t> field_prototype_map_t; /**< Holds the fieldname and the prototype_node. */
+  typedef std::vector<object_proxy*> proxy_vector_t; /**< Shortcut for the proxy index. */
+  typedef std::pair<object_observer*, bool> observer_info_t;  /**< Shortcut for an observer and its subtype flag. */
+  typedef std::list<observer_info_t> observer_list_t;         /**< Shortcut for the list of observers. */
 
   // tree links
   prototype_node *parent; /**< The parent node */
@@ -204,13 +243,46 @@ public:
    */
   field_prototype_map_t relations; /**< Map holding relation information for type. */
 
+  /* observers registered for this prototype,
+   * the flag tells if the observer is also
+   * notified about objects of the subtypes
+   */
+  observer_list_t observers; /**< The observers registered for this type. */
+
   object_proxy *op_first;  /**< The marker of the first list node. */
   object_proxy *op_marker; /**< The marker of the last list node of the own elements. */
   object_proxy *op_last;   /**< The marker of the last list node of all elements. */
+
+  /* contiguous index of all object proxies
+   * of this node in insertion order. removed
+   * proxies leave a null slot until the
+   * index is compacted
+   */
+  proxy_vector_t proxies;  /**< The index of the own object proxies. */
+  unsigned long holes;     /**< The count of null slots in the proxy index. */
   
   unsigned int depth;  /**< The depth of the node inside of the tree. */
   unsigned long count; /**< The total count of elements. */
 
+  /**
+   * Tells if the objects of a node may be
+   * evicted from memory by the object cache.
+   */
+  enum eviction_t {
+    EVICTION_UNKNOWN = 0, /**< Not yet determined. */
+    EVICTION_NEVER,       /**< The objects hold object pointers or containers. */
+    EVICTION_ALLOWED      /**< The objects may be evicted. */
+  };
+  eviction_t eviction;    /**< Tells if the objects may be evicted. */
+  unsigned long evicted;  /**< The count of own objects currently evicted from memory. */
+
+  /* the counters of this prototype in the
+   * metrics registry, looked up on first use
+   */
+  metric_counter *insert_counter; /**< The insert counter or null. */
+  metric_counter *update_counter; /**< The update counter or null. */
+  metric_counter *remove_counter; /**< The remove counter or null. */
+
   std::string type;	   /**< The type name of the object */
   
   bool abstract;       /**< Indicates wether this node holds a producer of an abstract object */
@@ -0,0 +1,146 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <cstddef>
+
+namespace oos {
+
+/**
+ * @class arena
+ * @brief A bump allocator for many small blocks
+ *
+ * The arena hands out memory from large chunks
+ * by advancing a cursor. Single allocations are
+ * never freed, instead all memory of the arena
+ * is released at once with clear() or when the
+ * arena is destroyed. Destructors of objects
+ * placed in the arena are never called, so it
+ * is meant for plain data.
+ */
+class OOS_API arena
+{
+public:
+  typedef std::size_t size_type; /**< Shortcut for the size type. */
+
+  /**
+   * Creates an empty arena. The first chunk
+   * is allocated on the first allocation.
+   *
+   * @param chunk_size The size of a regular chunk.
+   */
+  explicit arena(size_type chunk_size = 1 << 16);
+  ~arena();
+
+  /**
+   * @brief Allocates a block of memory.
+   *
+   * Allocates a block of the given size aligned
+   * to eight bytes. Blocks bigger than a quarter
+   * of the chunk size get a chunk of their own.
+   *
+   * @param size The size of the block.
+   * @return The allocated block.
+   */
+  void* allocate(size_type size)
+  {
+    size = (size + ALIGNMENT - 1) & ~size_type(ALIGNMENT - 1);
+    if (size <= size_type(end_ - cursor_)) {
+      char *ptr = cursor_;
+      cursor_ += size;
+      used_ += size;
+      return ptr;
+    }
+    return allocate_chunk(size);
+  }
+
+  /**
+   * @brief Copies a character sequence.
+   *
+   * Copies the given characters into the arena
+   * and appends a terminating null character.
+   *
+   * @param str The characters to copy.
+   * @param len The number of characters.
+   * @return The copied null terminated string.
+   */
+  const char* copy(const char *str, size_type len);
+
+  /**
+   * Releases all memory blocks at once. The
+   * first chunk is kept for further use.
+   */
+  void clear();
+
+  /**
+   * Returns the number of bytes allocated
+   * from the system.
+   *
+   * @return The number of reserved bytes.
+   */
+  size_type capacity() const;
+
+  /**
+   * Returns the number of bytes handed out
+   * to callers.
+   *
+   * @return The number of used bytes.
+   */
+  size_type size() const;
+
+private:
+  // copying not permitted
+  arena(const arena&);
+  arena& operator=(const arena&);
+
+  void* allocate_chunk(size_type size);
+
+private:
+  enum { ALIGNMENT = 8 };
+
+  struct chunk
+  {
+    chunk *next;
+    size_type size;
+  };
+
+  size_type chunk_size_;
+  chunk *chunks_;
+  char *cursor_;
+  char *end_;
+  size_type capacity_;
+  size_type used_;
+};
+
+}
+
+#endif /* ARENA_HPP */
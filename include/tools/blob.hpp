@@ -36,22 +36,31 @@
 namespace oos {
 
 /// @cond OOS_DEV
+/*
+ * A blob stores up to INLINE_SIZE bytes inside
+ * the blob itself. Larger data lives in a reference
+ * counted block which is shared between copies of
+ * the blob and copied on the first modification
+ * (copy-on-write). Copying a blob never copies
+ * large payloads.
+ */
 class OOS_API blob
 {
 public:
   typedef unsigned int size_type;
-  enum { CHUNK_SIZE = 1024 };
+  enum { INLINE_SIZE = 24 };
 
 public:
   blob();
+  blob(const char *data, size_type size);
+  blob(const blob &x);
+  blob& operator=(const blob &x);
   ~blob();
   
   /**
    * @brief Assign data to blob.
    * 
-   * Assign data to blob. If data is to
-   * big for blob it isn't assigned and
-   * false is returned. Current data is
+   * Assign data to blob. Current data is
    * cleared.
    * 
    * @tparam T The type of the data.
@@ -61,19 +70,14 @@ public:
   template < typename T >
   bool assign(const T &val)
   {
-    delete [] data_;
-    data_ = new char[sizeof(T)];
-    memcpy(data_, &val, sizeof(T));
-    size_ = sizeof(T);
-    return false;
+    assign(reinterpret_cast<const char*>(&val), sizeof(T));
+    return true;
   }
 
   /**
    * @brief Append data to blob.
    * 
-   * Append data to blob. If data is to
-   * big for blob it isn't appended and
-   * false is returned.
+   * Append data to blob.
    * 
    * @tparam T The type of the data.
    * @param val The value to append.
@@ -82,20 +86,71 @@ public:
   template < typename T >
   bool append(const T &val)
   {
-    if (sizeof(T) > size_) {
-      return false;
-    }
-    return false;
+    append(reinterpret_cast<const char*>(&val), sizeof(T));
+    return true;
   }
 
+  void assign(const char *data, size_type size);
+
+  void append(const char *data, size_type size);
+
+  void reserve(size_type capacity);
+
+  /*
+   * Sets the size of the blob. New bytes
+   * are uninitialized and must be written
+   * via mutable_data().
+   */
+  void resize(size_type size);
+
+  void clear();
+
+  bool empty() const;
+
   size_type size() const;
 
   size_type capacity() const;
 
   const char* data() const;
 
+  /*
+   * Returns the writable data of the blob.
+   * Shared data is copied first.
+   */
+  char* mutable_data();
+
+  /*
+   * Returns the number of blobs sharing
+   * the data (1 for inline or unshared data).
+   */
+  long use_count() const;
+
+  bool operator==(const blob &x) const;
+
+  bool operator!=(const blob &x) const;
+
+private:
+  struct block
+  {
+    volatile long refcount;
+    size_type capacity;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  bool is_inline() const;
+  char* bytes();
+  void grow(size_type capacity);
+  void detach();
+  void release();
+
+  static block* allocate(size_type capacity);
+
 private:
-  char *data_;
+  union {
+    char inline_[INLINE_SIZE];
+    block *block_;
+  };
   size_type size_;
   size_type capacity_;
 };
@@ -0,0 +1,288 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+#include <cstddef>
+
+namespace oos {
+
+/**
+ * @class bounded_queue
+ * @brief A bounded lock-free queue
+ * @tparam T The type of the queued values.
+ *
+ * The bounded_queue is a fixed size ring buffer
+ * which can be used by several producer and
+ * consumer threads at the same time without
+ * any lock. Each slot of the ring carries a
+ * sequence number telling producers and consumers
+ * whether the slot is free or filled for their
+ * current position.
+ *
+ * The capacity is rounded up to the next power
+ * of two. The value type must be default
+ * constructible and assignable.
+ */
+template < class T >
+class bounded_queue
+{
+public:
+  typedef T value_type;           /**< Shortcut for the value type. */
+  typedef std::size_t size_type;  /**< Shortcut for the size type. */
+
+  /**
+   * Creates a bounded_queue which can hold
+   * at least capacity values.
+   *
+   * @param capacity The minimum capacity of the queue.
+   */
+  explicit bounded_queue(size_type capacity)
+    : buffer_(0)
+    , mask_(0)
+    , enqueue_pos_(0)
+    , dequeue_pos_(0)
+  {
+    size_type size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    buffer_ = new cell[size];
+    mask_ = size - 1;
+    for (size_type i = 0; i < size; ++i) {
+      buffer_[i].sequence = i;
+    }
+  }
+
+  ~bounded_queue()
+  {
+    delete [] buffer_;
+  }
+
+  /**
+   * @brief Appends a value to the queue.
+   *
+   * Appends the given value if the queue
+   * isn't full. May be called from several
+   * threads at the same time.
+   *
+   * @param value The value to append.
+   * @return False if the queue is full.
+   */
+  bool try_push(const value_type &value)
+  {
+    cell *c = 0;
+    size_type pos = load(&enqueue_pos_);
+    for (;;) {
+      c = &buffer_[pos & mask_];
+      size_type seq = load(&c->sequence);
+      std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (dif == 0) {
+        // slot is free, try to claim it
+        if (compare_and_swap(&enqueue_pos_, pos, pos + 1)) {
+          break;
+        }
+      } else if (dif < 0) {
+        // slot is still filled, queue is full
+        return false;
+      }
+      pos = load(&enqueue_pos_);
+    }
+    c->value = value;
+    store(&c->sequence, pos + 1);
+    return true;
+  }
+
+  /**
+   * @brief Appends a value to the queue.
+   *
+   * Appends the given value and waits
+   * while the queue is full.
+   *
+   * @param value The value to append.
+   */
+  void push(const value_type &value)
+  {
+    while (!try_push(value)) {
+      yield();
+    }
+  }
+
+  /**
+   * @brief Takes the first value of the queue.
+   *
+   * Takes the first value if the queue isn't
+   * empty. May be called from several threads
+   * at the same time.
+   *
+   * @param value The value taken from the queue.
+   * @return False if the queue is empty.
+   */
+  bool try_pop(value_type &value)
+  {
+    cell *c = 0;
+    size_type pos = load(&dequeue_pos_);
+    for (;;) {
+      c = &buffer_[pos & mask_];
+      size_type seq = load(&c->sequence);
+      std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+      if (dif == 0) {
+        // slot is filled, try to claim it
+        if (compare_and_swap(&dequeue_pos_, pos, pos + 1)) {
+          break;
+        }
+      } else if (dif < 0) {
+        // slot isn't filled yet, queue is empty
+        return false;
+      }
+      pos = load(&dequeue_pos_);
+    }
+    value = c->value;
+    // release resources held by the slot
+    c->value = value_type();
+    store(&c->sequence, pos + mask_ + 1);
+    return true;
+  }
+
+  /**
+   * @brief Takes the first value of the queue.
+   *
+   * Takes the first value and waits
+   * while the queue is empty.
+   *
+   * @param value The value taken from the queue.
+   */
+  void pop(value_type &value)
+  {
+    while (!try_pop(value)) {
+      yield();
+    }
+  }
+
+  /**
+   * Returns the capacity of the queue.
+   *
+   * @return The capacity of the queue.
+   */
+  size_type capacity() const
+  {
+    return mask_ + 1;
+  }
+
+  /**
+   * Returns the number of queued values. While
+   * other threads use the queue the returned
+   * size is just a snapshot.
+   *
+   * @return The number of queued values.
+   */
+  size_type size() const
+  {
+    size_type first = load(&dequeue_pos_);
+    size_type last = load(&enqueue_pos_);
+    return (last > first ? last - first : 0);
+  }
+
+  /**
+   * Returns true if the queue is empty. While
+   * other threads use the queue the result
+   * is just a snapshot.
+   *
+   * @return True if the queue is empty.
+   */
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  /**
+   * Gives up the time slice of the
+   * calling thread.
+   */
+  static void yield()
+  {
+#ifdef WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+  }
+
+private:
+  // copying not permitted
+  bounded_queue(const bounded_queue&);
+  bounded_queue& operator=(const bounded_queue&);
+
+  static size_type load(const volatile size_type *ptr)
+  {
+#ifdef WIN32
+    size_type value = *ptr;
+    MemoryBarrier();
+    return value;
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+  }
+
+  static void store(volatile size_type *ptr, size_type value)
+  {
+#ifdef WIN32
+    MemoryBarrier();
+    *ptr = value;
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+  }
+
+  static bool compare_and_swap(volatile size_type *ptr, size_type expected, size_type desired)
+  {
+#ifdef WIN32
+    return InterlockedCompareExchangePointer((PVOID volatile*)ptr, (PVOID)desired, (PVOID)expected) == (PVOID)expected;
+#else
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+  }
+
+private:
+  enum { CACHE_LINE_SIZE = 64 };
+
+  struct cell
+  {
+    volatile size_type sequence;
+    value_type value;
+  };
+
+  cell *buffer_;
+  size_type mask_;
+  // keep producer and consumer positions on separate cache lines
+  char pad0_[CACHE_LINE_SIZE];
+  volatile size_type enqueue_pos_;
+  char pad1_[CACHE_LINE_SIZE];
+  volatile size_type dequeue_pos_;
+  char pad2_[CACHE_LINE_SIZE];
+};
+
+}
+
+#endif /* BOUNDED_QUEUE_HPP */
@@ -41,9 +41,11 @@
 #endif
 
 #include <cstdlib>
+#include <cstddef>
 #include <iostream>
 #include <typeinfo>
 #include <cstring>
+#include <limits>
 
 /**
  * @file convert.hpp
@@ -59,6 +61,67 @@ namespace oos {
 
 class varchar_base;
 
+/// @cond OOS_DEV
+
+/*
+ * Locale independent number conversion core used
+ * by the convert functions. The functions never
+ * allocate memory; they write into or read from
+ * caller supplied buffers.
+ */
+
+/*
+ * Size of a character buffer which holds every
+ * integer and every shortest double representation.
+ */
+enum { CONVERT_NUMBER_BUFFER_SIZE = 32 };
+
+/*
+ * Writes the decimal representation of value to buf
+ * (of at least CONVERT_NUMBER_BUFFER_SIZE characters)
+ * and returns the number of written characters. The
+ * result isn't null terminated.
+ */
+OOS_API std::size_t format_integer(long long value, char *buf);
+OOS_API std::size_t format_unsigned(unsigned long long value, char *buf);
+
+/*
+ * Writes value with precision decimal places (like
+ * "%.*f" in the C locale) to buf of the given size. A
+ * negative precision writes the shortest representation
+ * which converts back to the same double. Returns the
+ * number of characters without the terminating null or
+ * size if the result doesn't fit into buf.
+ */
+OOS_API std::size_t format_double(double value, int precision, char *buf, std::size_t size);
+
+/*
+ * Parses the number at the beginning of str. Leading
+ * whitespace and a sign are skipped, the number ends
+ * at the first character which doesn't belong to it.
+ * Returns false if str doesn't start with a number or
+ * the number is out of range.
+ */
+OOS_API bool parse_integer(const char *str, long long &value);
+OOS_API bool parse_unsigned(const char *str, unsigned long long &value);
+OOS_API bool parse_double(const char *str, double &value);
+
+/*
+ * Copies the first len characters of str and a
+ * terminating null to buf of the given size. Throws
+ * std::bad_cast if the result doesn't fit.
+ */
+inline void copy_converted(const char *str, std::size_t len, char *to, std::size_t size)
+{
+  if (len >= size) {
+    throw std::bad_cast();
+  }
+  memcpy(to, str, len);
+  to[len] = '\0';
+}
+
+/// @endcond
+
 #ifdef OOS_DOXYGEN_DOC
 
 /**
@@ -434,11 +497,11 @@ void
 convert(bool from, char *to, S size,
         typename oos::enable_if<std::is_integral<S>::value>::type* = 0)
 {
-#ifdef WIN32
-  _snprintf_s(to, size, size, (from ? "true" : "false"));
-#else
-  snprintf(to, size, (from ? "true" : "false"));
-#endif
+  if (from) {
+    copy_converted("true", 4, to, size);
+  } else {
+    copy_converted("false", 5, to, size);
+  }
 }
 
 /*
@@ -456,11 +519,8 @@ convert(const T &from, char *to, S size,
         typename oos::enable_if<!std::is_same<T, unsigned char>::value >::type* = 0,
         typename oos::enable_if<std::is_integral<S>::value>::type* = 0)
 {
-#ifdef WIN32
-  _snprintf_s(to, size, size, "%d", from);
-#else
-  snprintf(to, size, "%lu", (long unsigned int)from);
-#endif
+  char buf[CONVERT_NUMBER_BUFFER_SIZE];
+  copy_converted(buf, format_unsigned(from, buf), to, size);
 }
 /*
  * from
@@ -475,11 +535,8 @@ convert(const T &from, char *to, S size,
                                 std::is_same<T, unsigned char>::value>::type* = 0,
         typename oos::enable_if<std::is_integral<S>::value>::type* = 0)
 {
-#ifdef WIN32
-  _snprintf_s(to, size, size, "%c", from);
-#else
-  snprintf(to, size, "%c", from);
-#endif
+  char c = static_cast<char>(from);
+  copy_converted(&c, 1, to, size);
 }
 template < class T, class S >
 void
@@ -490,11 +547,8 @@ convert(const T &from, char *to, S size,
         typename oos::enable_if<!std::is_same<T, char>::value >::type* = 0,
         typename oos::enable_if<std::is_integral<S>::value>::type* = 0)
 {
-#ifdef WIN32
-  _snprintf_s(to, size, size, "%d", from);
-#else
-  snprintf(to, size, "%ld", (long unsigned int)from);
-#endif
+  char buf[CONVERT_NUMBER_BUFFER_SIZE];
+  copy_converted(buf, format_integer(from, buf), to, size);
 }
 
 /*
@@ -510,14 +564,9 @@ convert(const T &from, char *to, S size, P precision,
         typename oos::enable_if<std::is_integral<S>::value>::type* = 0,
         typename oos::enable_if<std::is_integral<P>::value>::type* = 0)
 {
-  char buf[32];
-#ifdef WIN32
-  _snprintf_s(buf, 32, 32, "%%0.%df", precision);
-  _snprintf_s(to, size, size, buf, from);
-#else
-  snprintf(buf, 32, "%%0.%df", precision);
-  snprintf(to, size, buf, from);
-#endif
+  if (format_double(from, precision, to, size) >= (std::size_t)size) {
+    throw std::bad_cast();
+  }
 }
 
 /*
@@ -540,15 +589,7 @@ void
 convert(const char *from, char *to, S size,
         typename oos::enable_if<std::is_integral<S>::value>::type* = 0)
 {
-  if (strlen(from) < (size_t)size) {
-#ifdef WIN32
-    strcpy_s(to, size, from);
-#else
-    strcpy(to, from);
-#endif
-  } else {
-    throw std::bad_cast();
-  }
+  copy_converted(from, strlen(from), to, size);
 }
 
 /*
@@ -566,8 +607,11 @@ convert(const T &from, U &to, P precision,
         typename oos::enable_if<std::is_integral<P>::value>::type* = 0)
 {
   char buf[256];
-  convert(from, buf, 256, precision);
-  to.assign(buf);
+  std::size_t len = format_double(from, precision, buf, sizeof(buf));
+  if (len >= sizeof(buf)) {
+    throw std::bad_cast();
+  }
+  to.assign(buf, len);
 }
 
 /*
@@ -583,9 +627,17 @@ convert(const T &from, U &to,
                                 std::is_base_of<varchar_base, U>::value>::type* = 0,
         typename oos::enable_if<std::is_integral<T>::value>::type* = 0)
 {
-  char buf[256];
-  convert(from, buf, 256);
-  to.assign(buf);
+  char buf[CONVERT_NUMBER_BUFFER_SIZE];
+  if (std::is_same<T, char>::value || std::is_same<T, unsigned char>::value) {
+    buf[0] = static_cast<char>(from);
+    to.assign(buf, 1);
+  } else if (std::is_same<T, bool>::value) {
+    to.assign(from ? "true" : "false");
+  } else if (std::is_signed<T>::value) {
+    to.assign(buf, format_integer(static_cast<long long>(from), buf));
+  } else {
+    to.assign(buf, format_unsigned(static_cast<unsigned long long>(from), buf));
+  }
 }
 template < class T, class U >
 void
@@ -609,11 +661,13 @@ convert(const char *from, T &to,
         typename oos::enable_if<(std::is_integral<T>::value &&
                                  std::is_signed<T>::value)>::type* = 0)
 {
-  char *ptr;
-  to = static_cast<T>(strtol(from, &ptr, 10));
-  if (errno == ERANGE || (to == 0 && ptr == from)) {
+  long long value = 0;
+  if (!parse_integer(from, value) ||
+      value < static_cast<long long>(std::numeric_limits<T>::min()) ||
+      value > static_cast<long long>(std::numeric_limits<T>::max())) {
     throw std::bad_cast();
   }
+  to = static_cast<T>(value);
 }
 /*
  * from
@@ -628,11 +682,12 @@ convert(const char *from, T &to,
                                  std::is_unsigned<T>::value &&
                                  !std::is_same<T, bool>::value)>::type* = 0)
 {
-  char *ptr;
-  to = static_cast<T>(strtoul(from, &ptr, 10));
-  if (errno == ERANGE || (to == 0 && ptr == from)) {
+  unsigned long long value = 0;
+  if (!parse_unsigned(from, value) ||
+      value > static_cast<unsigned long long>(std::numeric_limits<T>::max())) {
     throw std::bad_cast();
   }
+  to = static_cast<T>(value);
 }
 /*
  * from
@@ -645,11 +700,13 @@ void
 convert(const char *from, T &to,
         typename oos::enable_if<std::is_floating_point<T>::value>::type* = 0)
 {
-  char *ptr;
-  to = static_cast<T>(strtod(from, &ptr));
-  if (errno == ERANGE || (to == 0 && ptr == from)) {
+  double value = 0;
+  if (!parse_double(from, value) ||
+      (value > std::numeric_limits<T>::max() && value <= std::numeric_limits<double>::max()) ||
+      (value < -std::numeric_limits<T>::max() && value >= -std::numeric_limits<double>::max())) {
     throw std::bad_cast();
   }
+  to = static_cast<T>(value);
 }
 /*
  * from
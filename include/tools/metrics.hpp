@@ -0,0 +1,483 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include "tools/singleton.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+#include <cstddef>
+
+namespace oos {
+
+/// @cond OOS_DEV
+
+enum {
+  METRIC_SHARDS = 16,     // number of per thread slots of a metric
+  METRIC_BUCKETS = 64,    // number of power of two histogram buckets
+  METRIC_CACHE_LINE = 64
+};
+
+/*
+ * Returns the shard of the calling thread. Each
+ * thread gets its own shard on the first call,
+ * threads share a shard when there are more
+ * threads than shards.
+ */
+OOS_API unsigned metric_shard();
+
+/// @endcond
+
+/**
+ * @class metric_counter
+ * @brief A counter sharded by thread
+ *
+ * Each thread adds to its own cache line so
+ * threads counting the same event don't
+ * contend. The value is the sum of all
+ * shards. Counters are created and owned
+ * by the metrics registry.
+ */
+class OOS_API metric_counter
+{
+public:
+  typedef long long value_type; /**< Shortcut for the value type. */
+
+  /**
+   * Adds the given value to the counter.
+   *
+   * @param n The value to add.
+   */
+  void add(value_type n = 1);
+
+  /**
+   * Returns the sum of all shards.
+   *
+   * @return The value of the counter.
+   */
+  value_type value() const;
+
+  /**
+   * Sets the counter to zero.
+   */
+  void reset();
+
+  /**
+   * Returns the name of the counter.
+   *
+   * @return The name of the counter.
+   */
+  const std::string& name() const;
+
+  /**
+   * Returns the type the counter is kept
+   * for or an empty string.
+   *
+   * @return The type of the counter.
+   */
+  const std::string& type() const;
+
+private:
+  friend class metrics;
+
+  metric_counter(const std::string &name, const std::string &type);
+
+  // copying not permitted
+  metric_counter(const metric_counter&);
+  metric_counter& operator=(const metric_counter&);
+
+private:
+  struct shard
+  {
+    volatile value_type value;
+    char pad[METRIC_CACHE_LINE - sizeof(value_type)];
+  };
+
+  std::string name_;
+  std::string type_;
+  shard shards_[METRIC_SHARDS];
+};
+
+/**
+ * @class metric_histogram
+ * @brief A histogram sharded by thread
+ *
+ * The histogram counts values in buckets
+ * of powers of two. Bucket zero holds the
+ * zero values, bucket i holds the values
+ * from 2^(i-1) to 2^i - 1. Like the counter
+ * each thread writes to its own shard.
+ */
+class OOS_API metric_histogram
+{
+public:
+  typedef unsigned long long value_type; /**< Shortcut for the value type. */
+
+  /**
+   * Adds a value to the histogram.
+   *
+   * @param v The value to add.
+   */
+  void observe(value_type v);
+
+  /**
+   * Sets all buckets to zero.
+   */
+  void reset();
+
+  /**
+   * Returns the name of the histogram.
+   *
+   * @return The name of the histogram.
+   */
+  const std::string& name() const;
+
+  /**
+   * Returns the type the histogram is kept
+   * for or an empty string.
+   *
+   * @return The type of the histogram.
+   */
+  const std::string& type() const;
+
+  /**
+   * Returns the bucket of a value.
+   *
+   * @param v The value.
+   * @return The bucket of the value.
+   */
+  static unsigned bucket(value_type v);
+
+private:
+  friend class metrics;
+
+  metric_histogram(const std::string &name, const std::string &type);
+
+  // copying not permitted
+  metric_histogram(const metric_histogram&);
+  metric_histogram& operator=(const metric_histogram&);
+
+private:
+  struct shard
+  {
+    volatile value_type buckets[METRIC_BUCKETS];
+    volatile value_type sum;
+    char pad[METRIC_CACHE_LINE - sizeof(value_type)];
+  };
+
+  std::string name_;
+  std::string type_;
+  shard shards_[METRIC_SHARDS];
+};
+
+/**
+ * @struct metric_value
+ * @brief The value of a counter or gauge in a snapshot
+ */
+struct OOS_API metric_value
+{
+  metric_value() : value(0) {}
+
+  std::string name;   /**< The name of the metric. */
+  std::string type;   /**< The type the metric is kept for or empty. */
+  long long value;    /**< The value of the metric. */
+};
+
+/**
+ * @struct metric_distribution
+ * @brief The buckets of a histogram in a snapshot
+ */
+struct OOS_API metric_distribution
+{
+  metric_distribution() : count(0), sum(0) {}
+
+  /**
+   * Returns the largest value counted
+   * by the given bucket.
+   *
+   * @param bucket The bucket.
+   * @return The upper bound of the bucket.
+   */
+  static unsigned long long upper_bound(std::size_t bucket);
+
+  /**
+   * Returns the upper bound of the bucket
+   * holding the given quantile.
+   *
+   * @param q The quantile between 0 and 1.
+   * @return The estimated quantile.
+   */
+  unsigned long long quantile(double q) const;
+
+  std::string name;                          /**< The name of the histogram. */
+  std::string type;                          /**< The type the histogram is kept for or empty. */
+  unsigned long long count;                  /**< The number of values. */
+  unsigned long long sum;                    /**< The sum of all values. */
+  std::vector<unsigned long long> buckets;   /**< The count of each bucket. */
+};
+
+/**
+ * @class metrics_snapshot
+ * @brief The values of all metrics at one point in time
+ *
+ * A snapshot holds the counters and histograms
+ * of the registry and the gauges reported by the
+ * metric sources. Gauges with the same name and
+ * type reported by several sources are summed up.
+ *
+ * The snapshot can be written as plain text with
+ * one line per value or as json.
+ */
+class OOS_API metrics_snapshot
+{
+public:
+  typedef std::vector<metric_value> t_value_vector;               /**< Shortcut to the value vector. */
+  typedef std::vector<metric_distribution> t_distribution_vector; /**< Shortcut to the distribution vector. */
+
+  /**
+   * Adds a value to a gauge. The
+   * gauge is created if necessary.
+   *
+   * @param name The name of the gauge.
+   * @param type The type of the gauge or empty.
+   * @param value The value to add.
+   */
+  void gauge(const std::string &name, const std::string &type, long long value);
+
+  /**
+   * Returns the counter with the given
+   * name and type or null.
+   *
+   * @param name The name of the counter.
+   * @param type The type of the counter.
+   * @return The counter or null.
+   */
+  const metric_value* find_counter(const std::string &name, const std::string &type = "") const;
+
+  /**
+   * Returns the gauge with the given
+   * name and type or null.
+   *
+   * @param name The name of the gauge.
+   * @param type The type of the gauge.
+   * @return The gauge or null.
+   */
+  const metric_value* find_gauge(const std::string &name, const std::string &type = "") const;
+
+  /**
+   * Returns the histogram with the given
+   * name and type or null.
+   *
+   * @param name The name of the histogram.
+   * @param type The type of the histogram.
+   * @return The histogram or null.
+   */
+  const metric_distribution* find_histogram(const std::string &name, const std::string &type = "") const;
+
+  /**
+   * Writes the snapshot as text. Each value
+   * is written in one line as name, the type
+   * in braces if there is one and the value.
+   * Histograms are written as cumulative
+   * buckets followed by their sum and count.
+   *
+   * @param out The stream to write to.
+   */
+  void write_text(std::ostream &out) const;
+
+  /**
+   * Writes the snapshot as json object
+   * with the arrays counters, gauges and
+   * histograms.
+   *
+   * @param out The stream to write to.
+   */
+  void write_json(std::ostream &out) const;
+
+  t_value_vector counters;             /**< The counters. */
+  t_value_vector gauges;               /**< The gauges. */
+  t_distribution_vector histograms;    /**< The histograms. */
+};
+
+/**
+ * @class metric_source
+ * @brief Reports gauges to a snapshot
+ *
+ * Values which are known anyway, like the
+ * number of objects of a store, aren't counted
+ * but reported by a metric_source when a
+ * snapshot is taken.
+ */
+class OOS_API metric_source
+{
+public:
+  virtual ~metric_source() {}
+
+  /**
+   * Adds the gauges of the source
+   * to the snapshot.
+   *
+   * @param snapshot The snapshot to add to.
+   */
+  virtual void collect(metrics_snapshot &snapshot) const = 0;
+};
+
+/**
+ * @class metrics
+ * @brief The registry of all metrics
+ *
+ * The metrics registry creates and holds all
+ * counters and histograms. A metric is identified
+ * by its name and an optional type, i.e. the
+ * prototype a counter is kept for. Metrics live
+ * as long as the registry, callers may keep
+ * references to them.
+ *
+ * Metrics are disabled by default. All counting
+ * code first checks enabled(), so disabled
+ * metrics cost one load and branch.
+ *
+ * Snapshots read the shards while other threads
+ * may still write to them, so the values of a
+ * snapshot taken under load aren't exactly
+ * consistent with each other.
+ */
+class OOS_API metrics : public singleton<metrics>
+{
+private:
+  friend class singleton<metrics>;
+
+  metrics();
+
+public:
+  virtual ~metrics();
+
+  /**
+   * Returns true if metrics are enabled.
+   *
+   * @return True if metrics are enabled.
+   */
+  static bool enabled()
+  {
+    return enabled_ != 0;
+  }
+
+  /**
+   * Enables or disables all metrics.
+   *
+   * @param on True to enable the metrics.
+   */
+  static void enable(bool on = true);
+
+  /**
+   * Returns the counter with the given name
+   * and type. The counter is created if
+   * necessary.
+   *
+   * @param name The name of the counter.
+   * @param type The type of the counter or empty.
+   * @return The counter.
+   */
+  metric_counter& counter(const std::string &name, const std::string &type = "");
+
+  /**
+   * Returns the histogram with the given name
+   * and type. The histogram is created if
+   * necessary.
+   *
+   * @param name The name of the histogram.
+   * @param type The type of the histogram or empty.
+   * @return The histogram.
+   */
+  metric_histogram& histogram(const std::string &name, const std::string &type = "");
+
+  /**
+   * Registers a source reporting gauges
+   * to each snapshot.
+   *
+   * @param source The source to register.
+   */
+  void register_source(const metric_source *source);
+
+  /**
+   * Unregisters a source. Sources destroyed
+   * after the registry are ignored.
+   *
+   * @param source The source to unregister.
+   */
+  void unregister_source(const metric_source *source);
+
+  /**
+   * Returns the current values of all
+   * metrics and sources.
+   *
+   * @return The snapshot.
+   */
+  metrics_snapshot snapshot() const;
+
+  /**
+   * Sets all counters and histograms to zero.
+   */
+  void reset();
+
+  /**
+   * Returns a monotonic time in nanoseconds
+   * to measure latencies.
+   *
+   * @return The current time in nanoseconds.
+   */
+  static unsigned long long now();
+
+private:
+  void lock() const;
+  void unlock() const;
+
+private:
+  typedef std::pair<std::string, std::string> t_metric_key;
+  typedef std::map<t_metric_key, metric_counter*> t_counter_map;
+  typedef std::map<t_metric_key, metric_histogram*> t_histogram_map;
+  typedef std::vector<const metric_source*> t_source_vector;
+
+  static volatile int enabled_;
+  static volatile int destroyed_;
+
+  t_counter_map counter_map_;
+  t_histogram_map histogram_map_;
+  t_source_vector sources_;
+  mutable volatile int lock_;
+};
+
+}
+
+#endif /* METRICS_HPP */
@@ -33,6 +33,7 @@
 
 #include <string>
 #include <stdexcept>
+#include <cstring>
 
 namespace oos {
 
@@ -47,6 +48,12 @@ public:
 
   varchar_base(const varchar_base &x);
 
+  /*
+   * A varchar_base owning its storage adopts
+   * the capacity of x. A varchar with an inline
+   * buffer keeps its capacity and throws a
+   * std::logic_error if x doesn't fit.
+   */
   varchar_base& operator=(const varchar_base &x);
 
   varchar_base& operator=(const std::string &x);
@@ -69,10 +76,21 @@ public:
 
   void assign(const char *s);
 
+  /*
+   * Sets the size of the string (at most
+   * the capacity). The new characters must
+   * be written via data().
+   */
+  void resize(size_type n);
+
   std::string str() const;
 
   const char* c_str() const;
 
+  char* data();
+
+  const char* data() const;
+
   size_type size() const;
 
   size_type capacity() const;
@@ -80,12 +98,21 @@ public:
   friend OOS_API std::ostream& operator<<(std::ostream &out, const varchar_base &val);
 
 protected:
-  void ok(const std::string &x);
-  void trim();
+  /*
+   * Uses the given buffer of capacity + 1
+   * characters as storage. The buffer must
+   * live as long as the varchar_base.
+   */
+  varchar_base(char *buf, size_type capacity);
+
+  void append(const char *s, size_t n);
+  void ok(size_type n) const;
 
 protected:
+  char *data_;
+  size_type size_;
   size_type capacity_;
-  std::string data_;
+  bool heap_;
 };
 /// @endcond
 
@@ -98,8 +125,11 @@ protected:
  * SQL VARCHAR type in mind. The capacity of
  * the string is given within the template
  * parameter of type unsigned int.
- * The real string is represented internaly
- * by a std::string.
+ * The characters are stored inside the
+ * varchar itself, so a varchar never
+ * allocates memory. Longer strings are
+ * cut at the capacity, assigning a longer
+ * varchar throws a std::logic_error.
  */
 template < unsigned int C >
 class varchar : public varchar_base
@@ -110,7 +140,7 @@ public:
    * with the given capacity
    */
   varchar()
-    : varchar_base(C)
+    : varchar_base(buffer_, C)
   {}
 
   /**
@@ -120,9 +150,9 @@ public:
    * @param x The varchar to copy.
    */
   varchar(const varchar &x)
-    : varchar_base(C)
+    : varchar_base(buffer_, C)
   {
-    data_ = x.data_;
+    assign(x.data_, x.size_);
   }
 
   /**
@@ -132,9 +162,9 @@ public:
    * @param x The string value to set.
    */
   explicit varchar(const std::string &x)
-    : varchar_base(C)
+    : varchar_base(buffer_, C)
   {
-    data_ = x;
+    assign(x.data(), x.size());
   }
 
   /**
@@ -144,9 +174,9 @@ public:
    * @param x The string value to set.
    */
   explicit varchar(const char *x)
-    : varchar_base(C)
+    : varchar_base(buffer_, C)
   {
-    data_.assign(x);
+    assign(x);
   }
 
   /**
@@ -157,9 +187,24 @@ public:
    */
   varchar& operator=(const varchar &x)
   {
-    
-    capacity_ = C;
-    data_ = x.data_;
+    assign(x.data_, x.size_);
+    return *this;
+  }
+
+  /**
+   * Assigns a varchar of another capacity.
+   * The capacity doesn't change. If the string
+   * of x doesn't fit into this varchar a
+   * std::logic_error is thrown and this
+   * varchar is left unchanged.
+   *
+   * @param x The varchar to assign.
+   * @return Returns a reference to this class.
+   * @throws std::logic_error If x is longer than the capacity.
+   */
+  varchar& operator=(const varchar_base &x)
+  {
+    varchar_base::operator=(x);
     return *this;
   }
 
@@ -171,7 +216,7 @@ public:
    */
   varchar& operator=(const std::string &x)
   {
-    data_ = x;
+    assign(x.data(), x.size());
     return *this;
   }
 
@@ -183,9 +228,12 @@ public:
    */
   varchar& operator=(const char *x)
   {
-    varchar_base::operator=(x);
+    assign(x);
     return *this;
   }
+
+private:
+  char buffer_[C + 1];
 };
 
 /**
@@ -199,7 +247,7 @@ public:
 template < unsigned int C1, unsigned int C2 >
 bool operator==(const varchar<C1> &l, const varchar<C2> &r)
 {
-  return l.str() == r.str();
+  return l.varchar_base::operator==(r);
 }
 
 /**
@@ -212,7 +260,7 @@ bool operator==(const varchar<C1> &l, const varchar<C2> &r)
 template < unsigned int C >
 bool operator==(const varchar<C> &l, const char *r)
 {
-  return l.str() == r;
+  return l.size() == strlen(r) && memcmp(l.c_str(), r, l.size()) == 0;
 }
 
 /**
@@ -226,7 +274,7 @@ bool operator==(const varchar<C> &l, const char *r)
 template < unsigned int C1, unsigned int C2 >
 bool operator!=(const varchar<C1> &l, const varchar<C2> &r)
 {
-  return l.str() != r.str();
+  return !l.varchar_base::operator==(r);
 }
 
 /**
@@ -239,7 +287,7 @@ bool operator!=(const varchar<C1> &l, const varchar<C2> &r)
 template < unsigned int C >
 bool operator!=(const varchar<C> &l, const char *r)
 {
-  return l.str() != r;
+  return !(l == r);
 }
 
 }
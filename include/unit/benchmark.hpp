@@ -0,0 +1,180 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#ifdef WIN32
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#ifdef WIN32
+#include <functional>
+#else
+#include <tr1/functional>
+#endif
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @brief Returns the current allocation counters.
+ *
+ * A function of this type may be installed with
+ * test_suite::allocation_hook(). It returns the
+ * number of allocations and the number of allocated
+ * bytes since the start of the program.
+ */
+typedef void (*allocation_hook_func)(unsigned long long &count, unsigned long long &bytes);
+
+/**
+ * @struct benchmark_options
+ * @brief Controls how a benchmark is measured
+ *
+ * The benchmark function is first called with one
+ * iteration which isn't measured, so the benchmark
+ * may set up its data on the first call. Then it is
+ * called with a growing number of iterations until one call
+ * takes at least min_sample_time seconds. The
+ * benchmark then runs for warmup_time seconds
+ * without measuring and finally takes the given
+ * number of samples with the calibrated iterations.
+ */
+struct OOS_API benchmark_options
+{
+  benchmark_options()
+    : samples(30), min_sample_time(0.01), warmup_time(0.05), allocation_hook(0)
+  {}
+
+  unsigned samples;                      /**< The number of measured samples. */
+  double min_sample_time;                /**< The minimum time of a sample in seconds. */
+  double warmup_time;                    /**< The time to run before measuring in seconds. */
+  allocation_hook_func allocation_hook;  /**< The allocation counters or NULL. */
+};
+
+/**
+ * @struct benchmark_result
+ * @brief The statistics of one benchmark
+ *
+ * All times are nanoseconds per iteration. If no
+ * allocation hook was installed the allocation
+ * figures are negative.
+ */
+struct OOS_API benchmark_result
+{
+  benchmark_result()
+    : iterations(0), samples(0)
+    , wall_min(0), wall_median(0), wall_p99(0)
+    , cpu_min(0), cpu_median(0), cpu_p99(0)
+    , allocations(-1), allocated_bytes(-1)
+  {}
+
+  std::string unit;               /**< The name of the unit_test. */
+  std::string name;               /**< The name of the benchmark. */
+  unsigned long long iterations;  /**< The iterations of each sample. */
+  unsigned samples;               /**< The number of samples. */
+  double wall_min;                /**< The fastest wall clock time. */
+  double wall_median;             /**< The median wall clock time. */
+  double wall_p99;                /**< The 99th percentile of the wall clock time. */
+  double cpu_min;                 /**< The fastest cpu time. */
+  double cpu_median;              /**< The median cpu time. */
+  double cpu_p99;                 /**< The 99th percentile of the cpu time. */
+  double allocations;             /**< The allocations per iteration. */
+  double allocated_bytes;         /**< The allocated bytes per iteration. */
+};
+
+/**
+ * Shortcut to a list of benchmark results.
+ */
+typedef std::vector<benchmark_result> t_benchmark_result_vector;
+
+/**
+ * @brief A benchmark function.
+ *
+ * The function must run the measured code
+ * as many times as the given number of
+ * iterations.
+ */
+typedef std::tr1::function<void (unsigned long long)> bench_func;
+
+/**
+ * @brief Measures a benchmark function.
+ *
+ * Calibrates, warms up and measures the given
+ * function as described in benchmark_options.
+ * The returned result carries no unit and name.
+ *
+ * @param func The benchmark function.
+ * @param options The measure options.
+ * @return The statistics of the benchmark.
+ */
+OOS_API benchmark_result measure_benchmark(const bench_func &func, const benchmark_options &options);
+
+/**
+ * @brief Keeps a computed value alive.
+ *
+ * Passing the address of a value computed by a
+ * benchmark prevents the compiler from removing
+ * the computation.
+ *
+ * @param ptr The address of the computed value.
+ */
+OOS_API void benchmark_use(const void *ptr);
+
+/**
+ * Writes the results as a json object with
+ * a benchmarks array.
+ *
+ * @param out The stream to write to.
+ * @param results The results to write.
+ */
+OOS_API void write_benchmark_json(std::ostream &out, const t_benchmark_result_vector &results);
+
+/**
+ * Writes the results as comma separated values
+ * with a header line.
+ *
+ * @param out The stream to write to.
+ * @param results The results to write.
+ */
+OOS_API void write_benchmark_csv(std::ostream &out, const t_benchmark_result_vector &results);
+
+/**
+ * Reads results written by write_benchmark_json()
+ * or write_benchmark_csv() from the given stream.
+ *
+ * @param in The stream to read from.
+ * @param results The read results are appended here.
+ * @return False if the input couldn't be read.
+ */
+OOS_API bool read_benchmark_results(std::istream &in, t_benchmark_result_vector &results);
+
+}
+
+#endif /* BENCHMARK_HPP */
@@ -33,6 +33,8 @@
 
 #include "tools/singleton.hpp"
 
+#include "unit/benchmark.hpp"
+
 #ifdef WIN32
 #include <memory>
 #else
@@ -62,6 +64,22 @@ class unit_test;
  * It can execute all test_units or a specific test_unit.
  * It also provides function listing all test_unit classes
  * and their tests.
+ *
+ * The bench command measures the benchmarks of all
+ * or of specific test_units:
+ *
+ * @code
+ * test_oos bench <all|unit|unit:benchmark> [json|csv] [output <file>]
+ *                [baseline <file>] [threshold <percent>]
+ *                [samples <n>] [min_time <ms>]
+ * @endcode
+ *
+ * With json or csv the results are written in that
+ * format to the output file or to stdout. With a
+ * baseline file (written by an earlier bench command)
+ * the median wall clock times are compared and each
+ * benchmark slower than the threshold (default 10
+ * percent) is reported as regression.
  */
 class OOS_API test_suite : public singleton<test_suite>
 {
@@ -78,13 +96,14 @@ private:
   {
     UNKNOWN = 0, /**<Enum type for an unknown test_suite command. */
     LIST,        /**<Enum type for the list command. */
-    EXECUTE      /**<Enum type for the execute command. */
+    EXECUTE,     /**<Enum type for the execute command. */
+    BENCHMARK    /**<Enum type for the bench command. */
   } test_suite_cmd;
 
   typedef struct test_suite_args_struct
   {
     test_suite_args_struct()
-      : cmd(UNKNOWN), initialized(false), brief(false), cmake(false)
+      : cmd(UNKNOWN), initialized(false), brief(false), cmake(false), threshold(10.0)
     {}
     test_suite_cmd cmd;
     bool initialized;
@@ -92,6 +111,11 @@ private:
     bool cmake;
     std::string unit;
     std::string test;
+    std::string format;
+    std::string output;
+    std::string baseline;
+    double threshold;
+    benchmark_options options;
   } test_suite_args;
 
   test_suite();
@@ -139,13 +163,25 @@ public:
    */
   void register_unit(unit_test *utest);
 
+  /**
+   * @brief Installs an allocation hook.
+   *
+   * If set the bench command reports the allocations
+   * per iteration of each benchmark.
+   *
+   * @param hook The function returning the allocation counters.
+   */
+  void allocation_hook(allocation_hook_func hook);
+
   /**
    * @brief Executes the test_suite.
    *
    * Executes all test unit classes or the
    * command given via init.
+   *
+   * @return False if a benchmark is slower than its baseline.
    */
-  void run();
+  bool run();
 
   /**
    * @brief Executes a specific test_unit.
@@ -171,6 +207,10 @@ public:
    */
   void run(const std::string &unit, const std::string &test);
 
+private:
+  bool benchmark();
+  bool compare(const t_benchmark_result_vector &results, std::ostream &out) const;
+
 private:
   test_suite_args args_;
   t_unit_test_map unit_test_map_;
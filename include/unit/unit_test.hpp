@@ -40,6 +40,7 @@
 #endif /* OOS_DOXYGEN_DOC */
 
 #include "unit/unit_exception.hpp"
+#include "unit/benchmark.hpp"
 
 #include "tools/enable_if.hpp"
 
@@ -288,6 +289,37 @@ public:
    */
   void add_test(const std::string &name, const test_func &test, const std::string &caption);
 
+  /**
+   * @brief Adds a benchmark to the test_unit.
+   *
+   * This method adds a new benchmark function
+   * identified by the given name to the test_unit.
+   * Benchmarks aren't executed with the tests,
+   * they are measured with the bench command of
+   * the test_suite. The function is called with
+   * the number of iterations to run.
+   *
+   * @param name unique name of the benchmark to store.
+   * @param bench The benchmark function object.
+   * @param caption A short description of the benchmark.
+   */
+  void add_benchmark(const std::string &name, const bench_func &bench, const std::string &caption);
+
+  /**
+   * @brief Measures the benchmarks.
+   *
+   * Measures the benchmark with the given name or
+   * all benchmarks of the test_unit if the name is
+   * empty. The result of each benchmark is appended
+   * to the given result vector.
+   *
+   * @param name The name of the benchmark or an empty string.
+   * @param options The measure options.
+   * @param results The vector receiving the results.
+   * @param out The stream receiving the progress.
+   */
+  void benchmark(const std::string &name, const benchmark_options &options, t_benchmark_result_vector &results, std::ostream &out);
+
   /**
    * @brief Checks if a is equal b.
    *
@@ -582,8 +614,18 @@ private:
     std::string message;
   } test_func_info;
 
+  typedef struct bench_func_info_struct
+  {
+    bench_func_info_struct(const bench_func &f, const std::string &c)
+      : func(f), caption(c)
+    {}
+    bench_func func;
+    std::string caption;
+  } bench_func_info;
+
 private:
   void execute(test_func_info &test_info);
+  void benchmark(const std::string &name, bench_func_info &bench_info, const benchmark_options &options, t_benchmark_result_vector &results, std::ostream &out);
 
 private:
   std::string name_;
@@ -591,6 +633,9 @@ private:
 
   typedef std::map<std::string, test_func_info> t_test_func_info_map;
   t_test_func_info_map test_func_info_map_;
+
+  typedef std::map<std::string, bench_func_info> t_bench_func_info_map;
+  t_bench_func_info_map bench_func_info_map_;
 };
 
 }
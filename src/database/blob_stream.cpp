@@ -0,0 +1,57 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "database/blob_stream.hpp"
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace oos {
+
+blob_stream::~blob_stream()
+{}
+
+blob_stream::size_type blob_stream::read(std::ostream &out)
+{
+  std::vector<char> chunk(CHUNK_SIZE);
+  size_type count = 0;
+  size_type n = 0;
+  while ((n = read(&chunk[0], chunk.size())) > 0) {
+    out.write(&chunk[0], n);
+    count += n;
+  }
+  return count;
+}
+
+blob_stream::size_type blob_stream::write(std::istream &in)
+{
+  std::vector<char> chunk(CHUNK_SIZE);
+  size_type count = 0;
+  while (in) {
+    in.read(&chunk[0], chunk.size());
+    size_type n = static_cast<size_type>(in.gcount());
+    if (n == 0) {
+      break;
+    }
+    write(&chunk[0], n);
+    count += n;
+  }
+  return count;
+}
+
+}
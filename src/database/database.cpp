@@ -21,12 +21,16 @@
 #include "database/database_sequencer.hpp"
 #include "database/transaction.hpp"
 #include "database/statement.hpp"
+#include "database/result.hpp"
+#include "database/sql_tracer.hpp"
 #include "database/table.hpp"
 #include "database/action.hpp"
 
 #include "object/object_store.hpp"
 #include "object/prototype_node.hpp"
 
+#include "tools/metrics.hpp"
+
 #include <stdexcept>
 
 namespace oos {
@@ -142,6 +146,19 @@ void database::load(const prototype_node &node)
   i->second->load(db_->ostore());
 }
 
+object* database::load(const prototype_node &node, long id)
+{
+  table_map_t::iterator i = table_map_.find(node.type);
+  if (i == table_map_.end()) {
+    // create table
+    table_ptr tbl(new table(*this, node));
+    
+    i = table_map_.insert(std::make_pair(node.type, tbl)).first;
+  }
+  
+  return i->second->load(db_->ostore(), id);
+}
+
 bool database::is_loaded(const std::string &name) const
 {
 #ifdef WIN32
@@ -158,8 +175,37 @@ bool database::is_loaded(const std::string &name) const
 
 result* database::execute(const std::string &sql)
 {
+  if (metrics::enabled()) {
+    static metric_counter &executes = metrics::instance().counter("database_executes");
+    executes.add();
+  }
 //  std::cout << sql << "\n";
-  return on_execute(sql);
+  sql_tracer *tracer = sql_tracer::installed();
+  if (!tracer) {
+    return on_execute(sql);
+  }
+  unsigned long long start = metrics::now();
+  result *res = on_execute(sql);
+  sql_trace_event event;
+  event.phase = sql_trace_event::TRACE_EXECUTE;
+  event.sql = sql.c_str();
+  event.rows = (res ? res->affected_rows() : 0);
+  event.duration = metrics::now() - start;
+  tracer->trace(event);
+  if (res) {
+    res->trace(sql, 0);
+  }
+  return res;
+}
+
+blob_stream* database::open_blob(const std::string &, const std::string &, long)
+{
+  throw database_exception("database", "incremental blob i/o isn't supported");
+}
+
+blob_stream* database::create_blob(const std::string &, const std::string &, long, blob_stream::size_type)
+{
+  throw database_exception("database", "incremental blob i/o isn't supported");
 }
 
 void database::drop()
@@ -195,6 +241,11 @@ void database::begin()
 
 void database::commit()
 {
+  for (table_map_t::iterator i = table_map_.begin(); i != table_map_.end(); ++i) {
+    i->second->flush_updates();
+    i->second->flush_removes();
+  }
+
   // write sequence to db
   sequencer_->commit();
 
@@ -205,6 +256,11 @@ void database::commit()
 
 void database::rollback()
 {
+  for (table_map_t::iterator i = table_map_.begin(); i != table_map_.end(); ++i) {
+    i->second->discard_updates();
+    i->second->discard_removes();
+  }
+
   sequencer_->rollback();
 
   if (commiting_) {
@@ -249,7 +305,9 @@ void database::visit(update_action *a)
     throw database_exception("db", "table not found");
   }
 
-  i->second->update(a->obj());
+  // written at commit together with all other
+  // updated objects of the table
+  i->second->queue_update(a->obj());
 }
 
 void database::visit(delete_action *a)
@@ -259,8 +317,9 @@ void database::visit(delete_action *a)
     throw database_exception("db", "table not found");
   }
 
-  i->second->remove(a->id());
-
+  // deleted at commit together with all other
+  // deleted objects of the table
+  i->second->queue_remove(a->id());
 }
 
 const session* database::db() const
@@ -59,8 +59,10 @@ const char* mssql_result::column(size_type /*c*/) const
 
 bool mssql_result::fetch()
 {
+  fetch_timer timer(*this);
   SQLRETURN ret = SQLFetch(stmt_);
   if (SQL_SUCCEEDED(ret)) {
+    count_row();
     return true;
   } else {
     throw_error(ret, SQL_HANDLE_STMT, stmt_, "mssql", "error on fetching next row");
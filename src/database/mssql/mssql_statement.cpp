@@ -66,12 +66,14 @@ mssql_statement::~mssql_statement()
 
 void mssql_statement::prepare(const sql &s)
 {
+  unsigned long long start = trace_start();
   reset();
   
   str(s.prepare());
 
   SQLRETURN ret = SQLPrepare(stmt_, (SQLCHAR*)str().c_str(), SQL_NTS);
   throw_error(ret, SQL_HANDLE_STMT, stmt_, str());
+  trace_prepare(start);
 }
 
 void mssql_statement::reset()
@@ -91,6 +93,7 @@ void mssql_statement::clear()
 
 result* mssql_statement::execute()
 {
+  unsigned long long start = trace_start();
 //  std::cout << str() << "\n";
 
   SQLRETURN ret = SQLExecute(stmt_);
@@ -98,7 +101,24 @@ result* mssql_statement::execute()
   // check result
   throw_error(ret, SQL_HANDLE_STMT, stmt_, str(), "error on query execute");
 
-  return new mssql_result(stmt_, false);
+  return trace_execute(new mssql_result(stmt_, false), start);
+}
+
+unsigned long mssql_statement::execute_update()
+{
+  unsigned long long start = trace_start();
+
+  SQLRETURN ret = SQLExecute(stmt_);
+
+  // check result
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, str(), "error on query execute");
+
+  SQLLEN rows = 0;
+  ret = SQLRowCount(stmt_, &rows);
+  throw_error(ret, SQL_HANDLE_STMT, stmt_, str(), "error on row count");
+
+  trace_update((unsigned long)rows, start);
+  return (unsigned long)rows;
 }
 
 void mssql_statement::write(const char *, char x)
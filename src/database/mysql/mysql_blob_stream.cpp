@@ -0,0 +1,181 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "database/mysql/mysql_blob_stream.hpp"
+#include "database/mysql/mysql_database.hpp"
+#include "database/mysql/mysql_exception.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace oos {
+
+namespace mysql {
+
+mysql_blob_stream::mysql_blob_stream(mysql_database &db, const std::string &table, const std::string &column, long id)
+  : stmt_(mysql_stmt_init(db()))
+  , writable_(false)
+  , id_(id)
+  , length_(0)
+  , is_null_(0)
+  , size_(0)
+  , pos_(0)
+{
+  prepare("SELECT " + column + " FROM " + table + " WHERE id=?;");
+
+  MYSQL_BIND param;
+  memset(&param, 0, sizeof(param));
+  param.buffer_type = MYSQL_TYPE_LONGLONG;
+  param.buffer = &id_;
+  check(mysql_stmt_bind_param(stmt_, &param), "mysql_stmt_bind_param");
+  check(mysql_stmt_execute(stmt_), "mysql_stmt_execute");
+
+  // bind without a buffer, the value is copied chunk by chunk in read()
+  MYSQL_BIND column_bind;
+  memset(&column_bind, 0, sizeof(column_bind));
+  column_bind.buffer_type = MYSQL_TYPE_BLOB;
+  column_bind.length = &length_;
+  column_bind.is_null = &is_null_;
+  check(mysql_stmt_bind_result(stmt_, &column_bind), "mysql_stmt_bind_result");
+
+  int ret = mysql_stmt_fetch(stmt_);
+  if (ret == MYSQL_NO_DATA) {
+    std::stringstream msg;
+    msg << "no row with id " << id << " in table " << table;
+    release();
+    throw mysql_stmt_exception(msg.str());
+  } else if (ret == 1) {
+    check(ret, "mysql_stmt_fetch");
+  }
+  size_ = (is_null_ ? 0 : length_);
+}
+
+mysql_blob_stream::mysql_blob_stream(mysql_database &db, const std::string &table, const std::string &column, long id, size_type size)
+  : stmt_(mysql_stmt_init(db()))
+  , writable_(true)
+  , id_(id)
+  , length_(0)
+  , is_null_(0)
+  , size_(size)
+  , pos_(0)
+{
+  prepare("UPDATE " + table + " SET " + column + "=? WHERE id=?;");
+
+  MYSQL_BIND params[2];
+  memset(params, 0, sizeof(params));
+  // the value of the first parameter is sent in chunks
+  params[0].buffer_type = MYSQL_TYPE_LONG_BLOB;
+  params[1].buffer_type = MYSQL_TYPE_LONGLONG;
+  params[1].buffer = &id_;
+  check(mysql_stmt_bind_param(stmt_, params), "mysql_stmt_bind_param");
+}
+
+mysql_blob_stream::~mysql_blob_stream()
+{
+  try {
+    close();
+  } catch (...) {
+    release();
+  }
+}
+
+mysql_blob_stream::size_type mysql_blob_stream::size() const
+{
+  return size_;
+}
+
+mysql_blob_stream::size_type mysql_blob_stream::read(char *buf, size_type len)
+{
+  if (!stmt_ || writable_) {
+    throw mysql_stmt_exception("blob stream isn't open for reading");
+  }
+  size_type n = (len < size_ - pos_ ? len : size_ - pos_);
+  if (n == 0) {
+    return 0;
+  }
+  MYSQL_BIND chunk;
+  memset(&chunk, 0, sizeof(chunk));
+  chunk.buffer_type = MYSQL_TYPE_BLOB;
+  chunk.buffer = buf;
+  chunk.buffer_length = n;
+  chunk.length = &length_;
+  throw_stmt_error(mysql_stmt_fetch_column(stmt_, &chunk, 0, pos_), stmt_, "mysql_stmt_fetch_column", sql_);
+  pos_ += n;
+  return n;
+}
+
+void mysql_blob_stream::write(const char *buf, size_type len)
+{
+  if (!stmt_ || !writable_) {
+    throw mysql_stmt_exception("blob stream isn't open for writing");
+  }
+  if (len > size_ - pos_) {
+    throw mysql_stmt_exception("mysql_stmt_send_long_data: data exceeds the size of the blob");
+  }
+  // keep each packet below max_allowed_packet
+  while (len > 0) {
+    size_type n = (len < CHUNK_SIZE ? len : static_cast<size_type>(CHUNK_SIZE));
+    throw_stmt_error(mysql_stmt_send_long_data(stmt_, 0, buf, n), stmt_, "mysql_stmt_send_long_data", sql_);
+    buf += n;
+    len -= n;
+    pos_ += n;
+  }
+}
+
+void mysql_blob_stream::close()
+{
+  if (!stmt_) {
+    return;
+  }
+  if (writable_) {
+    check(mysql_stmt_execute(stmt_), "mysql_stmt_execute");
+  }
+  release();
+}
+
+void mysql_blob_stream::prepare(const std::string &sql)
+{
+  sql_ = sql;
+  if (!stmt_) {
+    throw mysql_stmt_exception("mysql_stmt_init: out of memory");
+  }
+  check(mysql_stmt_prepare(stmt_, sql_.c_str(), sql_.size()), "mysql_stmt_prepare");
+}
+
+void mysql_blob_stream::check(int ret, const char *source)
+{
+  if (ret == 0) {
+    return;
+  }
+  // the destructor doesn't run if a constructor throws
+  mysql_stmt_exception ex(stmt_, source, sql_);
+  release();
+  throw ex;
+}
+
+void mysql_blob_stream::release()
+{
+  if (stmt_) {
+    mysql_stmt_free_result(stmt_);
+    mysql_stmt_close(stmt_);
+    stmt_ = 0;
+  }
+}
+
+}
+
+}
@@ -20,6 +20,7 @@
 #include "database/mysql/mysql_result.hpp"
 #include "database/mysql/mysql_types.hpp"
 #include "database/mysql/mysql_exception.hpp"
+#include "database/mysql/mysql_blob_stream.hpp"
 
 #include "database/session.hpp"
 #include "database/transaction.hpp"
@@ -89,8 +90,7 @@ void mysql_database::on_open(const std::string &connection)
   mysql_init(&mysql_);
 //  if (mysql_real_connect(&mysql_, host.c_str(), user.c_str(), passwd.c_str(), db.c_str(), 0, NULL, 0) == NULL) {
   if (mysql_real_connect(&mysql_, host.c_str(), user.c_str(), (has_pwd ? passwd.c_str() : 0), db.c_str(), 0, NULL, 0) == NULL) {
-    printf("Connection Error %u: %s\n", mysql_errno(&mysql_), mysql_error(&mysql_));
-    exit(1);
+    throw_error(mysql_errno(&mysql_), &mysql_, "mysql_real_connect");
   }
   is_open_ = true;
 }
@@ -185,6 +185,8 @@ const char* mysql_database::type_string(data_type_t type) const
       return "VARCHAR";
     case type_text:
       return "TEXT";
+    case type_blob:
+      return "LONGBLOB";
     default:
       {
         std::stringstream msg;
@@ -195,6 +197,16 @@ const char* mysql_database::type_string(data_type_t type) const
     }
 }
 
+blob_stream* mysql_database::open_blob(const std::string &table, const std::string &column, long id)
+{
+  return new mysql_blob_stream(*this, table, column, id);
+}
+
+blob_stream* mysql_database::create_blob(const std::string &table, const std::string &column, long id, blob_stream::size_type size)
+{
+  return new mysql_blob_stream(*this, table, column, id, size);
+}
+
 }
 
 }
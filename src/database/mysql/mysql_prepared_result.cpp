@@ -91,6 +91,7 @@ bool mysql_prepared_result::fetch()
 
 bool mysql_prepared_result::fetch(object *o)
 {
+  fetch_timer timer(*this);
   // reset result column index
   result_index = 0;
   // prepare result array
@@ -111,6 +112,7 @@ bool mysql_prepared_result::fetch(object *o)
 //  }
   }
 
+  count_row();
   return true;
 
 //  return rows-- > 0;
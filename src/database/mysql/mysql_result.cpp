@@ -16,6 +16,7 @@
  */
 
 #include "database/mysql/mysql_result.hpp"
+#include "database/mysql/mysql_exception.hpp"
 #include "database/row.hpp"
 
 namespace oos {
@@ -31,8 +32,7 @@ mysql_result::mysql_result(MYSQL *c)
 {
   res = mysql_store_result(c);
   if (res == 0 && mysql_errno(c) > 0) {
-    printf("Error %u: %s\n", mysql_errno(c), mysql_error(c));
-    exit(1);
+    throw_error(mysql_errno(c), c, "mysql_store_result");
   } else if (res) {
     rows = (size_type)mysql_num_rows(res);
     fields_ = mysql_num_fields(res);
@@ -56,12 +56,17 @@ const char* mysql_result::column(size_type c) const
 
 bool mysql_result::fetch()
 {
+  fetch_timer timer(*this);
   row = mysql_fetch_row(res);
   if (!row) {
     rows = 0;
     return false;
   }    
-  return rows-- > 0;
+  if (rows-- > 0) {
+    count_row();
+    return true;
+  }
+  return false;
 }
 
 bool mysql_result::fetch(object *)
@@ -63,6 +63,7 @@ mysql_statement::~mysql_statement()
 
 void mysql_statement::prepare(const sql &s)
 {
+  unsigned long long start = trace_start();
   reset();
   
   str(s.prepare());
@@ -75,11 +76,9 @@ void mysql_statement::prepare(const sql &s)
     length_vector.assign(host_size, 0);
   }
   
-  if (mysql_stmt_prepare(stmt, str().c_str(), str().size())) {
-    fprintf(stderr, " mysql_stmt_prepare(), SELECT failed\n");
-    fprintf(stderr, " %s\n", mysql_stmt_error(stmt));
-    exit(EXIT_FAILURE);
-  }
+  int ret = mysql_stmt_prepare(stmt, str().c_str(), str().size());
+  throw_stmt_error(ret, stmt, "mysql_stmt_prepare", str());
+  trace_prepare(start);
 }
 
 void mysql_statement::reset()
@@ -104,26 +103,33 @@ void mysql_statement::clear()
 
 result* mysql_statement::execute()
 {
+  unsigned long long start = trace_start();
 //  std::cout << "Executing prepared statement: " << str() << "\n";
   if (host_array) {
 //    std::cout << "\thost_array: " << host_array << "\n";
-    if (mysql_stmt_bind_param(stmt, host_array)) {
-      fprintf(stderr, " mysql_stmt_bind_param() failed\n");
-      fprintf(stderr, " %s\n", mysql_stmt_error(stmt));
-      exit(EXIT_FAILURE);
-    }
+    int ret = mysql_stmt_bind_param(stmt, host_array);
+    throw_stmt_error(ret, stmt, "mysql_stmt_bind_param", str());
   }
-  if (mysql_stmt_execute(stmt)) {
-    fprintf(stderr, " mysql_stmt_execute(), failed\n");
-    fprintf(stderr, " %d: %s\n", mysql_stmt_errno(stmt), mysql_stmt_error(stmt));
-    exit(EXIT_FAILURE);
-  }
-  if (mysql_stmt_store_result(stmt)) {
-    fprintf(stderr, " mysql_stmt_store_result(), failed\n");
-    fprintf(stderr, " %s\n", mysql_stmt_error(stmt));
-    exit(EXIT_FAILURE);
+  int ret = mysql_stmt_execute(stmt);
+  throw_stmt_error(ret, stmt, "mysql_stmt_execute", str());
+  ret = mysql_stmt_store_result(stmt);
+  throw_stmt_error(ret, stmt, "mysql_stmt_store_result", str());
+  return trace_execute(new mysql_prepared_result(stmt, result_size), start);
+}
+
+unsigned long mysql_statement::execute_update()
+{
+  unsigned long long start = trace_start();
+  if (host_array) {
+    int ret = mysql_stmt_bind_param(stmt, host_array);
+    throw_stmt_error(ret, stmt, "mysql_stmt_bind_param", str());
   }
-  return new mysql_prepared_result(stmt, result_size);
+  int ret = mysql_stmt_execute(stmt);
+  throw_stmt_error(ret, stmt, "mysql_stmt_execute", str());
+  unsigned long rows = (unsigned long)mysql_stmt_affected_rows(stmt);
+
+  trace_update(rows, start);
+  return rows;
 }
 
 void mysql_statement::write(const char *, char x)
@@ -192,6 +192,23 @@ query& query::where(const condition &c)
   return *this;
 }
 
+query& query::where_in(const std::string &column, data_type_t type, unsigned long count)
+{
+  throw_invalid(QUERY_COND_WHERE, state);
+
+  sql_.append(std::string(" WHERE ") + column + " IN (");
+  for (unsigned long i = 0; i < count; ++i) {
+    if (i > 0) {
+      sql_.append(", ");
+    }
+    sql_.append(column.c_str(), type, "");
+  }
+  sql_.append(")");
+
+  state = QUERY_COND_WHERE;
+  return *this;
+}
+
 query& query::and_(const condition &c)
 {
   throw_invalid(QUERY_AND, state);
@@ -297,7 +314,12 @@ statement* query::prepare()
 {
   statement *stmt = db_.create_statement();
   // TODO: fix call to prepare
-  stmt->prepare(sql_);
+  try {
+    stmt->prepare(sql_);
+  } catch (...) {
+    delete stmt;
+    throw;
+  }
 
   return stmt;
 }
@@ -365,6 +387,21 @@ void query::throw_invalid(query::state_t next, query::state_t current) const
         throw std::logic_error(msg.str());
       }
       break;
+    case query::QUERY_ORDERBY:
+    case query::QUERY_GROUPBY:
+      if (current != query::QUERY_SELECT &&
+          current != query::QUERY_OBJECT_SELECT &&
+          current != query::QUERY_COLUMN &&
+          current != query::QUERY_WHERE &&
+          current != query::QUERY_COND_WHERE &&
+          current != query::QUERY_AND &&
+          current != query::QUERY_OR &&
+          current != query::QUERY_GROUPBY)
+      {
+        msg << "invalid next state: [" << next << "] (current: " << current << ")";
+        throw std::logic_error(msg.str());
+      }
+      break;
     case query::QUERY_SET:
       if (current != query::QUERY_UPDATE &&
           current != query::QUERY_SET)
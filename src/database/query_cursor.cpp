@@ -0,0 +1,189 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "database/query_cursor.hpp"
+#include "database/query.hpp"
+#include "database/condition.hpp"
+#include "database/session.hpp"
+#include "database/statement.hpp"
+#include "database/result.hpp"
+
+#include "object/object.hpp"
+#include "object/prototype_node.hpp"
+
+namespace oos {
+
+query_cursor::iterator::iterator()
+  : cursor_(0)
+  , index_(0)
+{}
+
+query_cursor::iterator::iterator(query_cursor *cursor, size_type index)
+  : cursor_(cursor)
+  , index_(index)
+{}
+
+object* query_cursor::iterator::operator*() const
+{
+  return cursor_->page_[index_];
+}
+
+query_cursor::iterator& query_cursor::iterator::operator++()
+{
+  if (++index_ < cursor_->page_.size()) {
+    return *this;
+  }
+  index_ = 0;
+  if (!cursor_->fetch()) {
+    cursor_ = 0;
+  }
+  return *this;
+}
+
+bool query_cursor::iterator::operator==(const iterator &x) const
+{
+  return cursor_ == x.cursor_ && index_ == x.index_;
+}
+
+bool query_cursor::iterator::operator!=(const iterator &x) const
+{
+  return !operator==(x);
+}
+
+query_cursor::query_cursor(session &s, const prototype_node &node, size_type page_size)
+  : db_(s.db())
+  , node_(node)
+  , page_size_(page_size > 0 ? page_size : 1)
+  , stmt_(0)
+  , last_id_(0)
+  , pages_(0)
+  , exhausted_(false)
+{
+  prepare();
+}
+
+query_cursor::query_cursor(database &db, const prototype_node &node, size_type page_size)
+  : db_(db)
+  , node_(node)
+  , page_size_(page_size > 0 ? page_size : 1)
+  , stmt_(0)
+  , last_id_(0)
+  , pages_(0)
+  , exhausted_(false)
+{
+  prepare();
+}
+
+query_cursor::~query_cursor()
+{
+  clear_page();
+  delete stmt_;
+}
+
+bool query_cursor::fetch()
+{
+  clear_page();
+
+  if (exhausted_) {
+    return false;
+  }
+
+  stmt_->reset();
+  stmt_->bind(0, last_id_);
+
+  result *res = stmt_->execute();
+  object *o = node_.producer->create();
+  while (res->fetch(o)) {
+    page_.push_back(o);
+    o = node_.producer->create();
+  }
+  delete o;
+  delete res;
+
+  // release the read lock of the backend
+  // until the next page is requested
+  stmt_->reset();
+
+  if (page_.empty()) {
+    exhausted_ = true;
+    return false;
+  }
+
+  last_id_ = page_.back()->id();
+  ++pages_;
+  // a short page is the last one
+  exhausted_ = page_.size() < page_size_;
+  return true;
+}
+
+const query_cursor::t_object_vector& query_cursor::page() const
+{
+  return page_;
+}
+
+void query_cursor::rewind(long after_id)
+{
+  clear_page();
+  last_id_ = after_id;
+  pages_ = 0;
+  exhausted_ = false;
+}
+
+query_cursor::iterator query_cursor::begin()
+{
+  if (page_.empty() && !fetch()) {
+    return end();
+  }
+  return iterator(this, 0);
+}
+
+query_cursor::iterator query_cursor::end()
+{
+  return iterator();
+}
+
+long query_cursor::last_id() const
+{
+  return last_id_;
+}
+
+query_cursor::size_type query_cursor::page_size() const
+{
+  return page_size_;
+}
+
+unsigned long query_cursor::pages() const
+{
+  return pages_;
+}
+
+void query_cursor::prepare()
+{
+  query q(db_);
+  stmt_ = q.select(node_).where(cond("id").greater(0)).order_by("id").limit((int)page_size_).prepare();
+  page_.reserve(page_size_);
+}
+
+void query_cursor::clear_page()
+{
+  for (t_object_vector::iterator i = page_.begin(); i != page_.end(); ++i) {
+    delete *i;
+  }
+  page_.clear();
+}
+
+}
@@ -120,7 +120,7 @@ void query_insert::write_field(const char *id, data_type_t type, const varchar_b
     dialect.append(id);
   } else {
     std::stringstream valstr;
-    valstr << "'" << x.str() << "'";
+    valstr << "'" << x << "'";
     dialect.append(id, type, valstr.str());
   }
 }
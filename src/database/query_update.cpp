@@ -113,7 +113,7 @@ void query_update::write_pair(const char *id, data_type_t type, const varchar_ba
     }
     dialect.append(std::string(id) + "=");
     std::stringstream valstr;
-    valstr << "'" << x.str() << "'";
+    valstr << "'" << x << "'";
     dialect.append(id, type, valstr.str());
 }
 
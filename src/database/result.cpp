@@ -17,16 +17,38 @@
 
 #include "database/result.hpp"
 #include "database/statement.hpp"
+#include "database/sql_tracer.hpp"
 
 #include "object/object_atomizable.hpp"
 
+#include "tools/metrics.hpp"
+
 namespace oos {
 
 result::result()
+  : rows_fetched_(0)
+  , traced_(false)
+  , trace_params_(0)
+  , fetch_duration_(0)
 {}
 
 result::~result()
-{}
+{
+  if (rows_fetched_ > 0 && metrics::enabled()) {
+    static metric_histogram &rows = metrics::instance().histogram("result_rows_fetched");
+    rows.observe(rows_fetched_);
+  }
+  sql_tracer *tracer = (traced_ ? sql_tracer::installed() : 0);
+  if (tracer && fetch_duration_ > 0) {
+    sql_trace_event event;
+    event.phase = sql_trace_event::TRACE_FETCH;
+    event.sql = trace_sql_.c_str();
+    event.params = trace_params_;
+    event.rows = rows_fetched_;
+    event.duration = fetch_duration_;
+    tracer->trace(event);
+  }
+}
 
 void result::get(object_atomizable *o)
 {
@@ -34,5 +56,17 @@ void result::get(object_atomizable *o)
   o->deserialize(*this);
 }
 
+void result::trace(const std::string &sql, unsigned long params)
+{
+  traced_ = true;
+  trace_sql_ = sql;
+  trace_params_ = params;
+}
+
+unsigned long long result::now()
+{
+  return metrics::now();
+}
+
 
 }
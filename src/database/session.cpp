@@ -55,11 +55,20 @@ session::session(object_store &ostore, const std::string &dbstring)
   }
 
   impl_->open(connection_);
+
+  // the memory database can't reload objects
+  if (type_ != "memory") {
+    ostore_.loader(this);
+  }
 }
 
 
 session::~session()
 {
+  // reload evicted objects, the others stay evicted
+  if (ostore_.loader() == this) {
+    ostore_.loader(0);
+  }
   if (impl_) {
     if (type_ == "memory") {
       delete impl_;
@@ -72,6 +81,10 @@ session::~session()
 void session::open()
 {
   impl_->open(connection_);
+
+  if (type_ != "memory") {
+    ostore_.loader(this);
+  }
 }
 
 bool session::is_open() const
@@ -91,6 +104,10 @@ void session::drop()
 
 void session::close()
 {
+  // reload evicted objects while the database is open
+  if (ostore_.loader() == this) {
+    ostore_.loader(0);
+  }
   impl_->close();
 }
 
@@ -170,6 +187,24 @@ object* session::load(const std::string &/*type*/, int /*id*/)
   return 0;
 }
 
+object* session::load(const prototype_node &node, long id)
+{
+  return impl_->load(node, id);
+}
+
+bool session::is_dirty(long id) const
+{
+  /*
+   * changes of outer transactions are
+   * unknown while a nested transaction
+   * is running, treat all objects as dirty
+   */
+  if (transaction_stack_.size() > 1) {
+    return true;
+  }
+  return !transaction_stack_.empty() && transaction_stack_.top()->is_dirty(id);
+}
+
 void session::begin(transaction &tr)
 {
   push_transaction(&tr);
@@ -0,0 +1,246 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "database/sql_tracer.hpp"
+
+#include <ostream>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+namespace oos {
+
+const char* sql_trace_event::phase_name(phase_t phase)
+{
+  switch (phase) {
+    case TRACE_PREPARE:
+      return "prepare";
+    case TRACE_BIND:
+      return "bind";
+    case TRACE_EXECUTE:
+      return "execute";
+    case TRACE_FETCH:
+      return "fetch";
+    default:
+      return "unknown";
+  }
+}
+
+sql_tracer * volatile sql_tracer::tracer_ = 0;
+
+sql_tracer* sql_tracer::install(sql_tracer *tracer)
+{
+#ifdef WIN32
+  return (sql_tracer*)InterlockedExchangePointer((PVOID volatile*)&tracer_, tracer);
+#else
+  return __atomic_exchange_n(&tracer_, tracer, __ATOMIC_ACQ_REL);
+#endif
+}
+
+sql_tracer* sql_tracer::installed()
+{
+#ifdef WIN32
+  sql_tracer *tracer = tracer_;
+  MemoryBarrier();
+  return tracer;
+#else
+  return __atomic_load_n(&tracer_, __ATOMIC_ACQUIRE);
+#endif
+}
+
+slow_statement_log::ring::ring(size_type capacity)
+  : buffer(capacity > 0 ? capacity : 1)
+  , next(0)
+  , full(false)
+{}
+
+void slow_statement_log::ring::push(const sql_trace_event &event)
+{
+  entry &e = buffer[next];
+  e.phase = event.phase;
+  e.sql.assign(event.sql ? event.sql : "");
+  e.params = event.params;
+  e.rows = event.rows;
+  e.duration = event.duration;
+  if (++next == buffer.size()) {
+    next = 0;
+    full = true;
+  }
+}
+
+slow_statement_log::t_entry_vector slow_statement_log::ring::entries() const
+{
+  t_entry_vector result;
+  if (full) {
+    result.reserve(buffer.size());
+    result.insert(result.end(), buffer.begin() + next, buffer.end());
+  }
+  result.insert(result.end(), buffer.begin(), buffer.begin() + next);
+  return result;
+}
+
+void slow_statement_log::ring::clear()
+{
+  for (t_entry_vector::iterator i = buffer.begin(); i != buffer.end(); ++i) {
+    *i = entry();
+  }
+  next = 0;
+  full = false;
+}
+
+slow_statement_log::slow_statement_log(unsigned long long threshold, size_type capacity, unsigned long sample_rate)
+  : threshold_(threshold)
+  , sample_rate_(sample_rate)
+  , out_(0)
+  , slow_(capacity)
+  , recent_(capacity)
+  , traced_(0)
+  , slow_count_(0)
+  , lock_(0)
+{}
+
+slow_statement_log::~slow_statement_log()
+{}
+
+void slow_statement_log::trace(const sql_trace_event &event)
+{
+  lock();
+  ++traced_;
+  if (sample_rate_ > 0 && traced_ % sample_rate_ == 0) {
+    recent_.push(event);
+  }
+  if (event.duration >= threshold_) {
+    ++slow_count_;
+    slow_.push(event);
+    if (out_) {
+      *out_ << "slow sql " << sql_trace_event::phase_name(event.phase)
+            << " (" << event.duration / 1000 << " us, "
+            << event.params << " params, "
+            << event.rows << " rows): "
+            << (event.sql ? event.sql : "") << "\n";
+    }
+  }
+  unlock();
+}
+
+void slow_statement_log::threshold(unsigned long long threshold)
+{
+  lock();
+  threshold_ = threshold;
+  unlock();
+}
+
+unsigned long long slow_statement_log::threshold() const
+{
+  lock();
+  unsigned long long threshold = threshold_;
+  unlock();
+  return threshold;
+}
+
+void slow_statement_log::sample_rate(unsigned long sample_rate)
+{
+  lock();
+  sample_rate_ = sample_rate;
+  unlock();
+}
+
+unsigned long slow_statement_log::sample_rate() const
+{
+  lock();
+  unsigned long sample_rate = sample_rate_;
+  unlock();
+  return sample_rate;
+}
+
+void slow_statement_log::output(std::ostream *out)
+{
+  lock();
+  out_ = out;
+  unlock();
+}
+
+slow_statement_log::t_entry_vector slow_statement_log::slow_statements() const
+{
+  lock();
+  t_entry_vector entries = slow_.entries();
+  unlock();
+  return entries;
+}
+
+slow_statement_log::t_entry_vector slow_statement_log::recent_statements() const
+{
+  lock();
+  t_entry_vector entries = recent_.entries();
+  unlock();
+  return entries;
+}
+
+unsigned long long slow_statement_log::traced() const
+{
+  lock();
+  unsigned long long traced = traced_;
+  unlock();
+  return traced;
+}
+
+unsigned long long slow_statement_log::slow_count() const
+{
+  lock();
+  unsigned long long count = slow_count_;
+  unlock();
+  return count;
+}
+
+void slow_statement_log::clear()
+{
+  lock();
+  slow_.clear();
+  recent_.clear();
+  traced_ = 0;
+  slow_count_ = 0;
+  unlock();
+}
+
+void slow_statement_log::lock() const
+{
+#ifdef WIN32
+  while (InterlockedCompareExchange((volatile LONG*)&lock_, 1, 0) != 0) {
+    SwitchToThread();
+  }
+#else
+  int expected = 0;
+  while (!__atomic_compare_exchange_n(&lock_, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    expected = 0;
+    sched_yield();
+  }
+#endif
+}
+
+void slow_statement_log::unlock() const
+{
+#ifdef WIN32
+  InterlockedExchange((volatile LONG*)&lock_, 0);
+#else
+  __atomic_store_n(&lock_, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "database/sqlite/sqlite_blob_stream.hpp"
+#include "database/sqlite/sqlite_database.hpp"
+#include "database/sqlite/sqlite_exception.hpp"
+
+#include <sqlite3.h>
+
+#include <sstream>
+
+namespace oos {
+
+namespace sqlite {
+
+namespace {
+
+void throw_blob_error(int ec, sqlite3 *db, const std::string &source)
+{
+  if (ec == SQLITE_OK) {
+    return;
+  }
+  std::stringstream msg;
+  msg << source << ": " << sqlite3_errmsg(db);
+  throw sqlite_exception(msg.str());
+}
+
+}
+
+sqlite_blob_stream::sqlite_blob_stream(sqlite_database &db, const std::string &table, const std::string &column, long rowid, bool writable)
+  : db_(db)
+  , blob_(0)
+  , size_(0)
+  , pos_(0)
+{
+  int ret = sqlite3_blob_open(db_(), "main", table.c_str(), column.c_str(), rowid, writable ? 1 : 0, &blob_);
+  if (ret != SQLITE_OK) {
+    // sqlite may return a handle on error which must be closed
+    sqlite3_blob_close(blob_);
+    blob_ = 0;
+  }
+  throw_blob_error(ret, db_(), "sqlite3_blob_open");
+  size_ = sqlite3_blob_bytes(blob_);
+}
+
+sqlite_blob_stream::~sqlite_blob_stream()
+{
+  if (blob_) {
+    sqlite3_blob_close(blob_);
+  }
+}
+
+sqlite_blob_stream::size_type sqlite_blob_stream::size() const
+{
+  return size_;
+}
+
+sqlite_blob_stream::size_type sqlite_blob_stream::read(char *buf, size_type len)
+{
+  if (!blob_) {
+    throw sqlite_exception("blob stream is closed");
+  }
+  size_type n = (len < size_ - pos_ ? len : size_ - pos_);
+  if (n == 0) {
+    return 0;
+  }
+  throw_blob_error(sqlite3_blob_read(blob_, buf, static_cast<int>(n), static_cast<int>(pos_)), db_(), "sqlite3_blob_read");
+  pos_ += n;
+  return n;
+}
+
+void sqlite_blob_stream::write(const char *buf, size_type len)
+{
+  if (!blob_) {
+    throw sqlite_exception("blob stream is closed");
+  }
+  if (len > size_ - pos_) {
+    throw sqlite_exception("sqlite3_blob_write: data exceeds the size of the blob");
+  }
+  throw_blob_error(sqlite3_blob_write(blob_, buf, static_cast<int>(len), static_cast<int>(pos_)), db_(), "sqlite3_blob_write");
+  pos_ += len;
+}
+
+void sqlite_blob_stream::close()
+{
+  if (blob_) {
+    int ret = sqlite3_blob_close(blob_);
+    blob_ = 0;
+    throw_blob_error(ret, db_(), "sqlite3_blob_close");
+  }
+}
+
+void sqlite_blob_stream::reopen(long rowid)
+{
+  if (!blob_) {
+    throw sqlite_exception("blob stream is closed");
+  }
+  throw_blob_error(sqlite3_blob_reopen(blob_, rowid), db_(), "sqlite3_blob_reopen");
+  size_ = sqlite3_blob_bytes(blob_);
+  pos_ = 0;
+}
+
+}
+
+}
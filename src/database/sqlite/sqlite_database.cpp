@@ -20,6 +20,7 @@
 #include "database/sqlite/sqlite_result.hpp"
 #include "database/sqlite/sqlite_types.hpp"
 #include "database/sqlite/sqlite_exception.hpp"
+#include "database/sqlite/sqlite_blob_stream.hpp"
 
 #include "database/session.hpp"
 #include "database/transaction.hpp"
@@ -154,6 +155,33 @@ int sqlite_database::parse_result(void* param, int column_count, char** values,
   return 0;
 }
 
+blob_stream* sqlite_database::open_blob(const std::string &table, const std::string &column, long id)
+{
+  return new sqlite_blob_stream(*this, table, column, id, false);
+}
+
+blob_stream* sqlite_database::create_blob(const std::string &table, const std::string &column, long id, blob_stream::size_type size)
+{
+  // sqlite can't resize a blob via its handle, reserve the final size first
+  std::string sql = "UPDATE " + table + " SET " + column + "=zeroblob(?) WHERE rowid=?;";
+  sqlite3_stmt *stmt = 0;
+  int ret = sqlite3_prepare_v2(sqlite_db_, sql.c_str(), sql.size(), &stmt, 0);
+  throw_error(ret, sqlite_db_, "sqlite3_prepare_v2");
+  sqlite3_bind_int64(stmt, 1, size);
+  sqlite3_bind_int64(stmt, 2, id);
+  ret = sqlite3_step(stmt);
+  sqlite3_finalize(stmt);
+  if (ret != SQLITE_DONE) {
+    throw_error(ret, sqlite_db_, "sqlite3_step");
+  }
+  if (sqlite3_changes(sqlite_db_) == 0) {
+    std::stringstream msg;
+    msg << "create_blob: no row with id " << id << " in table " << table;
+    throw sqlite_exception(msg.str());
+  }
+  return new sqlite_blob_stream(*this, table, column, id, true);
+}
+
 const char* sqlite_database::type_string(data_type_t type) const
 {
   switch(type) {
@@ -185,6 +213,8 @@ const char* sqlite_database::type_string(data_type_t type) const
       return "VARCHAR";
     case type_text:
       return "TEXT";
+    case type_blob:
+      return "BLOB";
     default:
       {
         std::stringstream msg;
@@ -31,6 +31,7 @@ const char* sqlite_prepared_result::column(size_type ) const
 
 bool sqlite_prepared_result::fetch()
 {
+  fetch_timer timer(*this);
   if (!first_) {
     // get next row
     ret_ = sqlite3_step(stmt_);
@@ -42,6 +43,7 @@ bool sqlite_prepared_result::fetch()
     return false;
   }
 
+  count_row();
   return true;
 }
 
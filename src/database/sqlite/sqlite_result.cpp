@@ -41,7 +41,12 @@ const char* sqlite_result::column(sqlite_result::size_type c) const
 
 bool sqlite_result::fetch()
 {
-  return ++pos_ < rows_.size();
+  fetch_timer timer(*this);
+  if (++pos_ < rows_.size()) {
+    count_row();
+    return true;
+  }
+  return false;
 }
 
 bool sqlite_result::fetch(object *)
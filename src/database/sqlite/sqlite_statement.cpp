@@ -67,14 +67,29 @@ sqlite_statement::~sqlite_statement()
 
 result* sqlite_statement::execute()
 {
+  unsigned long long start = trace_start();
   // get next row
   int ret = sqlite3_step(stmt_);
   
-  return new sqlite_prepared_result(stmt_, ret);
+  return trace_execute(new sqlite_prepared_result(stmt_, ret), start);
+}
+
+unsigned long sqlite_statement::execute_update()
+{
+  unsigned long long start = trace_start();
+  int ret = sqlite3_step(stmt_);
+  if (ret != SQLITE_DONE && ret != SQLITE_ROW) {
+    throw_error(ret, db_(), "sqlite3_step", str());
+  }
+  unsigned long rows = sqlite3_changes(db_());
+
+  trace_update(rows, start);
+  return rows;
 }
 
 void sqlite_statement::prepare(const sql &s)
 {
+  unsigned long long start = trace_start();
   reset();
   
   str(s.prepare());
@@ -84,6 +99,7 @@ void sqlite_statement::prepare(const sql &s)
   // prepare sqlite statement
   int ret = sqlite3_prepare_v2(db_(), str().c_str(), str().size(), &stmt_, 0);
   throw_error(ret, db_(), "sqlite3_prepare_v2", str());
+  trace_prepare(start);
 }
 
 void sqlite_statement::reset()
@@ -16,9 +16,13 @@
  */
 
 #include "database/statement.hpp"
+#include "database/result.hpp"
+#include "database/sql_tracer.hpp"
 
 #include "object/object_atomizable.hpp"
 
+#include "tools/metrics.hpp"
+
 #ifdef WIN32
 #include <functional>
 #else
@@ -29,17 +33,47 @@ using namespace std::tr1::placeholders;
 
 namespace oos {
 
+namespace {
+
+void count_execute()
+{
+  if (metrics::enabled()) {
+    static metric_counter &executes = metrics::instance().counter("statement_executes");
+    executes.add();
+  }
+}
+
+}
+
 statement::~statement()
 {}
 
 int statement::bind(object_atomizable *o)
 {
+  unsigned long long start = trace_start();
   reset();
   host_index = 0;
   o->serialize(*this);
+  sql_tracer *tracer = (start ? sql_tracer::installed() : 0);
+  if (tracer) {
+    sql_trace_event event;
+    event.phase = sql_trace_event::TRACE_BIND;
+    event.sql = sql_.c_str();
+    event.params = host_index;
+    event.duration = metrics::now() - start;
+    tracer->trace(event);
+  }
   return host_index;
 }
 
+unsigned long statement::execute_update()
+{
+  result *res = execute();
+  unsigned long rows = res->affected_rows();
+  delete res;
+  return rows;
+}
+
 std::string statement::str() const
 {
   return sql_;
@@ -50,4 +84,59 @@ void statement::str(const std::string &s)
   sql_ = s;
 }
 
+unsigned long long statement::trace_start()
+{
+  return (sql_tracer::enabled() ? metrics::now() : 0);
+}
+
+void statement::trace_prepare(unsigned long long start)
+{
+  if (metrics::enabled()) {
+    static metric_counter &prepares = metrics::instance().counter("statement_prepares");
+    prepares.add();
+  }
+  sql_tracer *tracer = (start ? sql_tracer::installed() : 0);
+  if (tracer) {
+    sql_trace_event event;
+    event.phase = sql_trace_event::TRACE_PREPARE;
+    event.sql = sql_.c_str();
+    event.duration = metrics::now() - start;
+    tracer->trace(event);
+  }
+}
+
+result* statement::trace_execute(result *res, unsigned long long start)
+{
+  count_execute();
+  sql_tracer *tracer = (start ? sql_tracer::installed() : 0);
+  if (tracer) {
+    sql_trace_event event;
+    event.phase = sql_trace_event::TRACE_EXECUTE;
+    event.sql = sql_.c_str();
+    event.params = host_index;
+    event.rows = (res ? res->affected_rows() : 0);
+    event.duration = metrics::now() - start;
+    tracer->trace(event);
+    if (res) {
+      res->trace(sql_, host_index);
+    }
+  }
+  return res;
+}
+
+void statement::trace_update(unsigned long rows, unsigned long long start)
+{
+  count_execute();
+  sql_tracer *tracer = (start ? sql_tracer::installed() : 0);
+  if (tracer) {
+    sql_trace_event event;
+    event.phase = sql_trace_event::TRACE_EXECUTE;
+    event.sql = sql_.c_str();
+    event.params = host_index;
+    event.rows = rows;
+    event.duration = metrics::now() - start;
+    tracer->trace(event);
+  }
+}
+
 }
@@ -16,6 +16,7 @@
  */
 
 #include "database/table.hpp"
+#include "database/session.hpp"
 #include "database/database.hpp"
 #include "database/result.hpp"
 #include "database/query.hpp"
@@ -34,6 +35,7 @@ public:
     : generic_object_reader<relation_filler>(this)
     , info_(tbl)
     , object_(0)
+    , field_(0)
   {}
   virtual ~relation_filler() {}
   
@@ -43,6 +45,7 @@ public:
     object_proxy *last = info_->node_.op_marker;
     while (first != last) {
       object_ = first->obj;
+      field_ = 0;
       object_->deserialize(*this);
       first = first->next;
     }
@@ -52,20 +55,25 @@ public:
   void read_value(const char*, T&) {}
   
   void read_value(const char*, char*, int) {}
+
+  void read_value(const char*, object_base_ptr&)
+  {
+    ++field_;
+  }
   
-  void read_value(const char *id, object_container &x)
+  void read_value(const char *, object_container &x)
   {
-//    std::cout << "DEBUG: fill container [" << id << "]\n";
-    table::relation_data_t::iterator i = info_->relation_data.find(id);
-    if (i != info_->relation_data.end()) {
-      table::object_map_t::iterator j = i->second.find(object_->id());
+    table::object_map_t *relation = info_->plan_[field_++].relation;
+    if (!relation) {
+      return;
+    }
+    table::object_map_t::iterator j = relation->find(object_->id());
 //      std::cout << "DEBUG: lookup for object [" << object_->classname() << "] id [" << object_->id() << "]\n";
-      if (j != i->second.end()) {
+    if (j != relation->end()) {
 //        std::cout << "DEBUG: found item list [" << x.classname() << "] with [" << j->second.size() << "] elements\n";
-        while (!j->second.empty()) {
-          x.append_proxy(j->second.front()->proxy_);
-          j->second.pop_front();
-        }
+      while (!j->second.empty()) {
+        x.append_proxy(j->second.front()->proxy_);
+        j->second.pop_front();
       }
     }
   }
@@ -73,8 +81,77 @@ public:
 private:
   database::table_ptr &info_;
   object *object_;
+  table::t_field_plan_vector::size_type field_;
+};
+
+/*
+ * walks the fields of a prototype object once
+ * and resolves the decoding plan of a table
+ */
+class plan_builder : public generic_object_reader<plan_builder>
+{
+public:
+  plan_builder(table &tbl, object_store &ostore)
+    : generic_object_reader<plan_builder>(this)
+    , table_(tbl)
+    , ostore_(ostore)
+  {}
+  virtual ~plan_builder() {}
+
+  template < class T >
+  void read_value(const char*, T&) {}
+
+  void read_value(const char*, char*, int) {}
+
+  void read_value(const char *, object_base_ptr &x)
+  {
+    table::field_plan field;
+    field.kind = table::field_plan::FIELD_POINTER;
+    prototype_iterator node = ostore_.find_prototype(x.type());
+    if (node != ostore_.end()) {
+      field.node = node.get();
+      /*
+       * the objects of the pointer field are children
+       * of a container of the pointed prototype, the
+       * loaded objects are collected in the relation
+       * data of the pointed prototypes table
+       */
+      prototype_node::field_prototype_map_t::const_iterator i = table_.node_.relations.find(node->type);
+      if (i != table_.node_.relations.end()) {
+        field.target = table_.find_table(node->type);
+        if (field.target) {
+          field.relation = &field.target->relation_data[i->second.second];
+        }
+      }
+    }
+    table_.plan_.push_back(field);
+  }
+
+  void read_value(const char *id, object_container &x)
+  {
+    table::field_plan field;
+    field.kind = table::field_plan::FIELD_CONTAINER;
+    prototype_iterator node = ostore_.find_prototype(x.classname());
+    if (node != ostore_.end()) {
+      field.node = node.get();
+      field.target = table_.find_table(node->type);
+      field.relation = &table_.relation_data[id];
+    }
+    table_.plan_.push_back(field);
+  }
+
+private:
+  table &table_;
+  object_store &ostore_;
 };
 
+/*
+ * 512 host values stay below the parameter
+ * limits of all backends (999 on older SQLite
+ * builds, 2100 on MSSQL)
+ */
+const unsigned long table::delete_chunk_size_[table::DELETE_CHUNK_COUNT] = { 512, 64, 8 };
+
 table::table(database &db, const prototype_node &node)
   : generic_object_reader<table>(this)
   , db_(db)
@@ -84,11 +161,18 @@ table::table(database &db, const prototype_node &node)
   , update_(0)
   , delete_(0)
   , select_(0)
+  , select_id_(0)
   , object_(0)
   , ostore_(0)
   , prepared_(false)
+  , plan_index_(0)
+  , planned_(false)
   , is_loaded_(false)
-{}
+{
+  for (int i = 0; i < DELETE_CHUNK_COUNT; ++i) {
+    delete_chunk_[i] = 0;
+  }
+}
 
 table::~table()
 {
@@ -97,6 +181,10 @@ table::~table()
     delete update_;
     delete delete_;
     delete select_;
+    delete select_id_;
+  }
+  for (int i = 0; i < DELETE_CHUNK_COUNT; ++i) {
+    delete delete_chunk_[i];
   }
 }
 
@@ -109,14 +197,32 @@ void table::prepare()
 {
   query q(db_);
 
-  object *o = node_.producer->create();
-  insert_ = q.insert(o, node_.type).prepare();
-  update_ = q.reset().update(node_.type, o).where(cond("id").equal(0)).prepare();
-  delete_ = q.reset().remove(node_).where(cond("id").equal(0)).prepare();
-  select_ = q.reset().select(node_).prepare();
-  delete o;
+#ifdef WIN32
+  std::auto_ptr<object> o(node_.producer->create());
+#else
+  std::unique_ptr<object> o(node_.producer->create());
+#endif
+  try {
+    insert_ = q.insert(o.get(), node_.type).prepare();
+    update_ = q.reset().update(node_.type, o.get()).where(cond("id").equal(0)).prepare();
+    delete_ = q.reset().remove(node_).where(cond("id").equal(0)).prepare();
+    select_ = q.reset().select(node_).prepare();
+    select_id_ = q.reset().select(node_).where(cond("id").equal(0)).prepare();
+  } catch (...) {
+    // a missing table can't be prepared, release what was prepared
+    delete insert_;
+    delete update_;
+    delete delete_;
+    delete select_;
+    insert_ = update_ = delete_ = select_ = select_id_ = 0;
+    throw;
+  }
 
   prepared_ = true;
+
+  if (db_.db()) {
+    build_plan(db_.db()->ostore());
+  }
 }
 
 void table::create()
@@ -137,8 +243,15 @@ void table::load(object_store &ostore)
     prepare();
   }
 
+  if (!planned_) {
+    build_plan(ostore);
+  }
+
   ostore_ = &ostore;
 
+  // the second pass only resolves pointers and containers
+  bool resolve = !plan_.empty();
+
   // check result  
   // create object
   result *res(select_->execute());
@@ -146,7 +259,10 @@ void table::load(object_store &ostore)
   column_ = 0;
   while (res->fetch(object_)) {
   
-    object_->deserialize(*this);
+    if (resolve) {
+      plan_index_ = 0;
+      object_->deserialize(*this);
+    }
 
     ostore.insert(object_);
 
@@ -168,7 +284,7 @@ void table::load(object_store &ostore)
 //      throw std::out_of_range("unknown key");
     } else {
       database::table_ptr tbl = i->second;
-      if (tbl->is_loaded()) {
+      if (tbl->is_loaded() && !tbl->plan_.empty()) {
 //        std::cout << " loaded\n";
         relation_filler filler(tbl);
         filler.fill();
@@ -183,6 +299,52 @@ void table::load(object_store &ostore)
   is_loaded_ = true;
 }
 
+object* table::load(object_store &ostore, long id)
+{
+  if (!prepared_) {
+    prepare();
+  }
+
+  if (!planned_) {
+    build_plan(ostore);
+  }
+
+  // keep the state of a running table load
+  object *loading = object_;
+  object_store *loading_store = ostore_;
+  int loading_column = column_;
+  t_field_plan_vector::size_type loading_field = plan_index_;
+
+  ostore_ = &ostore;
+
+  select_id_->reset();
+  select_id_->bind(0, id);
+  result *res(select_id_->execute());
+  object_ = node_.producer->create();
+  column_ = 0;
+  if (res->fetch(object_)) {
+    if (!plan_.empty()) {
+      plan_index_ = 0;
+      object_->deserialize(*this);
+    }
+  } else {
+    delete object_;
+    object_ = 0;
+  }
+  delete res;
+  // release the statement for following loads
+  select_id_->reset();
+
+  object *o = object_;
+
+  object_ = loading;
+  ostore_ = loading_store;
+  column_ = loading_column;
+  plan_index_ = loading_field;
+
+  return o;
+}
+
 void table::insert(object *obj)
 {
   insert_->bind(obj);
@@ -195,9 +357,7 @@ void table::update(object *obj)
 {
   int pos = update_->bind(obj);
   update_->bind(pos, obj->id());
-  result *res = update_->execute();
-
-  delete res;
+  update_->execute_update();
 }
 
 void table::remove(object *obj)
@@ -207,10 +367,80 @@ void table::remove(object *obj)
 
 void table::remove(long id)
 {
+  // release the statement of the previous delete
+  delete_->reset();
   delete_->bind(0, id);
-  result *res = delete_->execute();
+  delete_->execute_update();
+}
 
-  delete res;
+void table::queue_update(object *obj)
+{
+  updated_.push_back(obj);
+}
+
+void table::flush_updates()
+{
+  if (updated_.empty()) {
+    return;
+  }
+  /*
+   * rebind and step the one prepared update
+   * statement for each object, the statement
+   * is reset by bind() and no result is created
+   */
+  for (std::vector<object*>::const_iterator i = updated_.begin(); i != updated_.end(); ++i) {
+    int pos = update_->bind(*i);
+    update_->bind(pos, (*i)->id());
+    update_->execute_update();
+  }
+  // release the statement until the next commit
+  update_->reset();
+  updated_.clear();
+}
+
+void table::discard_updates()
+{
+  updated_.clear();
+}
+
+void table::queue_remove(long id)
+{
+  removed_.push_back(id);
+}
+
+void table::flush_removes()
+{
+  std::vector<long>::size_type pos = 0;
+  std::vector<long>::size_type size = removed_.size();
+  for (int i = 0; i < DELETE_CHUNK_COUNT; ++i) {
+    const unsigned long chunk = delete_chunk_size_[i];
+    if (size - pos < chunk) {
+      continue;
+    }
+    if (!delete_chunk_[i]) {
+      query q(db_);
+      delete_chunk_[i] = q.remove(node_).where_in("id", type_long, chunk).prepare();
+    }
+    statement *stmt = delete_chunk_[i];
+    while (size - pos >= chunk) {
+      stmt->reset();
+      for (unsigned long j = 0; j < chunk; ++j) {
+        stmt->bind(j, removed_[pos++]);
+      }
+      stmt->execute_update();
+    }
+    // release the statement until the next commit
+    stmt->reset();
+  }
+  while (pos < size) {
+    remove(removed_[pos++]);
+  }
+  removed_.clear();
+}
+
+void table::discard_removes()
+{
+  removed_.clear();
 }
 
 void table::drop()
@@ -234,6 +464,8 @@ const prototype_node& table::node() const
 
 void table::read_value(const char *, object_base_ptr &x)
 {
+  const field_plan &field = plan_[plan_index_++];
+
   long oid = x.id();
 //  std::cout << "DEBUG: reading field [" << id << "] (column: " << column_ << ")\n";
   
@@ -248,51 +480,53 @@ void table::read_value(const char *, object_base_ptr &x)
     oproxy = ostore_->create_proxy(oid);
   }
 
-  prototype_iterator node = ostore_->find_prototype(x.type());
-  
-//  std::cout << "DEBUG: found prototype node [" << node->type << "]\n";
-
   /*
    * add the child object to the object proxy
    * of the parent container
    */
-  database::table_map_t::iterator j = db().table_map_.find(node->type);
-  prototype_node::field_prototype_map_t::const_iterator i = node_.relations.find(node->type);
-  if (i != node_.relations.end()) {
-//    std::cout << "DEBUG: found relation node [" << i->second.first->type << "] for field [" << i->second.second << "]\n";
-    j->second->relation_data[i->second.second][oid].push_back(object_);
-//    std::cout << "DEBUG: store relation data in node [" << i->second.first->type << "]->[" << i->second.second << "][" << oid << "].push_back[" << *object_ << "]\n";
+  if (field.relation) {
+    (*field.relation)[oid].push_back(object_);
   }
   
   x.reset(oproxy->obj);
 }
 
-void table::read_value(const char *id, object_container &x)
+void table::read_value(const char *, object_container &x)
 {
+  const field_plan &field = plan_[plan_index_++];
+
   /*
-   * find prototype node and check if there
-   * are proxies to insert for this container
+   * check if there are proxies to
+   * insert for this container
    */
-  prototype_iterator p = ostore_->find_prototype(x.classname());
-  if (p != ostore_->end()) {
-//    std::cout << "DEBUG: found container of type [" << p->type << "(" << x.classname() << ")] for prototype:field [" << node_.type << ":" << id << "]\n";
-    if (db().is_loaded(p->type)) {
-//      std::cout << "DEBUG: " << x.classname() << " loaded; fill in field [" << id << "] of container [" << object_->id() << "]\n";
-      database::relation_data_t::iterator i = relation_data.find(id);
-      if (i != relation_data.end()) {
-        database::object_map_t::iterator j = i->second.find(object_->id());
-        if (j != i->second.end()) {
-//          std::cout << "DEBUG: found item list [" << x.classname() << "] with [" << j->second.size() << "] elements\n";
-          while (!j->second.empty()) {
-            x.append_proxy(j->second.front()->proxy_);
-            j->second.pop_front();
-          }
-        }
-      }
-    } else {
-//      std::cout << "DEBUG: " << x.classname() << " not loaded; container will be filled after of [" << x.classname() << "] load\n";
+  if (!field.relation || !field.target || !field.target->is_loaded()) {
+//    std::cout << "DEBUG: " << x.classname() << " not loaded; container will be filled after of [" << x.classname() << "] load\n";
+    return;
+  }
+  object_map_t::iterator j = field.relation->find(object_->id());
+  if (j != field.relation->end()) {
+//    std::cout << "DEBUG: found item list [" << x.classname() << "] with [" << j->second.size() << "] elements\n";
+    while (!j->second.empty()) {
+      x.append_proxy(j->second.front()->proxy_);
+      j->second.pop_front();
     }
   }
 }
 
+void table::build_plan(object_store &ostore)
+{
+  plan_.clear();
+  object *o = node_.producer->create();
+  plan_builder builder(*this, ostore);
+  o->deserialize(builder);
+  delete o;
+  planned_ = true;
+}
+
+table* table::find_table(const std::string &type) const
+{
+  database::table_map_t::const_iterator i = db_.table_map_.find(type);
+  return (i == db_.table_map_.end() ? 0 : i->second.get());
+}
+
 }
@@ -22,6 +22,7 @@
 #include "database/database_exception.hpp"
 
 #include "tools/byte_buffer.hpp"
+#include "tools/metrics.hpp"
 
 #include "object/object_store.hpp"
 #include "object/object.hpp"
@@ -141,8 +142,19 @@ transaction::commit()
     throw database_exception("transaction", "transaction isn't current transaction");
 //    cout << "commit: transaction [" << id_ << "] isn't current transaction (" << db_.current_transaction() << ")\n";
   } else {
+    unsigned long long start = (metrics::enabled() ? metrics::now() : 0);
     // commit all transaction actions
     db_.commit(*this);
+    if (start > 0) {
+      static metric_counter &commits = metrics::instance().counter("transaction_commits");
+      static metric_counter &actions = metrics::instance().counter("transaction_actions");
+      static metric_counter &backup_bytes = metrics::instance().counter("transaction_backup_bytes");
+      static metric_histogram &latency = metrics::instance().histogram("transaction_commit_ns");
+      commits.add();
+      actions.add(static_cast<metric_counter::value_type>(action_list_.size()));
+      backup_bytes.add(static_cast<metric_counter::value_type>(object_buffer_.size()));
+      latency.observe(metrics::now() - start);
+    }
 //    cout << "commited transaction [" << id_ << "]\n";
     // clear actions
     cleanup();
@@ -165,6 +177,10 @@ transaction::rollback()
      * clear insert action map
      *
      **************/
+    if (metrics::enabled()) {
+      static metric_counter &rollbacks = metrics::instance().counter("transaction_rollbacks");
+      rollbacks.add();
+    }
 
     while (!action_list_.empty()) {
       iterator i = action_list_.begin();
@@ -181,6 +197,12 @@ transaction::rollback()
   }
 }
 
+bool
+transaction::is_dirty(long id) const
+{
+  return id_map_.find(id) != id_map_.end();
+}
+
 session&
 transaction::db()
 {
@@ -143,9 +143,11 @@ void action_inserter::visit(delete_action *)
 bool action_remover::remove(transaction::iterator i, object *o)
 {
   obj_ = o;
+  id_ = o->id();
   iter_ = i;
   (*i)->accept(this);
   obj_ = 0;
+  id_ = 0;
   return true;
 }
 
@@ -1,4 +1,5 @@
 #include "json/json_array.hpp"
+#include "json/json_writer.hpp"
 
 namespace oos {
 
@@ -89,21 +90,18 @@ bool json_array::parse(std::istream &in)
   return true;
 }
 
-void json_array::print(std::ostream &out) const
+void json_array::write(json_writer &writer) const
 {
-  out << "[ ";
+  writer.begin_array();
 
   t_value_vector::const_iterator first = value_vector_.begin();
   t_value_vector::const_iterator last = value_vector_.end();
 
-  while (first != last) {
-    out << *first;
-    if (++first != last) {
-      out << ", ";
-    }
+  for (; first != last; ++first) {
+    writer.value(*first);
   }
 
-  out << " ]";
+  writer.end_array();
 }
 
 json_array::iterator json_array::begin()
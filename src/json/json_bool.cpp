@@ -1,4 +1,5 @@
 #include "json/json_bool.hpp"
+#include "json/json_writer.hpp"
 
 namespace oos {
 
@@ -61,9 +62,9 @@ bool json_bool::parse(std::istream &in)
   return true;
 }
 
-void json_bool::print(std::ostream &out) const
+void json_bool::write(json_writer &writer) const
 {
-  out << (value_ ? json_bool::true_string : json_bool::false_string);
+  writer.value(value_);
 }
 
 bool json_bool::value() const
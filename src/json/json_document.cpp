@@ -0,0 +1,209 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/json_document.hpp"
+
+#include <cstring>
+
+namespace oos {
+
+json_document::json_document()
+  : generic_json_parser<json_document>(this)
+  , root_(0)
+{}
+
+json_document::~json_document()
+{}
+
+json_node json_document::parse(const char *str, size_t len)
+{
+  reset();
+  try {
+    parse_json(str, len);
+  } catch (...) {
+    reset();
+    throw;
+  }
+  return root();
+}
+
+json_node json_document::parse(const char *str)
+{
+  return parse(str, strlen(str));
+}
+
+json_node json_document::parse(const std::string &str)
+{
+  return parse(str.data(), str.size());
+}
+
+json_node json_document::parse(std::istream &in)
+{
+  reset();
+  try {
+    parse_json(in);
+  } catch (...) {
+    reset();
+    throw;
+  }
+  return root();
+}
+
+json_node json_document::root() const
+{
+  return json_node(root_);
+}
+
+void json_document::clear()
+{
+  reset();
+}
+
+size_t json_document::memory_usage() const
+{
+  return arena_.capacity();
+}
+
+void json_document::on_begin_object()
+{
+  frames_.push_back(values_.size());
+}
+
+void json_document::on_object_key(const std::string &key)
+{
+  t_key_map::iterator i = keys_.find(key);
+  if (i == keys_.end()) {
+    i = keys_.insert(std::make_pair(key, arena_.copy(key.data(), key.size()))).first;
+  }
+  push(json_node::JSON_STRING, key.size());
+  values_.back().str = i->second;
+}
+
+void json_document::on_end_object()
+{
+  end_container(json_node::JSON_OBJECT);
+}
+
+void json_document::on_begin_array()
+{
+  frames_.push_back(values_.size());
+}
+
+void json_document::on_end_array()
+{
+  end_container(json_node::JSON_ARRAY);
+}
+
+void json_document::on_string(const std::string &value)
+{
+  push(json_node::JSON_STRING, value.size());
+  values_.back().str = arena_.copy(value.data(), value.size());
+}
+
+void json_document::on_number(double value)
+{
+  push(json_node::JSON_NUMBER, 0);
+  values_.back().number = value;
+}
+
+void json_document::on_integer(long long value)
+{
+  push(json_node::JSON_NUMBER | json_node_data::INTEGER, 0);
+  values_.back().integer = value;
+}
+
+void json_document::on_bool(bool value)
+{
+  push(json_node::JSON_BOOL, value ? 1 : 0);
+}
+
+void json_document::on_null()
+{
+  push(json_node::JSON_NULL, 0);
+}
+
+void json_document::reset()
+{
+  arena_.clear();
+  root_ = 0;
+  values_.clear();
+  frames_.clear();
+  keys_.clear();
+}
+
+void json_document::push(unsigned int type, unsigned int size)
+{
+  json_node_data data;
+  data.type = type;
+  data.size = size;
+  data.first = 0;
+  values_.push_back(data);
+}
+
+void json_document::end_container(unsigned int type)
+{
+  size_t start = frames_.back();
+  frames_.pop_back();
+  size_t n = values_.size() - start;
+  size_t members = (type == json_node::JSON_OBJECT ? n / 2 : n);
+
+  // move the children from the stack into the arena
+  size_t bytes = n * sizeof(json_node_data);
+  size_t capacity = 0;
+  if (type == json_node::JSON_OBJECT && members >= json_node_data::HASH_THRESHOLD) {
+    capacity = json_node_data::hash_capacity(members);
+  }
+  json_node_data *children = static_cast<json_node_data*>(arena_.allocate(bytes + capacity * sizeof(unsigned int)));
+  if (n > 0) {
+    std::memcpy(children, &values_[start], bytes);
+  }
+  values_.resize(start);
+
+  if (capacity > 0) {
+    // build the hash index behind the members
+    unsigned int *slots = reinterpret_cast<unsigned int*>(children + n);
+    std::memset(slots, 0, capacity * sizeof(unsigned int));
+    size_t mask = capacity - 1;
+    for (size_t m = 0; m < members; ++m) {
+      const json_node_data *k = children + 2 * m;
+      size_t i = json_node_data::hash(k->str, k->size) & mask;
+      while (slots[i] != 0) {
+        const json_node_data *other = children + 2 * (slots[i] - 1);
+        if (other->size == k->size && std::memcmp(other->str, k->str, k->size) == 0) {
+          // duplicate key, the last member wins
+          break;
+        }
+        i = (i + 1) & mask;
+      }
+      slots[i] = static_cast<unsigned int>(m + 1);
+    }
+    type |= json_node_data::HASHED;
+  }
+
+  push(type, static_cast<unsigned int>(members));
+  values_.back().first = children;
+
+  if (frames_.empty()) {
+    // the root node also lives in the arena
+    json_node_data *root = static_cast<json_node_data*>(arena_.allocate(sizeof(json_node_data)));
+    *root = values_.back();
+    values_.clear();
+    root_ = root;
+  }
+}
+
+}
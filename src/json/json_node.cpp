@@ -0,0 +1,280 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/json_node.hpp"
+#include "json/json_object.hpp"
+#include "json/json_array.hpp"
+#include "json/json_string.hpp"
+#include "json/json_number.hpp"
+#include "json/json_bool.hpp"
+#include "json/json_null.hpp"
+#include "json/json_writer.hpp"
+
+#include <stdexcept>
+#include <cstring>
+
+namespace oos {
+
+namespace {
+
+const json_node_data null_data = { json_node::JSON_NULL, 0, { 0 } };
+
+}
+
+json_node::json_node()
+  : data_(&null_data)
+{}
+
+json_node::json_node(const json_node_data *data)
+  : data_(data ? data : &null_data)
+{}
+
+json_node::type_t json_node::type() const
+{
+  return static_cast<type_t>(data_->type & json_node_data::TYPE_MASK);
+}
+
+bool json_node::is_null() const
+{
+  return type() == JSON_NULL;
+}
+
+bool json_node::is_bool() const
+{
+  return type() == JSON_BOOL;
+}
+
+bool json_node::is_number() const
+{
+  return type() == JSON_NUMBER;
+}
+
+bool json_node::is_integer() const
+{
+  return is_number() && (data_->type & json_node_data::INTEGER) != 0;
+}
+
+bool json_node::is_string() const
+{
+  return type() == JSON_STRING;
+}
+
+bool json_node::is_array() const
+{
+  return type() == JSON_ARRAY;
+}
+
+bool json_node::is_object() const
+{
+  return type() == JSON_OBJECT;
+}
+
+json_node json_node::operator[](const std::string &key) const
+{
+  if (!is_object()) {
+    throw std::logic_error(std::string(type_name()) + " has no key access operator");
+  }
+  const json_node_data *m = member(key.data(), key.size());
+  if (!m) {
+    throw std::logic_error("json_object has no key " + key);
+  }
+  return json_node(m);
+}
+
+json_node json_node::operator[](size_t index) const
+{
+  if (!is_array()) {
+    throw std::logic_error(std::string(type_name()) + " has no index access operator");
+  }
+  if (index >= data_->size) {
+    throw std::logic_error("json_array index out of range");
+  }
+  return json_node(data_->first + index);
+}
+
+json_node json_node::find(const char *key, size_t len, bool &found) const
+{
+  const json_node_data *m = (is_object() ? member(key, len) : 0);
+  found = m != 0;
+  return json_node(m);
+}
+
+bool json_node::contains(const std::string &key) const
+{
+  return is_object() && member(key.data(), key.size()) != 0;
+}
+
+size_t json_node::size() const
+{
+  switch (type()) {
+    case JSON_STRING:
+    case JSON_ARRAY:
+    case JSON_OBJECT:
+      return data_->size;
+    default:
+      throw std::logic_error(std::string(type_name()) + " has no size method");
+  }
+}
+
+std::string json_node::key(size_t index) const
+{
+  if (!is_object() || index >= data_->size) {
+    throw std::logic_error("invalid json_object member");
+  }
+  const json_node_data *k = data_->first + 2 * index;
+  return std::string(k->str, k->size);
+}
+
+json_node json_node::value(size_t index) const
+{
+  if (!is_object() || index >= data_->size) {
+    throw std::logic_error("invalid json_object member");
+  }
+  return json_node(data_->first + 2 * index + 1);
+}
+
+bool json_node::as_bool() const
+{
+  if (!is_bool()) {
+    throw std::logic_error(std::string(type_name()) + " isn't a json_bool");
+  }
+  return data_->size != 0;
+}
+
+double json_node::as_number() const
+{
+  if (!is_number()) {
+    throw std::logic_error(std::string(type_name()) + " isn't a json_number");
+  }
+  if (data_->type & json_node_data::INTEGER) {
+    return static_cast<double>(data_->integer);
+  }
+  return data_->number;
+}
+
+long long json_node::as_integer() const
+{
+  if (!is_number()) {
+    throw std::logic_error(std::string(type_name()) + " isn't a json_number");
+  }
+  if (data_->type & json_node_data::INTEGER) {
+    return data_->integer;
+  }
+  return static_cast<long long>(data_->number);
+}
+
+std::string json_node::as_string() const
+{
+  if (!is_string()) {
+    throw std::logic_error(std::string(type_name()) + " isn't a json_string");
+  }
+  return std::string(data_->str, data_->size);
+}
+
+const char* json_node::c_str() const
+{
+  if (!is_string()) {
+    throw std::logic_error(std::string(type_name()) + " isn't a json_string");
+  }
+  return data_->str;
+}
+
+json_value json_node::to_value() const
+{
+  switch (type()) {
+    case JSON_BOOL:
+      return json_value(as_bool());
+    case JSON_NUMBER:
+      if (is_integer()) {
+        return json_value(data_->integer);
+      }
+      return json_value(data_->number);
+    case JSON_STRING:
+      return json_value(as_string());
+    case JSON_ARRAY:
+    {
+      json_value ary(new json_array);
+      for (size_t i = 0; i < data_->size; ++i) {
+        ary.push_back(json_node(data_->first + i).to_value());
+      }
+      return ary;
+    }
+    case JSON_OBJECT:
+    {
+      json_value obj(new json_object);
+      for (size_t i = 0; i < data_->size; ++i) {
+        obj[key(i)] = value(i).to_value();
+      }
+      return obj;
+    }
+    default:
+      return json_value(new json_null);
+  }
+}
+
+std::ostream& operator<<(std::ostream &str, const json_node &node)
+{
+  json_writer writer(str);
+  writer.value(node);
+  return str;
+}
+
+const char* json_node::type_name() const
+{
+  switch (type()) {
+    case JSON_BOOL:
+      return "json_bool";
+    case JSON_NUMBER:
+      return "json_number";
+    case JSON_STRING:
+      return "json_string";
+    case JSON_ARRAY:
+      return "json_array";
+    case JSON_OBJECT:
+      return "json_object";
+    default:
+      return "json_null";
+  }
+}
+
+const json_node_data* json_node::member(const char *key, size_t len) const
+{
+  const json_node_data *members = data_->first;
+  size_t n = data_->size;
+  if (data_->type & json_node_data::HASHED) {
+    // the hash index follows the members
+    const unsigned int *slots = reinterpret_cast<const unsigned int*>(members + 2 * n);
+    size_t mask = json_node_data::hash_capacity(n) - 1;
+    for (size_t i = json_node_data::hash(key, len) & mask; slots[i] != 0; i = (i + 1) & mask) {
+      const json_node_data *k = members + 2 * (slots[i] - 1);
+      if (k->size == len && std::memcmp(k->str, key, len) == 0) {
+        return k + 1;
+      }
+    }
+    return 0;
+  }
+  // the last member with a key wins like in json_object
+  for (size_t i = n; i > 0; --i) {
+    const json_node_data *k = members + 2 * (i - 1);
+    if (k->size == len && std::memcmp(k->str, key, len) == 0) {
+      return k + 1;
+    }
+  }
+  return 0;
+}
+
+}
@@ -1,4 +1,5 @@
 #include "json/json_null.hpp"
+#include "json/json_writer.hpp"
 
 namespace oos {
 
@@ -41,9 +42,9 @@ bool json_null::parse(std::istream &in)
   return true;
 }
 
-void json_null::print(std::ostream &out) const
+void json_null::write(json_writer &writer) const
 {
-  out << json_null::null_string;
+  writer.null();
 }
 
 }
@@ -1,4 +1,6 @@
 #include "json/json_number.hpp"
+#include "json/json_numeric.hpp"
+#include "json/json_writer.hpp"
 
 #include <stdexcept>
 
@@ -6,16 +8,29 @@ namespace oos {
 
 json_number::json_number()
   : json_type("json_number")
+  , is_integer_(false)
+  , integer_(0)
   , value_(0.0)
 {}
 
 json_number::json_number(double val)
   : json_type("json_number")
+  , is_integer_(false)
+  , integer_(0)
   , value_(val)
 {}
 
+json_number::json_number(long long val)
+  : json_type("json_number")
+  , is_integer_(true)
+  , integer_(val)
+  , value_(static_cast<double>(val))
+{}
+
 json_number::json_number(const json_number &x)
   : json_type("json_number")
+  , is_integer_(x.is_integer_)
+  , integer_(x.integer_)
   , value_(x.value_)
 {}
 
@@ -24,7 +39,9 @@ json_number::json_number(const json_value &x)
 {
   const json_number *n = x.value_type<json_number>();
   if (n) {
-    value_ = n->value();
+    is_integer_ = n->is_integer_;
+    integer_ = n->integer_;
+    value_ = n->value_;
   } else {
     throw std::logic_error("json_value isn't of type json_number");
   }
@@ -32,13 +49,21 @@ json_number::json_number(const json_value &x)
 
 json_number& json_number::operator=(const json_number &x)
 {
+  is_integer_ = x.is_integer_;
+  integer_ = x.integer_;
   value_ = x.value_;
   return *this;
 }
 
 json_number& json_number::operator=(double x)
 {
-  value_ = x;
+  value(x);
+  return *this;
+}
+
+json_number& json_number::operator=(long long x)
+{
+  integer(x);
   return *this;
 }
 
@@ -46,7 +71,9 @@ json_number& json_number::operator=(const json_value &x)
 {
   const json_number *n = x.value_type<json_number>();
   if (n) {
-    value_ = n->value();
+    is_integer_ = n->is_integer_;
+    integer_ = n->integer_;
+    value_ = n->value_;
   } else {
     throw std::logic_error("json_value isn't of type json_number");
   }
@@ -58,6 +85,9 @@ json_number::~json_number()
 
 bool json_number::operator<(const json_number &x) const
 {
+  if (is_integer_ && x.is_integer_) {
+    return integer_ < x.integer_;
+  }
   return value_ < x.value_;
 }
 
@@ -65,10 +95,13 @@ bool json_number::parse(std::istream &in)
 {
   // skip white
   in >> std::ws;
-  
-  in >> value_;
-  
-  char c = in.peek();
+
+  std::string buf;
+  int c = in.peek();
+  while (isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+    buf.push_back(static_cast<char>(in.get()));
+    c = in.peek();
+  }
   
   switch (c) {
     case ' ':
@@ -79,12 +112,30 @@ bool json_number::parse(std::istream &in)
     default:
       return false;
   }
+
+  bool is_integer = false;
+  long long integer = 0;
+  double real = 0.0;
+  const char *first = buf.data();
+  const char *last = first + buf.size();
+  if (json_parse_number(first, last, is_integer, integer, real) != last) {
+    return false;
+  }
+  if (is_integer) {
+    this->integer(integer);
+  } else {
+    value(real);
+  }
   return true;
 }
 
-void json_number::print(std::ostream &out) const
+void json_number::write(json_writer &writer) const
 {
-  out << value_;
+  if (is_integer_) {
+    writer.value(integer_);
+  } else {
+    writer.value(value_);
+  }
 }
 
 double json_number::value() const
@@ -94,7 +145,26 @@ double json_number::value() const
 
 void json_number::value(double val)
 {
+  is_integer_ = false;
+  integer_ = 0;
   value_ = val;
 }
 
+bool json_number::is_integer() const
+{
+  return is_integer_;
+}
+
+long long json_number::integer() const
+{
+  return (is_integer_ ? integer_ : static_cast<long long>(value_));
+}
+
+void json_number::integer(long long val)
+{
+  is_integer_ = true;
+  integer_ = val;
+  value_ = static_cast<double>(val);
+}
+
 }
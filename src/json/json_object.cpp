@@ -1,5 +1,6 @@
 #include "json/json_object.hpp"
 #include "json/json_string.hpp"
+#include "json/json_writer.hpp"
 
 #include <algorithm>
 
@@ -119,21 +120,19 @@ bool json_object::parse(std::istream &in)
   return in.eof();
 }
 
-void json_object::print(std::ostream &out) const
+void json_object::write(json_writer &writer) const
 {
-  out << "{ ";
+  writer.begin_object();
 
   t_string_value_map::const_iterator first = string_value_map_.begin();
   t_string_value_map::const_iterator last = string_value_map_.end();
 
-  while (first != last) {
-    out << first->first << " : " << first->second;
-    if (++first != last) {
-      out << ", ";
-    }
+  for (; first != last; ++first) {
+    writer.key(first->first.value());
+    writer.value(first->second);
   }
 
-  out << " }";
+  writer.end_object();
 }
 
 void json_object::clear()
@@ -0,0 +1,395 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/json_object_reader.hpp"
+
+#include "object/object.hpp"
+#include "object/object_store.hpp"
+#include "object/object_ptr.hpp"
+#include "object/object_proxy.hpp"
+#include "object/object_container.hpp"
+#include "object/object_exception.hpp"
+
+#include "tools/varchar.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace oos {
+
+json_object_reader::json_object_reader(object_store &ostore)
+  : generic_object_reader<json_object_reader>(this)
+  , ostore_(ostore)
+  , count_(0)
+  , next_(0)
+  , object_depth_(0)
+  , current_(0)
+{}
+
+json_object_reader::~json_object_reader()
+{}
+
+void json_object_reader::deserialize(object *o, const char *str, std::size_t len)
+{
+  reset();
+  object_depth_ = 1;
+  json_reader reader;
+  reader.feed(str, len);
+  reader.finish();
+  if (!next_object(reader)) {
+    // TODO: throw json_error instead
+    throw std::logic_error("json object expected");
+  }
+  next_ = 0;
+  o->deserialize(*this);
+}
+
+std::size_t json_object_reader::import(const char *type, std::istream &in)
+{
+  if (ostore_.find_prototype(type) == ostore_.end()) {
+    throw object_exception("unknown prototype type");
+  }
+  reset();
+  json_reader reader;
+  std::vector<char> chunk(CHUNK_SIZE);
+  std::size_t count = 0;
+  while (in.read(&chunk[0], chunk.size()) || in.gcount() > 0) {
+    reader.feed(&chunk[0], static_cast<std::size_t>(in.gcount()));
+    count += insert_objects(reader, type);
+  }
+  reader.finish();
+  count += insert_objects(reader, type);
+  return count;
+}
+
+std::size_t json_object_reader::import(const char *type, const char *str, std::size_t len)
+{
+  if (ostore_.find_prototype(type) == ostore_.end()) {
+    throw object_exception("unknown prototype type");
+  }
+  reset();
+  json_reader reader;
+  reader.feed(str, len);
+  reader.finish();
+  return insert_objects(reader, type);
+}
+
+void json_object_reader::read_value(const char *id, char &x)
+{
+  const member *m = find(id);
+  if (!m) {
+    return;
+  }
+  if (m->type == json_reader::TOKEN_STRING) {
+    x = (m->str.empty() ? '\0' : m->str[0]);
+  } else {
+    x = static_cast<char>(integer(m, x));
+  }
+}
+
+void json_object_reader::read_value(const char *id, float &x)
+{
+  double d = x;
+  read_value(id, d);
+  x = static_cast<float>(d);
+}
+
+void json_object_reader::read_value(const char *id, double &x)
+{
+  const member *m = find(id);
+  if (!m) {
+    return;
+  }
+  if (m->type == json_reader::TOKEN_NUMBER) {
+    x = m->number;
+  } else {
+    x = static_cast<double>(integer(m, static_cast<long long>(x)));
+  }
+}
+
+void json_object_reader::read_value(const char *id, short &x)
+{
+  x = static_cast<short>(integer(find(id), x));
+}
+
+void json_object_reader::read_value(const char *id, int &x)
+{
+  x = static_cast<int>(integer(find(id), x));
+}
+
+void json_object_reader::read_value(const char *id, long &x)
+{
+  x = static_cast<long>(integer(find(id), x));
+}
+
+void json_object_reader::read_value(const char *id, unsigned char &x)
+{
+  x = static_cast<unsigned char>(integer(find(id), x));
+}
+
+void json_object_reader::read_value(const char *id, unsigned short &x)
+{
+  x = static_cast<unsigned short>(integer(find(id), x));
+}
+
+void json_object_reader::read_value(const char *id, unsigned int &x)
+{
+  x = static_cast<unsigned int>(integer(find(id), x));
+}
+
+void json_object_reader::read_value(const char *id, unsigned long &x)
+{
+  const member *m = find(id);
+  if (m && m->type == json_reader::TOKEN_NUMBER) {
+    // values above the 64 bit integer range are read as real numbers
+    x = static_cast<unsigned long>(m->number);
+  } else {
+    x = static_cast<unsigned long>(integer(m, static_cast<long long>(x)));
+  }
+}
+
+void json_object_reader::read_value(const char *id, bool &x)
+{
+  x = integer(find(id), x) != 0;
+}
+
+void json_object_reader::read_value(const char *id, char *&x, int s)
+{
+  const member *m = find(id);
+  if (!m || s <= 0) {
+    return;
+  }
+  std::size_t len = 0;
+  if (m->type == json_reader::TOKEN_STRING) {
+    len = std::min(m->str.size(), static_cast<std::size_t>(s - 1));
+    memcpy(x, m->str.data(), len);
+  }
+  x[len] = '\0';
+}
+
+void json_object_reader::read_value(const char *id, std::string &x)
+{
+  const member *m = find(id);
+  if (!m) {
+    return;
+  }
+  if (m->type == json_reader::TOKEN_STRING) {
+    x = m->str;
+  } else if (m->type == json_reader::TOKEN_NULL) {
+    x.clear();
+  } else {
+    // TODO: throw json_error instead
+    throw std::logic_error(std::string("json string expected for field ") + id);
+  }
+}
+
+void json_object_reader::read_value(const char *id, varchar_base &x)
+{
+  const member *m = find(id);
+  if (!m) {
+    return;
+  }
+  if (m->type == json_reader::TOKEN_STRING) {
+    x.assign(m->str.data(), m->str.size());
+  } else if (m->type == json_reader::TOKEN_NULL) {
+    x.assign("", 0);
+  } else {
+    // TODO: throw json_error instead
+    throw std::logic_error(std::string("json string expected for field ") + id);
+  }
+}
+
+void json_object_reader::read_value(const char *id, object_base_ptr &x)
+{
+  const member *m = find(id);
+  if (!m) {
+    return;
+  }
+  long oid = static_cast<long>(m->type == json_reader::TOKEN_INTEGER ? m->integer : 0);
+  if (oid <= 0) {
+    x.reset();
+    return;
+  }
+  object_proxy *oproxy = ostore_.find_proxy(oid);
+  if (!oproxy) {
+    oproxy = ostore_.create_proxy(oid);
+  }
+  x.reset(oproxy->obj);
+}
+
+void json_object_reader::read_value(const char *id, object_container &x)
+{
+  const member *m = find(id);
+  if (!m) {
+    return;
+  }
+  x.reset();
+  for (std::vector<long>::const_iterator i = m->ids.begin(); i != m->ids.end(); ++i) {
+    object_proxy *oproxy = ostore_.find_proxy(*i);
+    if (!oproxy) {
+      oproxy = ostore_.create_proxy(*i);
+    }
+    x.append_proxy(oproxy);
+  }
+}
+
+void json_object_reader::reset()
+{
+  count_ = 0;
+  next_ = 0;
+  object_depth_ = 0;
+  current_ = 0;
+}
+
+bool json_object_reader::next_object(json_reader &reader)
+{
+  json_reader::token_t t;
+  while ((t = reader.next()) != json_reader::TOKEN_NEED_MORE && t != json_reader::TOKEN_END) {
+    std::size_t depth = reader.depth();
+    if (object_depth_ == 0) {
+      // the root decides between an array of objects and a single object
+      object_depth_ = (t == json_reader::TOKEN_BEGIN_ARRAY ? 2 : 1);
+      if (t == json_reader::TOKEN_BEGIN_ARRAY) {
+        continue;
+      }
+    }
+    switch (t) {
+      case json_reader::TOKEN_BEGIN_OBJECT:
+        if (depth == object_depth_) {
+          count_ = 0;
+          current_ = 0;
+        } else if (depth == object_depth_ + 1 && current_) {
+          // nested objects aren't mapped
+          current_->type = t;
+        }
+        break;
+      case json_reader::TOKEN_END_OBJECT:
+        if (depth + 1 == object_depth_) {
+          return true;
+        }
+        break;
+      case json_reader::TOKEN_KEY:
+        if (depth == object_depth_) {
+          if (count_ == members_.size()) {
+            members_.push_back(member());
+          }
+          current_ = &members_[count_++];
+          current_->key.assign(reader.data(), reader.length());
+          current_->type = json_reader::TOKEN_NULL;
+          current_->ids.clear();
+        }
+        break;
+      case json_reader::TOKEN_BEGIN_ARRAY:
+        if (depth == object_depth_) {
+          // TODO: throw json_error instead
+          throw std::logic_error("json object expected");
+        } else if (depth == object_depth_ + 1 && current_) {
+          current_->type = t;
+        }
+        break;
+      case json_reader::TOKEN_END_ARRAY:
+        break;
+      default:
+        if (depth + 1 == object_depth_) {
+          // TODO: throw json_error instead
+          throw std::logic_error("json object expected");
+        } else if (depth == object_depth_ && current_) {
+          current_->type = t;
+          switch (t) {
+            case json_reader::TOKEN_STRING:
+              current_->str.assign(reader.data(), reader.length());
+              break;
+            case json_reader::TOKEN_NUMBER:
+              current_->number = reader.as_number();
+              break;
+            case json_reader::TOKEN_INTEGER:
+              current_->integer = reader.as_integer();
+              break;
+            case json_reader::TOKEN_BOOL:
+              current_->boolean = reader.as_bool();
+              break;
+            default:
+              break;
+          }
+        } else if (depth == object_depth_ + 1 && current_ && current_->type == json_reader::TOKEN_BEGIN_ARRAY &&
+                   t == json_reader::TOKEN_INTEGER) {
+          current_->ids.push_back(static_cast<long>(reader.as_integer()));
+        }
+        break;
+    }
+  }
+  return false;
+}
+
+std::size_t json_object_reader::insert_objects(json_reader &reader, const char *type)
+{
+  std::size_t count = 0;
+  while (next_object(reader)) {
+    object *o = ostore_.create(type);
+    next_ = 0;
+    try {
+      o->deserialize(*this);
+    } catch (...) {
+      delete o;
+      throw;
+    }
+    ostore_.insert(o);
+    ++count;
+  }
+  return count;
+}
+
+const json_object_reader::member* json_object_reader::find(const char *id)
+{
+  // fields are usually read in the order they were written
+  for (std::size_t i = next_; i < count_; ++i) {
+    if (members_[i].key == id) {
+      next_ = i + 1;
+      return &members_[i];
+    }
+  }
+  for (std::size_t i = 0; i < next_ && i < count_; ++i) {
+    if (members_[i].key == id) {
+      next_ = i + 1;
+      return &members_[i];
+    }
+  }
+  return 0;
+}
+
+long long json_object_reader::integer(const member *m, long long def)
+{
+  if (!m) {
+    return def;
+  }
+  switch (m->type) {
+    case json_reader::TOKEN_INTEGER:
+      return m->integer;
+    case json_reader::TOKEN_NUMBER:
+      return static_cast<long long>(m->number);
+    case json_reader::TOKEN_BOOL:
+      return m->boolean ? 1 : 0;
+    case json_reader::TOKEN_NULL:
+      return def;
+    default:
+      // TODO: throw json_error instead
+      throw std::logic_error("json number expected for field " + m->key);
+  }
+}
+
+}
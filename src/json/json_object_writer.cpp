@@ -0,0 +1,104 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/json_object_writer.hpp"
+
+#include "object/object.hpp"
+#include "object/object_ptr.hpp"
+#include "object/object_container.hpp"
+
+#include "tools/varchar.hpp"
+
+#include <cstring>
+
+using namespace std::tr1::placeholders;
+
+namespace oos {
+
+json_object_writer::json_object_writer()
+  : generic_object_writer<json_object_writer>(this)
+  , writer_(0)
+{}
+
+json_object_writer::~json_object_writer()
+{}
+
+void json_object_writer::serialize(const object *o, json_writer &writer)
+{
+  writer_ = &writer;
+  writer.begin_object();
+  o->serialize(*this);
+  writer.end_object();
+  writer_ = 0;
+}
+
+void json_object_writer::serialize(const object *o, std::string &out)
+{
+  json_writer writer(json_writer::FORMAT_COMPACT);
+  serialize(o, writer);
+  out.append(writer.data(), writer.size());
+}
+
+void json_object_writer::write_value(const char *id, char x)
+{
+  writer_->key(id);
+  writer_->value(&x, x ? 1 : 0);
+}
+
+void json_object_writer::write_value(const char *id, const char *x, int s)
+{
+  writer_->key(id);
+  const char *end = static_cast<const char*>(memchr(x, 0, s));
+  writer_->value(x, end ? end - x : s);
+}
+
+void json_object_writer::write_value(const char *id, const std::string &x)
+{
+  writer_->key(id);
+  writer_->value(x);
+}
+
+void json_object_writer::write_value(const char *id, const varchar_base &x)
+{
+  writer_->key(id);
+  writer_->value(x.c_str(), x.size());
+}
+
+void json_object_writer::write_value(const char *id, const object_base_ptr &x)
+{
+  writer_->key(id);
+  if (x.id() == 0) {
+    writer_->null();
+  } else {
+    writer_->value(x.id());
+  }
+}
+
+void json_object_writer::write_value(const char *id, const object_container &x)
+{
+  writer_->key(id);
+  writer_->begin_array();
+  x.for_each(std::tr1::bind(&json_object_writer::write_container_item, this, _1));
+  writer_->end_array();
+}
+
+void json_object_writer::write_container_item(object *o)
+{
+  writer_->value(o->id());
+}
+
+}
@@ -3,6 +3,17 @@
 #include "json/json_array.hpp"
 
 #include <sstream>
+#include <cstring>
+
+#ifdef WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace oos {
 
@@ -15,12 +26,7 @@ json_parser::~json_parser()
 
 json_value json_parser::parse(std::istream &in)
 {
-  /*
-   * clear stack
-   */
-  while (!state_stack_.empty()) {
-    state_stack_.pop();
-  }
+  reset();
 
   /*
    * call parser
@@ -35,14 +41,72 @@ json_value json_parser::parse(std::istream &in)
 
 json_value json_parser::parse(std::string &str)
 {
-  std::istringstream in(str);
-  return parse(in);
+  return parse(str.data(), str.size());
 }
 
 json_value json_parser::parse(const char *str)
 {
-  std::istringstream in(str);
-  return parse(in);
+  return parse(str, strlen(str));
+}
+
+json_value json_parser::parse(const char *str, std::size_t len)
+{
+  reset();
+
+  parse_json(str, len);
+
+  return value_;
+}
+
+json_value json_parser::parse_file(const char *filename)
+{
+#ifdef WIN32
+  std::ifstream in(filename, std::ios::in | std::ios::binary);
+  if (!in) {
+    throw std::logic_error(std::string("couldn't open file ") + filename);
+  }
+  std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  return parse(content.data(), content.size());
+#else
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    throw std::logic_error(std::string("couldn't open file ") + filename);
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    close(fd);
+    throw std::logic_error(std::string("couldn't stat file ") + filename);
+  }
+  std::size_t len = st.st_size;
+  if (len == 0) {
+    close(fd);
+    return parse("", 0);
+  }
+  void *addr = mmap(0, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw std::logic_error(std::string("couldn't map file ") + filename);
+  }
+  madvise(addr, len, MADV_SEQUENTIAL);
+  try {
+    parse(static_cast<const char*>(addr), len);
+  } catch (...) {
+    munmap(addr, len);
+    throw;
+  }
+  munmap(addr, len);
+  return value_;
+#endif
+}
+
+void json_parser::reset()
+{
+  /*
+   * clear stack
+   */
+  while (!state_stack_.empty()) {
+    state_stack_.pop();
+  }
 }
 
 void json_parser::on_begin_object()
@@ -108,6 +172,15 @@ void json_parser::on_number(double value)
   }
 }
 
+void json_parser::on_integer(long long value)
+{
+  if (state_stack_.top().first) {
+    state_stack_.top().second[key_] = value;
+  } else {
+    state_stack_.top().second.push_back(value);
+  }
+}
+
 void json_parser::on_bool(bool value)
 {
   if (state_stack_.top().first) {
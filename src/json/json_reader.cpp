@@ -0,0 +1,448 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/json_reader.hpp"
+#include "json/json_scan.hpp"
+#include "json/json_numeric.hpp"
+
+#include <stdexcept>
+#include <cstring>
+#include <cctype>
+
+namespace oos {
+
+namespace {
+
+bool is_number_char(char c)
+{
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+}
+
+json_reader::json_reader()
+  : cur_(0)
+  , end_(0)
+  , external_(false)
+  , finished_(false)
+  , state_(STATE_ROOT)
+  , token_(TOKEN_NEED_MORE)
+  , scan_offset_(0)
+  , escaped_(false)
+  , str_(0)
+  , len_(0)
+  , number_(0.0)
+  , integer_(0)
+  , bool_(false)
+{}
+
+json_reader::~json_reader()
+{}
+
+void json_reader::feed(const char *data, std::size_t len)
+{
+  if (finished_) {
+    throw std::logic_error("json reader input is already finished");
+  }
+  if (cur_ == end_) {
+    // nothing left over, read directly from the chunk
+    buffer_.clear();
+    cur_ = data;
+    end_ = data + len;
+    external_ = true;
+    return;
+  }
+  if (external_) {
+    buffer_.assign(cur_, end_);
+    external_ = false;
+  } else {
+    // drop the bytes already read
+    buffer_.erase(buffer_.begin(), buffer_.begin() + (cur_ - &buffer_[0]));
+  }
+  buffer_.insert(buffer_.end(), data, data + len);
+  cur_ = &buffer_[0];
+  end_ = cur_ + buffer_.size();
+}
+
+void json_reader::finish()
+{
+  finished_ = true;
+}
+
+json_reader::token_t json_reader::next()
+{
+  for (;;) {
+    cur_ = json_skip_whitespace(cur_, end_);
+    if (cur_ == end_) {
+      if (!finished_) {
+        return need_more();
+      }
+      if (state_ == STATE_TRAILING || state_ == STATE_DONE) {
+        state_ = STATE_DONE;
+        return token_ = TOKEN_END;
+      }
+      // TODO: throw json_error instead
+      throw std::logic_error("unexpected end of json input");
+    }
+
+    char c = *cur_;
+    switch (state_) {
+      case STATE_ROOT:
+        if (c != '{' && c != '[') {
+          // TODO: throw json_error instead
+          throw std::logic_error("root must be either array '[]' or object '{}'");
+        }
+        return begin_container(c);
+      case STATE_FIRST_KEY:
+        if (c == '}') {
+          return end_container(c);
+        }
+        // fall through
+      case STATE_KEY:
+        if (c != '"') {
+          // TODO: throw json_error instead
+          throw std::logic_error("invalid json character");
+        }
+        if (read_string(TOKEN_KEY) == TOKEN_NEED_MORE) {
+          return TOKEN_NEED_MORE;
+        }
+        state_ = STATE_COLON;
+        return token_;
+      case STATE_COLON:
+        if (c != ':') {
+          // TODO: throw json_error instead
+          throw std::logic_error("character isn't colon");
+        }
+        ++cur_;
+        state_ = STATE_VALUE;
+        break;
+      case STATE_FIRST_VALUE:
+        if (c == ']') {
+          return end_container(c);
+        }
+        // fall through
+      case STATE_VALUE:
+        return read_value();
+      case STATE_NEXT:
+        if (c == ',') {
+          ++cur_;
+          state_ = (stack_.back() == '{' ? STATE_KEY : STATE_VALUE);
+        } else if (c == '}' || c == ']') {
+          return end_container(c);
+        } else {
+          // TODO: throw json_error instead
+          throw std::logic_error("invalid json character");
+        }
+        break;
+      case STATE_TRAILING:
+      case STATE_DONE:
+      default:
+        // TODO: throw json_error instead
+        throw std::logic_error("no characters are allowed after closed root node");
+    }
+  }
+}
+
+json_reader::token_t json_reader::token() const
+{
+  return token_;
+}
+
+std::size_t json_reader::depth() const
+{
+  return stack_.size();
+}
+
+const char* json_reader::data() const
+{
+  return str_;
+}
+
+std::size_t json_reader::length() const
+{
+  return len_;
+}
+
+std::string json_reader::as_string() const
+{
+  return std::string(str_, len_);
+}
+
+double json_reader::as_number() const
+{
+  return (token_ == TOKEN_INTEGER ? static_cast<double>(integer_) : number_);
+}
+
+long long json_reader::as_integer() const
+{
+  return integer_;
+}
+
+bool json_reader::as_bool() const
+{
+  return bool_;
+}
+
+std::size_t json_reader::memory_usage() const
+{
+  return buffer_.capacity() + string_.capacity() + stack_.capacity();
+}
+
+void json_reader::reset()
+{
+  cur_ = end_ = 0;
+  external_ = false;
+  finished_ = false;
+  state_ = STATE_ROOT;
+  token_ = TOKEN_NEED_MORE;
+  stack_.clear();
+  buffer_.clear();
+  scan_offset_ = 0;
+  escaped_ = false;
+  str_ = 0;
+  len_ = 0;
+}
+
+json_reader::token_t json_reader::need_more()
+{
+  if (external_) {
+    // keep the unread rest, the chunk is going to be reused
+    buffer_.assign(cur_, end_);
+    external_ = false;
+    cur_ = buffer_.empty() ? 0 : &buffer_[0];
+    end_ = cur_ + buffer_.size();
+  }
+  return token_ = TOKEN_NEED_MORE;
+}
+
+json_reader::token_t json_reader::begin_container(char c)
+{
+  ++cur_;
+  stack_.push_back(c);
+  if (c == '{') {
+    state_ = STATE_FIRST_KEY;
+    return token_ = TOKEN_BEGIN_OBJECT;
+  } else {
+    state_ = STATE_FIRST_VALUE;
+    return token_ = TOKEN_BEGIN_ARRAY;
+  }
+}
+
+json_reader::token_t json_reader::end_container(char c)
+{
+  if (stack_.back() != (c == '}' ? '{' : '[')) {
+    // TODO: throw json_error instead
+    throw std::logic_error(c == '}' ? "not a valid object closing bracket" : "not a valid array closing bracket");
+  }
+  ++cur_;
+  stack_.pop_back();
+  state_ = (stack_.empty() ? STATE_TRAILING : STATE_NEXT);
+  return token_ = (c == '}' ? TOKEN_END_OBJECT : TOKEN_END_ARRAY);
+}
+
+json_reader::token_t json_reader::read_value()
+{
+  token_t t = TOKEN_NEED_MORE;
+  switch (*cur_) {
+    case '{':
+    case '[':
+      return begin_container(*cur_);
+    case '"':
+      t = read_string(TOKEN_STRING);
+      break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      t = read_number();
+      break;
+    case 't':
+      t = read_literal("true", 4);
+      bool_ = true;
+      break;
+    case 'f':
+      t = read_literal("false", 5);
+      bool_ = false;
+      break;
+    case 'n':
+      t = read_literal("null", 4);
+      break;
+    default:
+      // TODO: throw json_error instead
+      throw std::logic_error("unknown json type");
+  }
+  if (t != TOKEN_NEED_MORE) {
+    state_ = STATE_NEXT;
+  }
+  return t;
+}
+
+json_reader::token_t json_reader::read_string(token_t type)
+{
+  const char *first = cur_ + 1;
+  const char *p = first + scan_offset_;
+  for (;;) {
+    const char *special = json_find_string_special(p, end_);
+    if (special == end_) {
+      p = special;
+      break;
+    }
+    if (*special == '"') {
+      if (escaped_) {
+        decode_string(first, special);
+        str_ = string_.data();
+        len_ = string_.size();
+      } else {
+        str_ = first;
+        len_ = special - first;
+      }
+      cur_ = special + 1;
+      scan_offset_ = 0;
+      escaped_ = false;
+      return token_ = type;
+    }
+    // validate the escape sequence once it is complete
+    if (end_ - special < 2) {
+      p = special;
+      break;
+    }
+    switch (special[1]) {
+      case '"':
+      case '\\':
+      case '/':
+      case 'b':
+      case 'f':
+      case 'n':
+      case 'r':
+      case 't':
+        p = special + 2;
+        break;
+      case 'u':
+        if (end_ - special < 6) {
+          scan_offset_ = special - first;
+          if (finished_) {
+            // TODO: throw json_error instead
+            throw std::logic_error("unterminated json string");
+          }
+          return need_more();
+        }
+        for (int i = 2; i < 6; ++i) {
+          if (!isxdigit(static_cast<unsigned char>(special[i]))) {
+            // TODO: throw json_error instead
+            throw std::logic_error("invalid json character");
+          }
+        }
+        p = special + 6;
+        break;
+      default:
+        // TODO: throw json_error instead
+        throw std::logic_error("invalid json character");
+    }
+    escaped_ = true;
+  }
+  if (finished_) {
+    // TODO: throw json_error instead
+    throw std::logic_error("unterminated json string");
+  }
+  // continue behind the last complete part of the string
+  scan_offset_ = p - first;
+  return need_more();
+}
+
+void json_reader::decode_string(const char *first, const char *last)
+{
+  string_.clear();
+  while (first != last) {
+    const char *special = json_find_string_special(first, last);
+    string_.append(first, special);
+    if (special == last) {
+      break;
+    }
+    char c = special[1];
+    first = special + 2;
+    switch (c) {
+      case 'b':
+        string_.push_back('\b');
+        break;
+      case 'f':
+        string_.push_back('\f');
+        break;
+      case 'n':
+        string_.push_back('\n');
+        break;
+      case 'r':
+        string_.push_back('\r');
+        break;
+      case 't':
+        string_.push_back('\t');
+        break;
+      case 'u':
+        // keep the four hex digits like the json parsers do
+        string_.append(special, 6);
+        first = special + 6;
+        break;
+      default:
+        string_.push_back(c);
+        break;
+    }
+  }
+}
+
+json_reader::token_t json_reader::read_number()
+{
+  const char *last = cur_;
+  while (last != end_ && is_number_char(*last)) {
+    ++last;
+  }
+  if (last == end_ && !finished_) {
+    return need_more();
+  }
+  bool is_integer = false;
+  if (json_parse_number(cur_, last, is_integer, integer_, number_) != last) {
+    // TODO: throw json_error instead
+    throw std::logic_error("invalid json number");
+  }
+  cur_ = last;
+  return token_ = (is_integer ? TOKEN_INTEGER : TOKEN_NUMBER);
+}
+
+json_reader::token_t json_reader::read_literal(const char *literal, std::size_t len)
+{
+  std::size_t available = end_ - cur_;
+  if (available < len) {
+    if (finished_ || std::memcmp(cur_, literal, available) != 0) {
+      // TODO: throw json_error instead
+      throw std::logic_error("invalid literal character");
+    }
+    return need_more();
+  }
+  if (std::memcmp(cur_, literal, len) != 0) {
+    // TODO: throw json_error instead
+    throw std::logic_error("invalid literal character");
+  }
+  cur_ += len;
+  return token_ = (literal[0] == 'n' ? TOKEN_NULL : TOKEN_BOOL);
+}
+
+}
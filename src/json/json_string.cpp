@@ -1,4 +1,5 @@
 #include "json/json_string.hpp"
+#include "json/json_writer.hpp"
 
 #include <cctype>
 
@@ -137,12 +138,12 @@ bool json_string::parse(std::istream &in)
   return true;
 }
 
-void json_string::print(std::ostream &out) const
+void json_string::write(json_writer &writer) const
 {
-  out << "\"" << value_ << "\"";
+  writer.value(value_);
 }
 
-std::string json_string::value() const
+const std::string& json_string::value() const
 {
   return value_;
 }
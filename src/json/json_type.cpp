@@ -1,4 +1,5 @@
 #include "json/json_type.hpp"
+#include "json/json_writer.hpp"
 
 #include <stdexcept>
 
@@ -56,6 +57,12 @@ std::istream& operator>>(std::istream &str, json_type &value)
 }
 */
 
+void json_type::print(std::ostream &out) const
+{
+  json_writer writer(out);
+  write(writer);
+}
+
 std::ostream& operator<<(std::ostream &str, const json_type &value)
 {
   value.print(str);
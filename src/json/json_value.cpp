@@ -5,6 +5,7 @@
 #include "json/json_null.hpp"
 #include "json/json_number.hpp"
 #include "json/json_array.hpp"
+#include "json/json_writer.hpp"
 
 #include <iostream>
 
@@ -33,6 +34,10 @@ json_value::json_value(const char *x)
 {}
 
 json_value::json_value(int x)
+  : type_(new json_number(static_cast<long long>(x)))
+{}
+
+json_value::json_value(long long x)
   : type_(new json_number(x))
 {}
 
@@ -74,6 +79,12 @@ json_value& json_value::operator=(double x)
   return *this;
 }
 
+json_value& json_value::operator=(long long x)
+{
+  type_.reset(new json_number(x));
+  return *this;
+}
+
 json_value& json_value::operator=(bool x)
 {
   type_.reset(new json_bool(x));
@@ -154,9 +165,15 @@ std::istream& operator>>(std::istream &str, json_value &value)
   return str;
 }
 
+void json_value::write(json_writer &writer) const
+{
+  type_->write(writer);
+}
+
 std::ostream& operator<<(std::ostream &str, const json_value &value)
 {
-  value.type_->print(str);
+  json_writer writer(str);
+  value.type_->write(writer);
   return str;
 }
 
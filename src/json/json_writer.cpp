@@ -0,0 +1,544 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "json/json_writer.hpp"
+#include "json/json_numeric.hpp"
+#include "json/json_value.hpp"
+#include "json/json_node.hpp"
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include <stdexcept>
+#include <cctype>
+#include <cstring>
+
+namespace oos {
+
+namespace {
+
+/*
+ * characters which must be escaped
+ * in a json string
+ */
+struct escape_table
+{
+  escape_table()
+  {
+    for (int i = 0; i < 256; ++i) {
+      escape[i] = (i < 0x20 || i == '"' || i == '\\');
+    }
+  }
+  bool escape[256];
+};
+
+const escape_table escapes;
+
+const char hex_digits[] = "0123456789abcdef";
+const char blanks[] = "                                ";
+
+bool is_unicode_escape(const char *str, const char *end)
+{
+  if (end - str < 6 || str[1] != 'u') {
+    return false;
+  }
+  for (int i = 2; i < 6; ++i) {
+    if (!isxdigit(static_cast<unsigned char>(str[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+json_writer::json_writer(format_t format)
+  : target_(TARGET_BUFFER)
+  , format_(format)
+  , buf_(0)
+  , size_(0)
+  , capacity_(0)
+  , overflow_(false)
+  , fd_(-1)
+  , out_(0)
+  , after_key_(false)
+{}
+
+json_writer::json_writer(char *buf, std::size_t size, format_t format)
+  : target_(TARGET_FIXED)
+  , format_(format)
+  , buf_(buf)
+  , size_(0)
+  , capacity_(size)
+  , overflow_(false)
+  , fd_(-1)
+  , out_(0)
+  , after_key_(false)
+{}
+
+json_writer::json_writer(int fd, format_t format)
+  : target_(TARGET_FD)
+  , format_(format)
+  , buf_(new char[BLOCK_SIZE])
+  , size_(0)
+  , capacity_(BLOCK_SIZE)
+  , overflow_(false)
+  , fd_(fd)
+  , out_(0)
+  , after_key_(false)
+{}
+
+json_writer::json_writer(std::ostream &out, format_t format)
+  : target_(TARGET_STREAM)
+  , format_(format)
+  , buf_(0)
+  , size_(0)
+  , capacity_(0)
+  , overflow_(false)
+  , fd_(-1)
+  , out_(&out)
+  , after_key_(false)
+{}
+
+json_writer::~json_writer()
+{
+  try {
+    flush();
+  } catch (...) {
+    // never throw from a destructor
+  }
+  if (target_ != TARGET_FIXED) {
+    delete [] buf_;
+  }
+}
+
+void json_writer::begin_object()
+{
+  begin_container('{');
+}
+
+void json_writer::end_object()
+{
+  end_container('}');
+}
+
+void json_writer::begin_array()
+{
+  begin_container('[');
+}
+
+void json_writer::end_array()
+{
+  end_container(']');
+}
+
+void json_writer::key(const char *str, std::size_t len)
+{
+  separate();
+  string(str, len);
+  switch (format_) {
+    case FORMAT_COMPACT:
+      put(':');
+      break;
+    case FORMAT_PRETTY:
+      put(": ", 2);
+      break;
+    default:
+      put(" : ", 3);
+      break;
+  }
+  after_key_ = true;
+}
+
+void json_writer::key(const char *str)
+{
+  key(str, strlen(str));
+}
+
+void json_writer::key(const std::string &str)
+{
+  key(str.data(), str.size());
+}
+
+void json_writer::value(const char *str, std::size_t len)
+{
+  separate();
+  string(str, len);
+}
+
+void json_writer::value(const char *str)
+{
+  value(str, strlen(str));
+}
+
+void json_writer::value(const std::string &str)
+{
+  value(str.data(), str.size());
+}
+
+void json_writer::value(double x)
+{
+  separate();
+  char buf[JSON_NUMBER_BUFFER_SIZE];
+  put(buf, json_format_number(x, buf));
+}
+
+void json_writer::value(int x)
+{
+  value(static_cast<long long>(x));
+}
+
+void json_writer::value(unsigned int x)
+{
+  value(static_cast<long long>(x));
+}
+
+void json_writer::value(long x)
+{
+  value(static_cast<long long>(x));
+}
+
+void json_writer::value(unsigned long x)
+{
+  value(static_cast<unsigned long long>(x));
+}
+
+void json_writer::value(long long x)
+{
+  separate();
+  char buf[JSON_NUMBER_BUFFER_SIZE];
+  put(buf, json_format_integer(x, buf));
+}
+
+void json_writer::value(unsigned long long x)
+{
+  separate();
+  char buf[JSON_NUMBER_BUFFER_SIZE];
+  char *end = buf + sizeof(buf);
+  char *p = end;
+  do {
+    *--p = static_cast<char>('0' + x % 10);
+    x /= 10;
+  } while (x != 0);
+  put(p, end - p);
+}
+
+void json_writer::value(bool x)
+{
+  separate();
+  if (x) {
+    put("true", 4);
+  } else {
+    put("false", 5);
+  }
+}
+
+void json_writer::value(const json_value &x)
+{
+  x.write(*this);
+}
+
+void json_writer::value(const json_node &x)
+{
+  node(x);
+}
+
+void json_writer::null()
+{
+  separate();
+  put("null", 4);
+}
+
+void json_writer::flush()
+{
+  if ((target_ == TARGET_FD || target_ == TARGET_STREAM) && size_ > 0) {
+    // reset the size first, a failing target must not be written twice
+    std::size_t size = size_;
+    size_ = 0;
+    write_target(buf_, size);
+  }
+}
+
+const char* json_writer::data() const
+{
+  return buf_ ? buf_ : "";
+}
+
+std::size_t json_writer::size() const
+{
+  return size_;
+}
+
+std::string json_writer::str() const
+{
+  return std::string(data(), size_);
+}
+
+void json_writer::clear()
+{
+  size_ = 0;
+  overflow_ = false;
+  empty_.clear();
+  after_key_ = false;
+}
+
+bool json_writer::overflow() const
+{
+  return overflow_;
+}
+
+json_writer::format_t json_writer::format() const
+{
+  return format_;
+}
+
+bool json_writer::make_room(std::size_t len)
+{
+  switch (target_) {
+    case TARGET_BUFFER:
+    {
+      std::size_t capacity = (capacity_ ? capacity_ * 2 : static_cast<std::size_t>(INITIAL_SIZE));
+      while (capacity - size_ < len) {
+        capacity *= 2;
+      }
+      char *buf = new char[capacity];
+      if (size_ > 0) {
+        std::memcpy(buf, buf_, size_);
+      }
+      delete [] buf_;
+      buf_ = buf;
+      capacity_ = capacity;
+      return true;
+    }
+    case TARGET_STREAM:
+      if (!buf_) {
+        // the stream buffer is allocated with the first output
+        buf_ = new char[BLOCK_SIZE];
+        capacity_ = BLOCK_SIZE;
+      }
+      // fall through
+    case TARGET_FD:
+      flush();
+      return capacity_ - size_ >= len;
+    case TARGET_FIXED:
+    default:
+      return false;
+  }
+}
+
+void json_writer::put_slow(const char *str, std::size_t len)
+{
+  if (target_ == TARGET_FIXED) {
+    std::size_t n = capacity_ - size_;
+    std::memcpy(buf_ + size_, str, n);
+    size_ += n;
+    overflow_ = true;
+  } else {
+    // larger than the whole buffer, the buffer is already flushed
+    write_target(str, len);
+  }
+}
+
+void json_writer::write_target(const char *str, std::size_t len)
+{
+  if (target_ == TARGET_STREAM) {
+    out_->write(str, len);
+    return;
+  }
+  while (len > 0) {
+#ifdef WIN32
+    int n = _write(fd_, str, static_cast<unsigned int>(len));
+#else
+    ssize_t n = ::write(fd_, str, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+#endif
+    if (n <= 0) {
+      throw std::runtime_error("couldn't write json output");
+    }
+    str += n;
+    len -= n;
+  }
+}
+
+void json_writer::separate()
+{
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (empty_.empty()) {
+    return;
+  }
+  if (empty_.back()) {
+    empty_.back() = false;
+    if (format_ == FORMAT_PRETTY) {
+      newline();
+    }
+  } else {
+    put(',');
+    if (format_ == FORMAT_PRETTY) {
+      newline();
+    } else if (format_ == FORMAT_INLINE) {
+      put(' ');
+    }
+  }
+}
+
+void json_writer::newline()
+{
+  put('\n');
+  std::size_t indent = 2 * empty_.size();
+  while (indent > 0) {
+    std::size_t n = (indent < sizeof(blanks) - 1 ? indent : sizeof(blanks) - 1);
+    put(blanks, n);
+    indent -= n;
+  }
+}
+
+void json_writer::begin_container(char c)
+{
+  separate();
+  put(c);
+  if (format_ == FORMAT_INLINE) {
+    put(' ');
+  }
+  empty_.push_back(true);
+}
+
+void json_writer::end_container(char c)
+{
+  if (empty_.empty()) {
+    throw std::logic_error("no open json container");
+  }
+  bool empty = empty_.back();
+  empty_.pop_back();
+  if (format_ == FORMAT_INLINE) {
+    put(' ');
+  } else if (format_ == FORMAT_PRETTY && !empty) {
+    newline();
+  }
+  put(c);
+}
+
+void json_writer::string(const char *str, std::size_t len)
+{
+  put('"');
+  const char *end = str + len;
+  while (str != end) {
+    // copy the runs without special characters at once
+    const char *first = str;
+    while (str != end && !escapes.escape[static_cast<unsigned char>(*str)]) {
+      ++str;
+    }
+    put(first, str - first);
+    if (str == end) {
+      break;
+    }
+    unsigned char c = static_cast<unsigned char>(*str);
+    if (c == '\\' && is_unicode_escape(str, end)) {
+      // unicode escapes are kept by the parsers
+      put(str, 6);
+      str += 6;
+      continue;
+    }
+    ++str;
+    char escape[6] = { '\\', 0, '0', '0', 0, 0 };
+    switch (c) {
+      case '"':
+      case '\\':
+        escape[1] = c;
+        put(escape, 2);
+        break;
+      case '\b':
+        escape[1] = 'b';
+        put(escape, 2);
+        break;
+      case '\f':
+        escape[1] = 'f';
+        put(escape, 2);
+        break;
+      case '\n':
+        escape[1] = 'n';
+        put(escape, 2);
+        break;
+      case '\r':
+        escape[1] = 'r';
+        put(escape, 2);
+        break;
+      case '\t':
+        escape[1] = 't';
+        put(escape, 2);
+        break;
+      default:
+        escape[1] = 'u';
+        escape[4] = hex_digits[c >> 4];
+        escape[5] = hex_digits[c & 0xf];
+        put(escape, 6);
+        break;
+    }
+  }
+  put('"');
+}
+
+void json_writer::node(const json_node &x)
+{
+  const json_node_data *data = x.data_;
+  switch (x.type()) {
+    case json_node::JSON_NULL:
+      null();
+      break;
+    case json_node::JSON_BOOL:
+      value(data->size != 0);
+      break;
+    case json_node::JSON_NUMBER:
+      if (x.is_integer()) {
+        value(data->integer);
+      } else {
+        value(data->number);
+      }
+      break;
+    case json_node::JSON_STRING:
+      value(data->str, data->size);
+      break;
+    case json_node::JSON_ARRAY:
+      begin_array();
+      for (std::size_t i = 0; i < data->size; ++i) {
+        node(json_node(data->first + i));
+      }
+      end_array();
+      break;
+    case json_node::JSON_OBJECT:
+      begin_object();
+      for (std::size_t i = 0; i < data->size; ++i) {
+        const json_node_data *member = data->first + 2 * i;
+        key(member->str, member->size);
+        node(json_node(member + 1));
+      }
+      end_object();
+      break;
+    default:
+      break;
+  }
+}
+
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "object/change_feed.hpp"
+#include "object/object.hpp"
+#include "object/object_proxy.hpp"
+#include "object/object_serializer.hpp"
+
+#include "tools/byte_buffer.hpp"
+
+namespace oos {
+
+change_feed::change_feed(size_type capacity, overflow_t overflow, bool payload)
+  : queue_(capacity)
+  , overflow_(overflow)
+  , payload_(payload)
+  , dropped_(0)
+{}
+
+change_feed::~change_feed()
+{}
+
+void change_feed::on_insert(object *o)
+{
+  push(change_record::CHANGE_INSERT, o);
+}
+
+void change_feed::on_update(object *o)
+{
+  push(change_record::CHANGE_UPDATE, o);
+}
+
+void change_feed::on_delete(object *o)
+{
+  push(change_record::CHANGE_DELETE, o);
+}
+
+bool change_feed::try_pop(change_record &record)
+{
+  return queue_.try_pop(record);
+}
+
+void change_feed::pop(change_record &record)
+{
+  queue_.pop(record);
+}
+
+change_feed::size_type change_feed::capacity() const
+{
+  return queue_.capacity();
+}
+
+change_feed::size_type change_feed::size() const
+{
+  return queue_.size();
+}
+
+unsigned long change_feed::dropped() const
+{
+#ifdef WIN32
+  return dropped_;
+#else
+  return __atomic_load_n(&dropped_, __ATOMIC_RELAXED);
+#endif
+}
+
+change_feed::overflow_t change_feed::overflow() const
+{
+  return overflow_;
+}
+
+bool change_feed::payload() const
+{
+  return payload_;
+}
+
+void change_feed::push(change_record::operation_t op, object *o)
+{
+  change_record record;
+  record.op = op;
+  record.id = o->id();
+  record.node = (o->proxy_ ? o->proxy_->node : 0);
+
+  if (payload_) {
+    /*
+     * each call uses its own buffer and serializer
+     * so several stores may write to the feed
+     * at the same time
+     */
+    byte_buffer buffer;
+    object_serializer serializer;
+    serializer.serialize(o, buffer);
+    record.payload.resize(buffer.size());
+    if (!record.payload.empty()) {
+      buffer.release(&record.payload[0], record.payload.size());
+    }
+  }
+
+  if (overflow_ == BLOCK_ON_FULL) {
+    queue_.push(record);
+  } else if (!queue_.try_push(record)) {
+#ifdef WIN32
+    InterlockedIncrement((volatile LONG*)&dropped_);
+#else
+    __atomic_add_fetch(&dropped_, 1, __ATOMIC_RELAXED);
+#endif
+  }
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "object/memory_report.hpp"
+
+#include <ostream>
+#include <iomanip>
+
+namespace oos {
+
+prototype_memory::prototype_memory()
+  : objects(0)
+  , loaded(0)
+  , object_size(0)
+  , object_bytes(0)
+  , heap_bytes(0)
+  , proxy_bytes(0)
+  , pointer_bytes(0)
+{}
+
+std::size_t prototype_memory::total() const
+{
+  return object_bytes + heap_bytes + proxy_bytes + pointer_bytes;
+}
+
+memory_report::memory_report()
+  : id_map_bytes(0)
+{}
+
+const prototype_memory* memory_report::find(const std::string &type) const
+{
+  for (t_prototype_memory_vector::const_iterator i = prototypes.begin(); i != prototypes.end(); ++i) {
+    if (i->type == type) {
+      return &*i;
+    }
+  }
+  return 0;
+}
+
+std::size_t memory_report::total() const
+{
+  std::size_t bytes = id_map_bytes;
+  for (t_prototype_memory_vector::const_iterator i = prototypes.begin(); i != prototypes.end(); ++i) {
+    bytes += i->total();
+  }
+  return bytes;
+}
+
+void memory_report::write(std::ostream &out) const
+{
+  out << std::left << std::setw(24) << "type" << std::right
+      << std::setw(10) << "objects"
+      << std::setw(10) << "loaded"
+      << std::setw(8) << "size"
+      << std::setw(12) << "bytes"
+      << std::setw(12) << "heap"
+      << std::setw(12) << "proxies"
+      << std::setw(12) << "pointers"
+      << std::setw(12) << "total" << "\n";
+  prototype_memory sum;
+  for (t_prototype_memory_vector::const_iterator i = prototypes.begin(); i != prototypes.end(); ++i) {
+    out << std::left << std::setw(24) << i->type << std::right
+        << std::setw(10) << i->objects
+        << std::setw(10) << i->loaded
+        << std::setw(8) << i->object_size
+        << std::setw(12) << i->object_bytes
+        << std::setw(12) << i->heap_bytes
+        << std::setw(12) << i->proxy_bytes
+        << std::setw(12) << i->pointer_bytes
+        << std::setw(12) << i->total() << "\n";
+    sum.objects += i->objects;
+    sum.loaded += i->loaded;
+    sum.object_bytes += i->object_bytes;
+    sum.heap_bytes += i->heap_bytes;
+    sum.proxy_bytes += i->proxy_bytes;
+    sum.pointer_bytes += i->pointer_bytes;
+  }
+  out << std::left << std::setw(24) << "id map" << std::right
+      << std::setw(76) << ""
+      << std::setw(12) << id_map_bytes << "\n";
+  out << std::left << std::setw(24) << "total" << std::right
+      << std::setw(10) << sum.objects
+      << std::setw(10) << sum.loaded
+      << std::setw(8) << ""
+      << std::setw(12) << sum.object_bytes
+      << std::setw(12) << sum.heap_bytes
+      << std::setw(12) << sum.proxy_bytes
+      << std::setw(12) << sum.pointer_bytes
+      << std::setw(12) << total() << "\n";
+}
+
+}
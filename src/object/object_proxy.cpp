@@ -34,6 +34,8 @@ object_proxy::object_proxy(object_store *os)
   , ptr_count(0)
   , ostore(os)
   , node(0)
+  , index(0)
+  , referenced(false)
 {}
 
 object_proxy::object_proxy(long i, object_store *os)
@@ -45,6 +47,8 @@ object_proxy::object_proxy(long i, object_store *os)
   , ptr_count(0)
   , ostore(os)
   , node(0)
+  , index(0)
+  , referenced(false)
 {}
 
 object_proxy::object_proxy(object *o, object_store *os)
@@ -56,6 +60,8 @@ object_proxy::object_proxy(object *o, object_store *os)
   , ptr_count(0)
   , ostore(os)
   , node(0)
+  , index(0)
+  , referenced(false)
 {}
 
 object_proxy::~object_proxy()
@@ -136,6 +142,7 @@ bool object_proxy::linked() const
 
 void object_proxy::reset(object *o)
 {
+  referenced = false;
   ref_count = 0;
   ptr_count = 0;
   id = o->id();
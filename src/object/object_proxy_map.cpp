@@ -0,0 +1,302 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "object/object_proxy_map.hpp"
+
+#include <algorithm>
+
+namespace oos {
+
+object_proxy_map::object_proxy_map()
+  : directory_limit_(0)
+  , pages_(0)
+  , hash_(0)
+  , hash_capacity_(0)
+  , hash_size_(0)
+  , size_(0)
+  , max_id_(0)
+{}
+
+object_proxy_map::~object_proxy_map()
+{
+  clear();
+}
+
+bool object_proxy_map::insert(long id, object_proxy *proxy)
+{
+  if (id == 0 || !proxy) {
+    return false;
+  }
+  if (in_directory(id)) {
+    size_type index = static_cast<unsigned long>(id) >> PAGE_SHIFT;
+    page_entry &entry = directory_[index];
+    if (entry.slots) {
+      object_proxy *&slot = entry.slots[id & PAGE_MASK];
+      if (slot) {
+        return false;
+      }
+      slot = proxy;
+      ++entry.count;
+    } else {
+      if (!hash_insert(id, proxy)) {
+        return false;
+      }
+      if (++entry.count >= PAGE_THRESHOLD) {
+        allocate_page(index);
+      }
+    }
+  } else if (!hash_insert(id, proxy)) {
+    return false;
+  }
+  ++size_;
+  if (id > max_id_) {
+    max_id_ = id;
+  }
+  return true;
+}
+
+bool object_proxy_map::erase(long id)
+{
+  if (id == 0) {
+    return false;
+  }
+  size_type index = static_cast<unsigned long>(id) >> PAGE_SHIFT;
+  if (id > 0 && index < directory_.size()) {
+    page_entry &entry = directory_[index];
+    if (entry.slots) {
+      object_proxy *&slot = entry.slots[id & PAGE_MASK];
+      if (!slot) {
+        return false;
+      }
+      slot = 0;
+      if (--entry.count == 0) {
+        release_page(index);
+      }
+    } else {
+      if (!hash_erase(id)) {
+        return false;
+      }
+      --entry.count;
+    }
+  } else if (!hash_erase(id)) {
+    return false;
+  }
+  --size_;
+  return true;
+}
+
+void object_proxy_map::clear()
+{
+  for (size_type i = 0; i < directory_.size(); ++i) {
+    delete [] directory_[i].slots;
+  }
+  t_page_directory().swap(directory_);
+  delete [] hash_;
+  hash_ = 0;
+  hash_capacity_ = 0;
+  hash_size_ = 0;
+  directory_limit_ = 0;
+  pages_ = 0;
+  size_ = 0;
+  max_id_ = 0;
+}
+
+void object_proxy_map::reserve(size_type n)
+{
+  size_type pages = ((max_id_ > 0 ? max_id_ : 0) + n) >> PAGE_SHIFT;
+  directory_limit_ = std::max(directory_limit_, pages + 1);
+  directory_.reserve(directory_limit_);
+}
+
+object_proxy_map::size_type object_proxy_map::size() const
+{
+  return size_;
+}
+
+bool object_proxy_map::empty() const
+{
+  return size_ == 0;
+}
+
+object_proxy_map::size_type object_proxy_map::memory_usage() const
+{
+  return sizeof(object_proxy_map)
+       + directory_.capacity() * sizeof(page_entry)
+       + pages_ * PAGE_SIZE * sizeof(object_proxy*)
+       + hash_capacity_ * sizeof(hash_slot);
+}
+
+bool object_proxy_map::in_directory(long id)
+{
+  if (id <= 0) {
+    return false;
+  }
+  size_type index = static_cast<unsigned long>(id) >> PAGE_SHIFT;
+  if (index < directory_.size()) {
+    return true;
+  }
+  /*
+   * the directory may grow up to a minimum size,
+   * a reserved size or as long as the ids are
+   * dense enough (a quarter of the covered ids
+   * are in use)
+   */
+  size_type limit = std::max<size_type>(MIN_DIRECTORY_SIZE, directory_limit_);
+  limit = std::max(limit, 4 * ((size_ >> PAGE_SHIFT) + 1));
+  if (index >= limit) {
+    return false;
+  }
+  size_type first = directory_.size();
+  directory_.resize(std::max(index + 1, std::min(2 * first, limit)));
+  /*
+   * count entries stored in the hash table
+   * which belong to the newly covered pages
+   */
+  for (size_type i = 0; hash_size_ > 0 && i < hash_capacity_; ++i) {
+    if (hash_[i].id <= 0) {
+      continue;
+    }
+    size_type j = static_cast<unsigned long>(hash_[i].id) >> PAGE_SHIFT;
+    if (j >= first && j < directory_.size()) {
+      ++directory_[j].count;
+    }
+  }
+  return true;
+}
+
+void object_proxy_map::allocate_page(size_type index)
+{
+  page_entry &entry = directory_[index];
+  entry.slots = new object_proxy*[PAGE_SIZE]();
+  entry.count = 0;
+  ++pages_;
+  // move all entries of the page from the hash table
+  long first = static_cast<long>(index << PAGE_SHIFT);
+  for (long id = first; hash_size_ > 0 && id < first + PAGE_SIZE; ++id) {
+    object_proxy *proxy = hash_find(id);
+    if (proxy) {
+      entry.slots[id & PAGE_MASK] = proxy;
+      ++entry.count;
+      hash_erase(id);
+    }
+  }
+}
+
+void object_proxy_map::release_page(size_type index)
+{
+  delete [] directory_[index].slots;
+  directory_[index].slots = 0;
+  --pages_;
+}
+
+object_proxy* object_proxy_map::hash_find(long id) const
+{
+  if (hash_size_ == 0 || id == 0) {
+    return 0;
+  }
+  size_type mask = hash_capacity_ - 1;
+  for (size_type i = hash_index(id); hash_[i].id != 0; i = (i + 1) & mask) {
+    if (hash_[i].id == id) {
+      return hash_[i].proxy;
+    }
+  }
+  return 0;
+}
+
+bool object_proxy_map::hash_insert(long id, object_proxy *proxy)
+{
+  if ((hash_size_ + 1) * 4 > hash_capacity_ * 3) {
+    hash_resize(std::max<size_type>(MIN_HASH_CAPACITY, hash_capacity_ * 2));
+  }
+  size_type mask = hash_capacity_ - 1;
+  size_type i = hash_index(id);
+  while (hash_[i].id != 0) {
+    if (hash_[i].id == id) {
+      return false;
+    }
+    i = (i + 1) & mask;
+  }
+  hash_[i].id = id;
+  hash_[i].proxy = proxy;
+  ++hash_size_;
+  return true;
+}
+
+bool object_proxy_map::hash_erase(long id)
+{
+  if (hash_size_ == 0) {
+    return false;
+  }
+  size_type mask = hash_capacity_ - 1;
+  size_type i = hash_index(id);
+  while (hash_[i].id != id) {
+    if (hash_[i].id == 0) {
+      return false;
+    }
+    i = (i + 1) & mask;
+  }
+  /*
+   * shift back the following entries of the
+   * probe sequence instead of leaving a tombstone
+   */
+  size_type j = i;
+  for (;;) {
+    j = (j + 1) & mask;
+    if (hash_[j].id == 0) {
+      break;
+    }
+    size_type k = hash_index(hash_[j].id);
+    if ((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) {
+      continue;
+    }
+    hash_[i] = hash_[j];
+    i = j;
+  }
+  hash_[i].id = 0;
+  hash_[i].proxy = 0;
+  --hash_size_;
+  return true;
+}
+
+void object_proxy_map::hash_resize(size_type capacity)
+{
+  hash_slot *old_hash = hash_;
+  size_type old_capacity = hash_capacity_;
+
+  hash_ = new hash_slot[capacity]();
+  hash_capacity_ = capacity;
+  hash_size_ = 0;
+
+  for (size_type i = 0; i < old_capacity; ++i) {
+    if (old_hash[i].id != 0) {
+      hash_insert(old_hash[i].id, old_hash[i].proxy);
+    }
+  }
+  delete [] old_hash;
+}
+
+object_proxy_map::size_type object_proxy_map::hash_index(long id) const
+{
+  // finalizer of murmur hash 3
+  unsigned long long h = static_cast<unsigned long long>(id);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<size_type>(h) & (hash_capacity_ - 1);
+}
+
+}
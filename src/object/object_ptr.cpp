@@ -158,6 +158,8 @@ object_base_ptr::reset(const object *o)
       }
       proxy_->add(this);
     }
+  } else {
+    proxy_ = 0;
   }
   id_ = (proxy_ ? proxy_->id : 0);
 }
@@ -186,13 +188,20 @@ void object_base_ptr::id(long i)
 object*
 object_base_ptr::ptr() const
 {
-  return (proxy_ ? proxy_->obj : NULL);
+  return lookup_object();
 }
 
 object*
 object_base_ptr::lookup_object() const
 {
-  return (proxy_ ? proxy_->obj : NULL);
+  if (!proxy_) {
+    return NULL;
+  } else if (proxy_->ostore) {
+    // reloads the object if it was evicted
+    return proxy_->ostore->lookup_object(proxy_);
+  } else {
+    return proxy_->obj;
+  }
 }
 
 bool object_base_ptr::is_reference() const
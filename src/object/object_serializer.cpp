@@ -77,7 +77,7 @@ void object_serializer::write_value(const char*, const varchar_base &s)
   size_t len = s.size();
   
   buffer_->append(&len, sizeof(len));
-  buffer_->append(s.str().c_str(), len);
+  buffer_->append(s.data(), len);
 }
 
 void object_serializer::write_value(const char*, const object_base_ptr &x)
@@ -118,10 +118,16 @@ void object_serializer::read_value(const char*, varchar_base &s)
 {
   size_t len = 0;
   buffer_->release(&len, sizeof(len));
-  char *str = new char[len];
-  buffer_->release(str, len);
-  s.assign(str, len);
-  delete [] str;
+  if (len <= s.capacity()) {
+    // read directly into the varchar storage
+    s.resize(len);
+    buffer_->release(s.data(), len);
+  } else {
+    char *str = new char[len];
+    buffer_->release(str, len);
+    s.assign(str, len);
+    delete [] str;
+  }
 }
 
 void object_serializer::read_value(const char*, object_base_ptr &x)
@@ -25,8 +25,11 @@
 #include "object/object_creator.hpp"
 #include "object/object_deleter.hpp"
 #include "object/object_exception.hpp"
+#include "object/object_loader.hpp"
 #include "object/prototype_node.hpp"
 
+#include "tools/metrics.hpp"
+
 #ifdef WIN32
 #include <functional>
 #include <memory>
@@ -38,14 +41,87 @@
 #include <iostream>
 #include <iomanip>
 #include <typeinfo>
+#include <stdexcept>
 #include <algorithm>
 #include <stack>
+#include <map>
 
 using namespace std;
 using namespace std::tr1::placeholders;
 
 namespace oos {
 
+namespace {
+
+/*
+ * estimated sizes of the memory used by the
+ * standard containers: a tree node holds three
+ * links and the color, a list node two links and
+ * a string keeps up to 15 characters inside
+ * the string object
+ */
+const std::size_t TREE_NODE_OVERHEAD = 4 * sizeof(void*);
+const std::size_t LIST_NODE_OVERHEAD = 2 * sizeof(void*);
+const std::string::size_type SHORT_STRING_CAPACITY = 15;
+
+std::size_t string_heap_bytes(const std::string &x)
+{
+  return (x.capacity() > SHORT_STRING_CAPACITY ? x.capacity() + 1 : 0);
+}
+
+/*
+ * estimates the bytes an object holds outside
+ * of its own memory: the characters of long
+ * strings and the elements of containers.
+ * varchars keep their characters inside the
+ * object, the items of containers are counted
+ * by their own prototype.
+ */
+class heap_estimator : public generic_object_writer<heap_estimator>
+{
+public:
+  heap_estimator()
+    : generic_object_writer<heap_estimator>(this)
+    , bytes_(0)
+  {}
+  virtual ~heap_estimator() {}
+
+  std::size_t estimate(const object *o)
+  {
+    bytes_ = 0;
+    o->serialize(*this);
+    return bytes_;
+  }
+
+  template < class T >
+  void write_value(const char*, const T&) {}
+
+  void write_value(const char*, const char*, int) {}
+
+  void write_value(const char*, const std::string &x)
+  {
+    bytes_ += string_heap_bytes(x);
+  }
+
+  void write_value(const char*, const object_container &x)
+  {
+    bytes_ += x.size() * (LIST_NODE_OVERHEAD + sizeof(object_base_ptr));
+  }
+
+private:
+  std::size_t bytes_;
+};
+
+metric_counter& prototype_counter(metric_counter *&counter, const char *name, const prototype_node *node)
+{
+  if (!counter) {
+    counter = &metrics::instance().counter(name, node->type);
+  }
+  return *counter;
+}
+
+}
+
 class relation_handler : public generic_object_writer<relation_handler>
 {
 public:
@@ -79,6 +155,48 @@ private:
   prototype_node *node_;
 };
 
+/*
+ * detects object pointers, references
+ * and containers of an object
+ */
+class reference_detector : public generic_object_reader<reference_detector>
+{
+public:
+  reference_detector()
+    : generic_object_reader<reference_detector>(this)
+    , found(false)
+  {}
+  virtual ~reference_detector() {}
+
+  template < class T >
+  void read_value(const char*, T&) {}
+
+  void read_value(const char*, char*, int) {}
+
+  void read_value(const char*, object_base_ptr&) { found = true; }
+  void read_value(const char*, object_container&) { found = true; }
+
+  bool found;
+};
+
+/*
+ * objects holding object pointers or containers
+ * can't be reloaded with their links, so they are
+ * never evicted. the kind of a prototype is
+ * determined once with a fresh prototype object
+ */
+prototype_node::eviction_t resolve_eviction(prototype_node *node)
+{
+  if (node->eviction == prototype_node::EVICTION_UNKNOWN && node->producer) {
+    object *o = node->producer->create();
+    reference_detector detector;
+    o->deserialize(detector);
+    delete o;
+    node->eviction = (detector.found ? prototype_node::EVICTION_NEVER : prototype_node::EVICTION_ALLOWED);
+  }
+  return node->eviction;
+}
+
 /*
 class equal_type : public std::unary_function<const prototype_node*, bool> {
 public:
@@ -180,9 +298,20 @@ void prototype_iterator::decrement()
 
 object_store::object_store()
   : root_(new prototype_node(new object_producer<object>, "object", true))
+  , typed_observer_count_(0)
+  , batch_depth_(0)
   , first_(new object_proxy(this))
   , last_(new object_proxy(this))
   , object_deleter_(new object_deleter)
+  , loader_(0)
+  , cache_budget_(0)
+  , cache_size_(0)
+  , cache_retry_(0)
+  , cache_hits_(0)
+  , cache_misses_(0)
+  , cache_evictions_(0)
+  , clock_hand_(0)
+  , metrics_(*this)
 {
   prototype_map_.insert(std::make_pair("object", root_));
   typeid_prototype_map_[root_->producer->classname()]["object"] = root_;
@@ -203,6 +332,27 @@ object_store::~object_store()
   delete object_deleter_;
 }
 
+object_store::store_metrics::store_metrics(const object_store &store)
+  : store_(store)
+{
+  metrics::instance().register_source(this);
+}
+
+object_store::store_metrics::~store_metrics()
+{
+  metrics::instance().unregister_source(this);
+}
+
+void object_store::store_metrics::collect(metrics_snapshot &snapshot) const
+{
+  long long proxies = static_cast<long long>(store_.object_map_.size());
+  snapshot.gauge("object_store_proxies", "", proxies);
+  snapshot.gauge("object_store_proxy_bytes", "", proxies * static_cast<long long>(sizeof(object_proxy)));
+  // estimated by the object sizes of the producers
+  snapshot.gauge("object_store_object_bytes", "", static_cast<long long>(store_.cache_size_));
+  snapshot.gauge("object_store_pinned_bytes", "", static_cast<long long>(store_.cache_pinned()));
+}
+
 prototype_iterator
 object_store::insert_prototype(object_base_producer *producer, const char *type, bool abstract, const char *parent)
 {
@@ -299,6 +449,8 @@ bool object_store::clear_prototype(const char *type, bool recursive)
 
   node->clear();
 
+  recount_cache();
+
   return true;
 }
 
@@ -319,6 +471,8 @@ bool object_store::remove_prototype(const char *type)
   }
   // and objects they're containing 
   node->clear();
+  // and the observers registered for it
+  typed_observer_count_ -= node->observers.size();
   // delete prototype node as well
   // unlink node
   node->unlink();
@@ -340,6 +494,8 @@ bool object_store::remove_prototype(const char *type)
   // delete node
   delete node;
 
+  recount_cache();
+
   return true;
 }
 
@@ -408,6 +564,72 @@ void object_store::clear(bool full)
     clear_prototype(root_->type.c_str(), true);
   }
   object_map_.clear();
+  recount_cache();
+}
+
+void object_store::reserve(std::size_t n)
+{
+  object_map_.reserve(n);
+}
+
+void object_store::cache_budget(std::size_t bytes)
+{
+  cache_budget_ = bytes;
+  cache_retry_ = 0;
+  if (cache_budget_ > 0 && cache_size_ > cache_budget_) {
+    evict(0);
+  }
+}
+
+std::size_t object_store::cache_budget() const
+{
+  return cache_budget_;
+}
+
+std::size_t object_store::cache_size() const
+{
+  return cache_size_;
+}
+
+std::size_t object_store::cache_pinned() const
+{
+  std::size_t pinned = 0;
+  prototype_node *node = root_;
+  while (node) {
+    if (node->producer && node->count > node->evicted && resolve_eviction(node) == prototype_node::EVICTION_NEVER) {
+      pinned += (node->count - node->evicted) * node->producer->size();
+    }
+    node = node->next_node();
+  }
+  return pinned;
+}
+
+unsigned long object_store::cache_hits() const
+{
+  return cache_hits_;
+}
+
+unsigned long object_store::cache_misses() const
+{
+  return cache_misses_;
+}
+
+unsigned long object_store::cache_evictions() const
+{
+  return cache_evictions_;
+}
+
+void object_store::loader(object_loader *l)
+{
+  if (loader_ && loader_ != l) {
+    restore_evicted();
+  }
+  loader_ = l;
+}
+
+object_loader* object_store::loader() const
+{
+  return loader_;
 }
 
 bool object_store::empty() const
@@ -425,8 +647,13 @@ int depth(prototype_node *node)
   return d;
 }
 
-void object_store::dump_prototypes(std::ostream &out) const
+void object_store::dump_prototypes(std::ostream &out, bool memory) const
 {
+  memory_report report;
+  if (memory) {
+    report = memory_usage();
+  }
+  memory_report::t_prototype_memory_vector::size_type index = 0;
   prototype_node *node = root_;
 //  out << "dumping prototype tree:\n";
   out << "digraph G {\n";
@@ -436,12 +663,51 @@ void object_store::dump_prototypes(std::ostream &out) const
   do {
     int d = depth(node);
     for (int i = 0; i < d; ++i) out << " ";
-    out << *node;
+    node->dump(out, (memory ? &report.prototypes[index++] : 0));
     node = node->next_node();
   } while (node);
   out << "}" << std::endl;
 }
 
+memory_report object_store::memory_usage() const
+{
+  memory_report report;
+  report.id_map_bytes = object_map_.memory_usage();
+
+  heap_estimator estimator;
+  prototype_node *node = root_;
+  do {
+    prototype_memory memory;
+    memory.type = node->type;
+    memory.object_size = (node->producer ? node->producer->size() : 0);
+    memory.proxy_bytes = node->proxies.capacity() * sizeof(object_proxy*);
+    for (prototype_node::proxy_vector_t::const_iterator i = node->proxies.begin(); i != node->proxies.end(); ++i) {
+      const object_proxy *proxy = *i;
+      if (!proxy) {
+        continue;
+      }
+      ++memory.objects;
+      memory.proxy_bytes += sizeof(object_proxy);
+      memory.pointer_bytes += proxy->ptr_set_.size() * (TREE_NODE_OVERHEAD + sizeof(object_base_ptr*));
+      object_proxy::string_object_list_map_t::const_iterator first = proxy->relations.begin();
+      object_proxy::string_object_list_map_t::const_iterator last = proxy->relations.end();
+      for (; first != last; ++first) {
+        memory.pointer_bytes += TREE_NODE_OVERHEAD + sizeof(*first) + string_heap_bytes(first->first);
+        memory.pointer_bytes += first->second.size() * (LIST_NODE_OVERHEAD + sizeof(object*));
+      }
+      if (proxy->obj) {
+        ++memory.loaded;
+        memory.heap_bytes += estimator.estimate(proxy->obj);
+      }
+    }
+    memory.object_bytes = memory.loaded * memory.object_size;
+    report.prototypes.push_back(memory);
+    node = node->next_node();
+  } while (node);
+
+  return report;
+}
+
 void object_store::dump_objects(std::ostream &out) const
 {
   out << "dumping all objects\n";
@@ -470,7 +736,10 @@ object* object_store::create(const char *type) const
 
 void object_store::mark_modified(object_proxy *oproxy)
 {
-  std::for_each(observer_list_.begin(), observer_list_.end(), std::tr1::bind(&object_observer::on_update, _1, oproxy->obj));
+  if (metrics::enabled() && oproxy->node) {
+    prototype_counter(oproxy->node->update_counter, "object_store_updates", oproxy->node).add();
+  }
+  notify(NOTIFY_UPDATE, oproxy->obj);
 }
 
 void object_store::register_observer(object_observer *observer)
@@ -480,6 +749,25 @@ void object_store::register_observer(object_observer *observer)
   }
 }
 
+void object_store::register_observer(object_observer *observer, const char *type, bool subtypes)
+{
+  prototype_node *node = get_prototype(type);
+  if (!node) {
+    throw object_exception("couldn't find prototype for observer");
+  }
+  prototype_node::observer_list_t::iterator first = node->observers.begin();
+  prototype_node::observer_list_t::iterator last = node->observers.end();
+  while (first != last) {
+    if (first->first == observer) {
+      first->second = subtypes;
+      return;
+    }
+    ++first;
+  }
+  node->observers.push_back(std::make_pair(observer, subtypes));
+  ++typed_observer_count_;
+}
+
 void object_store::unregister_observer(object_observer *observer)
 {
   t_observer_list::iterator i = std::find(observer_list_.begin(), observer_list_.end(), observer);
@@ -487,6 +775,20 @@ void object_store::unregister_observer(object_observer *observer)
 //    delete *i;
     observer_list_.erase(i);
   }
+  // remove registrations for single prototypes
+  prototype_node *node = root_;
+  while (node && typed_observer_count_ > 0) {
+    prototype_node::observer_list_t::iterator first = node->observers.begin();
+    while (first != node->observers.end()) {
+      if (first->first == observer) {
+        first = node->observers.erase(first);
+        --typed_observer_count_;
+      } else {
+        ++first;
+      }
+    }
+    node = node->next_node();
+  }
 }
 
 void object_store::insert(object_container &oc)
@@ -521,6 +823,11 @@ object_store::insert_object(object *o, bool notify)
       // replace it with new object
       // unlink it and
       // link it into new place in list
+      if (oproxy->obj) {
+        cache_size_ -= oproxy->node->producer->size();
+      } else {
+        --oproxy->node->evicted;
+      }
       remove_proxy(oproxy->node, oproxy);
     }
     oproxy->reset(o);
@@ -551,12 +858,25 @@ object_store::insert_object(object *o, bool notify)
   oproxy->node = node;
   // set this into persistent object
   o->proxy_ = oproxy;
-  // notify observer
+  // notify observer (at the end of a bulk operation)
   if (notify) {
-    std::for_each(observer_list_.begin(), observer_list_.end(), std::tr1::bind(&object_observer::on_insert, _1, o));
+    if (batch_depth_ > 0) {
+      batch_inserted_.push_back(o);
+    } else {
+      this->notify(NOTIFY_INSERT, o);
+    }
+  }
+  if (metrics::enabled()) {
+    prototype_counter(node->insert_counter, "object_store_inserts", node).add();
+  }
+  // account object in cache
+  oproxy->referenced = true;
+  cache_size_ += node->producer->size();
+  if (batch_depth_ == 0 && cache_budget_ > 0 && cache_size_ > std::max(cache_budget_, cache_retry_)) {
+    evict(oproxy);
   }
-  // insert element into hash map for fast lookup
-  object_map_[o->id()] = oproxy;
+  // the proxy is already registered in the map
+  // by find_proxy or create_proxy above
   // return new object
   //std::cout << "created object (" << std::right << std::setfill(' ') << std::setw(4) << o->id() << ") of type [" << o->classname() << "] proxy " << *oproxy << "\n";
   return o;
@@ -581,16 +901,7 @@ object_store::remove(object *o)
     throw object_exception("object is not removable");
   }
   
-  object_deleter::iterator first = object_deleter_->begin();
-  object_deleter::iterator last = object_deleter_->end();
-  
-  while (first != last) {
-    if (!first->second.ignore) {
-      remove_object((first++)->second.obj, true);
-    } else {
-      ++first;
-    }
-  }
+  remove_deleted_objects();
 }
 void
 object_store::remove_object(object *o, bool notify)
@@ -605,7 +916,7 @@ object_store::remove_object(object *o, bool notify)
     throw object_exception("couldn't find node for object");
   }
   
-  if (object_map_.erase(o->id()) != 1) {
+  if (!object_map_.erase(o->id())) {
     // couldn't remove object
     // throw exception
     throw object_exception("couldn't remove object");
@@ -613,9 +924,15 @@ object_store::remove_object(object *o, bool notify)
 
   remove_proxy(node, o->proxy_);
 
+  cache_size_ -= node->producer->size();
+
+  if (metrics::enabled()) {
+    prototype_counter(node->remove_counter, "object_store_removes", node).add();
+  }
+
   if (notify) {
     // notify observer
-    std::for_each(observer_list_.begin(), observer_list_.end(), std::tr1::bind(&object_observer::on_delete, _1, o));
+    this->notify(NOTIFY_DELETE, o);
   }
   // set object in object_proxy to null
   object_proxy *op = o->proxy_;
@@ -637,17 +954,33 @@ object_store::remove(object_container &oc)
     throw object_exception("couldn't remove container object");
   }
 
+  remove_deleted_objects();
+  oc.uninstall();
+}
+
+void
+object_store::remove_deleted_objects()
+{
+  /*
+   * notify the observers once with all objects
+   * to be deleted before they are removed
+   */
+  std::vector<object*> objects;
   object_deleter::iterator first = object_deleter_->begin();
   object_deleter::iterator last = object_deleter_->end();
-  
   while (first != last) {
     if (!first->second.ignore) {
-      remove_object((first++)->second.obj, true);
-    } else {
-      ++first;
+      objects.push_back(first->second.obj);
     }
+    ++first;
+  }
+
+  notify(NOTIFY_DELETE, objects);
+
+  std::vector<object*>::iterator i = objects.begin();
+  while (i != objects.end()) {
+    remove_object(*i++, false);
   }
-  oc.uninstall();
 }
 
 void
@@ -677,12 +1010,7 @@ object_store::unlink_proxy(object_proxy *proxy)
 
 object_proxy* object_store::find_proxy(long id) const
 {
-  t_object_proxy_map::const_iterator i = object_map_.find(id);
-  if (i == object_map_.end()) {
-    return NULL;
-  } else {
-    return i->second;
-  }
+  return object_map_.find(id);
 }
 
 object_proxy* object_store::create_proxy(long id)
@@ -691,24 +1019,23 @@ object_proxy* object_store::create_proxy(long id)
     return NULL;
   }
   
-  t_object_proxy_map::iterator i = object_map_.find(id);
-  if (i == object_map_.end()) {
-    return object_map_.insert(std::make_pair(id, new object_proxy(id, this))).first->second;
-  } else {
+  if (object_map_.find(id)) {
     return 0;
   }
+  object_proxy *oproxy = new object_proxy(id, this);
+  object_map_.insert(id, oproxy);
+  return oproxy;
 }
 
 bool object_store::delete_proxy(long id)
 {
-  t_object_proxy_map::iterator i = object_map_.find(id);
-  if (i == object_map_.end()) {
+  object_proxy *oproxy = object_map_.find(id);
+  if (!oproxy) {
     return false;
-  } else if (i->second->linked()) {
+  } else if (oproxy->linked()) {
     return false;
   } else {
-    object_map_.erase(i);
-    return true;
+    return object_map_.erase(id);
   }
 }
 
@@ -756,12 +1083,17 @@ void object_store::insert_proxy(prototype_node *node, object_proxy *oproxy)
   }
   // set prototype node
   oproxy->node = node;
+  // append to contiguous proxy index
+  node->push_proxy(oproxy);
   // adjust size
   ++node->count;
 }
 
 void object_store::remove_proxy(prototype_node *node, object_proxy *oproxy)
 {
+  if (clock_hand_ == oproxy) {
+    clock_hand_ = oproxy->next;
+  }
   if (oproxy == node->op_first->next) {
     // adjust left marker
     //cout << "remove: object proxy is left marker " << *o << " before second last (" << *node->op_marker->prev->obj << ")\n";
@@ -775,6 +1107,8 @@ void object_store::remove_proxy(prototype_node *node, object_proxy *oproxy)
   }
   // unlink object_proxy
   unlink_proxy(oproxy);
+  // remove from contiguous proxy index
+  node->erase_proxy(oproxy);
   // adjust object count for node
   --node->count;
 }
@@ -784,4 +1118,234 @@ sequencer_impl_ptr object_store::exchange_sequencer(const sequencer_impl_ptr &se
   return seq_.exchange_sequencer(seq);
 }
 
+void object_store::notify(notification_t type, object *o)
+{
+  void (object_observer::*on_notify)(object*) = &object_observer::on_delete;
+  if (type == NOTIFY_INSERT) {
+    on_notify = &object_observer::on_insert;
+  } else if (type == NOTIFY_UPDATE) {
+    on_notify = &object_observer::on_update;
+  }
+
+  t_observer_list::iterator first = observer_list_.begin();
+  t_observer_list::iterator last = observer_list_.end();
+  while (first != last) {
+    ((*first++)->*on_notify)(o);
+  }
+
+  if (typed_observer_count_ == 0 || !o->proxy_ || !o->proxy_->node) {
+    return;
+  }
+  // walk up the prototype tree for observers of super types
+  prototype_node *own = o->proxy_->node;
+  for (prototype_node *node = own; node; node = node->parent) {
+    prototype_node::observer_list_t::iterator i = node->observers.begin();
+    prototype_node::observer_list_t::iterator end = node->observers.end();
+    for (; i != end; ++i) {
+      if (node == own || i->second) {
+        (i->first->*on_notify)(o);
+      }
+    }
+  }
+}
+
+void object_store::notify(notification_t type, const std::vector<object*> &objects)
+{
+  if (objects.empty()) {
+    return;
+  }
+  if (type == NOTIFY_UPDATE) {
+    // there are no bulk updates
+    std::vector<object*>::const_iterator i = objects.begin();
+    while (i != objects.end()) {
+      notify(type, *i++);
+    }
+    return;
+  }
+  void (object_observer::*on_notify)(object *const*, std::size_t) = &object_observer::on_bulk_delete;
+  if (type == NOTIFY_INSERT) {
+    on_notify = &object_observer::on_bulk_insert;
+  }
+
+  t_observer_list::iterator first = observer_list_.begin();
+  t_observer_list::iterator last = observer_list_.end();
+  while (first != last) {
+    ((*first++)->*on_notify)(&objects[0], objects.size());
+  }
+
+  if (typed_observer_count_ == 0) {
+    return;
+  }
+  // collect the objects for each observer of a single prototype
+  typedef std::map<object_observer*, std::vector<object*> > t_observer_objects_map;
+  t_observer_objects_map observer_objects;
+  std::vector<object*>::const_iterator i = objects.begin();
+  for (; i != objects.end(); ++i) {
+    if (!(*i)->proxy_ || !(*i)->proxy_->node) {
+      continue;
+    }
+    prototype_node *own = (*i)->proxy_->node;
+    for (prototype_node *node = own; node; node = node->parent) {
+      prototype_node::observer_list_t::iterator j = node->observers.begin();
+      prototype_node::observer_list_t::iterator end = node->observers.end();
+      for (; j != end; ++j) {
+        if (node == own || j->second) {
+          observer_objects[j->first].push_back(*i);
+        }
+      }
+    }
+  }
+  t_observer_objects_map::iterator k = observer_objects.begin();
+  for (; k != observer_objects.end(); ++k) {
+    (k->first->*on_notify)(&k->second[0], k->second.size());
+  }
+}
+
+void object_store::begin_batch()
+{
+  ++batch_depth_;
+}
+
+void object_store::end_batch()
+{
+  if (--batch_depth_ > 0) {
+    return;
+  }
+  std::vector<object*> objects;
+  objects.swap(batch_inserted_);
+  notify(NOTIFY_INSERT, objects);
+
+  if (cache_budget_ > 0 && cache_size_ > std::max(cache_budget_, cache_retry_)) {
+    evict(0);
+  }
+}
+
+object* object_store::load_object(object_proxy *oproxy)
+{
+  /*
+   * only linked proxies without an object
+   * are evicted, all others are unknown yet
+   */
+  if (!loader_ || !oproxy->node || oproxy->id == 0) {
+    return 0;
+  }
+  ++cache_misses_;
+  object *o = loader_->load(*oproxy->node, oproxy->id);
+  if (!o) {
+    return 0;
+  }
+  o->proxy_ = oproxy;
+  oproxy->obj = o;
+  oproxy->referenced = true;
+  --oproxy->node->evicted;
+  cache_size_ += oproxy->node->producer->size();
+  if (cache_budget_ > 0 && cache_size_ > std::max(cache_budget_, cache_retry_)) {
+    evict(oproxy);
+  }
+  return o;
+}
+
+void object_store::evict(object_proxy *keep)
+{
+  if (!loader_) {
+    return;
+  }
+  /*
+   * clock sweep over the object proxy list:
+   * an object accessed since the last visit of
+   * the hand gets a second chance, otherwise it
+   * is evicted if possible. the hand moves at
+   * most two rounds
+   */
+  std::size_t steps = 2 * (object_map_.size() + 3 * prototype_map_.size()) + 2;
+  while (cache_size_ > cache_budget_ && steps-- > 0) {
+    if (!clock_hand_ || clock_hand_ == last_) {
+      clock_hand_ = first_;
+    }
+    object_proxy *oproxy = clock_hand_;
+    clock_hand_ = clock_hand_->next;
+    if (!oproxy->obj || oproxy->id == 0 || oproxy == keep) {
+      continue;
+    }
+    if (oproxy->referenced) {
+      oproxy->referenced = false;
+    } else if (is_evictable(oproxy)) {
+      evict_object(oproxy);
+    }
+  }
+  if (cache_size_ > cache_budget_) {
+    // not enough unused objects, try again later
+    cache_retry_ = cache_size_ + cache_budget_ / 8;
+  } else {
+    cache_retry_ = 0;
+  }
+}
+
+bool object_store::is_evictable(object_proxy *oproxy)
+{
+  if (oproxy->ref_count > 0 || oproxy->ptr_count > 0 || !oproxy->ptr_set_.empty()) {
+    return false;
+  }
+  prototype_node *node = oproxy->node;
+  if (!node || resolve_eviction(node) == prototype_node::EVICTION_NEVER) {
+    return false;
+  }
+  return !loader_->is_dirty(oproxy->id);
+}
+
+void object_store::evict_object(object_proxy *oproxy)
+{
+  object *o = oproxy->obj;
+  oproxy->obj = 0;
+  ++oproxy->node->evicted;
+  cache_size_ -= oproxy->node->producer->size();
+  ++cache_evictions_;
+  delete o;
+}
+
+void object_store::restore_evicted()
+{
+  /*
+   * reload all evicted objects with the current
+   * loader without enforcing the budget. objects
+   * which can't be reloaded stay evicted until
+   * they are accessed with a loader attached again.
+   * once the loader fails to reach its source the
+   * remaining objects aren't tried anymore
+   */
+  object_proxy *oproxy = first_;
+  while (oproxy && oproxy != last_) {
+    if (!oproxy->obj && oproxy->id != 0 && oproxy->node) {
+      prototype_node *node = oproxy->node;
+      object *o = 0;
+      try {
+        o = loader_->load(*node, oproxy->id);
+      } catch (std::exception &) {
+        break;
+      }
+      if (o) {
+        o->proxy_ = oproxy;
+        oproxy->obj = o;
+        --node->evicted;
+        cache_size_ += node->producer->size();
+      }
+    }
+    oproxy = oproxy->next;
+  }
+}
+
+void object_store::recount_cache()
+{
+  cache_size_ = 0;
+  cache_retry_ = 0;
+  clock_hand_ = 0;
+  prototype_node *node = root_;
+  while (node) {
+    if (node->producer) {
+      cache_size_ += (node->count - node->evicted) * node->producer->size();
+    }
+    node = node->next_node();
+  }
+}
+
 }
@@ -33,8 +33,14 @@ prototype_node::prototype_node()
   , op_first(0)
   , op_marker(0)
   , op_last(0)
+  , holes(0)
   , depth(0)
   , count(0)
+  , eviction(EVICTION_UNKNOWN)
+  , evicted(0)
+  , insert_counter(0)
+  , update_counter(0)
+  , remove_counter(0)
   , abstract(false)
   , initialized(false)
 {
@@ -50,8 +56,14 @@ prototype_node::prototype_node(object_base_producer *p, const char *t, bool a)
   , op_first(0)
   , op_marker(0)
   , op_last(0)
+  , holes(0)
   , depth(0)
   , count(0)
+  , eviction(EVICTION_UNKNOWN)
+  , evicted(0)
+  , insert_counter(0)
+  , update_counter(0)
+  , remove_counter(0)
   , type(t)
   , abstract(a)
   , initialized(false)
@@ -107,7 +119,10 @@ prototype_node::clear()
     // delete object proxy and object
     delete op;
   }
+  proxy_vector_t().swap(proxies);
+  holes = 0;
   count = 0;
+  evicted = 0;
 //  cout << "done.\n";
 }
 
@@ -253,8 +268,39 @@ void prototype_node::adjust_right_marker(object_proxy* old_proxy, object_proxy *
   }
 }
 
-std::ostream& operator <<(std::ostream &os, const prototype_node &pn)
+void prototype_node::push_proxy(object_proxy *proxy)
+{
+  proxy->index = proxies.size();
+  proxies.push_back(proxy);
+}
+
+void prototype_node::erase_proxy(object_proxy *proxy)
+{
+  if (proxy->index >= proxies.size() || proxies[proxy->index] != proxy) {
+    return;
+  }
+  proxies[proxy->index] = 0;
+  ++holes;
+  if (holes == proxies.size()) {
+    proxies.clear();
+    holes = 0;
+  } else if (holes * 2 > proxies.size()) {
+    // compact index and keep order
+    proxy_vector_t::size_type j = 0;
+    for (proxy_vector_t::size_type i = 0; i < proxies.size(); ++i) {
+      if (proxies[i]) {
+        proxies[i]->index = j;
+        proxies[j++] = proxies[i];
+      }
+    }
+    proxies.resize(j);
+    holes = 0;
+  }
+}
+
+void prototype_node::dump(std::ostream &os, const prototype_memory *memory) const
 {
+  const prototype_node &pn = *this;
   if (pn.parent) {
     os << "\t" << pn.parent->type << " -> " << pn.type << "\n";
   }
@@ -290,7 +336,22 @@ std::ostream& operator <<(std::ostream &os, const prototype_node &pn)
     ++first;
   }
   */
+  if (memory) {
+    os << "|{objects|" << memory->objects << "}";
+    os << "|{loaded|" << memory->loaded << "}";
+    os << "|{object size|" << memory->object_size << "}";
+    os << "|{object bytes|" << memory->object_bytes << "}";
+    os << "|{heap bytes|" << memory->heap_bytes << "}";
+    os << "|{proxy bytes|" << memory->proxy_bytes << "}";
+    os << "|{pointer bytes|" << memory->pointer_bytes << "}";
+    os << "|{total bytes|" << memory->total() << "}";
+  }
   os << "}\"]\n";
+}
+
+std::ostream& operator <<(std::ostream &os, const prototype_node &pn)
+{
+  pn.dump(os);
   return os;
 }
 
@@ -0,0 +1,127 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/arena.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace oos {
+
+namespace {
+
+// size of the chunk header rounded to the alignment
+const std::size_t header_size = (sizeof(void*) + sizeof(std::size_t) + 7) & ~std::size_t(7);
+
+}
+
+arena::arena(size_type chunk_size)
+  : chunk_size_(chunk_size)
+  , chunks_(0)
+  , cursor_(0)
+  , end_(0)
+  , capacity_(0)
+  , used_(0)
+{}
+
+arena::~arena()
+{
+  while (chunks_) {
+    chunk *next = chunks_->next;
+    std::free(chunks_);
+    chunks_ = next;
+  }
+}
+
+const char* arena::copy(const char *str, size_type len)
+{
+  char *ptr = static_cast<char*>(allocate(len + 1));
+  std::memcpy(ptr, str, len);
+  ptr[len] = '\0';
+  return ptr;
+}
+
+void arena::clear()
+{
+  if (!chunks_) {
+    return;
+  }
+  // keep the oldest chunk, it is a regular one
+  chunk *first = chunks_;
+  while (first->next) {
+    chunk *next = first->next;
+    capacity_ -= first->size;
+    std::free(first);
+    first = next;
+  }
+  chunks_ = first;
+  cursor_ = reinterpret_cast<char*>(first) + header_size;
+  end_ = reinterpret_cast<char*>(first) + first->size;
+  used_ = 0;
+}
+
+arena::size_type arena::capacity() const
+{
+  return capacity_;
+}
+
+arena::size_type arena::size() const
+{
+  return used_;
+}
+
+void* arena::allocate_chunk(size_type size)
+{
+  if (size > chunk_size_ / 4) {
+    /*
+     * big blocks get a chunk of their own
+     * which is placed behind the current
+     * chunk, so the cursor stays valid
+     */
+    chunk *c = static_cast<chunk*>(std::malloc(header_size + size));
+    if (!c) {
+      throw std::bad_alloc();
+    }
+    c->size = header_size + size;
+    capacity_ += c->size;
+    used_ += size;
+    if (chunks_) {
+      c->next = chunks_->next;
+      chunks_->next = c;
+    } else {
+      c->next = 0;
+      chunks_ = c;
+    }
+    return reinterpret_cast<char*>(c) + header_size;
+  }
+
+  chunk *c = static_cast<chunk*>(std::malloc(chunk_size_));
+  if (!c) {
+    throw std::bad_alloc();
+  }
+  c->size = chunk_size_;
+  capacity_ += c->size;
+  used_ += size;
+  c->next = chunks_;
+  chunks_ = c;
+  cursor_ = reinterpret_cast<char*>(c) + header_size + size;
+  end_ = reinterpret_cast<char*>(c) + c->size;
+  return reinterpret_cast<char*>(c) + header_size;
+}
+
+}
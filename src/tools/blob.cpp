@@ -1,17 +1,155 @@
 #include "tools/blob.hpp"
 
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <new>
+
 namespace oos {
 
+namespace {
+
+void increment(volatile long *count)
+{
+#ifdef WIN32
+  InterlockedIncrement(count);
+#else
+  __atomic_add_fetch(count, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+long decrement(volatile long *count)
+{
+#ifdef WIN32
+  return InterlockedDecrement(count);
+#else
+  return __atomic_sub_fetch(count, 1, __ATOMIC_ACQ_REL);
+#endif
+}
+
+long load(const volatile long *count)
+{
+#ifdef WIN32
+  return *count;
+#else
+  return __atomic_load_n(count, __ATOMIC_ACQUIRE);
+#endif
+}
+
+}
+
 blob::blob()
-  : data_(new char[CHUNK_SIZE])
-  , size_(0)
-  , capacity_(CHUNK_SIZE)
+  : size_(0)
+  , capacity_(INLINE_SIZE)
+{}
+
+blob::blob(const char *data, size_type size)
+  : size_(0)
+  , capacity_(INLINE_SIZE)
+{
+  assign(data, size);
+}
+
+blob::blob(const blob &x)
+  : size_(x.size_)
+  , capacity_(x.capacity_)
 {
+  if (x.is_inline()) {
+    memcpy(inline_, x.inline_, size_);
+  } else {
+    block_ = x.block_;
+    increment(&block_->refcount);
+  }
+}
+
+blob& blob::operator=(const blob &x)
+{
+  if (this == &x) {
+    return *this;
+  }
+  if (!x.is_inline()) {
+    // share the block of x
+    increment(&x.block_->refcount);
+    release();
+    block_ = x.block_;
+    capacity_ = x.capacity_;
+  } else if (is_inline() || use_count() > 1) {
+    release();
+    memcpy(inline_, x.inline_, x.size_);
+  } else {
+    // keep the own block
+    memcpy(block_->data(), x.inline_, x.size_);
+  }
+  size_ = x.size_;
+  return *this;
 }
 
 blob::~blob()
 {
-  delete [] data_;
+  release();
+}
+
+void blob::assign(const char *data, size_type size)
+{
+  if (!is_inline() && use_count() > 1) {
+    release();
+  }
+  size_ = 0;
+  if (size > capacity_) {
+    grow(size);
+  }
+  // data may point into this blob
+  memmove(bytes(), data, size);
+  size_ = size;
+}
+
+void blob::append(const char *data, size_type size)
+{
+  if (size_ + size > capacity_) {
+    size_type capacity = capacity_ * 2;
+    if (capacity < size_ + size) {
+      capacity = size_ + size;
+    }
+    // data may point into this blob, copy it before the old data is released
+    block *b = allocate(capacity);
+    memcpy(b->data(), bytes(), size_);
+    memcpy(b->data() + size_, data, size);
+    release();
+    block_ = b;
+    capacity_ = capacity;
+  } else {
+    detach();
+    memmove(bytes() + size_, data, size);
+  }
+  size_ += size;
+}
+
+void blob::reserve(size_type capacity)
+{
+  if (capacity > capacity_) {
+    grow(capacity);
+  }
+}
+
+void blob::resize(size_type size)
+{
+  reserve(size);
+  detach();
+  size_ = size;
+}
+
+void blob::clear()
+{
+  if (!is_inline() && use_count() > 1) {
+    release();
+  }
+  size_ = 0;
+}
+
+bool blob::empty() const
+{
+  return size_ == 0;
 }
 
 blob::size_type blob::size() const
@@ -26,7 +164,70 @@ blob::size_type blob::capacity() const
 
 const char* blob::data() const
 {
-  return data_;
+  return is_inline() ? inline_ : block_->data();
+}
+
+char* blob::mutable_data()
+{
+  detach();
+  return bytes();
+}
+
+long blob::use_count() const
+{
+  return is_inline() ? 1 : load(&block_->refcount);
+}
+
+bool blob::operator==(const blob &x) const
+{
+  return size_ == x.size_ && (size_ == 0 || memcmp(data(), x.data(), size_) == 0);
+}
+
+bool blob::operator!=(const blob &x) const
+{
+  return !operator==(x);
+}
+
+bool blob::is_inline() const
+{
+  return capacity_ <= INLINE_SIZE;
+}
+
+char* blob::bytes()
+{
+  return is_inline() ? inline_ : block_->data();
+}
+
+void blob::grow(size_type capacity)
+{
+  block *b = allocate(capacity);
+  memcpy(b->data(), bytes(), size_);
+  release();
+  block_ = b;
+  capacity_ = capacity;
+}
+
+void blob::detach()
+{
+  if (!is_inline() && use_count() > 1) {
+    grow(capacity_);
+  }
+}
+
+void blob::release()
+{
+  if (!is_inline() && decrement(&block_->refcount) == 0) {
+    ::operator delete(block_);
+  }
+  capacity_ = INLINE_SIZE;
+}
+
+blob::block* blob::allocate(size_type capacity)
+{
+  block *b = static_cast<block*>(::operator new(sizeof(block) + capacity));
+  b->refcount = 1;
+  b->capacity = capacity;
+  return b;
 }
 
 }
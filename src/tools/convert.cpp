@@ -17,14 +17,302 @@
 
 #include "tools/convert.hpp"
 
+#include "json/json_numeric.hpp"
+
 #include <cstring>
+#include <cstdio>
+#include <cmath>
 
 namespace oos {
 
+namespace {
+
+const char digit_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+const double powers_of_ten[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// doubles below can be split into integral and fractional part exactly
+const double max_exact_scaled = 4503599627370496.0; // 2^52
+
+inline bool is_space(char c)
+{
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool is_digit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+inline const char* skip_space(const char *str)
+{
+  while (is_space(*str)) {
+    ++str;
+  }
+  return str;
+}
+
+/*
+ * Writes the digits of value right aligned
+ * ending in front of end and returns the
+ * position of the first digit.
+ */
+char* write_digits(unsigned long long value, char *end)
+{
+  while (value >= 100) {
+    unsigned idx = static_cast<unsigned>(value % 100) * 2;
+    value /= 100;
+    *--end = digit_pairs[idx + 1];
+    *--end = digit_pairs[idx];
+  }
+  if (value >= 10) {
+    unsigned idx = static_cast<unsigned>(value) * 2;
+    *--end = digit_pairs[idx + 1];
+    *--end = digit_pairs[idx];
+  } else {
+    *--end = static_cast<char>('0' + value);
+  }
+  return end;
+}
+
+std::size_t write_string(const char *str, std::size_t len, char *buf, std::size_t size)
+{
+  if (len >= size) {
+    return size;
+  }
+  memcpy(buf, str, len);
+  buf[len] = '\0';
+  return len;
+}
+
+/*
+ * Rounds value * 10^precision to the nearest integer
+ * like printf does, ties are rounded to even. Returns
+ * false if the scaled value is too large to be
+ * rounded exactly.
+ */
+bool round_scaled(double value, int precision, unsigned long long &result)
+{
+  if (precision > 22) {
+    return false;
+  }
+  double scaled = value * powers_of_ten[precision];
+  if (!(scaled < max_exact_scaled)) {
+    return false;
+  }
+  double integral = std::floor(scaled);
+  double fraction = scaled - integral;
+  result = static_cast<unsigned long long>(integral);
+  if (fraction > 0.5) {
+    ++result;
+  } else if (fraction == 0.5) {
+    /*
+     * the product may have been rounded to the tie,
+     * the exact rest of the multiplication decides
+     */
+    double rest = fma(value, powers_of_ten[precision], -scaled);
+    if (rest > 0 || (rest == 0 && (result & 1) != 0)) {
+      ++result;
+    }
+  }
+  return true;
+}
+
+std::size_t format_with_printf(double value, int precision, char *buf, std::size_t size)
+{
+#ifdef WIN32
+  int len = _snprintf_s(buf, size, _TRUNCATE, "%.*f", precision, value);
+  if (len < 0) {
+    return size;
+  }
+#else
+  int len = snprintf(buf, size, "%.*f", precision, value);
+  if (len < 0 || static_cast<std::size_t>(len) >= size) {
+    return size;
+  }
+#endif
+  // replace the decimal separator of the current locale
+  for (char *p = buf; *p != '\0'; ++p) {
+    if (!is_digit(*p) && *p != '-') {
+      *p = '.';
+      break;
+    }
+  }
+  return static_cast<std::size_t>(len);
+}
+
+}
+
+std::size_t format_unsigned(unsigned long long value, char *buf)
+{
+  char digits[CONVERT_NUMBER_BUFFER_SIZE];
+  char *end = digits + CONVERT_NUMBER_BUFFER_SIZE;
+  char *first = write_digits(value, end);
+  std::size_t len = end - first;
+  memcpy(buf, first, len);
+  return len;
+}
+
+std::size_t format_integer(long long value, char *buf)
+{
+  if (value < 0) {
+    *buf = '-';
+    return format_unsigned(~static_cast<unsigned long long>(value) + 1, buf + 1) + 1;
+  }
+  return format_unsigned(static_cast<unsigned long long>(value), buf);
+}
+
+std::size_t format_double(double value, int precision, char *buf, std::size_t size)
+{
+  if (std::isnan(value)) {
+    return write_string((std::signbit(value) ? "-nan" : "nan"), (std::signbit(value) ? 4 : 3), buf, size);
+  } else if (std::isinf(value)) {
+    return write_string((value < 0 ? "-inf" : "inf"), (value < 0 ? 4 : 3), buf, size);
+  }
+
+  if (precision < 0) {
+    char number[JSON_NUMBER_BUFFER_SIZE];
+    std::size_t len = json_format_number(value, number);
+    // whole numbers don't need the trailing ".0"
+    if (len > 2 && number[len - 2] == '.' && number[len - 1] == '0') {
+      len -= 2;
+    }
+    return write_string(number, len, buf, size);
+  }
+
+  bool negative = std::signbit(value);
+  unsigned long long scaled = 0;
+  if (!round_scaled(negative ? -value : value, precision, scaled)) {
+    return format_with_printf(value, precision, buf, size);
+  }
+
+  // sign, at least one integral digit, point and fraction
+  char number[CONVERT_NUMBER_BUFFER_SIZE + 24];
+  char *end = number + sizeof(number);
+  char *first = write_digits(scaled, end);
+  while (end - first < precision + 1) {
+    *--first = '0';
+  }
+  if (precision > 0) {
+    char *point = end - precision;
+    memmove(first - 1, first, point - first);
+    --first;
+    *(point - 1) = '.';
+  }
+  if (negative) {
+    *--first = '-';
+  }
+  return write_string(first, end - first, buf, size);
+}
+
+bool parse_unsigned(const char *str, unsigned long long &value)
+{
+  const char *p = skip_space(str);
+  if (*p == '+') {
+    ++p;
+  }
+  if (!is_digit(*p)) {
+    return false;
+  }
+  const unsigned long long max = ~0ULL;
+  unsigned long long result = 0;
+  while (is_digit(*p)) {
+    unsigned digit = static_cast<unsigned>(*p++ - '0');
+    if (result > (max - digit) / 10) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+  value = result;
+  return true;
+}
+
+bool parse_integer(const char *str, long long &value)
+{
+  const char *p = skip_space(str);
+  bool negative = false;
+  if (*p == '-') {
+    negative = true;
+    ++p;
+  } else if (*p == '+') {
+    ++p;
+  }
+  if (!is_digit(*p)) {
+    return false;
+  }
+  // the magnitude of the smallest long long
+  const unsigned long long max = (negative ? 9223372036854775808ULL : 9223372036854775807ULL);
+  unsigned long long result = 0;
+  while (is_digit(*p)) {
+    unsigned digit = static_cast<unsigned>(*p++ - '0');
+    if (result > (max - digit) / 10) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+  if (negative) {
+    value = (result == 0 ? 0 : -static_cast<long long>(result - 1) - 1);
+  } else {
+    value = static_cast<long long>(result);
+  }
+  return true;
+}
+
+bool parse_double(const char *str, double &value)
+{
+  const char *p = skip_space(str);
+  bool negative = false;
+  if (*p == '-') {
+    negative = true;
+    ++p;
+  } else if (*p == '+') {
+    ++p;
+  }
+  // json numbers don't have leading zeros
+  while (*p == '0' && is_digit(p[1])) {
+    ++p;
+  }
+
+  bool is_integer = false;
+  long long integer = 0;
+  double real = 0;
+  if (is_digit(*p) && json_parse_number(p, p + strlen(p), is_integer, integer, real) != 0) {
+    real = (is_integer ? static_cast<double>(integer) : real);
+    if (std::isinf(real)) {
+      // out of range
+      return false;
+    }
+    value = (negative ? -real : real);
+    return true;
+  }
+
+  // forms like ".5", "5." or "inf" aren't json numbers
+  char *end = 0;
+  real = strtod(str, &end);
+  if (end == str) {
+    return false;
+  }
+  value = real;
+  return true;
+}
+
 void
 convert(const varchar_base &from, std::string &to)
 {
-  to = from.str();
+  to.assign(from.data(), from.size());
 }
 
 void
@@ -48,11 +336,11 @@ convert(const varchar_base &from, varchar_base &to)
 void
 convert(const char *from, bool &to)
 {
-  char *ptr;
-  to = strtoul(from, &ptr, 10) > 0;
-  if (errno == ERANGE || (to == 0 && ptr == from)) {
+  long long value = 0;
+  if (!parse_integer(from, value)) {
     throw std::bad_cast();
   }
+  to = value != 0;
 }
 
 void
@@ -0,0 +1,528 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/metrics.hpp"
+#include "tools/convert.hpp"
+
+#include "json/json_writer.hpp"
+
+#ifdef WIN32
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <sched.h>
+#include <time.h>
+#endif
+
+namespace oos {
+
+namespace {
+
+#ifdef WIN32
+__declspec(thread) unsigned thread_shard = 0;
+#else
+__thread unsigned thread_shard = 0;
+#endif
+
+volatile unsigned shard_counter = 0;
+
+template < class T >
+void atomic_add(volatile T *ptr, T value)
+{
+#ifdef WIN32
+  InterlockedExchangeAdd64((volatile LONGLONG*)ptr, (LONGLONG)value);
+#else
+  __atomic_add_fetch(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+template < class T >
+T atomic_load(const volatile T *ptr)
+{
+#ifdef WIN32
+  return *ptr;
+#else
+  return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+#endif
+}
+
+template < class T >
+void atomic_store(volatile T *ptr, T value)
+{
+#ifdef WIN32
+  *ptr = value;
+  MemoryBarrier();
+#else
+  __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+#endif
+}
+
+void write_text_name(std::ostream &out, const std::string &name, const std::string &type, const char *suffix = "", const char *le = 0)
+{
+  out << name << suffix;
+  if (type.empty() && !le) {
+    return;
+  }
+  out << "{";
+  if (!type.empty()) {
+    out << "type=\"";
+    for (std::string::const_iterator i = type.begin(); i != type.end(); ++i) {
+      if (*i == '"' || *i == '\\') {
+        out << '\\';
+      }
+      out << *i;
+    }
+    out << "\"";
+  }
+  if (le) {
+    out << (type.empty() ? "" : ",") << "le=\"" << le << "\"";
+  }
+  out << "}";
+}
+
+void write_json_values(json_writer &writer, const char *key, const metrics_snapshot::t_value_vector &values)
+{
+  writer.key(key);
+  writer.begin_array();
+  for (metrics_snapshot::t_value_vector::const_iterator i = values.begin(); i != values.end(); ++i) {
+    writer.begin_object();
+    writer.key("name");
+    writer.value(i->name);
+    if (!i->type.empty()) {
+      writer.key("type");
+      writer.value(i->type);
+    }
+    writer.key("value");
+    writer.value(i->value);
+    writer.end_object();
+  }
+  writer.end_array();
+}
+
+template < class T >
+const T* find_metric(const std::vector<T> &metrics, const std::string &name, const std::string &type)
+{
+  for (typename std::vector<T>::const_iterator i = metrics.begin(); i != metrics.end(); ++i) {
+    if (i->name == name && i->type == type) {
+      return &*i;
+    }
+  }
+  return 0;
+}
+
+}
+
+unsigned metric_shard()
+{
+  if (thread_shard == 0) {
+#ifdef WIN32
+    thread_shard = InterlockedIncrement((volatile LONG*)&shard_counter);
+#else
+    thread_shard = __atomic_add_fetch(&shard_counter, 1, __ATOMIC_RELAXED);
+#endif
+  }
+  return thread_shard & (METRIC_SHARDS - 1);
+}
+
+metric_counter::metric_counter(const std::string &name, const std::string &type)
+  : name_(name)
+  , type_(type)
+{
+  reset();
+}
+
+void metric_counter::add(value_type n)
+{
+  atomic_add(&shards_[metric_shard()].value, n);
+}
+
+metric_counter::value_type metric_counter::value() const
+{
+  value_type sum = 0;
+  for (int i = 0; i < METRIC_SHARDS; ++i) {
+    sum += atomic_load(&shards_[i].value);
+  }
+  return sum;
+}
+
+void metric_counter::reset()
+{
+  for (int i = 0; i < METRIC_SHARDS; ++i) {
+    atomic_store(&shards_[i].value, value_type(0));
+  }
+}
+
+const std::string& metric_counter::name() const
+{
+  return name_;
+}
+
+const std::string& metric_counter::type() const
+{
+  return type_;
+}
+
+metric_histogram::metric_histogram(const std::string &name, const std::string &type)
+  : name_(name)
+  , type_(type)
+{
+  reset();
+}
+
+void metric_histogram::observe(value_type v)
+{
+  shard &s = shards_[metric_shard()];
+  atomic_add(&s.buckets[bucket(v)], value_type(1));
+  atomic_add(&s.sum, v);
+}
+
+void metric_histogram::reset()
+{
+  for (int i = 0; i < METRIC_SHARDS; ++i) {
+    for (int j = 0; j < METRIC_BUCKETS; ++j) {
+      atomic_store(&shards_[i].buckets[j], value_type(0));
+    }
+    atomic_store(&shards_[i].sum, value_type(0));
+  }
+}
+
+const std::string& metric_histogram::name() const
+{
+  return name_;
+}
+
+const std::string& metric_histogram::type() const
+{
+  return type_;
+}
+
+unsigned metric_histogram::bucket(value_type v)
+{
+  if (v == 0) {
+    return 0;
+  }
+  // the number of significant bits, the last bucket takes the rest
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanReverse64(&index, v);
+  unsigned bits = index + 1;
+#else
+  unsigned bits = 64 - __builtin_clzll(v);
+#endif
+  return (bits < METRIC_BUCKETS ? bits : METRIC_BUCKETS - 1);
+}
+
+unsigned long long metric_distribution::upper_bound(std::size_t bucket)
+{
+  if (bucket >= METRIC_BUCKETS - 1) {
+    return ~0ULL;
+  }
+  return (1ULL << bucket) - 1;
+}
+
+unsigned long long metric_distribution::quantile(double q) const
+{
+  if (count == 0) {
+    return 0;
+  }
+  unsigned long long rank = static_cast<unsigned long long>(q * count);
+  if (rank >= count) {
+    rank = count - 1;
+  }
+  unsigned long long seen = 0;
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      return upper_bound(i);
+    }
+  }
+  return upper_bound(buckets.size() - 1);
+}
+
+void metrics_snapshot::gauge(const std::string &name, const std::string &type, long long value)
+{
+  for (t_value_vector::iterator i = gauges.begin(); i != gauges.end(); ++i) {
+    if (i->name == name && i->type == type) {
+      i->value += value;
+      return;
+    }
+  }
+  metric_value v;
+  v.name = name;
+  v.type = type;
+  v.value = value;
+  gauges.push_back(v);
+}
+
+const metric_value* metrics_snapshot::find_counter(const std::string &name, const std::string &type) const
+{
+  return find_metric(counters, name, type);
+}
+
+const metric_value* metrics_snapshot::find_gauge(const std::string &name, const std::string &type) const
+{
+  return find_metric(gauges, name, type);
+}
+
+const metric_distribution* metrics_snapshot::find_histogram(const std::string &name, const std::string &type) const
+{
+  return find_metric(histograms, name, type);
+}
+
+void metrics_snapshot::write_text(std::ostream &out) const
+{
+  for (t_value_vector::const_iterator i = counters.begin(); i != counters.end(); ++i) {
+    write_text_name(out, i->name, i->type);
+    out << " " << i->value << "\n";
+  }
+  for (t_value_vector::const_iterator i = gauges.begin(); i != gauges.end(); ++i) {
+    write_text_name(out, i->name, i->type);
+    out << " " << i->value << "\n";
+  }
+  for (t_distribution_vector::const_iterator i = histograms.begin(); i != histograms.end(); ++i) {
+    // cumulative buckets up to the last used one
+    std::size_t last = i->buckets.size();
+    while (last > 0 && i->buckets[last - 1] == 0) {
+      --last;
+    }
+    unsigned long long cumulative = 0;
+    for (std::size_t j = 0; j < last; ++j) {
+      cumulative += i->buckets[j];
+      char le[32];
+      char *end = le + format_unsigned(metric_distribution::upper_bound(j), le);
+      *end = '\0';
+      write_text_name(out, i->name, i->type, "_bucket", le);
+      out << " " << cumulative << "\n";
+    }
+    write_text_name(out, i->name, i->type, "_bucket", "+Inf");
+    out << " " << i->count << "\n";
+    write_text_name(out, i->name, i->type, "_sum");
+    out << " " << i->sum << "\n";
+    write_text_name(out, i->name, i->type, "_count");
+    out << " " << i->count << "\n";
+  }
+}
+
+void metrics_snapshot::write_json(std::ostream &out) const
+{
+  json_writer writer(out, json_writer::FORMAT_PRETTY);
+  writer.begin_object();
+  write_json_values(writer, "counters", counters);
+  write_json_values(writer, "gauges", gauges);
+  writer.key("histograms");
+  writer.begin_array();
+  for (t_distribution_vector::const_iterator i = histograms.begin(); i != histograms.end(); ++i) {
+    writer.begin_object();
+    writer.key("name");
+    writer.value(i->name);
+    if (!i->type.empty()) {
+      writer.key("type");
+      writer.value(i->type);
+    }
+    writer.key("count");
+    writer.value(i->count);
+    writer.key("sum");
+    writer.value(i->sum);
+    // only the used buckets with their upper bound
+    writer.key("buckets");
+    writer.begin_array();
+    for (std::size_t j = 0; j < i->buckets.size(); ++j) {
+      if (i->buckets[j] == 0) {
+        continue;
+      }
+      writer.begin_object();
+      writer.key("le");
+      writer.value(metric_distribution::upper_bound(j));
+      writer.key("count");
+      writer.value(i->buckets[j]);
+      writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+  }
+  writer.end_array();
+  writer.end_object();
+  writer.flush();
+  out << "\n";
+}
+
+volatile int metrics::enabled_ = 0;
+volatile int metrics::destroyed_ = 0;
+
+metrics::metrics()
+  : lock_(0)
+{}
+
+metrics::~metrics()
+{
+  /*
+   * static objects destroyed after the registry
+   * may still unregister sources or count, so
+   * disable all metrics first
+   */
+  atomic_store(&enabled_, 0);
+  atomic_store(&destroyed_, 1);
+  for (t_counter_map::iterator i = counter_map_.begin(); i != counter_map_.end(); ++i) {
+    delete i->second;
+  }
+  for (t_histogram_map::iterator i = histogram_map_.begin(); i != histogram_map_.end(); ++i) {
+    delete i->second;
+  }
+}
+
+void metrics::enable(bool on)
+{
+  atomic_store(&enabled_, on ? 1 : 0);
+}
+
+metric_counter& metrics::counter(const std::string &name, const std::string &type)
+{
+  lock();
+  t_counter_map::iterator i = counter_map_.find(std::make_pair(name, type));
+  if (i == counter_map_.end()) {
+    i = counter_map_.insert(std::make_pair(std::make_pair(name, type), new metric_counter(name, type))).first;
+  }
+  metric_counter &c = *i->second;
+  unlock();
+  return c;
+}
+
+metric_histogram& metrics::histogram(const std::string &name, const std::string &type)
+{
+  lock();
+  t_histogram_map::iterator i = histogram_map_.find(std::make_pair(name, type));
+  if (i == histogram_map_.end()) {
+    i = histogram_map_.insert(std::make_pair(std::make_pair(name, type), new metric_histogram(name, type))).first;
+  }
+  metric_histogram &h = *i->second;
+  unlock();
+  return h;
+}
+
+void metrics::register_source(const metric_source *source)
+{
+  if (atomic_load(&destroyed_)) {
+    return;
+  }
+  lock();
+  sources_.push_back(source);
+  unlock();
+}
+
+void metrics::unregister_source(const metric_source *source)
+{
+  if (atomic_load(&destroyed_)) {
+    return;
+  }
+  lock();
+  for (t_source_vector::iterator i = sources_.begin(); i != sources_.end(); ++i) {
+    if (*i == source) {
+      sources_.erase(i);
+      break;
+    }
+  }
+  unlock();
+}
+
+metrics_snapshot metrics::snapshot() const
+{
+  metrics_snapshot s;
+  lock();
+  s.counters.reserve(counter_map_.size());
+  for (t_counter_map::const_iterator i = counter_map_.begin(); i != counter_map_.end(); ++i) {
+    metric_value v;
+    v.name = i->second->name();
+    v.type = i->second->type();
+    v.value = i->second->value();
+    s.counters.push_back(v);
+  }
+  s.histograms.reserve(histogram_map_.size());
+  for (t_histogram_map::const_iterator i = histogram_map_.begin(); i != histogram_map_.end(); ++i) {
+    const metric_histogram &h = *i->second;
+    metric_distribution d;
+    d.name = h.name();
+    d.type = h.type();
+    d.buckets.resize(METRIC_BUCKETS, 0);
+    for (int j = 0; j < METRIC_SHARDS; ++j) {
+      for (int k = 0; k < METRIC_BUCKETS; ++k) {
+        d.buckets[k] += atomic_load(&h.shards_[j].buckets[k]);
+      }
+      d.sum += atomic_load(&h.shards_[j].sum);
+    }
+    for (int k = 0; k < METRIC_BUCKETS; ++k) {
+      d.count += d.buckets[k];
+    }
+    s.histograms.push_back(d);
+  }
+  for (t_source_vector::const_iterator i = sources_.begin(); i != sources_.end(); ++i) {
+    (*i)->collect(s);
+  }
+  unlock();
+  return s;
+}
+
+void metrics::reset()
+{
+  lock();
+  for (t_counter_map::iterator i = counter_map_.begin(); i != counter_map_.end(); ++i) {
+    i->second->reset();
+  }
+  for (t_histogram_map::iterator i = histogram_map_.begin(); i != histogram_map_.end(); ++i) {
+    i->second->reset();
+  }
+  unlock();
+}
+
+unsigned long long metrics::now()
+{
+#ifdef WIN32
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<unsigned long long>(double(counter.QuadPart) * 1e9 / double(frequency.QuadPart));
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL + static_cast<unsigned long long>(ts.tv_nsec);
+#endif
+}
+
+void metrics::lock() const
+{
+#ifdef WIN32
+  while (InterlockedCompareExchange((volatile LONG*)&lock_, 1, 0) != 0) {
+    SwitchToThread();
+  }
+#else
+  int expected = 0;
+  while (!__atomic_compare_exchange_n(&lock_, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    expected = 0;
+    sched_yield();
+  }
+#endif
+}
+
+void metrics::unlock() const
+{
+#ifdef WIN32
+  InterlockedExchange((volatile LONG*)&lock_, 0);
+#else
+  __atomic_store_n(&lock_, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+}
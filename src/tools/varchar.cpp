@@ -1,44 +1,82 @@
 #include "tools/varchar.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
 namespace oos {
 
 varchar_base::varchar_base(size_type capacity)
-  : capacity_(capacity)
-{}
+  : data_(new char[capacity + 1])
+  , size_(0)
+  , capacity_(capacity)
+  , heap_(true)
+{
+  data_[0] = '\0';
+}
+
+varchar_base::varchar_base(char *buf, size_type capacity)
+  : data_(buf)
+  , size_(0)
+  , capacity_(capacity)
+  , heap_(false)
+{
+  data_[0] = '\0';
+}
 
 varchar_base::varchar_base(const varchar_base &x)
-  : capacity_(x.capacity_)
-  , data_(x.data_)
-{}
+  : data_(new char[x.capacity_ + 1])
+  , size_(0)
+  , capacity_(x.capacity_)
+  , heap_(true)
+{
+  assign(x.data_, x.size_);
+}
 
 varchar_base& varchar_base::operator=(const varchar_base &x)
 {
-  capacity_ = x.capacity_;
-  data_ = x.data_;
+  if (this == &x) {
+    return *this;
+  }
+  if (heap_) {
+    // a detached varchar adopts the capacity of the source
+    if (capacity_ != x.capacity_) {
+      char *buf = new char[x.capacity_ + 1];
+      delete [] data_;
+      data_ = buf;
+      capacity_ = x.capacity_;
+    }
+  } else {
+    // an inline buffer can't grow
+    ok(x.size_);
+  }
+  assign(x.data_, x.size_);
   return *this;
 }
 
 varchar_base& varchar_base::operator=(const std::string &x)
 {
-  data_ = x;
-  trim();
+  assign(x.data(), x.size());
   return *this;
 }
 
 varchar_base& varchar_base::operator=(const char *x)
 {
 //  ok(x);
-  data_.assign(x);
-  trim();
+  assign(x);
   return *this;
 }
 
 varchar_base::~varchar_base()
-{}
+{
+  if (heap_) {
+    delete [] data_;
+  }
+}
 
 bool varchar_base::operator==(const varchar_base &x) const
 {
-  return data_ == x.data_;
+  return size_ == x.size_ && memcmp(data_, x.data_, size_) == 0;
 }
 
 bool varchar_base::operator!=(const varchar_base &x) const
@@ -48,49 +86,64 @@ bool varchar_base::operator!=(const varchar_base &x) const
 
 varchar_base& varchar_base::operator+=(const varchar_base &x)
 {
-  data_ += x.str();
-  trim();
+  append(x.data_, x.size_);
   return *this;
 }
 
 varchar_base& varchar_base::operator+=(const std::string &x)
 {
-  data_ += x;
-  trim();
+  append(x.data(), x.size());
   return *this;
 }
 
 varchar_base& varchar_base::operator+=(const char *x)
 {
-  data_ += x;
-  trim();
+  append(x, strlen(x));
   return *this;
 }
 
 void varchar_base::assign(const char *s, size_t n)
 {
-  data_.assign(s, n);
-  trim();
+  size_ = std::min(capacity_, n);
+  // s may point into this varchar
+  memmove(data_, s, size_);
+  data_[size_] = '\0';
 }
 
 void varchar_base::assign(const char *s)
 {
-  data_.assign(s);
+  assign(s, strlen(s));
+}
+
+void varchar_base::resize(size_type n)
+{
+  size_ = std::min(capacity_, n);
+  data_[size_] = '\0';
 }
 
 std::string varchar_base::str() const
 {
-  return data_;
+  return std::string(data_, size_);
 }
 
 const char* varchar_base::c_str() const
 {
-  return data_.c_str();
+  return data_;
+}
+
+char* varchar_base::data()
+{
+  return data_;
+}
+
+const char* varchar_base::data() const
+{
+  return data_;
 }
 
 varchar_base::size_type varchar_base::size() const
 {
-  return data_.size();
+  return size_;
 }
 
 varchar_base::size_type varchar_base::capacity() const
@@ -100,20 +153,24 @@ varchar_base::size_type varchar_base::capacity() const
 
 std::ostream& operator<<(std::ostream &out, const varchar_base &val)
 {
-  out << val.str();
+  out.write(val.data_, val.size_);
   return out;
 }
 
-void varchar_base::ok(const std::string &x)
+void varchar_base::append(const char *s, size_t n)
 {
-  if (x.size() > capacity_) {
-    throw std::logic_error("string is to long");
-  }
+  n = std::min(capacity_ - size_, n);
+  // s may point into this varchar
+  memmove(data_ + size_, s, n);
+  size_ += n;
+  data_[size_] = '\0';
 }
 
-void varchar_base::trim()
+void varchar_base::ok(size_type n) const
 {
-  data_.resize(std::min(capacity_, data_.size()));
+  if (n > capacity_) {
+    throw std::logic_error("string is to long");
+  }
 }
 
 }
@@ -0,0 +1,351 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "unit/benchmark.hpp"
+
+#include "json/json_document.hpp"
+#include "json/json_node.hpp"
+#include "json/json_writer.hpp"
+
+#include "tools/convert.hpp"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace oos {
+
+namespace {
+
+double wall_time()
+{
+#ifdef WIN32
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return double(counter.QuadPart) / double(frequency.QuadPart);
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) / 1e9;
+#endif
+}
+
+double cpu_time()
+{
+#ifdef WIN32
+  FILETIME creation, exit, kernel, user;
+  GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  // 100 nanosecond ticks
+  return double(k.QuadPart + u.QuadPart) / 1e7;
+#else
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return double(ts.tv_sec) + double(ts.tv_nsec) / 1e9;
+#endif
+}
+
+const char *csv_header = "unit,name,iterations,samples,wall_min_ns,wall_median_ns,wall_p99_ns,"
+                         "cpu_min_ns,cpu_median_ns,cpu_p99_ns,allocations,allocated_bytes";
+
+/*
+ * Sorts the samples and returns the minimum,
+ * the median and the 99th percentile.
+ */
+void statistics(std::vector<double> &samples, double &min, double &median, double &p99)
+{
+  std::sort(samples.begin(), samples.end());
+  std::size_t n = samples.size();
+  min = samples[0];
+  median = (n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2);
+  std::size_t rank = static_cast<std::size_t>(std::ceil(0.99 * n));
+  p99 = samples[rank > 0 ? rank - 1 : 0];
+}
+
+double rounded(double value)
+{
+  // nanoseconds with three decimal places are precise enough
+  return std::floor(value * 1000.0 + 0.5) / 1000.0;
+}
+
+void write_csv_number(std::ostream &out, double value)
+{
+  if (value < 0) {
+    return;
+  }
+  char buf[CONVERT_NUMBER_BUFFER_SIZE + 8];
+  convert(value, buf, sizeof(buf), -1);
+  out << buf;
+}
+
+void write_json_number(json_writer &writer, const char *key, double value)
+{
+  writer.key(key);
+  if (value < 0) {
+    writer.null();
+  } else {
+    writer.value(rounded(value));
+  }
+}
+
+double read_csv_number(const std::string &field)
+{
+  if (field.empty()) {
+    return -1;
+  }
+  double value = 0;
+  convert(field.c_str(), value);
+  return value;
+}
+
+double read_json_number(const json_node &object, const char *key)
+{
+  if (!object.contains(key)) {
+    return -1;
+  }
+  json_node node = object[key];
+  return (node.is_number() ? node.as_number() : -1);
+}
+
+bool read_csv(std::istream &in, t_benchmark_result_vector &results)
+{
+  std::string line;
+  if (!std::getline(in, line) || line.compare(0, 5, "unit,") != 0) {
+    return false;
+  }
+  while (std::getline(in, line)) {
+    if (!line.empty() && line[line.size() - 1] == '\r') {
+      line.erase(line.size() - 1);
+    }
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields;
+    std::istringstream str(line);
+    std::string field;
+    while (std::getline(str, field, ',')) {
+      fields.push_back(field);
+    }
+    // a trailing empty field isn't reported by getline
+    if (line[line.size() - 1] == ',') {
+      fields.push_back(std::string());
+    }
+    if (fields.size() != 12) {
+      return false;
+    }
+    benchmark_result result;
+    result.unit = fields[0];
+    result.name = fields[1];
+    result.iterations = static_cast<unsigned long long>(read_csv_number(fields[2]));
+    result.samples = static_cast<unsigned>(read_csv_number(fields[3]));
+    result.wall_min = read_csv_number(fields[4]);
+    result.wall_median = read_csv_number(fields[5]);
+    result.wall_p99 = read_csv_number(fields[6]);
+    result.cpu_min = read_csv_number(fields[7]);
+    result.cpu_median = read_csv_number(fields[8]);
+    result.cpu_p99 = read_csv_number(fields[9]);
+    result.allocations = read_csv_number(fields[10]);
+    result.allocated_bytes = read_csv_number(fields[11]);
+    results.push_back(result);
+  }
+  return true;
+}
+
+bool read_json(std::istream &in, t_benchmark_result_vector &results)
+{
+  json_document doc;
+  json_node root = doc.parse(in);
+  if (!root.is_object() || !root.contains("benchmarks")) {
+    return false;
+  }
+  json_node benchmarks = root["benchmarks"];
+  if (!benchmarks.is_array()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < benchmarks.size(); ++i) {
+    json_node b = benchmarks[i];
+    if (!b.is_object() || !b.contains("unit") || !b.contains("name")) {
+      return false;
+    }
+    benchmark_result result;
+    result.unit = b["unit"].as_string();
+    result.name = b["name"].as_string();
+    result.iterations = static_cast<unsigned long long>(read_json_number(b, "iterations"));
+    result.samples = static_cast<unsigned>(read_json_number(b, "samples"));
+    result.wall_min = read_json_number(b, "wall_min_ns");
+    result.wall_median = read_json_number(b, "wall_median_ns");
+    result.wall_p99 = read_json_number(b, "wall_p99_ns");
+    result.cpu_min = read_json_number(b, "cpu_min_ns");
+    result.cpu_median = read_json_number(b, "cpu_median_ns");
+    result.cpu_p99 = read_json_number(b, "cpu_p99_ns");
+    result.allocations = read_json_number(b, "allocations");
+    result.allocated_bytes = read_json_number(b, "allocated_bytes");
+    results.push_back(result);
+  }
+  return true;
+}
+
+}
+
+benchmark_result measure_benchmark(const bench_func &func, const benchmark_options &options)
+{
+  benchmark_result result;
+
+  // the first call may set up data lazily, it isn't measured
+  func(1);
+
+  // find the iterations of one sample
+  unsigned long long iterations = 1;
+  double spent = 0;
+  for (;;) {
+    double start = wall_time();
+    func(iterations);
+    double elapsed = wall_time() - start;
+    spent += elapsed;
+    if (elapsed >= options.min_sample_time || iterations >= (1ULL << 40)) {
+      break;
+    }
+    if (elapsed * 10 < options.min_sample_time) {
+      iterations *= 10;
+    } else {
+      iterations *= 2;
+    }
+  }
+
+  // the calibration counts as warm up
+  while (spent < options.warmup_time) {
+    double start = wall_time();
+    func(iterations);
+    spent += wall_time() - start;
+  }
+
+  unsigned samples = (options.samples > 0 ? options.samples : 1);
+  std::vector<double> wall(samples);
+  std::vector<double> cpu(samples);
+  unsigned long long first_count = 0, first_bytes = 0;
+  if (options.allocation_hook) {
+    options.allocation_hook(first_count, first_bytes);
+  }
+  for (unsigned i = 0; i < samples; ++i) {
+    double wall_start = wall_time();
+    double cpu_start = cpu_time();
+    func(iterations);
+    double cpu_end = cpu_time();
+    double wall_end = wall_time();
+    wall[i] = (wall_end - wall_start) * 1e9 / double(iterations);
+    cpu[i] = (cpu_end - cpu_start) * 1e9 / double(iterations);
+  }
+  if (options.allocation_hook) {
+    unsigned long long last_count = 0, last_bytes = 0;
+    options.allocation_hook(last_count, last_bytes);
+    double total = double(iterations) * double(samples);
+    result.allocations = double(last_count - first_count) / total;
+    result.allocated_bytes = double(last_bytes - first_bytes) / total;
+  }
+
+  result.iterations = iterations;
+  result.samples = samples;
+  statistics(wall, result.wall_min, result.wall_median, result.wall_p99);
+  statistics(cpu, result.cpu_min, result.cpu_median, result.cpu_p99);
+  return result;
+}
+
+void benchmark_use(const void *)
+{}
+
+void write_benchmark_json(std::ostream &out, const t_benchmark_result_vector &results)
+{
+  json_writer writer(out, json_writer::FORMAT_PRETTY);
+  writer.begin_object();
+  writer.key("benchmarks");
+  writer.begin_array();
+  for (t_benchmark_result_vector::const_iterator i = results.begin(); i != results.end(); ++i) {
+    writer.begin_object();
+    writer.key("unit");
+    writer.value(i->unit);
+    writer.key("name");
+    writer.value(i->name);
+    writer.key("iterations");
+    writer.value(i->iterations);
+    writer.key("samples");
+    writer.value(i->samples);
+    write_json_number(writer, "wall_min_ns", i->wall_min);
+    write_json_number(writer, "wall_median_ns", i->wall_median);
+    write_json_number(writer, "wall_p99_ns", i->wall_p99);
+    write_json_number(writer, "cpu_min_ns", i->cpu_min);
+    write_json_number(writer, "cpu_median_ns", i->cpu_median);
+    write_json_number(writer, "cpu_p99_ns", i->cpu_p99);
+    write_json_number(writer, "allocations", i->allocations);
+    write_json_number(writer, "allocated_bytes", i->allocated_bytes);
+    writer.end_object();
+  }
+  writer.end_array();
+  writer.end_object();
+  writer.flush();
+  out << "\n";
+}
+
+void write_benchmark_csv(std::ostream &out, const t_benchmark_result_vector &results)
+{
+  out << csv_header << "\n";
+  for (t_benchmark_result_vector::const_iterator i = results.begin(); i != results.end(); ++i) {
+    out << i->unit << "," << i->name << "," << i->iterations << "," << i->samples;
+    double values[] = {
+      i->wall_min, i->wall_median, i->wall_p99,
+      i->cpu_min, i->cpu_median, i->cpu_p99,
+      i->allocations, i->allocated_bytes
+    };
+    for (std::size_t j = 0; j < sizeof(values) / sizeof(values[0]); ++j) {
+      out << ",";
+      write_csv_number(out, (values[j] < 0 ? values[j] : rounded(values[j])));
+    }
+    out << "\n";
+  }
+}
+
+bool read_benchmark_results(std::istream &in, t_benchmark_result_vector &results)
+{
+  // skip blanks to find out the format
+  while (in && std::isspace(in.peek())) {
+    in.get();
+  }
+  try {
+    if (in.peek() == '{') {
+      return read_json(in, results);
+    } else {
+      return read_csv(in, results);
+    }
+  } catch (std::exception &) {
+    return false;
+  }
+}
+
+}
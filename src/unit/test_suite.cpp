@@ -4,6 +4,10 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
 
 namespace oos {
 
@@ -45,6 +49,15 @@ void test_suite::unit_lister::operator()(test_suite::value_type &x)
     }
     ++first;
   }
+  if (brief || cmake) {
+    return;
+  }
+  unit_test::t_bench_func_info_map::const_iterator bfirst = x.second->bench_func_info_map_.begin();
+  unit_test::t_bench_func_info_map::const_iterator blast = x.second->bench_func_info_map_.end();
+  while (bfirst != blast) {
+    out << "Benchmark [" << bfirst->first << "]: " << bfirst->second.caption << std::endl;
+    ++bfirst;
+  }
 }
 
 test_suite::~test_suite()
@@ -95,13 +108,56 @@ void test_suite::init(int argc, char *argv[])
         args_.test = val.substr(pos+1);
       }
     }
+  } else if (arg == "bench") {
+    if (argc < 3) {
+      return;
+    }
+
+    args_.cmd = BENCHMARK;
+
+    std::string val(argv[2]);
+    if (val != "all") {
+      size_t pos = val.find(':');
+      args_.unit = val.substr(0, pos);
+      if (pos != std::string::npos) {
+        args_.test = val.substr(pos+1);
+      }
+    }
+    // options
+    for (int i = 3; i < argc; ++i) {
+      std::string option(argv[i]);
+      if (option == "json" || option == "csv") {
+        args_.format = option;
+      } else if (i + 1 == argc) {
+        // option without value
+        return;
+      } else if (option == "output") {
+        args_.output = argv[++i];
+      } else if (option == "baseline") {
+        args_.baseline = argv[++i];
+      } else if (option == "threshold") {
+        args_.threshold = atof(argv[++i]);
+      } else if (option == "samples") {
+        args_.options.samples = static_cast<unsigned>(atoi(argv[++i]));
+      } else if (option == "min_time") {
+        args_.options.min_sample_time = atof(argv[++i]) / 1000.0;
+      } else {
+        // unknown option
+        return;
+      }
+    }
   } else {
     return;
   }
   args_.initialized = true;
 }
 
-void test_suite::run()
+void test_suite::allocation_hook(allocation_hook_func hook)
+{
+  args_.options.allocation_hook = hook;
+}
+
+bool test_suite::run()
 {
   if (args_.initialized) {
     switch (args_.cmd) {
@@ -117,12 +173,15 @@ void test_suite::run()
           std::for_each(unit_test_map_.begin(), unit_test_map_.end(), unit_executer());
         }
         break;
+      case BENCHMARK:
+        return benchmark();
       default:
         break;
       }
   } else {
-    std::cout << "usage: test_oos [list]|[exec <val>]\n";
+    std::cout << "usage: test_oos [list]|[exec <val>]|[bench <val> [json|csv] [output <file>] [baseline <file>] [threshold <percent>] [samples <n>] [min_time <ms>]]\n";
   }
+  return true;
 }
 
 void test_suite::run(const std::string &unit)
@@ -145,4 +204,80 @@ void test_suite::run(const std::string &unit, const std::string &test)
   }
 }
 
+bool test_suite::benchmark()
+{
+  // keep stdout clean for the results
+  std::ostream &log = (!args_.format.empty() && args_.output.empty() ? std::cerr : std::cout);
+
+  t_benchmark_result_vector results;
+  if (args_.unit.empty()) {
+    for (t_unit_test_map::iterator i = unit_test_map_.begin(); i != unit_test_map_.end(); ++i) {
+      log << "Measuring test unit [" << i->second->caption() << "]\n";
+      i->second->benchmark("", args_.options, results, log);
+    }
+  } else {
+    t_unit_test_map::iterator i = unit_test_map_.find(args_.unit);
+    if (i == unit_test_map_.end()) {
+      log << "couldn't find test unit [" << args_.unit << "]\n";
+      return true;
+    }
+    i->second->benchmark(args_.test, args_.options, results, log);
+  }
+
+  if (!args_.format.empty()) {
+    std::ofstream file;
+    if (!args_.output.empty()) {
+      file.open(args_.output.c_str());
+      if (!file) {
+        log << "couldn't open output file [" << args_.output << "]\n";
+        return false;
+      }
+    }
+    std::ostream &out = (args_.output.empty() ? std::cout : file);
+    if (args_.format == "json") {
+      write_benchmark_json(out, results);
+    } else {
+      write_benchmark_csv(out, results);
+    }
+  }
+
+  return args_.baseline.empty() || compare(results, log);
+}
+
+bool test_suite::compare(const t_benchmark_result_vector &results, std::ostream &out) const
+{
+  std::ifstream file(args_.baseline.c_str());
+  t_benchmark_result_vector baseline;
+  if (!file || !read_benchmark_results(file, baseline)) {
+    out << "couldn't read baseline file [" << args_.baseline << "]\n";
+    return false;
+  }
+
+  bool succeeded = true;
+  out << "Comparing with baseline [" << args_.baseline << "]\n";
+  for (t_benchmark_result_vector::const_iterator i = results.begin(); i != results.end(); ++i) {
+    out << std::left << std::setw(40) << (i->unit + ":" + i->name) << std::right;
+    t_benchmark_result_vector::const_iterator j = baseline.begin();
+    while (j != baseline.end() && (j->unit != i->unit || j->name != i->name)) {
+      ++j;
+    }
+    if (j == baseline.end() || j->wall_median <= 0) {
+      out << " no baseline\n";
+      continue;
+    }
+    double change = (i->wall_median / j->wall_median - 1.0) * 100.0;
+    std::stringstream line;
+    line << std::fixed << std::setprecision(1)
+         << " " << std::setw(12) << i->wall_median << " ns"
+         << " (baseline " << j->wall_median << " ns, "
+         << std::showpos << change << std::noshowpos << "%)";
+    if (change > args_.threshold) {
+      line << " REGRESSION";
+      succeeded = false;
+    }
+    out << line.str() << "\n";
+  }
+  return succeeded;
+}
+
 }
@@ -81,6 +81,31 @@ void unit_test::add_test(const std::string &name, const test_func &test, const s
   test_func_info_map_.insert(std::make_pair(name, test_func_info(test, caption)));
 }
 
+void unit_test::add_benchmark(const std::string &name, const bench_func &bench, const std::string &caption)
+{
+  bench_func_info_map_.insert(std::make_pair(name, bench_func_info(bench, caption)));
+}
+
+void unit_test::benchmark(const std::string &name, const benchmark_options &options, t_benchmark_result_vector &results, std::ostream &out)
+{
+  if (name.empty()) {
+    t_bench_func_info_map::iterator first = bench_func_info_map_.begin();
+    t_bench_func_info_map::iterator last = bench_func_info_map_.end();
+    // measure each benchmark
+    while (first != last) {
+      benchmark(first->first, first->second, options, results, out);
+      ++first;
+    }
+  } else {
+    t_bench_func_info_map::iterator i = bench_func_info_map_.find(name);
+    if (i == bench_func_info_map_.end()) {
+      out << "couldn't find benchmark [" << name << "] of unit [" << caption_ << "]\n";
+    } else {
+      benchmark(i->first, i->second, options, results, out);
+    }
+  }
+}
+
 void unit_test::assert_true(bool a, const std::string &msg, int line, const char *file)
 {
   if (!a) {
@@ -118,6 +143,32 @@ void unit_test::info(const std::string &msg)
   std::cout << "INFO: " << msg;
 }
 
+void unit_test::benchmark(const std::string &name, bench_func_info &bench_info, const benchmark_options &options, t_benchmark_result_vector &results, std::ostream &out)
+{
+  initialize();
+  out << "Measuring benchmark [" << std::left << std::setw(68) << bench_info.caption << "] ... " << std::flush;
+  benchmark_result result;
+  bool succeeded = true;
+  std::string message;
+  try {
+    result = measure_benchmark(bench_info.func, options);
+  } catch (unit_exception &ex) {
+    succeeded = false;
+    message = ex.what();
+  }
+  finalize();
+  if (succeeded) {
+    result.unit = name_;
+    result.name = name;
+    results.push_back(result);
+    std::stringstream median;
+    median << std::fixed << std::setprecision(1) << result.wall_median << " ns";
+    out << median.str() << "\n";
+  } else {
+    out << "failed\n\t" << message << "\n";
+  }
+}
+
 void unit_test::execute(test_func_info &test_info)
 {
     initialize();
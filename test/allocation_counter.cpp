@@ -0,0 +1,65 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "allocation_counter.hpp"
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// allocation counters reported by the bench command
+volatile long long allocation_count = 0;
+volatile long long allocation_bytes = 0;
+
+}
+
+void allocation_counters(unsigned long long &count, unsigned long long &bytes)
+{
+#ifdef WIN32
+  count = InterlockedCompareExchange64(&allocation_count, 0, 0);
+  bytes = InterlockedCompareExchange64(&allocation_bytes, 0, 0);
+#else
+  count = __atomic_load_n(&allocation_count, __ATOMIC_RELAXED);
+  bytes = __atomic_load_n(&allocation_bytes, __ATOMIC_RELAXED);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+#ifdef WIN32
+  InterlockedIncrement64(&allocation_count);
+  InterlockedExchangeAdd64(&allocation_bytes, size);
+#else
+  __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&allocation_bytes, size, __ATOMIC_RELAXED);
+#endif
+  void *ptr = malloc(size > 0 ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) throw()
+{
+  free(ptr);
+}
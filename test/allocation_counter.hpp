@@ -0,0 +1,32 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+/**
+ * Returns the number of allocations and allocated
+ * bytes counted by the replaced global operator new
+ * since the start of the program. The function is
+ * installed as allocation hook of the test_suite.
+ *
+ * @param count The number of allocations.
+ * @param bytes The number of allocated bytes.
+ */
+void allocation_counters(unsigned long long &count, unsigned long long &bytes);
+
+#endif /* ALLOCATION_COUNTER_HPP */
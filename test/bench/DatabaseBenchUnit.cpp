@@ -0,0 +1,401 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseBenchUnit.hpp"
+
+#include "../Item.hpp"
+
+#include "database/session.hpp"
+#include "database/database.hpp"
+#include "database/database_sequencer.hpp"
+#include "database/transaction.hpp"
+#include "database/query.hpp"
+#include "database/condition.hpp"
+#include "database/statement.hpp"
+#include "database/result.hpp"
+#include "database/sql.hpp"
+#include "database/types.hpp"
+
+#include "object/object_ptr.hpp"
+#include "object/object_view.hpp"
+
+#include <cstdio>
+#include <sstream>
+
+using namespace oos;
+using namespace std;
+
+namespace {
+
+typedef object_ptr<Item> item_ptr;
+typedef object_ptr<ItemPtrVector> item_vector_ptr;
+typedef object_ptr<album> album_ptr;
+typedef object_ptr<track> track_ptr;
+typedef object_view<Item> item_view_t;
+
+/*
+ * Writes the insert columns and host values
+ * of an object into a sql like query::insert
+ * does, so the generation of the sql can be
+ * measured without preparing a statement.
+ */
+class insert_sql_writer : public generic_object_writer<insert_sql_writer>
+{
+public:
+  explicit insert_sql_writer(sql &s)
+    : generic_object_writer<insert_sql_writer>(this)
+    , sql_(s)
+    , fields_(true)
+    , first_(true)
+  {}
+  virtual ~insert_sql_writer() {}
+
+  void fields() { fields_ = true; first_ = true; }
+  void values() { fields_ = false; first_ = true; }
+
+  template < class T >
+  void write_value(const char *id, const T&)
+  {
+    append(id, type_traits<T>::data_type());
+  }
+  void write_value(const char *id, const varchar_base&)
+  {
+    append(id, type_varchar);
+  }
+  void write_value(const char *id, const char*, int)
+  {
+    append(id, type_char_pointer);
+  }
+  void write_value(const char *id, const object_base_ptr&)
+  {
+    append(id, type_long);
+  }
+  void write_value(const char*, const object_container&) {}
+
+private:
+  void append(const char *id, data_type_t type)
+  {
+    if (!first_) {
+      sql_.append(", ");
+    }
+    first_ = false;
+    if (fields_) {
+      sql_.append(id);
+    } else {
+      sql_.append(id, type, "");
+    }
+  }
+
+private:
+  sql &sql_;
+  bool fields_;
+  bool first_;
+};
+
+// number of changes written by one transaction
+const unsigned long long BATCH_SIZE = 100;
+
+// number of items changed round robin by the update benchmark
+const int UPDATE_ITEMS = 1000;
+
+// number of tracks of one album
+const unsigned long long ALBUM_TRACKS = 9;
+
+// number of items of a vector removed by the delete benchmark
+const int CASCADE_ITEMS = 10;
+
+}
+
+DatabaseBenchUnit::DatabaseBenchUnit(const std::string &name, const std::string &msg, const std::string &db)
+  : unit_test(name, msg)
+  , db_(db)
+  , session_(0)
+  , memory_(db.compare(0, 9, "memory://") == 0)
+  , prepared_(false)
+{
+  // a sqlite file is removed before and after each benchmark
+  const std::string sqlite("sqlite://");
+  if (db_.compare(0, sqlite.size(), sqlite) == 0 && db_.substr(sqlite.size()) != ":memory:") {
+    file_ = db_.substr(sqlite.size());
+  }
+
+  for (unsigned long long size = 1; size <= 1000; size *= 10) {
+    std::stringstream name;
+    name << "commit_" << size;
+    std::stringstream caption;
+    caption << "insert one item with " << size << " items per transaction";
+    add_benchmark(name.str(), std::tr1::bind(&DatabaseBenchUnit::commit, this, std::tr1::placeholders::_1, size), caption.str());
+  }
+  add_benchmark("update", std::tr1::bind(&DatabaseBenchUnit::update, this, std::tr1::placeholders::_1), "update one of 1000 items with 100 updates per transaction");
+  add_benchmark("delete_cascade", std::tr1::bind(&DatabaseBenchUnit::delete_cascade, this, std::tr1::placeholders::_1), "insert and remove a vector with 10 items in two transactions");
+  add_benchmark("empty_transaction", std::tr1::bind(&DatabaseBenchUnit::empty_transaction, this, std::tr1::placeholders::_1), "begin and commit an empty transaction");
+  add_benchmark("sequencer_commit", std::tr1::bind(&DatabaseBenchUnit::sequencer_commit, this, std::tr1::placeholders::_1), "write the sequence with 100 writes per database transaction");
+
+  // the memory backend neither loads nor prepares statements
+  if (!memory_) {
+    add_benchmark("load_1000", std::tr1::bind(&DatabaseBenchUnit::load, this, std::tr1::placeholders::_1, 1000), "load 1000 albums and tracks with their relations");
+    add_benchmark("load_10000", std::tr1::bind(&DatabaseBenchUnit::load, this, std::tr1::placeholders::_1, 10000), "load 10000 albums and tracks with their relations");
+    add_benchmark("phase_generate", std::tr1::bind(&DatabaseBenchUnit::phase_generate, this, std::tr1::placeholders::_1), "generate the prepared insert sql of an item");
+    add_benchmark("phase_bind", std::tr1::bind(&DatabaseBenchUnit::phase_bind, this, std::tr1::placeholders::_1), "bind an item to the prepared update statement");
+    add_benchmark("phase_step", std::tr1::bind(&DatabaseBenchUnit::phase_step, this, std::tr1::placeholders::_1), "execute the bound update statement of an item");
+    add_benchmark("phase_decode", std::tr1::bind(&DatabaseBenchUnit::phase_decode, this, std::tr1::placeholders::_1), "decode a selected row into an item");
+  }
+}
+
+DatabaseBenchUnit::~DatabaseBenchUnit()
+{}
+
+void
+DatabaseBenchUnit::initialize()
+{
+  ostore_.insert_prototype<Item>("item");
+  ostore_.insert_prototype<ItemPtrVector>("item_ptr_vector");
+  ostore_.insert_prototype<album>("album");
+  ostore_.insert_prototype<track>("track");
+
+  remove_file();
+
+  session_ = new session(ostore_, db_);
+  session_->create();
+  if (!memory_) {
+    session_->load();
+  }
+
+  prepared_ = false;
+}
+
+void
+DatabaseBenchUnit::finalize()
+{
+  session_->drop();
+  session_->close();
+  delete session_;
+  session_ = 0;
+
+  remove_file();
+
+  ostore_.clear(true);
+}
+
+void
+DatabaseBenchUnit::remove_file() const
+{
+  if (!file_.empty()) {
+    std::remove(file_.c_str());
+  }
+}
+
+void
+DatabaseBenchUnit::commit(unsigned long long iterations, unsigned long long size)
+{
+  transaction tr(*session_);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    if (i % size == 0) {
+      tr.begin();
+    }
+    ostore_.insert(new Item("item", static_cast<int>(i)));
+    if ((i + 1) % size == 0 || i + 1 == iterations) {
+      tr.commit();
+    }
+  }
+}
+
+void
+DatabaseBenchUnit::load(unsigned long long iterations, unsigned long long rows)
+{
+  if (!prepared_) {
+    transaction tr(*session_);
+    tr.begin();
+    for (unsigned long long i = 0; i < rows; i += ALBUM_TRACKS + 1) {
+      album_ptr alb = ostore_.insert(new album("album"));
+      for (unsigned long long j = 0; j < ALBUM_TRACKS; ++j) {
+        alb->add(ostore_.insert(new track("track")));
+      }
+    }
+    tr.commit();
+    prepared_ = true;
+  }
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    ostore_.clear();
+    session_->load();
+  }
+}
+
+void
+DatabaseBenchUnit::update(unsigned long long iterations)
+{
+  if (!prepared_) {
+    transaction tr(*session_);
+    tr.begin();
+    for (int i = 0; i < UPDATE_ITEMS; ++i) {
+      ostore_.insert(new Item("item", i));
+    }
+    tr.commit();
+    prepared_ = true;
+  }
+  item_view_t view(ostore_);
+  item_view_t::iterator first = view.begin();
+  transaction tr(*session_);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    if (i % BATCH_SIZE == 0) {
+      tr.begin();
+    }
+    (*first)->set_int(static_cast<int>(i));
+    if (++first == view.end()) {
+      first = view.begin();
+    }
+    if ((i + 1) % BATCH_SIZE == 0 || i + 1 == iterations) {
+      tr.commit();
+    }
+  }
+}
+
+void
+DatabaseBenchUnit::delete_cascade(unsigned long long iterations)
+{
+  transaction tr(*session_);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    tr.begin();
+    item_vector_ptr items = ostore_.insert(new ItemPtrVector);
+    for (int j = 0; j < CASCADE_ITEMS; ++j) {
+      items->push_back(ostore_.insert(new Item("item", j)));
+    }
+    tr.commit();
+
+    tr.begin();
+    ostore_.remove(items);
+    tr.commit();
+  }
+}
+
+void
+DatabaseBenchUnit::empty_transaction(unsigned long long iterations)
+{
+  transaction tr(*session_);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    tr.begin();
+    tr.commit();
+  }
+}
+
+void
+DatabaseBenchUnit::sequencer_commit(unsigned long long iterations)
+{
+  database &db = session_->db();
+  database::database_sequencer_ptr seq = db.seq();
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    if (i % BATCH_SIZE == 0) {
+      db.begin();
+    }
+    seq->begin();
+    seq->next();
+    seq->commit();
+    if ((i + 1) % BATCH_SIZE == 0 || i + 1 == iterations) {
+      db.commit();
+    }
+  }
+}
+
+void
+DatabaseBenchUnit::phase_generate(unsigned long long iterations)
+{
+  Item item("item", 42);
+  sql s;
+  s.append("INSERT INTO item (");
+  insert_sql_writer writer(s);
+  writer.fields();
+  item.serialize(writer);
+  s.append(") VALUES (");
+  writer.values();
+  item.serialize(writer);
+  s.append(")");
+
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    std::string str(s.prepare());
+    benchmark_use(&str);
+  }
+}
+
+void
+DatabaseBenchUnit::phase_bind(unsigned long long iterations)
+{
+  Item item("item", 42);
+  query q(session_->db());
+  statement *stmt = q.update("item", &item).where(cond("id").equal(0)).prepare();
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    int pos = stmt->bind(&item);
+    stmt->bind(pos, 1L);
+  }
+  delete stmt;
+}
+
+void
+DatabaseBenchUnit::phase_step(unsigned long long iterations)
+{
+  if (!prepared_) {
+    transaction tr(*session_);
+    tr.begin();
+    ostore_.insert(new Item("item", 42));
+    tr.commit();
+    prepared_ = true;
+  }
+  item_view_t view(ostore_);
+  item_ptr item = *view.begin();
+
+  query q(session_->db());
+  statement *stmt = q.update("item", item.ptr()).where(cond("id").equal(0)).prepare();
+  int pos = stmt->bind(item.ptr());
+  stmt->bind(pos, item->id());
+  // the bindings stay valid, the done statement is reset by the next step
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    result *res = stmt->execute();
+    delete res;
+  }
+  delete stmt;
+}
+
+void
+DatabaseBenchUnit::phase_decode(unsigned long long iterations)
+{
+  if (!prepared_) {
+    transaction tr(*session_);
+    tr.begin();
+    ostore_.insert(new Item("item", 42));
+    tr.commit();
+    prepared_ = true;
+  }
+  item_view_t view(ostore_);
+  item_ptr item = *view.begin();
+
+  query q(session_->db());
+  statement *stmt = q.select(*ostore_.find_prototype("item")).where(cond("id").equal(0)).prepare();
+  stmt->bind(0, item->id());
+  result *res = stmt->execute();
+  if (!res->fetch()) {
+    delete res;
+    delete stmt;
+    UNIT_FAIL("couldn't select item " << item->id());
+  }
+  // decode the current row again and again
+  Item decoded;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    res->get(&decoded);
+    benchmark_use(&decoded);
+  }
+  delete res;
+  delete stmt;
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DATABASE_BENCHUNIT_HPP
+#define DATABASE_BENCHUNIT_HPP
+
+#include "unit/unit_test.hpp"
+
+#include "object/object_store.hpp"
+
+#include <string>
+
+namespace oos {
+class session;
+}
+
+/**
+ * Benchmarks of the persistence path of a
+ * session. The same benchmarks run on each
+ * backend given by its connection string.
+ *
+ * The phase benchmarks split one statement
+ * into sql generation, binding, stepping and
+ * decoding the result. They need prepared
+ * statements and are only added for backends
+ * other than the memory backend.
+ */
+class DatabaseBenchUnit : public oos::unit_test
+{
+public:
+  DatabaseBenchUnit(const std::string &name, const std::string &msg, const std::string &db);
+  virtual ~DatabaseBenchUnit();
+
+  virtual void initialize();
+  virtual void finalize();
+
+  void commit(unsigned long long iterations, unsigned long long size);
+  void load(unsigned long long iterations, unsigned long long rows);
+  void update(unsigned long long iterations);
+  void delete_cascade(unsigned long long iterations);
+  void empty_transaction(unsigned long long iterations);
+  void sequencer_commit(unsigned long long iterations);
+
+  void phase_generate(unsigned long long iterations);
+  void phase_bind(unsigned long long iterations);
+  void phase_step(unsigned long long iterations);
+  void phase_decode(unsigned long long iterations);
+
+private:
+  void remove_file() const;
+
+private:
+  oos::object_store ostore_;
+  std::string db_;
+  std::string file_;
+  oos::session *session_;
+  bool memory_;
+  bool prepared_;
+};
+
+#endif /* DATABASE_BENCHUNIT_HPP */
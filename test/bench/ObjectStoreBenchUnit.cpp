@@ -0,0 +1,284 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ObjectStoreBenchUnit.hpp"
+
+#include "object/object_expression.hpp"
+#include "object/object_serializer.hpp"
+#include "object/object_view.hpp"
+
+#include "tools/byte_buffer.hpp"
+
+#include <sstream>
+
+using namespace oos;
+using namespace std;
+
+namespace {
+
+const char* size_name(size_t size)
+{
+  switch (size) {
+    case 1000: return "1000";
+    case 10000: return "10000";
+    case 100000: return "100000";
+    default: return "1000000";
+  }
+}
+
+}
+
+ObjectStoreBenchUnit::ObjectStoreBenchUnit()
+  : unit_test("store", "ObjectStore Benchmark Unit")
+  , prepared_(false)
+{
+  // one item with its proxy takes about 700 bytes
+  for (size_t size = 1000; size <= 1000000; size *= 10) {
+    std::stringstream caption;
+    caption << "insert and remove one item with " << size << " items";
+    add_benchmark(std::string("insert_remove_") + size_name(size), std::tr1::bind(&ObjectStoreBenchUnit::insert_remove, this, std::tr1::placeholders::_1, size), caption.str());
+  }
+  add_benchmark("ptr_copy", std::tr1::bind(&ObjectStoreBenchUnit::ptr_copy, this, std::tr1::placeholders::_1), "copy and assign object_ptr");
+  add_benchmark("find_proxy_dense", std::tr1::bind(&ObjectStoreBenchUnit::find_proxy, this, std::tr1::placeholders::_1, 1, false), "find proxy by id, 100000 dense ids in order");
+  add_benchmark("find_proxy_random", std::tr1::bind(&ObjectStoreBenchUnit::find_proxy, this, std::tr1::placeholders::_1, 1, true), "find proxy by id, 100000 dense ids in random order");
+  add_benchmark("find_proxy_sparse", std::tr1::bind(&ObjectStoreBenchUnit::find_proxy, this, std::tr1::placeholders::_1, 1000003, true), "find proxy by id, 100000 sparse ids in random order");
+  add_benchmark("find_proxy_get", std::tr1::bind(&ObjectStoreBenchUnit::find_proxy_get, this, std::tr1::placeholders::_1), "find proxy by id and read the object");
+  add_benchmark("view_iterate", std::tr1::bind(&ObjectStoreBenchUnit::view_iterate, this, std::tr1::placeholders::_1), "iterate object_view per object");
+  add_benchmark("view_find_if", std::tr1::bind(&ObjectStoreBenchUnit::view_find_if, this, std::tr1::placeholders::_1), "object_view find_if over 10000 items");
+  add_benchmark("get_by_name", std::tr1::bind(&ObjectStoreBenchUnit::get_by_name, this, std::tr1::placeholders::_1), "object get value by name");
+  add_benchmark("set_by_name", std::tr1::bind(&ObjectStoreBenchUnit::set_by_name, this, std::tr1::placeholders::_1), "object set value by name");
+  add_benchmark("serializer_roundtrip", std::tr1::bind(&ObjectStoreBenchUnit::serializer_roundtrip, this, std::tr1::placeholders::_1), "serialize and deserialize item via byte_buffer");
+  add_benchmark("deleter_list_1000", std::tr1::bind(&ObjectStoreBenchUnit::deleter_list, this, std::tr1::placeholders::_1, 1000), "object_deleter check of list with 1000 items");
+  add_benchmark("deleter_list_100000", std::tr1::bind(&ObjectStoreBenchUnit::deleter_list, this, std::tr1::placeholders::_1, 100000), "object_deleter check of list with 100000 items");
+  add_benchmark("deleter_vector_1000", std::tr1::bind(&ObjectStoreBenchUnit::deleter_vector, this, std::tr1::placeholders::_1, 1000), "object_deleter check of vector with 1000 items");
+  add_benchmark("deleter_vector_100000", std::tr1::bind(&ObjectStoreBenchUnit::deleter_vector, this, std::tr1::placeholders::_1, 100000), "object_deleter check of vector with 100000 items");
+}
+
+ObjectStoreBenchUnit::~ObjectStoreBenchUnit()
+{}
+
+void
+ObjectStoreBenchUnit::initialize()
+{
+  ostore_.insert_prototype<Item>("ITEM");
+  ostore_.insert_prototype<ObjectItem<Item> >("OBJECT_ITEM");
+  ostore_.insert_prototype<ObjectItemPtrList>("OBJECT_ITEM_PTR_LIST");
+  ostore_.insert_prototype<ItemPtrVector>("ITEM_PTR_VECTOR");
+  prepared_ = false;
+}
+
+void
+ObjectStoreBenchUnit::finalize()
+{
+  items_.clear();
+  ids_.clear();
+  list_.reset();
+  vector_.reset();
+  ostore_.clear(true);
+}
+
+void
+ObjectStoreBenchUnit::fill(size_t size)
+{
+  items_.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    items_.push_back(ostore_.insert(new Item("item", static_cast<int>(i))));
+  }
+}
+
+void
+ObjectStoreBenchUnit::fill_ids(size_t size, long step)
+{
+  ids_.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    Item *item = new Item("item", static_cast<int>(i));
+    item->id(1 + static_cast<long>(i) * step);
+    ostore_.insert(item);
+    ids_.push_back(item->id());
+  }
+}
+
+void
+ObjectStoreBenchUnit::find_proxy(unsigned long long iterations, long step, bool random)
+{
+  if (!prepared_) {
+    fill_ids(100000, step);
+    prepared_ = true;
+  }
+  // a prime stride visits the ids in pseudo random order
+  const size_t stride = (random ? 7919 : 1);
+  size_t index = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    index = (index + stride) % ids_.size();
+    object_proxy *proxy = ostore_.find_proxy(ids_[index]);
+    benchmark_use(proxy);
+  }
+}
+
+void
+ObjectStoreBenchUnit::find_proxy_get(unsigned long long iterations)
+{
+  if (!prepared_) {
+    fill_ids(100000, 1);
+    prepared_ = true;
+  }
+  size_t index = 0;
+  long sum = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    index = (index + 7919) % ids_.size();
+    item_ptr item(ostore_.find_proxy(ids_[index]));
+    sum += item->get_int();
+  }
+  benchmark_use(&sum);
+}
+
+void
+ObjectStoreBenchUnit::insert_remove(unsigned long long iterations, size_t size)
+{
+  if (!prepared_) {
+    for (size_t i = 0; i < size; ++i) {
+      ostore_.insert(new Item("item", static_cast<int>(i)));
+    }
+    prepared_ = true;
+  }
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    item_ptr item = ostore_.insert(new Item("bench", static_cast<int>(i)));
+    ostore_.remove(item);
+  }
+}
+
+void
+ObjectStoreBenchUnit::ptr_copy(unsigned long long iterations)
+{
+  if (!prepared_) {
+    fill(1024);
+    prepared_ = true;
+  }
+  item_ptr item;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    item_ptr copy(items_[i & 1023]);
+    item = copy;
+    benchmark_use(&item);
+  }
+}
+
+void
+ObjectStoreBenchUnit::view_iterate(unsigned long long iterations)
+{
+  if (!prepared_) {
+    fill(100000);
+    prepared_ = true;
+  }
+  typedef object_view<Item> item_view_t;
+  item_view_t view(ostore_);
+  item_view_t::iterator first = view.begin();
+  item_view_t::iterator last = view.end();
+  long sum = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    sum += (*first)->get_int();
+    if (++first == last) {
+      first = view.begin();
+    }
+  }
+  benchmark_use(&sum);
+}
+
+void
+ObjectStoreBenchUnit::view_find_if(unsigned long long iterations)
+{
+  if (!prepared_) {
+    fill(10000);
+    prepared_ = true;
+  }
+  typedef object_view<Item> item_view_t;
+  item_view_t view(ostore_);
+  variable<int> x(make_var(&Item::get_int));
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    // the searched items are at the end of the view
+    item_view_t::iterator j = view.find_if(x == static_cast<int>(9999 - (i & 15)));
+    benchmark_use(&j);
+  }
+}
+
+void
+ObjectStoreBenchUnit::get_by_name(unsigned long long iterations)
+{
+  Item item("item", 42);
+  int value = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    item.get("val_int", value);
+    benchmark_use(&value);
+  }
+}
+
+void
+ObjectStoreBenchUnit::set_by_name(unsigned long long iterations)
+{
+  Item item("item", 42);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    item.set("val_int", static_cast<int>(i));
+    benchmark_use(&item);
+  }
+}
+
+void
+ObjectStoreBenchUnit::serializer_roundtrip(unsigned long long iterations)
+{
+  Item item("item", 42);
+  Item copy;
+  object_serializer serializer;
+  byte_buffer buffer;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    serializer.serialize(&item, buffer);
+    serializer.deserialize(&copy, buffer, &ostore_);
+    benchmark_use(&copy);
+  }
+}
+
+void
+ObjectStoreBenchUnit::deleter_list(unsigned long long iterations, size_t size)
+{
+  if (!prepared_) {
+    list_ = ostore_.insert(new ObjectItemPtrList);
+    for (size_t i = 0; i < size; ++i) {
+      object_ptr<ObjectItem<Item> > oitem = ostore_.insert(new ObjectItem<Item>("object item", static_cast<int>(i)));
+      oitem->ptr(ostore_.insert(new Item("item", static_cast<int>(i))));
+      list_->push_back(oitem);
+    }
+    prepared_ = true;
+  }
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    bool removable = ostore_.is_removable(list_);
+    benchmark_use(&removable);
+  }
+}
+
+void
+ObjectStoreBenchUnit::deleter_vector(unsigned long long iterations, size_t size)
+{
+  if (!prepared_) {
+    vector_ = ostore_.insert(new ItemPtrVector);
+    for (size_t i = 0; i < size; ++i) {
+      vector_->push_back(ostore_.insert(new Item("item", static_cast<int>(i))));
+    }
+    prepared_ = true;
+  }
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    bool removable = ostore_.is_removable(vector_);
+    benchmark_use(&removable);
+  }
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECTSTORE_BENCHUNIT_HPP
+#define OBJECTSTORE_BENCHUNIT_HPP
+
+#include "../Item.hpp"
+
+#include "unit/unit_test.hpp"
+
+#include "object/object_ptr.hpp"
+#include "object/object_store.hpp"
+
+#include <vector>
+
+/**
+ * A list of items pointing to another
+ * item building a three level graph.
+ */
+class ObjectItemPtrList : public List<oos::object_ptr<ObjectItem<Item> > >
+{
+public:
+  ObjectItemPtrList() : List<oos::object_ptr<ObjectItem<Item> > >("object_ptr_list") {}
+  virtual ~ObjectItemPtrList() {}
+};
+
+/**
+ * Benchmarks of the object_store hot paths
+ * measured with the types of Item.hpp.
+ */
+class ObjectStoreBenchUnit : public oos::unit_test
+{
+public:
+  ObjectStoreBenchUnit();
+  virtual ~ObjectStoreBenchUnit();
+
+  virtual void initialize();
+  virtual void finalize();
+
+  void insert_remove(unsigned long long iterations, std::size_t size);
+  void find_proxy(unsigned long long iterations, long step, bool random);
+  void find_proxy_get(unsigned long long iterations);
+  void ptr_copy(unsigned long long iterations);
+  void view_iterate(unsigned long long iterations);
+  void view_find_if(unsigned long long iterations);
+  void get_by_name(unsigned long long iterations);
+  void set_by_name(unsigned long long iterations);
+  void serializer_roundtrip(unsigned long long iterations);
+  void deleter_list(unsigned long long iterations, std::size_t size);
+  void deleter_vector(unsigned long long iterations, std::size_t size);
+
+private:
+  void fill(std::size_t size);
+  void fill_ids(std::size_t size, long step);
+
+private:
+  typedef oos::object_ptr<Item> item_ptr;
+
+  oos::object_store ostore_;
+  bool prepared_;
+  std::vector<item_ptr> items_;
+  std::vector<long> ids_;
+  oos::object_ptr<ObjectItemPtrList> list_;
+  oos::object_ptr<ItemPtrVector> vector_;
+};
+
+#endif /* OBJECTSTORE_BENCHUNIT_HPP */
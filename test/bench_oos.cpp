@@ -0,0 +1,38 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench/DatabaseBenchUnit.hpp"
+#include "bench/ObjectStoreBenchUnit.hpp"
+
+#include "unit/test_suite.hpp"
+
+#include "allocation_counter.hpp"
+
+using namespace oos;
+
+int main(int argc, char *argv[])
+{
+  test_suite::instance().init(argc, argv);
+  test_suite::instance().allocation_hook(&allocation_counters);
+
+  test_suite::instance().register_unit(new ObjectStoreBenchUnit());
+  test_suite::instance().register_unit(new DatabaseBenchUnit("sqlite", "sqlite file database benchmark unit", "sqlite://bench.sqlite"));
+  test_suite::instance().register_unit(new DatabaseBenchUnit("sqlite_memory", "sqlite in-memory database benchmark unit", "sqlite://:memory:"));
+  test_suite::instance().register_unit(new DatabaseBenchUnit("memory", "memory database benchmark unit", "memory://"));
+
+  return (test_suite::instance().run() ? 0 : 1);
+}
@@ -24,10 +24,15 @@
 
 #include "database/session.hpp"
 #include "database/transaction.hpp"
+#include "database/database.hpp"
 #include "database/database_exception.hpp"
+#include "database/result.hpp"
+#include "database/sql_tracer.hpp"
+#include "database/query_cursor.hpp"
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cstdio>
 
 using namespace oos;
@@ -52,6 +57,13 @@ DatabaseTestUnit::DatabaseTestUnit(const std::string &name, const std::string &m
   add_test("reload_simple", std::tr1::bind(&DatabaseTestUnit::test_reload_simple, this), "simple reload database test");
   add_test("reload", std::tr1::bind(&DatabaseTestUnit::test_reload, this), "reload database test");
   add_test("reload_container", std::tr1::bind(&DatabaseTestUnit::test_reload_container, this), "reload object list database test");
+  add_test("cache", std::tr1::bind(&DatabaseTestUnit::test_cache, this), "evict and reload objects with a memory budget");
+  add_test("blob", std::tr1::bind(&DatabaseTestUnit::test_blob, this), "write and read a large blob in chunks");
+  add_test("trace", std::tr1::bind(&DatabaseTestUnit::test_trace, this), "trace statements with the slow statement log");
+  add_test("cursor", std::tr1::bind(&DatabaseTestUnit::test_cursor, this), "page through a table with a keyset cursor");
+  add_test("delete_batch", std::tr1::bind(&DatabaseTestUnit::test_delete_batch, this), "delete many items with a few statements");
+  add_test("update_batch", std::tr1::bind(&DatabaseTestUnit::test_update_batch, this), "update many items at commit without results");
+  add_test("update_remove", std::tr1::bind(&DatabaseTestUnit::test_update_remove, this), "update and remove an item in one transaction");
 }
 
 DatabaseTestUnit::~DatabaseTestUnit()
@@ -1049,3 +1061,553 @@ const oos::object_store& DatabaseTestUnit::ostore() const
 {
   return ostore_;
 }
+
+void
+DatabaseTestUnit::test_cache()
+{
+  typedef object_ptr<Item> item_ptr;
+  typedef object_view<Item> oview_t;
+
+  // create database and make object store known to the database
+  session *db = create_session();
+
+  db->create();
+
+  transaction tr(*db);
+  tr.begin();
+  item_ptr last_item;
+  for (int i = 0; i < 100; ++i) {
+    last_item = ostore_.insert(new Item("Item", i));
+  }
+  // without a budget reading an object isn't recorded
+  UNIT_ASSERT_EQUAL(last_item->get_int(), 99, "invalid item");
+  UNIT_ASSERT_EQUAL(ostore_.cache_hits(), 0UL, "access without budget must not be counted");
+  last_item.reset();
+
+  // objects of a running transaction are never evicted
+  ostore_.cache_budget(10 * sizeof(Item));
+
+  UNIT_ASSERT_EQUAL(ostore_.cache_evictions(), 0UL, "dirty objects must not be evicted");
+
+  tr.commit();
+
+  // after commit the budget is enforced
+  ostore_.cache_budget(0);
+  ostore_.cache_budget(10 * sizeof(Item));
+
+  UNIT_ASSERT_TRUE(ostore_.cache_size() <= 10 * sizeof(Item), "cache exceeds memory budget");
+  UNIT_ASSERT_EQUAL(ostore_.cache_evictions(), 90UL, "expected 90 evicted objects");
+
+  oview_t oview(ostore_);
+
+  UNIT_ASSERT_EQUAL((int)oview.size(), 100, "evicted objects must stay in view");
+
+  // accessing the objects reloads them
+  int sum = 0;
+  oview_t::iterator first = oview.begin();
+  oview_t::iterator last = oview.end();
+  while (first != last) {
+    sum += (*first++)->get_int();
+  }
+
+  UNIT_ASSERT_EQUAL(sum, 4950, "invalid sum of reloaded items");
+  UNIT_ASSERT_TRUE(ostore_.cache_misses() >= 90UL, "expected reloaded objects");
+  UNIT_ASSERT_TRUE(ostore_.cache_size() <= 10 * sizeof(Item), "cache exceeds memory budget");
+
+  // a held object pointer keeps its object in memory
+  item_ptr item = *oview.begin();
+  Item *raw = item.get();
+  for (first = oview.begin(); first != last; ++first) {
+    (*first)->get_int();
+  }
+  UNIT_ASSERT_TRUE(item.is_loaded(), "referenced object must not be evicted");
+  UNIT_ASSERT_TRUE(item.get() == raw, "referenced object must not be reloaded");
+
+  // modify object and evict it afterwards
+  long id = item->id();
+  tr.begin();
+  item->set_int(4711);
+  tr.commit();
+  item.reset();
+
+  for (first = oview.begin(); first != last; ++first) {
+    (*first)->get_int();
+  }
+
+  for (first = oview.begin(); first != last; ++first) {
+    if ((*first)->id() == id) {
+      break;
+    }
+  }
+  UNIT_ASSERT_FALSE(first == last, "couldn't find modified object");
+  UNIT_ASSERT_EQUAL((*first)->get_int(), 4711, "reloaded object must contain the update");
+
+  // closing the database reloads the evicted objects
+  unsigned long evictions = ostore_.cache_evictions();
+  UNIT_ASSERT_GREATER(evictions, 0UL, "expected evicted objects");
+
+  db->close();
+
+  UNIT_ASSERT_TRUE(ostore_.loader() == 0, "closed session must not reload objects");
+  UNIT_ASSERT_EQUAL((int)oview.size(), 100, "objects must stay in view");
+  for (first = oview.begin(); first != last; ++first) {
+    item_ptr i = *first;
+    UNIT_ASSERT_NOT_NULL(i.get(), "evicted object must be reloaded on close");
+  }
+
+  // without a loader nothing is evicted
+  ostore_.cache_budget(0);
+  ostore_.cache_budget(10 * sizeof(Item));
+  UNIT_ASSERT_EQUAL(ostore_.cache_evictions(), evictions, "objects must not be evicted without loader");
+
+  db->open();
+
+  UNIT_ASSERT_TRUE(ostore_.loader() == db, "opened session must reload objects");
+
+  // evicted objects which can't be reloaded stay in the store
+  ostore_.cache_budget(0);
+  ostore_.cache_budget(10 * sizeof(Item));
+  int kept = 100 - (int)(ostore_.cache_evictions() - evictions);
+  UNIT_ASSERT_LESS(kept, 100, "expected evicted objects");
+
+  db->drop();
+  db->close();
+
+  ostore_.cache_budget(0);
+
+  UNIT_ASSERT_EQUAL((int)oview.size(), 100, "closing the session must not remove objects");
+  int loaded = 0;
+  for (first = oview.begin(); first != last; ++first) {
+    item_ptr i = *first;
+    if (i.get()) {
+      ++loaded;
+    }
+  }
+  UNIT_ASSERT_EQUAL(loaded, kept, "objects which can't be reloaded must stay evicted");
+
+  delete db;
+}
+
+void
+DatabaseTestUnit::test_blob()
+{
+  session *db = create_session();
+
+  database &impl = db->db();
+
+  std::string sql("CREATE TABLE blob_item (id ");
+  sql += impl.type_string(type_long);
+  sql += " NOT NULL PRIMARY KEY, data ";
+  sql += impl.type_string(type_blob);
+  sql += ");";
+  delete impl.execute(sql);
+  delete impl.execute("INSERT INTO blob_item (id, data) VALUES (1, NULL);");
+
+  // about 3 MB of data
+  std::string data;
+  data.reserve(3 * 1024 * 1024);
+  for (int i = 0; data.size() < 3 * 1024 * 1024; ++i) {
+    data += static_cast<char>(i % 251);
+  }
+
+  blob_stream *writer = impl.create_blob("blob_item", "data", 1, data.size());
+  istringstream in(data);
+  UNIT_ASSERT_EQUAL(writer->write(in), data.size(), "invalid number of written bytes");
+
+  // the value can't grow behind the given size
+  bool failed = false;
+  try {
+    writer->write("x", 1);
+  } catch (database_exception &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "data must not exceed the size of the blob");
+
+  writer->close();
+  delete writer;
+
+  blob_stream *reader = impl.open_blob("blob_item", "data", 1);
+  UNIT_ASSERT_EQUAL(reader->size(), data.size(), "invalid blob size");
+
+  char chunk[1000];
+  UNIT_ASSERT_EQUAL(reader->read(chunk, sizeof(chunk)), sizeof(chunk), "invalid number of read bytes");
+  UNIT_ASSERT_TRUE(data.compare(0, sizeof(chunk), chunk, sizeof(chunk)) == 0, "invalid blob data");
+
+  ostringstream out;
+  UNIT_ASSERT_EQUAL(reader->read(out), data.size() - sizeof(chunk), "invalid number of read bytes");
+  UNIT_ASSERT_TRUE(out.str() == data.substr(sizeof(chunk)), "invalid blob data");
+  UNIT_ASSERT_EQUAL(reader->read(chunk, sizeof(chunk)), (blob_stream::size_type)0, "blob must be read completely");
+
+  reader->close();
+  delete reader;
+
+  failed = false;
+  try {
+    delete impl.open_blob("blob_item", "data", 2);
+  } catch (database_exception &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "open blob of unknown row must fail");
+
+  delete impl.execute("DROP TABLE blob_item;");
+
+  db->close();
+
+  delete db;
+}
+
+void
+DatabaseTestUnit::test_trace()
+{
+  // keep each call as slow call and sample every second call
+  slow_statement_log log(0, 1024, 2);
+  std::stringstream out;
+  log.output(&out);
+
+  session *db = create_session();
+
+  db->create();
+
+  sql_tracer *previous = sql_tracer::install(&log);
+
+  UNIT_ASSERT_TRUE(sql_tracer::enabled(), "tracing must be enabled");
+  UNIT_ASSERT_TRUE(sql_tracer::installed() == &log, "slow statement log must be installed");
+
+  for (int i = 0; i < 5; ++i) {
+    db->insert(new Item());
+  }
+
+  db->close();
+
+  ostore_.clear();
+
+  db->open();
+
+  db->load();
+
+  sql_tracer::install(previous);
+
+  UNIT_ASSERT_GREATER(log.traced(), 0ULL, "calls must be traced");
+  UNIT_ASSERT_EQUAL(log.slow_count(), log.traced(), "each call must be slow");
+  UNIT_ASSERT_EQUAL(log.recent_statements().size(), (size_t)(log.traced() / 2), "every second call must be sampled");
+  UNIT_ASSERT_FALSE(out.str().empty(), "slow calls must be written");
+
+  unsigned long binds = 0;
+  unsigned long executes = 0;
+  unsigned long rows = 0;
+  slow_statement_log::t_entry_vector entries = log.slow_statements();
+  for (slow_statement_log::t_entry_vector::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+    UNIT_ASSERT_FALSE(i->sql.empty(), "sql of traced call must not be empty");
+    if (i->phase == sql_trace_event::TRACE_BIND) {
+      UNIT_ASSERT_GREATER(i->params, 0UL, "bind must have parameters");
+      ++binds;
+    } else if (i->phase == sql_trace_event::TRACE_EXECUTE) {
+      ++executes;
+    } else if (i->phase == sql_trace_event::TRACE_FETCH) {
+      rows += i->rows;
+    }
+  }
+  UNIT_ASSERT_GREATER(binds, 4UL, "each insert must be bound");
+  UNIT_ASSERT_GREATER(executes, 4UL, "each insert must be executed");
+  UNIT_ASSERT_GREATER(rows, 4UL, "each item must be fetched");
+
+  db->drop();
+
+  db->close();
+
+  delete db;
+
+  // the ring buffers keep the newest calls
+  slow_statement_log ring(1000, 4);
+
+  sql_trace_event event;
+  event.phase = sql_trace_event::TRACE_EXECUTE;
+  event.sql = "SELECT 1";
+  for (int i = 0; i < 10; ++i) {
+    event.duration = i * 500;
+    ring.trace(event);
+  }
+
+  UNIT_ASSERT_EQUAL(ring.traced(), 10ULL, "all calls must be traced");
+  UNIT_ASSERT_EQUAL(ring.slow_count(), 8ULL, "calls below the threshold must not be slow");
+  UNIT_ASSERT_TRUE(ring.recent_statements().empty(), "calls must not be sampled");
+
+  entries = ring.slow_statements();
+  UNIT_ASSERT_EQUAL(entries.size(), (size_t)4, "ring must be full");
+  UNIT_ASSERT_EQUAL(entries.front().duration, 3000ULL, "oldest kept call must come first");
+  UNIT_ASSERT_EQUAL(entries.back().duration, 4500ULL, "newest call must come last");
+  UNIT_ASSERT_EQUAL(entries.back().sql, std::string("SELECT 1"), "sql must be kept");
+
+  ring.threshold(10000);
+  ring.sample_rate(3);
+  for (int i = 0; i < 3; ++i) {
+    ring.trace(event);
+  }
+
+  UNIT_ASSERT_EQUAL(ring.slow_count(), 8ULL, "calls below the threshold must not be slow");
+  UNIT_ASSERT_EQUAL(ring.recent_statements().size(), (size_t)1, "every third call must be sampled");
+
+  ring.clear();
+
+  UNIT_ASSERT_EQUAL(ring.traced(), 0ULL, "ring must be cleared");
+  UNIT_ASSERT_TRUE(ring.slow_statements().empty(), "ring must be cleared");
+}
+
+void
+DatabaseTestUnit::test_cursor()
+{
+  session *db = create_session();
+
+  db->create();
+
+  for (int i = 0; i < 25; ++i) {
+    Item *item = new Item("cursor");
+    item->set_int(i);
+    db->insert(item);
+  }
+
+  slow_statement_log log(0, 1024);
+  sql_tracer *previous = sql_tracer::install(&log);
+
+  {
+    query_cursor cursor(*db, *ostore_.find_prototype("item"), 10);
+
+    UNIT_ASSERT_EQUAL(cursor.page_size(), (query_cursor::size_type)10, "invalid page size");
+
+    int count = 0;
+    long last_id = 0;
+    for (query_cursor::iterator i = cursor.begin(); i != cursor.end(); ++i) {
+      Item *item = static_cast<Item*>(*i);
+      UNIT_ASSERT_GREATER(item->id(), last_id, "ids must be ascending");
+      UNIT_ASSERT_EQUAL(item->get_int(), count, "invalid item value");
+      UNIT_ASSERT_EQUAL(item->get_string(), std::string("cursor"), "invalid item string");
+      UNIT_ASSERT_LESS(cursor.page().size(), (query_cursor::size_type)11, "page must not exceed the page size");
+      last_id = item->id();
+      ++count;
+    }
+
+    sql_tracer::install(previous);
+
+    UNIT_ASSERT_EQUAL(count, 25, "all items must be read");
+    UNIT_ASSERT_EQUAL(cursor.pages(), 3UL, "invalid number of pages");
+    UNIT_ASSERT_EQUAL(cursor.last_id(), last_id, "invalid last id");
+    UNIT_ASSERT_TRUE(cursor.page().empty(), "last page must be released");
+
+    unsigned long prepares = 0;
+    unsigned long executes = 0;
+    slow_statement_log::t_entry_vector entries = log.slow_statements();
+    for (slow_statement_log::t_entry_vector::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+      if (i->phase == sql_trace_event::TRACE_PREPARE) {
+        ++prepares;
+      } else if (i->phase == sql_trace_event::TRACE_EXECUTE) {
+        ++executes;
+      }
+    }
+    UNIT_ASSERT_EQUAL(prepares, 1UL, "statement must be prepared once");
+    UNIT_ASSERT_EQUAL(executes, 3UL, "each page must execute the statement once");
+
+    // start behind the first page
+    cursor.rewind();
+    UNIT_ASSERT_TRUE(cursor.fetch(), "first page must be fetched");
+    query_cursor::size_type first_page = cursor.page().size();
+    long after_id = cursor.last_id();
+
+    cursor.rewind(after_id);
+    count = 0;
+    for (query_cursor::iterator i = cursor.begin(); i != cursor.end(); ++i) {
+      UNIT_ASSERT_GREATER((*i)->id(), after_id, "id must be behind the start id");
+      ++count;
+    }
+    UNIT_ASSERT_EQUAL((query_cursor::size_type)count + first_page, (query_cursor::size_type)25, "remaining items must be read");
+
+    // a cursor behind the last row is empty
+    cursor.rewind(last_id);
+    UNIT_ASSERT_TRUE(cursor.begin() == cursor.end(), "cursor must be empty");
+    UNIT_ASSERT_FALSE(cursor.fetch(), "there must be no page");
+  }
+
+  db->drop();
+
+  db->close();
+
+  delete db;
+}
+
+void
+DatabaseTestUnit::test_delete_batch()
+{
+  typedef object_ptr<Item> item_ptr;
+  typedef object_view<Item> item_view;
+
+  session *db = create_session();
+
+  db->create();
+
+  transaction tr(*db);
+  tr.begin();
+  for (int i = 0; i < 605; ++i) {
+    ostore_.insert(new Item("batch", i));
+  }
+  tr.commit();
+
+  slow_statement_log log(0, 1024);
+  sql_tracer *previous = sql_tracer::install(&log);
+
+  item_view oview(ostore_);
+
+  tr.begin();
+  while (!oview.empty()) {
+    item_ptr item = oview.front();
+    ostore_.remove(item);
+  }
+  tr.commit();
+
+  sql_tracer::install(previous);
+
+  unsigned long deletes = 0;
+  slow_statement_log::t_entry_vector entries = log.slow_statements();
+  for (slow_statement_log::t_entry_vector::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+    if (i->phase == sql_trace_event::TRACE_EXECUTE && i->sql.compare(0, 6, "DELETE") == 0) {
+      ++deletes;
+    }
+  }
+  // 512 + 64 + 3 * 8 ids in chunks and 5 ids one by one
+  UNIT_ASSERT_EQUAL(deletes, 10UL, "deleted ids must be deleted in chunks");
+
+  db->close();
+
+  ostore_.clear();
+
+  db->open();
+
+  db->load();
+
+  UNIT_ASSERT_TRUE(oview.empty(), "all items must be deleted");
+
+  db->drop();
+
+  db->close();
+
+  delete db;
+}
+
+void
+DatabaseTestUnit::test_update_batch()
+{
+  typedef object_view<Item> item_view;
+
+  session *db = create_session();
+
+  db->create();
+
+  transaction tr(*db);
+  tr.begin();
+  for (int i = 0; i < 100; ++i) {
+    ostore_.insert(new Item("batch", i));
+  }
+  tr.commit();
+
+  slow_statement_log log(0, 1024);
+  sql_tracer *previous = sql_tracer::install(&log);
+
+  item_view oview(ostore_);
+
+  tr.begin();
+  for (item_view::iterator i = oview.begin(); i != oview.end(); ++i) {
+    (*i)->set_int((*i)->get_int() * 2);
+  }
+  // a second change of the same item is written once
+  oview.front()->set_string("first");
+  tr.commit();
+
+  sql_tracer::install(previous);
+
+  unsigned long updates = 0;
+  unsigned long fetches = 0;
+  slow_statement_log::t_entry_vector entries = log.slow_statements();
+  for (slow_statement_log::t_entry_vector::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+    if (i->sql.compare(0, 11, "UPDATE item") != 0) {
+      continue;
+    }
+    if (i->phase == sql_trace_event::TRACE_EXECUTE) {
+      UNIT_ASSERT_EQUAL(i->rows, 1UL, "each update must change one row");
+      ++updates;
+    } else if (i->phase == sql_trace_event::TRACE_FETCH) {
+      ++fetches;
+    }
+  }
+  UNIT_ASSERT_EQUAL(updates, 100UL, "each item must be updated once");
+  UNIT_ASSERT_EQUAL(fetches, 0UL, "updates must not create results");
+
+  db->close();
+
+  ostore_.clear();
+
+  db->open();
+
+  db->load();
+
+  UNIT_ASSERT_EQUAL(oview.size(), (size_t)100, "all items must be loaded");
+
+  int sum = 0;
+  for (item_view::iterator i = oview.begin(); i != oview.end(); ++i) {
+    sum += (*i)->get_int();
+  }
+  UNIT_ASSERT_EQUAL(sum, 9900, "updated values must be written");
+  UNIT_ASSERT_EQUAL(oview.front()->get_string(), std::string("first"), "updated string must be written");
+
+  db->drop();
+
+  db->close();
+
+  delete db;
+}
+
+void
+DatabaseTestUnit::test_update_remove()
+{
+  typedef object_ptr<Item> item_ptr;
+  typedef object_view<Item> item_view;
+
+  session *db = create_session();
+
+  db->create();
+
+  transaction tr(*db);
+  tr.begin();
+  item_ptr first = ostore_.insert(new Item("first", 1));
+  item_ptr second = ostore_.insert(new Item("second", 2));
+  tr.commit();
+
+  long first_id = first->id();
+
+  tr.begin();
+  // the update of the removed item must be dropped
+  first->set_int(10);
+  ostore_.remove(first);
+  second->set_int(20);
+  // an item inserted and removed is never written
+  item_ptr third = ostore_.insert(new Item("third", 3));
+  ostore_.remove(third);
+  tr.commit();
+
+  db->close();
+
+  ostore_.clear();
+
+  db->open();
+
+  db->load();
+
+  item_view oview(ostore_);
+
+  UNIT_ASSERT_EQUAL(oview.size(), (size_t)1, "only one item must be left");
+  UNIT_ASSERT_NOT_EQUAL(oview.front()->id(), first_id, "removed item must not be loaded");
+  UNIT_ASSERT_EQUAL(oview.front()->get_int(), 20, "update must be written");
+
+  db->drop();
+
+  db->close();
+
+  delete db;
+}
@@ -52,6 +52,13 @@ public:
   void test_reload_simple();
   void test_reload();
   void test_reload_container();
+  void test_cache();
+  void test_blob();
+  void test_trace();
+  void test_cursor();
+  void test_delete_batch();
+  void test_update_batch();
+  void test_update_remove();
 
 protected:
   oos::session* create_session();
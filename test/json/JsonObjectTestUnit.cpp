@@ -0,0 +1,319 @@
+#include "JsonObjectTestUnit.hpp"
+
+#include "json/json_object_writer.hpp"
+#include "json/json_object_reader.hpp"
+
+#include "object/object_store.hpp"
+#include "object/object_view.hpp"
+#include "object/object_serializer.hpp"
+
+#include "tools/byte_buffer.hpp"
+
+#include "../Item.hpp"
+
+#include <sstream>
+#include <map>
+#include <string>
+
+using namespace oos;
+using namespace std;
+
+JsonObjectTestUnit::JsonObjectTestUnit()
+  : unit_test("json_object", "json object mapping")
+  , prepared_(false)
+{
+  add_test("write", std::tr1::bind(&JsonObjectTestUnit::test_write, this), "write object as json");
+  add_test("read", std::tr1::bind(&JsonObjectTestUnit::test_read, this), "read object from json");
+  add_test("reference", std::tr1::bind(&JsonObjectTestUnit::test_reference, this), "read and write object references");
+  add_test("container", std::tr1::bind(&JsonObjectTestUnit::test_container, this), "read and write object containers");
+  add_test("import", std::tr1::bind(&JsonObjectTestUnit::test_import, this), "bulk export and import of objects");
+
+  add_benchmark("export", std::tr1::bind(&JsonObjectTestUnit::export_items, this, std::tr1::placeholders::_1), "export 1000 items as json");
+  add_benchmark("import", std::tr1::bind(&JsonObjectTestUnit::import_items, this, std::tr1::placeholders::_1), "import 1000 items from json into a cleared store");
+  add_benchmark("serializer", std::tr1::bind(&JsonObjectTestUnit::serialize_items, this, std::tr1::placeholders::_1), "serialize 1000 items with the object_serializer");
+}
+
+JsonObjectTestUnit::~JsonObjectTestUnit()
+{}
+
+void JsonObjectTestUnit::initialize()
+{
+  ostore_.insert_prototype<Item>("ITEM");
+  copy_.insert_prototype<Item>("ITEM");
+  prepared_ = false;
+}
+
+void JsonObjectTestUnit::finalize()
+{
+  json_.clear();
+  copy_.clear(true);
+  ostore_.clear(true);
+}
+
+void JsonObjectTestUnit::test_write()
+{
+  Item item("say \"hello\"\n\tworld", 42);
+  item.set_double(0.5);
+  item.set_bool(false);
+
+  json_object_writer writer;
+  string out;
+  writer.serialize(&item, out);
+
+  UNIT_ASSERT_EQUAL(out.substr(0, 20), "{\"id\":0,\"val_char\":\"", "invalid json start");
+  UNIT_ASSERT_TRUE(out.find("\"val_double\":0.5,") != string::npos, "double not written");
+  UNIT_ASSERT_TRUE(out.find("\"val_int\":42,") != string::npos, "int not written");
+  UNIT_ASSERT_TRUE(out.find("\"val_bool\":false,") != string::npos, "bool not written");
+  UNIT_ASSERT_TRUE(out.find("\"val_cstr\":\"Hallo\",") != string::npos, "character array not written");
+  UNIT_ASSERT_TRUE(out.find("\"val_string\":\"say \\\"hello\\\"\\n\\tworld\",") != string::npos, "string not escaped");
+  UNIT_ASSERT_TRUE(out.find("\"val_varchar\":\"Erde\"}") != string::npos, "varchar not written");
+
+  // control characters are written as unicode escapes
+  out.clear();
+  item.set_string(string("a\x01" "b", 3));
+  writer.serialize(&item, out);
+  UNIT_ASSERT_TRUE(out.find("\"val_string\":\"a\\u0001b\"") != string::npos, "control character not escaped");
+}
+
+void JsonObjectTestUnit::test_read()
+{
+  Item item("say \"hello\"\n\tworld", 42);
+  item.set_char('x');
+  item.set_float(-2.75f);
+  item.set_double(1e-300);
+  item.set_short(-3);
+  item.set_long(-1234567);
+  item.set_unsigned_short(65535);
+  item.set_unsigned_int(4000000000U);
+  item.set_unsigned_long(123456789UL);
+  item.set_bool(false);
+  item.set_cstr("Tschuess", 9);
+  item.set_varchar(varchar<64>("Mond"));
+
+  json_object_writer writer;
+  string out;
+  writer.serialize(&item, out);
+
+  object_store ostore;
+  json_object_reader reader(ostore);
+  Item copy;
+  reader.deserialize(&copy, out.data(), out.size());
+
+  UNIT_ASSERT_EQUAL(copy.get_char(), 'x', "invalid char");
+  UNIT_ASSERT_EQUAL(copy.get_float(), -2.75f, "invalid float");
+  UNIT_ASSERT_EQUAL(copy.get_double(), 1e-300, "invalid double");
+  UNIT_ASSERT_EQUAL(copy.get_short(), (short)-3, "invalid short");
+  UNIT_ASSERT_EQUAL(copy.get_int(), 42, "invalid int");
+  UNIT_ASSERT_EQUAL(copy.get_long(), -1234567L, "invalid long");
+  UNIT_ASSERT_EQUAL(copy.get_unsigned_short(), (unsigned short)65535, "invalid unsigned short");
+  UNIT_ASSERT_EQUAL(copy.get_unsigned_int(), 4000000000U, "invalid unsigned int");
+  UNIT_ASSERT_EQUAL(copy.get_unsigned_long(), 123456789UL, "invalid unsigned long");
+  UNIT_ASSERT_FALSE(copy.get_bool(), "invalid bool");
+  UNIT_ASSERT_EQUAL(string(copy.get_cstr()), "Tschuess", "invalid character array");
+  UNIT_ASSERT_EQUAL(copy.get_string(), "say \"hello\"\n\tworld", "invalid string");
+  UNIT_ASSERT_EQUAL(copy.get_varchar().str(), "Mond", "invalid varchar");
+
+  // members are found in any order, unknown members are skipped
+  const char *json = "{ \"val_string\" : \"reordered\", \"unknown\" : { \"a\" : [ 1, 2 ] }, \"val_int\" : 7 }";
+  reader.deserialize(&copy, json, strlen(json));
+  UNIT_ASSERT_EQUAL(copy.get_string(), "reordered", "invalid reordered string");
+  UNIT_ASSERT_EQUAL(copy.get_int(), 7, "invalid reordered int");
+  UNIT_ASSERT_EQUAL(copy.get_long(), -1234567L, "missing member must keep the value");
+
+  const char *invalid[] = {
+    "[ 1, 2 ]",
+    "{ \"val_int\" : \"text\" }",
+    "{ \"val_string\" : 1 }"
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+    bool failed = false;
+    try {
+      reader.deserialize(&copy, invalid[i], strlen(invalid[i]));
+    } catch (std::logic_error &) {
+      failed = true;
+    }
+    UNIT_ASSERT_TRUE(failed, string("reading must fail: ") + invalid[i]);
+  }
+}
+
+void JsonObjectTestUnit::test_reference()
+{
+  typedef ObjectItem<Item> object_item;
+
+  object_store ostore;
+  ostore.insert_prototype<Item>("ITEM");
+  ostore.insert_prototype<object_item>("OBJECT_ITEM");
+
+  object_ptr<Item> item = ostore.insert(new Item("referenced", 1));
+  object_ptr<object_item> oitem = ostore.insert(new object_item("referencing", 2));
+  oitem->ref(item);
+
+  json_object_writer writer;
+  stringstream items, oitems;
+  writer.serialize(object_view<Item>(ostore), items);
+  writer.serialize(object_view<object_item>(ostore), oitems);
+
+  stringstream expected;
+  expected << "\"ref\":" << item.id() << ",\"ptr\":" << oitem->ptr().id() << "}";
+  UNIT_ASSERT_TRUE(oitems.str().find(expected.str()) != string::npos, "invalid reference ids");
+
+  // referenced objects are imported first
+  object_store copy;
+  copy.insert_prototype<Item>("ITEM");
+  copy.insert_prototype<object_item>("OBJECT_ITEM");
+
+  json_object_reader reader(copy);
+  UNIT_ASSERT_EQUAL(reader.import<Item>(items), (size_t)2, "invalid number of imported items");
+  UNIT_ASSERT_EQUAL(reader.import<object_item>(oitems), (size_t)1, "invalid number of imported object items");
+
+  object_view<object_item> oview(copy);
+  object_ptr<object_item> ocopy = oview.front();
+  UNIT_ASSERT_EQUAL(ocopy.id(), oitem.id(), "invalid object id");
+  UNIT_ASSERT_EQUAL(ocopy->ref().id(), item.id(), "invalid reference id");
+  UNIT_ASSERT_EQUAL(ocopy->ref()->get_string(), "referenced", "invalid referenced object");
+  UNIT_ASSERT_EQUAL(ocopy->ptr().id(), oitem->ptr().id(), "invalid pointer id");
+  UNIT_ASSERT_EQUAL(ocopy->ref().ref_count(), 1UL, "invalid reference count");
+}
+
+void JsonObjectTestUnit::test_container()
+{
+  object_store ostore;
+  ostore.insert_prototype<Item>("ITEM");
+  ostore.insert_prototype<ItemPtrList>("ITEM_PTR_LIST");
+
+  object_ptr<ItemPtrList> list = ostore.insert(new ItemPtrList);
+  for (int i = 0; i < 3; ++i) {
+    list->push_back(ostore.insert(new Item("item", i)));
+  }
+
+  json_object_writer writer;
+  string out;
+  writer.serialize(list.get(), out);
+
+  stringstream expected;
+  expected << "{\"id\":" << list.id() << ",\"ptr_list\":[";
+  for (ItemPtrList::const_iterator i = list->begin(); i != list->end(); ++i) {
+    expected << (i != list->begin() ? "," : "") << (*i).id();
+  }
+  expected << "]}";
+  UNIT_ASSERT_EQUAL(out, expected.str(), "invalid container json");
+
+  // the container gets the items of the ids
+  json_object_reader reader(ostore);
+  ItemPtrList copy;
+  reader.deserialize(&copy, out.data(), out.size());
+  UNIT_ASSERT_EQUAL(copy.size(), (ItemPtrList::size_type)3, "invalid container size");
+}
+
+namespace {
+
+void fill_items(object_store &ostore, int count)
+{
+  for (int i = 0; i < count; ++i) {
+    stringstream name;
+    name << "item \"" << i << "\"";
+    Item *item = new Item(name.str(), i);
+    item->set_double(i * 0.1);
+    item->set_long(-i * 1000L);
+    item->set_bool(i % 2 == 0);
+    ostore.insert(item);
+  }
+}
+
+}
+
+void JsonObjectTestUnit::test_import()
+{
+  object_store ostore;
+  ostore.insert_prototype<Item>("ITEM");
+  fill_items(ostore, 5000);
+
+  json_object_writer writer;
+  stringstream out;
+  UNIT_ASSERT_EQUAL(writer.serialize(object_view<Item>(ostore), out), (size_t)5000, "invalid number of exported objects");
+
+  object_store copy;
+  copy.insert_prototype<Item>("ITEM");
+  json_object_reader reader(copy);
+  UNIT_ASSERT_EQUAL(reader.import<Item>(out), (size_t)5000, "invalid number of imported objects");
+
+  // the views may differ in order, compare by id
+  map<long, object_ptr<Item> > items;
+  object_view<Item> view(ostore);
+  for (object_view<Item>::const_iterator i = view.begin(); i != view.end(); ++i) {
+    items.insert(make_pair((*i).id(), *i));
+  }
+  object_view<Item> copy_view(copy);
+  size_t count = 0;
+  for (object_view<Item>::const_iterator j = copy_view.begin(); j != copy_view.end(); ++j, ++count) {
+    map<long, object_ptr<Item> >::const_iterator i = items.find((*j).id());
+    UNIT_ASSERT_TRUE(i != items.end(), "invalid id");
+    UNIT_ASSERT_EQUAL(i->second->get_string(), (*j)->get_string(), "invalid string");
+    UNIT_ASSERT_EQUAL(i->second->get_double(), (*j)->get_double(), "invalid double");
+    UNIT_ASSERT_EQUAL(i->second->get_long(), (*j)->get_long(), "invalid long");
+    UNIT_ASSERT_EQUAL(i->second->get_bool(), (*j)->get_bool(), "invalid bool");
+  }
+  UNIT_ASSERT_EQUAL(count, items.size(), "views must have the same size");
+
+  // the sequence continues behind the imported ids
+  object_ptr<Item> item = copy.insert(new Item);
+  UNIT_ASSERT_GREATER(item.id(), 5000L, "new id must not collide with imported ids");
+
+  bool failed = false;
+  try {
+    reader.import("UNKNOWN", "[]", 2);
+  } catch (object_exception &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "import of unknown type must fail");
+}
+
+void JsonObjectTestUnit::prepare_benchmark()
+{
+  if (prepared_) {
+    return;
+  }
+  fill_items(ostore_, BENCHMARK_OBJECTS);
+  json_object_writer writer;
+  stringstream out;
+  writer.serialize(object_view<Item>(ostore_), out);
+  json_ = out.str();
+  prepared_ = true;
+}
+
+void JsonObjectTestUnit::export_items(unsigned long long iterations)
+{
+  prepare_benchmark();
+  json_object_writer writer;
+  object_view<Item> view(ostore_);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    stringstream out;
+    writer.serialize(view, out);
+    benchmark_use(&out);
+  }
+}
+
+void JsonObjectTestUnit::import_items(unsigned long long iterations)
+{
+  prepare_benchmark();
+  json_object_reader reader(copy_);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    copy_.clear();
+    reader.import<Item>(json_.data(), json_.size());
+  }
+}
+
+void JsonObjectTestUnit::serialize_items(unsigned long long iterations)
+{
+  prepare_benchmark();
+  object_serializer serializer;
+  byte_buffer buffer;
+  object_view<Item> view(ostore_);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    buffer.clear();
+    for (object_view<Item>::const_iterator j = view.begin(); j != view.end(); ++j) {
+      serializer.serialize((*j).get(), buffer);
+    }
+    benchmark_use(&buffer);
+  }
+}
@@ -0,0 +1,41 @@
+#ifndef JSONOBJECTTESTUNIT_HPP
+#define JSONOBJECTTESTUNIT_HPP
+
+#include "unit/unit_test.hpp"
+
+#include "object/object_store.hpp"
+
+#include <string>
+
+class JsonObjectTestUnit : public oos::unit_test
+{
+public:
+  JsonObjectTestUnit();
+  virtual ~JsonObjectTestUnit();
+
+  virtual void initialize();
+  virtual void finalize();
+
+  void test_write();
+  void test_read();
+  void test_reference();
+  void test_container();
+  void test_import();
+
+  void export_items(unsigned long long iterations);
+  void import_items(unsigned long long iterations);
+  void serialize_items(unsigned long long iterations);
+
+private:
+  void prepare_benchmark();
+
+private:
+  enum { BENCHMARK_OBJECTS = 1000 };
+
+  oos::object_store ostore_;
+  oos::object_store copy_;
+  std::string json_;
+  bool prepared_;
+};
+
+#endif /* JSONOBJECTTESTUNIT_HPP */
@@ -1,23 +1,80 @@
 #include "JsonTestUnit.hpp"
 
 #include "json/json.hpp"
+#include "json/json_numeric.hpp"
 
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 using namespace oos;
 
+namespace {
+
+// xorshift generator to get reproducible random bits
+unsigned long long next_random(unsigned long long &state)
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+double random_double(unsigned long long &state)
+{
+  double d;
+  do {
+    unsigned long long bits = next_random(state);
+    memcpy(&d, &bits, sizeof(d));
+  } while (d != d || d - d != 0);
+  return d;
+}
+
+}
+
 JsonTestUnit::JsonTestUnit()
   : unit_test("json", "json test unit")
 {
   add_test("simple", std::tr1::bind(&JsonTestUnit::simple_test, this), "simple json test");
   add_test("string", std::tr1::bind(&JsonTestUnit::string_test, this), "string json test");
   add_test("number", std::tr1::bind(&JsonTestUnit::number_test, this), "number json test");
+  add_test("number_roundtrip", std::tr1::bind(&JsonTestUnit::number_roundtrip_test, this), "number round-trip json test");
   add_test("create", std::tr1::bind(&JsonTestUnit::create_test, this), "create json test");
   add_test("access", std::tr1::bind(&JsonTestUnit::access_test, this), "access json test");
   add_test("parser", std::tr1::bind(&JsonTestUnit::parser_test, this), "parser json test");
+  add_test("buffer", std::tr1::bind(&JsonTestUnit::buffer_test, this), "buffer parser json test");
+  add_test("document", std::tr1::bind(&JsonTestUnit::document_test, this), "json document test");
+  add_test("reader", std::tr1::bind(&JsonTestUnit::reader_test, this), "streaming json reader test");
+  add_test("writer", std::tr1::bind(&JsonTestUnit::writer_test, this), "buffered json writer test");
+
+  add_benchmark("parse_number_istream", std::tr1::bind(&JsonTestUnit::parse_number_istream, this, std::tr1::placeholders::_1), "read a number with istream");
+  add_benchmark("parse_number", std::tr1::bind(&JsonTestUnit::parse_number, this, std::tr1::placeholders::_1), "parse a number with json_parse_number");
+  add_benchmark("format_number_ostream", std::tr1::bind(&JsonTestUnit::format_number_ostream, this, std::tr1::placeholders::_1), "write a number with ostream");
+  add_benchmark("format_number", std::tr1::bind(&JsonTestUnit::format_number, this, std::tr1::placeholders::_1), "format a number with json_format_number");
+  add_benchmark("parse_istream", std::tr1::bind(&JsonTestUnit::parse_istream, this, std::tr1::placeholders::_1), "parse a 5000 event document from istream");
+  add_benchmark("parse_buffer", std::tr1::bind(&JsonTestUnit::parse_buffer, this, std::tr1::placeholders::_1), "parse a 5000 event document from buffer");
+  add_benchmark("scan_istream", std::tr1::bind(&JsonTestUnit::scan_istream, this, std::tr1::placeholders::_1), "scan a 5000 event document from istream without json_value");
+  add_benchmark("scan_buffer", std::tr1::bind(&JsonTestUnit::scan_buffer, this, std::tr1::placeholders::_1), "scan a 5000 event document from buffer without json_value");
+  add_benchmark("parse_document", std::tr1::bind(&JsonTestUnit::parse_document, this, std::tr1::placeholders::_1), "parse a 5000 event document into a json_document");
+  add_benchmark("read_chunks", std::tr1::bind(&JsonTestUnit::read_chunks, this, std::tr1::placeholders::_1), "read a 5000 event document with json_reader in 64 KB chunks");
+  add_benchmark("write_ostream", std::tr1::bind(&JsonTestUnit::write_ostream, this, std::tr1::placeholders::_1), "write a 5000 event document to ostream");
+  add_benchmark("write_buffer", std::tr1::bind(&JsonTestUnit::write_buffer, this, std::tr1::placeholders::_1), "write a 5000 event document compact with json_writer");
+
+  // values shared by the number benchmarks
+  unsigned long long state = 88172645463325252ULL;
+  for (int i = 0; i < BENCHMARK_VALUES; ++i) {
+    values_.push_back(i % 2 ? random_double(state) : double(next_random(state) % 1000000) / 1000.0);
+    stringstream str;
+    str.precision(17);
+    str << values_.back();
+    numbers_.push_back(str.str());
+  }
 }
 
 JsonTestUnit::~JsonTestUnit()
@@ -77,6 +134,136 @@ void JsonTestUnit::number_test()
     
     UNIT_ASSERT_EQUAL(numb.value(), 1.99998E+10, "values are not equal");
   }
+  {
+    // 64 bit ids keep their precision
+    json_parser parser;
+    json_value v = parser.parse("{ \"id\" : 9007199254740993, \"max\" : 9223372036854775807, \"min\" : -9223372036854775808, \"real\" : 2.5, \"big\" : 9223372036854775808 }");
+
+    json_number id = v["id"];
+    UNIT_ASSERT_TRUE(id.is_integer(), "id must be an integer");
+    UNIT_ASSERT_EQUAL(id.integer(), 9007199254740993LL, "id lost precision");
+
+    json_number max = v["max"];
+    UNIT_ASSERT_EQUAL(max.integer(), 9223372036854775807LL, "invalid max integer");
+    json_number min = v["min"];
+    UNIT_ASSERT_EQUAL(min.integer(), -9223372036854775807LL - 1, "invalid min integer");
+
+    json_number real = v["real"];
+    UNIT_ASSERT_FALSE(real.is_integer(), "real must not be an integer");
+    UNIT_ASSERT_EQUAL(real.value(), 2.5, "invalid real value");
+
+    json_number big = v["big"];
+    UNIT_ASSERT_FALSE(big.is_integer(), "big must not be an integer");
+
+    stringstream out;
+    out << v;
+    UNIT_ASSERT_EQUAL(out.str(), "{ \"big\" : 9223372036854776000.0, \"id\" : 9007199254740993, \"max\" : 9223372036854775807, \"min\" : -9223372036854775808, \"real\" : 2.5 }", "invalid printed numbers");
+
+    json_document doc;
+    json_node root = doc.parse("[ 9007199254740993, 0.1, 1e300 ]");
+    UNIT_ASSERT_TRUE(root[0].is_integer(), "document must keep integers");
+    UNIT_ASSERT_EQUAL(root[0].as_integer(), 9007199254740993LL, "document integer lost precision");
+    out.str("");
+    out << root;
+    UNIT_ASSERT_EQUAL(out.str(), "[ 9007199254740993, 0.1, 1e+300 ]", "invalid printed document numbers");
+  }
+  {
+    // formatting
+    char buf[JSON_NUMBER_BUFFER_SIZE];
+    const double values[] = { 0.0, 1.0, -2.5, 0.1, 1e21, 1e-7, 123456.789, 5e-324, 1.7976931348623157e308, 0.000001 };
+    const char *results[] = { "0.0", "1.0", "-2.5", "0.1", "1e+21", "1e-7", "123456.789", "5e-324", "1.7976931348623157e+308", "0.000001" };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+      string str(buf, json_format_number(values[i], buf));
+      UNIT_ASSERT_EQUAL(str, results[i], "invalid formatted number");
+    }
+    // invalid numbers
+    const char *invalid[] = { "[ 01 ]", "[ 1. ]", "[ - ]", "[ 1e ]", "[ .5 ]", "[ 1x ]" };
+    json_parser parser;
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+      bool failed = false;
+      try {
+        parser.parse(invalid[i]);
+      } catch (std::logic_error &) {
+        failed = true;
+      }
+      UNIT_ASSERT_TRUE(failed, string("parsing must fail: ") + invalid[i]);
+    }
+  }
+}
+
+void JsonTestUnit::number_roundtrip_test()
+{
+  unsigned long long state = 88172645463325252ULL;
+  char buf[JSON_NUMBER_BUFFER_SIZE];
+
+  for (int i = 0; i < 1000000; ++i) {
+    double d = (i % 2 ? random_double(state) : double(next_random(state) % 1000000) / 1000.0);
+    size_t len = json_format_number(d, buf);
+
+    bool is_integer = true;
+    long long integer = 0;
+    double real = 0.0;
+    const char *end = json_parse_number(buf, buf + len, is_integer, integer, real);
+    UNIT_ASSERT_TRUE(end == buf + len, "formatted number must be parsed completely");
+    UNIT_ASSERT_FALSE(is_integer, "formatted double must not be an integer");
+    UNIT_ASSERT_TRUE(memcmp(&d, &real, sizeof(d)) == 0, "double must survive a round-trip");
+
+    // parsing agrees with strtod
+    string str(buf, len);
+    UNIT_ASSERT_TRUE(strtod(str.c_str(), 0) == d, "strtod must read the same double");
+  }
+
+  for (int i = 0; i < 100000; ++i) {
+    long long v = static_cast<long long>(next_random(state));
+    size_t len = json_format_integer(v, buf);
+    bool is_integer = false;
+    long long integer = 0;
+    double real = 0.0;
+    json_parse_number(buf, buf + len, is_integer, integer, real);
+    UNIT_ASSERT_TRUE(is_integer, "formatted integer must be an integer");
+    UNIT_ASSERT_EQUAL(integer, v, "integer must survive a round-trip");
+  }
+}
+
+void JsonTestUnit::parse_number_istream(unsigned long long iterations)
+{
+  double value = 0.0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    istringstream in(numbers_[i % BENCHMARK_VALUES]);
+    in >> value;
+    benchmark_use(&value);
+  }
+}
+
+void JsonTestUnit::parse_number(unsigned long long iterations)
+{
+  bool is_integer;
+  long long integer;
+  double value;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    const string &number = numbers_[i % BENCHMARK_VALUES];
+    json_parse_number(number.data(), number.data() + number.size(), is_integer, integer, value);
+    benchmark_use(&value);
+  }
+}
+
+void JsonTestUnit::format_number_ostream(unsigned long long iterations)
+{
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    stringstream out;
+    out.precision(17);
+    out << values_[i % BENCHMARK_VALUES];
+    benchmark_use(&out);
+  }
+}
+
+void JsonTestUnit::format_number(unsigned long long iterations)
+{
+  char buf[JSON_NUMBER_BUFFER_SIZE];
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    json_format_number(values_[i % BENCHMARK_VALUES], buf);
+    benchmark_use(buf);
+  }
 }
 
 void JsonTestUnit::create_test()
@@ -153,3 +340,573 @@ void JsonTestUnit::parser_test()
   
   UNIT_ASSERT_EQUAL(out.str(), result, "result isn't as expected");
 }
+
+void JsonTestUnit::buffer_test()
+{
+  json_parser parser;
+
+  // whitespace and string runs longer than a scan block
+  string blank(100, ' ');
+  string text(70, 'x');
+  text += "\\\"" + string(40, 'y') + "\\n";
+
+  string str = blank + "{" + blank + "\"text\"" + blank + ":\"" + text + "\",\n\t\"array\":[1,-2.5e2 ,true,\r\nnull], \"empty\" : { }, \"none\" : [ ]}" + blank;
+
+  json_value v = parser.parse(str);
+
+  json_string s = v["text"];
+  UNIT_ASSERT_EQUAL(s.value(), string(70, 'x') + "\"" + string(40, 'y') + "\n", "invalid string value");
+  json_array ary = v["array"];
+  UNIT_ASSERT_TRUE(ary.size() == 4, "json array must contain 4 elements");
+  json_number numb = ary[1];
+  UNIT_ASSERT_EQUAL(numb.value(), -250.0, "invalid number value");
+
+  // the buffer doesn't need to be null terminated
+  const char buf[] = "[1,2,3]]]]";
+  v = parser.parse(buf, 7);
+  ary = v;
+  UNIT_ASSERT_TRUE(ary.size() == 3, "json array must contain 3 elements");
+
+  // buffer and stream parser must agree
+  string doc("{ \"a\" : [ 1, 2, { \"b\" : \"c\\td\" } ], \"e\" : false }");
+  stringstream buffer_out, stream_out;
+  buffer_out << parser.parse(doc.c_str());
+  istringstream in(doc);
+  stream_out << parser.parse(in);
+  UNIT_ASSERT_EQUAL(buffer_out.str(), stream_out.str(), "buffer and stream results differ");
+
+  // numbers longer than any fixed buffer
+  string digits = "0." + string(80, '0') + "125e81";
+  string long_doc = "[ " + digits + " ]";
+  istringstream long_in(long_doc);
+  ary = parser.parse(long_in);
+  numb = ary[0];
+  UNIT_ASSERT_EQUAL(numb.value(), 1.25, "invalid long stream number");
+  ary = parser.parse(long_doc.c_str());
+  numb = ary[0];
+  UNIT_ASSERT_EQUAL(numb.value(), 1.25, "invalid long buffer number");
+  json_number long_numb;
+  istringstream long_numb_in(digits + " ");
+  UNIT_ASSERT_TRUE(long_numb.parse(long_numb_in), "long json_number must be parsed");
+  UNIT_ASSERT_EQUAL(long_numb.value(), 1.25, "invalid long json_number");
+
+  const char *invalid[] = {
+    "",
+    "   ",
+    "{ \"a\" : 1 } x",
+    "{ \"a\" 1 }",
+    "{ \"a\" : \"unterminated }",
+    "[ 1, 2 ",
+    "[ tru ]",
+    "[ 1x ]",
+    "[ \"\\q\" ]"
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+    bool failed = false;
+    try {
+      parser.parse(invalid[i]);
+    } catch (std::logic_error &) {
+      failed = true;
+    }
+    UNIT_ASSERT_TRUE(failed, string("parsing must fail: ") + invalid[i]);
+  }
+
+  // parse a mapped file
+  const char *filename = "json_buffer_test.json";
+  FILE *f = fopen(filename, "w");
+  UNIT_ASSERT_NOT_NULL(f, "couldn't create json file");
+  fputs(str.c_str(), f);
+  fclose(f);
+  v = parser.parse_file(filename);
+  remove(filename);
+  s = v["text"];
+  UNIT_ASSERT_EQUAL(s.value(), string(70, 'x') + "\"" + string(40, 'y') + "\n", "invalid string value of file");
+}
+
+void JsonTestUnit::document_test()
+{
+  string str("{ \"text\" : \"hello world!\", \"bool\" : false, \"array\" : [ null, true, -5.66667 ], \"object\" : { \"found\" : true }, \"empty\" : { } }");
+
+  json_document doc;
+  json_node root = doc.parse(str);
+
+  UNIT_ASSERT_TRUE(root.is_object(), "root must be an object");
+  UNIT_ASSERT_EQUAL((int)root.size(), 5, "root must have 5 members");
+  UNIT_ASSERT_EQUAL(root["text"].as_string(), "hello world!", "invalid string");
+  UNIT_ASSERT_EQUAL(strcmp(root["text"].c_str(), "hello world!"), 0, "invalid c string");
+  UNIT_ASSERT_FALSE(root["bool"].as_bool(), "bool must be false");
+  UNIT_ASSERT_TRUE(root["array"][0].is_null(), "first element must be null");
+  UNIT_ASSERT_TRUE(root["array"][1].as_bool(), "second element must be true");
+  UNIT_ASSERT_EQUAL(root["array"][2].as_number(), -5.66667, "invalid number");
+  UNIT_ASSERT_TRUE(root["object"]["found"].as_bool(), "found must be true");
+  UNIT_ASSERT_EQUAL((int)root["empty"].size(), 0, "empty object expected");
+  UNIT_ASSERT_TRUE(root.contains("text"), "key text expected");
+  UNIT_ASSERT_FALSE(root.contains("missing"), "key missing not expected");
+  UNIT_ASSERT_EQUAL(root.key(0), "text", "members must keep their order");
+
+  bool failed = false;
+  try {
+    root["missing"];
+  } catch (std::logic_error &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "missing key must throw");
+
+  failed = false;
+  try {
+    root["text"][0];
+  } catch (std::logic_error &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "index access on string must throw");
+
+  // the converted structure prints like the json_parser result
+  json_parser parser;
+  stringstream doc_out, parser_out;
+  doc_out << root.to_value();
+  parser_out << parser.parse(str);
+  UNIT_ASSERT_EQUAL(doc_out.str(), parser_out.str(), "converted document differs");
+
+  stringstream out;
+  out << root["array"];
+  UNIT_ASSERT_EQUAL(out.str(), "[ null, true, -5.66667 ]", "invalid printed array");
+
+  // large objects are hashed, the last duplicate key wins
+  stringstream big;
+  big << "{";
+  for (int i = 0; i < 100; ++i) {
+    big << "\"key" << i << "\" : " << i << ", ";
+  }
+  big << "\"key7\" : 700 }";
+  root = doc.parse(big.str());
+  UNIT_ASSERT_EQUAL((int)root.size(), 101, "invalid number of members");
+  for (int i = 0; i < 100; ++i) {
+    stringstream key;
+    key << "key" << i;
+    UNIT_ASSERT_EQUAL(root[key.str()].as_number(), (i == 7 ? 700.0 : double(i)), "invalid hashed member");
+  }
+  UNIT_ASSERT_FALSE(root.contains("key100"), "key100 not expected");
+
+  doc.clear();
+  UNIT_ASSERT_TRUE(doc.root().is_null(), "cleared document must be null");
+}
+
+namespace {
+
+/*
+ * reads all tokens of the given input fed
+ * in chunks of the given size and returns
+ * them as one string
+ */
+string read_tokens(const string &input, size_t chunk)
+{
+  json_reader reader;
+  stringstream out;
+  size_t pos = 0;
+  json_reader::token_t t = json_reader::TOKEN_NEED_MORE;
+  while (t != json_reader::TOKEN_END) {
+    if (t == json_reader::TOKEN_NEED_MORE) {
+      if (pos < input.size()) {
+        // a fresh copy of the chunk ensures the reader keeps what it needs
+        string buf = input.substr(pos, chunk);
+        pos += buf.size();
+        reader.feed(buf.data(), buf.size());
+        while ((t = reader.next()) != json_reader::TOKEN_NEED_MORE) {
+          out << t << ":";
+          if (t == json_reader::TOKEN_KEY || t == json_reader::TOKEN_STRING) {
+            out << reader.as_string();
+          } else if (t == json_reader::TOKEN_INTEGER) {
+            out << reader.as_integer();
+          } else if (t == json_reader::TOKEN_NUMBER) {
+            out << reader.as_number();
+          } else if (t == json_reader::TOKEN_BOOL) {
+            out << reader.as_bool();
+          }
+          out << "@" << reader.depth() << " ";
+        }
+        continue;
+      }
+      reader.finish();
+    }
+    t = reader.next();
+    if (t != json_reader::TOKEN_END) {
+      out << t << ":@" << reader.depth() << " ";
+    }
+  }
+  return out.str();
+}
+
+}
+
+void JsonTestUnit::reader_test()
+{
+  string doc("{ \"name\" : \"plain\", \"text\" : \"a\\\"b\\\\c\\nd\\u00e4\", \"values\" : [ 1, -2.5e2, 9223372036854775807, true, false, null, [], {} ],"
+             "\"nested\" : { \"a\" : [ { \"b\" : 0.125 } ] }, \"last\" : 12345678 }");
+
+  stringstream expected;
+  expected << json_reader::TOKEN_BEGIN_OBJECT << ":@1 "
+           << json_reader::TOKEN_KEY << ":name@1 "
+           << json_reader::TOKEN_STRING << ":plain@1 "
+           << json_reader::TOKEN_KEY << ":text@1 "
+           << json_reader::TOKEN_STRING << ":a\"b\\c\nd\\u00e4@1 "
+           << json_reader::TOKEN_KEY << ":values@1 "
+           << json_reader::TOKEN_BEGIN_ARRAY << ":@2 "
+           << json_reader::TOKEN_INTEGER << ":1@2 "
+           << json_reader::TOKEN_NUMBER << ":-250@2 "
+           << json_reader::TOKEN_INTEGER << ":9223372036854775807@2 "
+           << json_reader::TOKEN_BOOL << ":1@2 "
+           << json_reader::TOKEN_BOOL << ":0@2 "
+           << json_reader::TOKEN_NULL << ":@2 "
+           << json_reader::TOKEN_BEGIN_ARRAY << ":@3 "
+           << json_reader::TOKEN_END_ARRAY << ":@2 "
+           << json_reader::TOKEN_BEGIN_OBJECT << ":@3 "
+           << json_reader::TOKEN_END_OBJECT << ":@2 "
+           << json_reader::TOKEN_END_ARRAY << ":@1 "
+           << json_reader::TOKEN_KEY << ":nested@1 "
+           << json_reader::TOKEN_BEGIN_OBJECT << ":@2 "
+           << json_reader::TOKEN_KEY << ":a@2 "
+           << json_reader::TOKEN_BEGIN_ARRAY << ":@3 "
+           << json_reader::TOKEN_BEGIN_OBJECT << ":@4 "
+           << json_reader::TOKEN_KEY << ":b@4 "
+           << json_reader::TOKEN_NUMBER << ":0.125@4 "
+           << json_reader::TOKEN_END_OBJECT << ":@3 "
+           << json_reader::TOKEN_END_ARRAY << ":@2 "
+           << json_reader::TOKEN_END_OBJECT << ":@1 "
+           << json_reader::TOKEN_KEY << ":last@1 ";
+
+  // the last number and the closing bracket may only be complete after finish()
+  string tokens = read_tokens(doc, doc.size());
+  UNIT_ASSERT_EQUAL(tokens.substr(0, expected.str().size()), expected.str(), "invalid tokens");
+
+  // every split of the input must give the same tokens
+  for (size_t chunk = 1; chunk < 12; ++chunk) {
+    UNIT_ASSERT_EQUAL(read_tokens(doc, chunk), tokens, "chunked input must give the same tokens");
+  }
+
+  const char *invalid[] = {
+    "",
+    "1",
+    "{ \"a\" : 1 } x",
+    "{ \"a\" 1 }",
+    "{ \"a\" : \"unterminated }",
+    "[ 1, 2 ",
+    "[ 1, ]",
+    "[ 1 }",
+    "[ tru ]",
+    "[ tru",
+    "[ 1x ]",
+    "[ 01 ]",
+    "[ \"\\q\" ]"
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+    for (size_t chunk = 1; chunk < 4; ++chunk) {
+      bool failed = false;
+      try {
+        read_tokens(invalid[i], chunk);
+      } catch (std::logic_error &) {
+        failed = true;
+      }
+      UNIT_ASSERT_TRUE(failed, string("reading must fail: ") + invalid[i]);
+    }
+  }
+
+  // a large array is read with constant memory
+  json_reader reader;
+  const int records = 100000;
+  long long id_sum = 0;
+  int count = 0;
+  size_t max_memory = 0;
+  string key;
+  string chunk;
+  for (int i = 0; i <= records; ++i) {
+    stringstream record;
+    if (i == 0) {
+      record << "[";
+    }
+    if (i < records) {
+      record << (i ? "," : "") << "{ \"id\" : " << i << ", \"name\" : \"record " << i << "\", \"tags\" : [ \"x\", \"y\" ] }";
+    } else {
+      record << "]";
+    }
+    chunk += record.str();
+    if (chunk.size() < 1000 && i < records) {
+      continue;
+    }
+    reader.feed(chunk.data(), chunk.size());
+    json_reader::token_t t;
+    while ((t = reader.next()) != json_reader::TOKEN_NEED_MORE) {
+      if (t == json_reader::TOKEN_KEY && reader.depth() == 2) {
+        key.assign(reader.data(), reader.length());
+      } else if (t == json_reader::TOKEN_INTEGER && key == "id") {
+        id_sum += reader.as_integer();
+      } else if (t == json_reader::TOKEN_END_OBJECT && reader.depth() == 1) {
+        ++count;
+      }
+    }
+    chunk.clear();
+    if (reader.memory_usage() > max_memory) {
+      max_memory = reader.memory_usage();
+    }
+  }
+  reader.finish();
+  UNIT_ASSERT_TRUE(reader.next() == json_reader::TOKEN_END, "document must be complete");
+  UNIT_ASSERT_EQUAL(count, records, "invalid number of records");
+  UNIT_ASSERT_EQUAL(id_sum, (long long)records * (records - 1) / 2, "invalid sum of ids");
+  UNIT_ASSERT_LESS(max_memory, (size_t)4096, "reader memory must not grow with the document");
+
+  // the reader can be reused
+  reader.reset();
+  reader.feed("[ true ]", 8);
+  reader.finish();
+  UNIT_ASSERT_TRUE(reader.next() == json_reader::TOKEN_BEGIN_ARRAY, "reset reader must read a new document");
+  UNIT_ASSERT_TRUE(reader.next() == json_reader::TOKEN_BOOL && reader.as_bool(), "reset reader must read a new document");
+}
+
+namespace {
+
+/*
+ * parser which only counts the values
+ * to measure the parser front-end without
+ * building a json_value structure
+ */
+class counting_parser : public generic_json_parser<counting_parser>
+{
+public:
+  counting_parser()
+    : generic_json_parser<counting_parser>(this)
+    , values(0)
+  {}
+
+  void parse(std::istream &in) { parse_json(in); }
+  void parse(const char *str, size_t len) { parse_json(str, len); }
+
+  void on_begin_object() {}
+  void on_object_key(const std::string &) {}
+  void on_end_object() { ++values; }
+
+  void on_begin_array() {}
+  void on_end_array() { ++values; }
+
+  void on_string(const std::string &) { ++values; }
+  void on_number(double) { ++values; }
+  void on_integer(long long) { ++values; }
+  void on_bool(bool) { ++values; }
+  void on_null() { ++values; }
+
+  unsigned long values;
+};
+
+}
+
+void JsonTestUnit::writer_test()
+{
+  json_writer compact(json_writer::FORMAT_COMPACT);
+  compact.begin_object();
+  compact.key("a");
+  compact.begin_array();
+  compact.value(1);
+  compact.value(-2.5);
+  compact.value(9223372036854775807LL);
+  compact.value(18446744073709551615ULL);
+  compact.end_array();
+  compact.key("b");
+  compact.begin_object();
+  compact.end_object();
+  compact.key("c");
+  compact.value("q\"b\\s\n\t\x01 \\u00e4");
+  compact.key("d");
+  compact.null();
+  compact.key("e");
+  compact.value(true);
+  compact.end_object();
+
+  UNIT_ASSERT_EQUAL(compact.str(), string("{\"a\":[1,-2.5,9223372036854775807,18446744073709551615],\"b\":{},"
+                                          "\"c\":\"q\\\"b\\\\s\\n\\t\\u0001 \\u00e4\",\"d\":null,\"e\":true}"),
+                    "compact output isn't as expected");
+
+  // the escaped output must be read again, \u escapes are kept as they are
+  json_parser parser;
+  string result = compact.str();
+  json_value value = parser.parse(result);
+  json_string text = value["c"];
+  UNIT_ASSERT_EQUAL(text.value(), string("q\"b\\s\n\t\\u0001 \\u00e4"), "string isn't as expected");
+
+  // inline format equals the output of operator<<
+  string str("{ \"text\" : \"hello world!\", \"empty\" : {}, \"array\" : [ null, false, -5.66667, [] ] }");
+  value = parser.parse(str);
+  stringstream out;
+  out << value;
+  json_writer inline_writer;
+  inline_writer.value(value);
+  UNIT_ASSERT_EQUAL(inline_writer.str(), out.str(), "inline output isn't as expected");
+
+  json_writer pretty(json_writer::FORMAT_PRETTY);
+  pretty.value(value);
+  UNIT_ASSERT_EQUAL(pretty.str(), string("{\n  \"array\": [\n    null,\n    false,\n    -5.66667,\n    []\n  ],\n"
+                                         "  \"empty\": {},\n  \"text\": \"hello world!\"\n}"),
+                    "pretty output isn't as expected");
+
+  // json_node keeps the order of the document
+  json_document document;
+  json_node root = document.parse(str);
+  json_writer node_writer;
+  node_writer.value(root);
+  UNIT_ASSERT_EQUAL(node_writer.str(), string("{ \"text\" : \"hello world!\", \"empty\" : {  }, \"array\" : [ null, false, -5.66667, [  ] ] }"),
+                    "node output isn't as expected");
+
+  // caller supplied buffer
+  char buf[16];
+  json_writer fixed(buf, sizeof(buf), json_writer::FORMAT_COMPACT);
+  fixed.begin_array();
+  fixed.value("short");
+  fixed.end_array();
+  UNIT_ASSERT_FALSE(fixed.overflow(), "buffer must not overflow");
+  UNIT_ASSERT_EQUAL(string(buf, fixed.size()), string("[\"short\"]"), "fixed output isn't as expected");
+  fixed.clear();
+  fixed.value("a string longer than the buffer");
+  UNIT_ASSERT_TRUE(fixed.overflow(), "buffer must overflow");
+  UNIT_ASSERT_EQUAL((int)fixed.size(), 16, "buffer must be filled");
+
+  // stream output in blocks
+  string big(100000, 'x');
+  stringstream sout;
+  {
+    json_writer stream_writer(sout, json_writer::FORMAT_COMPACT);
+    stream_writer.begin_array();
+    for (int i = 0; i < 10; ++i) {
+      stream_writer.value(big);
+    }
+    stream_writer.end_array();
+  }
+  UNIT_ASSERT_EQUAL((int)sout.str().size(), 10 * 100003 + 1, "stream output size isn't as expected");
+  result = sout.str();
+  UNIT_ASSERT_EQUAL((int)parser.parse(result).size(), 10, "invalid number of values");
+
+  // file descriptor output
+  FILE *file = tmpfile();
+  UNIT_ASSERT_TRUE(file != 0, "couldn't create temporary file");
+  {
+    json_writer fd_writer(fileno(file), json_writer::FORMAT_COMPACT);
+    fd_writer.value(value);
+  }
+  rewind(file);
+  char fbuf[256];
+  size_t n = fread(fbuf, 1, sizeof(fbuf), file);
+  fclose(file);
+  UNIT_ASSERT_EQUAL(string(fbuf, n), string("{\"array\":[null,false,-5.66667,[]],\"empty\":{},\"text\":\"hello world!\"}"),
+                    "fd output isn't as expected");
+}
+
+void JsonTestUnit::prepare_document()
+{
+  if (!document_.empty()) {
+    return;
+  }
+  // a document of about 800 KB
+  stringstream doc;
+  doc << "{ \"events\" : [\n";
+  for (int i = 0; i < 5000; ++i) {
+    doc << (i ? ",\n" : "") << "    { \"id\" : " << i << ", \"name\" : \"event number " << i
+        << "\", \"value\" : " << i * 0.25 << ", \"active\" : " << (i % 2 ? "true" : "false")
+        << ", \"payload\" : \"" << string(80, 'p') << "\\n" << string(40, 'q') << "\", \"tags\" : [ \"a\", \"b\", null ] }";
+  }
+  doc << "\n] }";
+  document_ = doc.str();
+  json_parser parser;
+  root_ = parser.parse(document_.data(), document_.size());
+}
+
+void JsonTestUnit::parse_istream(unsigned long long iterations)
+{
+  prepare_document();
+  json_parser parser;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    istringstream in(document_);
+    json_value value = parser.parse(in);
+    benchmark_use(&value);
+  }
+}
+
+void JsonTestUnit::parse_buffer(unsigned long long iterations)
+{
+  prepare_document();
+  json_parser parser;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    json_value value = parser.parse(document_.data(), document_.size());
+    benchmark_use(&value);
+  }
+}
+
+void JsonTestUnit::scan_istream(unsigned long long iterations)
+{
+  prepare_document();
+  counting_parser counter;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    istringstream in(document_);
+    counter.parse(in);
+  }
+  benchmark_use(&counter.values);
+}
+
+void JsonTestUnit::scan_buffer(unsigned long long iterations)
+{
+  prepare_document();
+  counting_parser counter;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    counter.parse(document_.data(), document_.size());
+  }
+  benchmark_use(&counter.values);
+}
+
+void JsonTestUnit::parse_document(unsigned long long iterations)
+{
+  prepare_document();
+  json_document document;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    document.parse(document_.data(), document_.size());
+    benchmark_use(&document);
+  }
+}
+
+void JsonTestUnit::read_chunks(unsigned long long iterations)
+{
+  prepare_document();
+  json_reader reader;
+  const size_t chunk = 64 * 1024;
+  unsigned long tokens = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    reader.reset();
+    for (size_t pos = 0; pos < document_.size(); pos += chunk) {
+      reader.feed(document_.data() + pos, std::min(chunk, document_.size() - pos));
+      while (reader.next() != json_reader::TOKEN_NEED_MORE) {
+        ++tokens;
+      }
+    }
+    reader.finish();
+    while (reader.next() != json_reader::TOKEN_END) {
+      ++tokens;
+    }
+  }
+  benchmark_use(&tokens);
+}
+
+void JsonTestUnit::write_ostream(unsigned long long iterations)
+{
+  prepare_document();
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    stringstream out;
+    out << root_;
+    benchmark_use(&out);
+  }
+}
+
+void JsonTestUnit::write_buffer(unsigned long long iterations)
+{
+  prepare_document();
+  json_writer writer(json_writer::FORMAT_COMPACT);
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    writer.clear();
+    writer.value(root_);
+    benchmark_use(&writer);
+  }
+}
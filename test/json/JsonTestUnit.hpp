@@ -3,6 +3,11 @@
 
 #include "unit/unit_test.hpp"
 
+#include "json/json_value.hpp"
+
+#include <string>
+#include <vector>
+
 class JsonTestUnit : public oos::unit_test
 {
 public:
@@ -12,14 +17,43 @@ public:
   void simple_test();
   void string_test();
   void number_test();
+  void number_roundtrip_test();
   void create_test();
   void access_test();
   void parser_test();
+  void buffer_test();
+  void document_test();
+  void reader_test();
+  void writer_test();
+
+  void parse_number_istream(unsigned long long iterations);
+  void parse_number(unsigned long long iterations);
+  void format_number_ostream(unsigned long long iterations);
+  void format_number(unsigned long long iterations);
+  void parse_istream(unsigned long long iterations);
+  void parse_buffer(unsigned long long iterations);
+  void scan_istream(unsigned long long iterations);
+  void scan_buffer(unsigned long long iterations);
+  void parse_document(unsigned long long iterations);
+  void read_chunks(unsigned long long iterations);
+  void write_ostream(unsigned long long iterations);
+  void write_buffer(unsigned long long iterations);
   /**
    * Initializes a test unit
    */
   virtual void initialize() {}
   virtual void finalize() {}  
+
+private:
+  void prepare_document();
+
+private:
+  enum { BENCHMARK_VALUES = 1024 };
+
+  std::vector<double> values_;
+  std::vector<std::string> numbers_;
+  std::string document_;
+  oos::json_value root_;
 };
 
 #endif /* JSONTESTUNIT_HPP */
@@ -0,0 +1,247 @@
+#include "ChangeFeedTestUnit.hpp"
+
+#include "object/change_feed.hpp"
+#include "object/object_store.hpp"
+#include "object/object_serializer.hpp"
+#include "object/prototype_node.hpp"
+
+#include "tools/byte_buffer.hpp"
+
+#include "../Item.hpp"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+using namespace oos;
+using namespace std;
+
+ChangeFeedTestUnit::ChangeFeedTestUnit()
+  : unit_test("change_feed", "change feed")
+{
+  add_test("queue", std::tr1::bind(&ChangeFeedTestUnit::test_queue, this), "test bounded queue");
+  add_test("simple", std::tr1::bind(&ChangeFeedTestUnit::test_simple, this), "test change feed records");
+  add_test("overflow", std::tr1::bind(&ChangeFeedTestUnit::test_overflow, this), "test change feed overflow");
+  add_test("payload", std::tr1::bind(&ChangeFeedTestUnit::test_payload, this), "test change feed payload");
+  add_test("threads", std::tr1::bind(&ChangeFeedTestUnit::test_threads, this), "test change feed with consumer thread");
+}
+
+ChangeFeedTestUnit::~ChangeFeedTestUnit()
+{}
+
+void ChangeFeedTestUnit::initialize()
+{}
+
+void ChangeFeedTestUnit::finalize()
+{}
+
+namespace {
+
+struct record_counter
+{
+  record_counter(int &inserted, int &updated, int &deleted)
+    : inserted_(inserted), updated_(updated), deleted_(deleted)
+  {}
+  void operator()(const change_record &record)
+  {
+    switch (record.op) {
+      case change_record::CHANGE_INSERT:
+        ++inserted_;
+        break;
+      case change_record::CHANGE_UPDATE:
+        ++updated_;
+        break;
+      case change_record::CHANGE_DELETE:
+        ++deleted_;
+        break;
+    }
+  }
+  int &inserted_;
+  int &updated_;
+  int &deleted_;
+};
+
+#ifndef WIN32
+struct consumer_info
+{
+  consumer_info(change_feed &f, long n)
+    : feed(f), expected(n), received(0), id_sum(0), ordered(true)
+  {}
+  change_feed &feed;
+  long expected;
+  long received;
+  long id_sum;
+  bool ordered;
+};
+
+void* consume(void *arg)
+{
+  consumer_info *info = static_cast<consumer_info*>(arg);
+  long last = 0;
+  change_record record;
+  while (info->received < info->expected) {
+    info->feed.pop(record);
+    if (record.id <= last) {
+      info->ordered = false;
+    }
+    last = record.id;
+    info->id_sum += record.id;
+    ++info->received;
+  }
+  return 0;
+}
+#endif
+
+}
+
+void ChangeFeedTestUnit::test_queue()
+{
+  bounded_queue<int> queue(5);
+
+  UNIT_ASSERT_EQUAL((int)queue.capacity(), 8, "capacity must be rounded to 8");
+  UNIT_ASSERT_TRUE(queue.empty(), "queue must be empty");
+
+  for (int i = 0; i < 8; ++i) {
+    UNIT_ASSERT_TRUE(queue.try_push(i), "couldn't push value");
+  }
+  UNIT_ASSERT_FALSE(queue.try_push(8), "queue must be full");
+  UNIT_ASSERT_EQUAL((int)queue.size(), 8, "queue size must be 8");
+
+  int value = -1;
+  for (int i = 0; i < 8; ++i) {
+    UNIT_ASSERT_TRUE(queue.try_pop(value), "couldn't pop value");
+    UNIT_ASSERT_EQUAL(value, i, "invalid value order");
+  }
+  UNIT_ASSERT_FALSE(queue.try_pop(value), "queue must be empty");
+
+  // wrap around several times
+  for (int i = 0; i < 100; ++i) {
+    UNIT_ASSERT_TRUE(queue.try_push(i), "couldn't push value");
+    UNIT_ASSERT_TRUE(queue.try_pop(value), "couldn't pop value");
+    UNIT_ASSERT_EQUAL(value, i, "invalid value");
+  }
+  UNIT_ASSERT_TRUE(queue.empty(), "queue must be empty");
+}
+
+void ChangeFeedTestUnit::test_simple()
+{
+  object_store ostore;
+  ostore.insert_prototype<Item>("ITEM");
+
+  change_feed feed(64);
+  ostore.register_observer(&feed);
+
+  typedef object_ptr<Item> item_ptr;
+  item_ptr item = ostore.insert(new Item("Item", 1));
+  ostore.insert(new Item("Item", 2));
+
+  item->set_int(7);
+
+  change_record record;
+  UNIT_ASSERT_TRUE(feed.try_pop(record), "first record expected");
+  UNIT_ASSERT_EQUAL(record.op, change_record::CHANGE_INSERT, "record must be an insert");
+  UNIT_ASSERT_EQUAL(record.id, item->id(), "invalid record id");
+  UNIT_ASSERT_NOT_NULL(record.node, "record must have a prototype");
+  UNIT_ASSERT_EQUAL(record.node->type, "ITEM", "invalid record type");
+  UNIT_ASSERT_TRUE(record.payload.empty(), "record must not have a payload");
+
+  UNIT_ASSERT_TRUE(feed.try_pop(record), "second record expected");
+  UNIT_ASSERT_EQUAL(record.op, change_record::CHANGE_INSERT, "record must be an insert");
+
+  UNIT_ASSERT_TRUE(feed.try_pop(record), "third record expected");
+  UNIT_ASSERT_EQUAL(record.op, change_record::CHANGE_UPDATE, "record must be an update");
+  UNIT_ASSERT_EQUAL(record.id, item->id(), "invalid record id");
+
+  UNIT_ASSERT_FALSE(feed.try_pop(record), "feed must be empty");
+
+  ostore.remove(item);
+
+  int inserted = 0, updated = 0, deleted = 0;
+  UNIT_ASSERT_EQUAL((int)feed.drain(record_counter(inserted, updated, deleted)), 1, "one record expected");
+  UNIT_ASSERT_EQUAL(deleted, 1, "one delete expected");
+
+  ostore.unregister_observer(&feed);
+}
+
+void ChangeFeedTestUnit::test_overflow()
+{
+  object_store ostore;
+  ostore.insert_prototype<Item>("ITEM");
+
+  change_feed feed(4, change_feed::DROP_ON_FULL);
+  ostore.register_observer(&feed);
+
+  for (int i = 0; i < 10; ++i) {
+    ostore.insert(new Item("Item", i));
+  }
+
+  UNIT_ASSERT_EQUAL((int)feed.size(), 4, "feed must be full");
+  UNIT_ASSERT_EQUAL(feed.dropped(), 6UL, "six records must be dropped");
+
+  int inserted = 0, updated = 0, deleted = 0;
+  UNIT_ASSERT_EQUAL((int)feed.drain(record_counter(inserted, updated, deleted), 3), 3, "three records expected");
+  UNIT_ASSERT_EQUAL((int)feed.drain(record_counter(inserted, updated, deleted)), 1, "one record expected");
+  UNIT_ASSERT_EQUAL(inserted, 4, "four inserts expected");
+
+  ostore.unregister_observer(&feed);
+}
+
+void ChangeFeedTestUnit::test_payload()
+{
+  object_store ostore;
+  ostore.insert_prototype<Item>("ITEM");
+
+  change_feed feed(8, change_feed::BLOCK_ON_FULL, true);
+  ostore.register_observer(&feed);
+
+  ostore.insert(new Item("Payload", 42));
+
+  change_record record;
+  UNIT_ASSERT_TRUE(feed.try_pop(record), "record expected");
+  UNIT_ASSERT_FALSE(record.payload.empty(), "record must have a payload");
+
+  // restore the object from the payload
+  byte_buffer buffer;
+  buffer.append(record.payload.data(), record.payload.size());
+  Item item;
+  object_serializer serializer;
+  serializer.deserialize(&item, buffer, &ostore);
+
+  UNIT_ASSERT_EQUAL(item.get_string(), "Payload", "invalid string of deserialized item");
+  UNIT_ASSERT_EQUAL(item.get_int(), 42, "invalid int of deserialized item");
+
+  ostore.unregister_observer(&feed);
+}
+
+void ChangeFeedTestUnit::test_threads()
+{
+#ifndef WIN32
+  object_store ostore;
+  ostore.insert_prototype<Item>("ITEM");
+
+  // small queue so the writer has to wait for the consumer
+  change_feed feed(16);
+  ostore.register_observer(&feed);
+
+  const long n = 10000;
+  consumer_info info(feed, n);
+
+  pthread_t consumer;
+  UNIT_ASSERT_EQUAL(pthread_create(&consumer, 0, consume, &info), 0, "couldn't start consumer thread");
+
+  long id_sum = 0;
+  for (long i = 0; i < n; ++i) {
+    object_ptr<Item> item = ostore.insert(new Item("Item", (int)i));
+    id_sum += item->id();
+  }
+
+  pthread_join(consumer, 0);
+
+  UNIT_ASSERT_EQUAL(info.received, n, "invalid number of received records");
+  UNIT_ASSERT_EQUAL(info.id_sum, id_sum, "invalid sum of received ids");
+  UNIT_ASSERT_TRUE(info.ordered, "records must be received in order");
+  UNIT_ASSERT_EQUAL(feed.dropped(), 0UL, "no record must be dropped");
+
+  ostore.unregister_observer(&feed);
+#endif
+}
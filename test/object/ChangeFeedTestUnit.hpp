@@ -0,0 +1,22 @@
+#ifndef CHANGEFEEDTESTUNIT_HPP
+#define CHANGEFEEDTESTUNIT_HPP
+
+#include "unit/unit_test.hpp"
+
+class ChangeFeedTestUnit : public oos::unit_test
+{
+public:
+  ChangeFeedTestUnit();
+  virtual ~ChangeFeedTestUnit();
+  
+  virtual void initialize();
+  virtual void finalize();
+
+  void test_queue();
+  void test_simple();
+  void test_overflow();
+  void test_payload();
+  void test_threads();
+};
+
+#endif /* CHANGEFEEDTESTUNIT_HPP */
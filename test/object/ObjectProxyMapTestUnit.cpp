@@ -0,0 +1,174 @@
+#include "ObjectProxyMapTestUnit.hpp"
+
+#include "object/object_proxy_map.hpp"
+
+using namespace oos;
+using namespace std;
+
+ObjectProxyMapTestUnit::ObjectProxyMapTestUnit()
+  : unit_test("proxy_map", "object proxy map")
+{
+  add_test("dense", std::tr1::bind(&ObjectProxyMapTestUnit::test_dense, this), "test object proxy map with dense ids");
+  add_test("sparse", std::tr1::bind(&ObjectProxyMapTestUnit::test_sparse, this), "test object proxy map with sparse ids");
+  add_test("mixed", std::tr1::bind(&ObjectProxyMapTestUnit::test_mixed, this), "test object proxy map with mixed ids");
+  add_test("erase", std::tr1::bind(&ObjectProxyMapTestUnit::test_erase, this), "test object proxy map erase");
+  add_test("reserve", std::tr1::bind(&ObjectProxyMapTestUnit::test_reserve, this), "test object proxy map reserve");
+}
+
+ObjectProxyMapTestUnit::~ObjectProxyMapTestUnit()
+{}
+
+void ObjectProxyMapTestUnit::initialize()
+{}
+
+void ObjectProxyMapTestUnit::finalize()
+{}
+
+namespace {
+
+/*
+ * the map never dereferences the proxies,
+ * so the tests use fake proxy addresses
+ */
+object_proxy* fake_proxy(long id)
+{
+  return reinterpret_cast<object_proxy*>(static_cast<size_t>(id) * 8 + 8);
+}
+
+}
+
+void ObjectProxyMapTestUnit::test_dense()
+{
+  object_proxy_map omap;
+
+  UNIT_ASSERT_TRUE(omap.empty(), "map must be empty");
+
+  for (long i = 1; i <= 10000; ++i) {
+    UNIT_ASSERT_TRUE(omap.insert(i, fake_proxy(i)), "couldn't insert id");
+  }
+  UNIT_ASSERT_FALSE(omap.insert(1, fake_proxy(1)), "id must not be inserted twice");
+  UNIT_ASSERT_FALSE(omap.insert(0, fake_proxy(0)), "id zero must not be inserted");
+  UNIT_ASSERT_EQUAL(omap.size(), (object_proxy_map::size_type)10000, "invalid map size");
+
+  for (long i = 1; i <= 10000; ++i) {
+    UNIT_ASSERT_EQUAL(omap.find(i), fake_proxy(i), "invalid proxy for id");
+  }
+  UNIT_ASSERT_NULL(omap.find(0), "id zero must not be found");
+  UNIT_ASSERT_NULL(omap.find(10001), "id must not be found");
+
+  omap.clear();
+
+  UNIT_ASSERT_TRUE(omap.empty(), "map must be empty");
+  UNIT_ASSERT_NULL(omap.find(1), "id must not be found");
+}
+
+void ObjectProxyMapTestUnit::test_sparse()
+{
+  object_proxy_map omap;
+
+  long id = 1;
+  for (int i = 0; i < 5000; ++i) {
+    UNIT_ASSERT_TRUE(omap.insert(id, fake_proxy(i)), "couldn't insert id");
+    UNIT_ASSERT_TRUE(omap.insert(-id, fake_proxy(i + 5000)), "couldn't insert negative id");
+    id += 1000003;
+  }
+  UNIT_ASSERT_EQUAL(omap.size(), (object_proxy_map::size_type)10000, "invalid map size");
+
+  id = 1;
+  for (int i = 0; i < 5000; ++i) {
+    UNIT_ASSERT_EQUAL(omap.find(id), fake_proxy(i), "invalid proxy for id");
+    UNIT_ASSERT_EQUAL(omap.find(-id), fake_proxy(i + 5000), "invalid proxy for negative id");
+    UNIT_ASSERT_NULL(omap.find(id + 1), "id must not be found");
+    id += 1000003;
+  }
+}
+
+void ObjectProxyMapTestUnit::test_mixed()
+{
+  object_proxy_map omap;
+
+  // a few ids of a page go to the hash table
+  for (long i = 1; i < 20; i += 2) {
+    UNIT_ASSERT_TRUE(omap.insert(i, fake_proxy(i)), "couldn't insert id");
+  }
+  // far ids which become part of the pages later
+  for (long i = 0; i < 10; ++i) {
+    long id = 100000000 + i;
+    UNIT_ASSERT_TRUE(omap.insert(id, fake_proxy(id)), "couldn't insert far id");
+  }
+  // fill up the pages
+  for (long i = 2; i < 200000; i += 2) {
+    UNIT_ASSERT_TRUE(omap.insert(i, fake_proxy(i)), "couldn't insert id");
+  }
+  for (long i = 21; i < 200000; i += 2) {
+    UNIT_ASSERT_TRUE(omap.insert(i, fake_proxy(i)), "couldn't insert id");
+  }
+  for (long i = 1; i < 200000; ++i) {
+    UNIT_ASSERT_EQUAL(omap.find(i), fake_proxy(i), "invalid proxy for id");
+  }
+  for (long i = 0; i < 10; ++i) {
+    long id = 100000000 + i;
+    UNIT_ASSERT_EQUAL(omap.find(id), fake_proxy(id), "invalid proxy for far id");
+  }
+  UNIT_ASSERT_EQUAL(omap.size(), (object_proxy_map::size_type)200009, "invalid map size");
+
+  // remove everything
+  for (long i = 1; i < 200000; ++i) {
+    UNIT_ASSERT_TRUE(omap.erase(i), "couldn't erase id");
+  }
+  for (long i = 0; i < 10; ++i) {
+    UNIT_ASSERT_TRUE(omap.erase(100000000 + i), "couldn't erase far id");
+  }
+  UNIT_ASSERT_TRUE(omap.empty(), "map must be empty");
+}
+
+void ObjectProxyMapTestUnit::test_erase()
+{
+  object_proxy_map omap;
+
+  for (long i = 1; i <= 5000; ++i) {
+    omap.insert(i, fake_proxy(i));
+    omap.insert(i * 7919 + 50000000, fake_proxy(i));
+  }
+
+  // erase every third id
+  for (long i = 1; i <= 5000; i += 3) {
+    UNIT_ASSERT_TRUE(omap.erase(i), "couldn't erase id");
+    UNIT_ASSERT_TRUE(omap.erase(i * 7919 + 50000000), "couldn't erase sparse id");
+  }
+  UNIT_ASSERT_FALSE(omap.erase(1), "id must not be erased twice");
+  UNIT_ASSERT_FALSE(omap.erase(0), "id zero must not be erased");
+
+  for (long i = 1; i <= 5000; ++i) {
+    if ((i - 1) % 3 == 0) {
+      UNIT_ASSERT_NULL(omap.find(i), "erased id must not be found");
+      UNIT_ASSERT_NULL(omap.find(i * 7919 + 50000000), "erased sparse id must not be found");
+    } else {
+      UNIT_ASSERT_EQUAL(omap.find(i), fake_proxy(i), "invalid proxy for id");
+      UNIT_ASSERT_EQUAL(omap.find(i * 7919 + 50000000), fake_proxy(i), "invalid proxy for sparse id");
+    }
+  }
+
+  // reinsert erased ids
+  for (long i = 1; i <= 5000; i += 3) {
+    UNIT_ASSERT_TRUE(omap.insert(i, fake_proxy(i)), "couldn't reinsert id");
+  }
+  UNIT_ASSERT_EQUAL(omap.size(), (object_proxy_map::size_type)8333, "invalid map size");
+}
+
+void ObjectProxyMapTestUnit::test_reserve()
+{
+  object_proxy_map omap;
+
+  omap.reserve(100000000);
+
+  object_proxy_map::size_type usage = omap.memory_usage();
+
+  for (long i = 1; i <= 100000; ++i) {
+    omap.insert(i * 16, fake_proxy(i));
+  }
+  for (long i = 1; i <= 100000; ++i) {
+    UNIT_ASSERT_EQUAL(omap.find(i * 16), fake_proxy(i), "invalid proxy for id");
+  }
+  UNIT_ASSERT_GREATER(omap.memory_usage(), usage, "map must allocate pages");
+}
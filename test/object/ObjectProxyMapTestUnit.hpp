@@ -0,0 +1,22 @@
+#ifndef OBJECTPROXYMAPTESTUNIT_HPP
+#define OBJECTPROXYMAPTESTUNIT_HPP
+
+#include "unit/unit_test.hpp"
+
+class ObjectProxyMapTestUnit : public oos::unit_test
+{
+public:
+  ObjectProxyMapTestUnit();
+  virtual ~ObjectProxyMapTestUnit();
+  
+  virtual void initialize();
+  virtual void finalize();
+
+  void test_dense();
+  void test_sparse();
+  void test_mixed();
+  void test_erase();
+  void test_reserve();
+};
+
+#endif /* OBJECTPROXYMAPTESTUNIT_HPP */
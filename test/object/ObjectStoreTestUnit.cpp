@@ -4,6 +4,9 @@
 #include "object/object_expression.hpp"
 #include "object/object_serializer.hpp"
 #include "object/object_view.hpp"
+#include "object/object_observer.hpp"
+#include "object/object_proxy.hpp"
+#include "object/memory_report.hpp"
 
 #include "tools/byte_buffer.hpp"
 #include "tools/algorithm.hpp"
@@ -33,8 +36,11 @@ ObjectStoreTestUnit::ObjectStoreTestUnit()
   add_test("sub_delete", std::tr1::bind(&ObjectStoreTestUnit::sub_delete, this), "create and delete multiple objects with sub object");
   add_test("hierarchy", std::tr1::bind(&ObjectStoreTestUnit::hierarchy, this), "object hierarchy test");
   add_test("view", std::tr1::bind(&ObjectStoreTestUnit::view_test, this), "object view test");
+  add_test("view_index", std::tr1::bind(&ObjectStoreTestUnit::view_index_test, this), "object view proxy index test");
+  add_test("observer", std::tr1::bind(&ObjectStoreTestUnit::observer_test, this), "typed and bulk observer test");
   add_test("clear", std::tr1::bind(&ObjectStoreTestUnit::clear_test, this), "object store clear test");
   add_test("generic", std::tr1::bind(&ObjectStoreTestUnit::generic_test, this), "generic object access test");
+  add_test("memory", std::tr1::bind(&ObjectStoreTestUnit::memory_test, this), "memory usage per prototype test");
 //  add_test("structure", std::tr1::bind(&ObjectStoreTestUnit::test_structure, this), "object structure test");
 }
 
@@ -65,6 +71,14 @@ ObjectStoreTestUnit::finalize()
   ostore_.clear(true);
 }
 
+struct item_counter_base : public std::unary_function<const object_ptr<Item>&, void>
+{
+  item_counter_base(int &c) : count(c) {}
+  
+  void operator ()(const object_ptr<Item> &) { ++count; }
+  int &count;
+};
+
 struct item_counter : public std::unary_function<const object_ptr<ObjectItem<Item> >&, void>
 {
   item_counter(int &c) : count(c) {}
@@ -564,6 +578,209 @@ ObjectStoreTestUnit::view_test()
   UNIT_ASSERT_GREATER(item->id(), 0, "invalid item");
 }
 
+struct item_collector : public std::unary_function<const object_ptr<Item>&, void>
+{
+  item_collector(std::vector<long> &i) : ids(i) {}
+
+  void operator ()(const object_ptr<Item> &x) { ids.push_back(x->id()); }
+  std::vector<long> &ids;
+};
+
+struct item_ptr_collector : public std::unary_function<const object_ptr<Item>&, void>
+{
+  item_ptr_collector(std::vector<object_ptr<Item> > &i) : items(i) {}
+
+  void operator ()(const object_ptr<Item> &x) { items.push_back(x); }
+  std::vector<object_ptr<Item> > &items;
+};
+
+void
+ObjectStoreTestUnit::view_index_test()
+{
+  ostore_.insert_prototype<ItemA, Item>("ITEM_A");
+  ostore_.insert_prototype<ItemB, Item>("ITEM_B");
+
+  typedef object_ptr<Item> item_ptr;
+  typedef object_view<Item> item_view_t;
+
+  std::vector<item_ptr> items;
+  for (int i = 0; i < 30; ++i) {
+    Item *itm;
+    switch (i % 3) {
+      case 0:
+        itm = new Item;
+        break;
+      case 1:
+        itm = new ItemA;
+        break;
+      default:
+        itm = new ItemB;
+        break;
+    }
+    itm->set_int(i);
+    items.push_back(ostore_.insert(itm));
+  }
+
+  // remove every second item to compact the indices
+  for (int i = 0; i < 30; i += 2) {
+    ostore_.remove(items[i]);
+  }
+
+  item_view_t iview(ostore_);
+
+  UNIT_ASSERT_EQUAL((int)iview.size(), 15, "invalid item view size");
+
+  std::vector<long> ids;
+  iview.for_each(item_collector(ids));
+
+  UNIT_ASSERT_EQUAL((int)ids.size(), 15, "invalid number of visited items");
+
+  // for_each must visit the same objects as the view iterator
+  std::vector<long> view_ids;
+  item_view_t::const_iterator first = iview.begin();
+  item_view_t::const_iterator last = iview.end();
+  while (first != last) {
+    view_ids.push_back((*first)->id());
+    ++first;
+  }
+  std::sort(ids.begin(), ids.end());
+  std::sort(view_ids.begin(), view_ids.end());
+  UNIT_ASSERT_TRUE(ids == view_ids, "view and for_each visited different items");
+
+  variable<int> x(make_var(&Item::get_int));
+
+  item_view_t::iterator k = iview.find_if(x == 7);
+  UNIT_ASSERT_FALSE(k == iview.end(), "couldn't find item 7");
+  UNIT_ASSERT_EQUAL((*k)->get_int(), 7, "invalid item found");
+
+  k = iview.find_if(x == 8);
+  UNIT_ASSERT_TRUE(k == iview.end(), "removed item 8 must not be found");
+
+  int count = 0;
+  iview.for_each_if(x > 20, item_counter_base(count));
+  UNIT_ASSERT_EQUAL(count, 5, "invalid number of items greater 20");
+
+  // copies of the visited object_ptr must stay valid after the visit
+  std::vector<item_ptr> kept;
+  iview.for_each_if(x > 20, item_ptr_collector(kept));
+  UNIT_ASSERT_EQUAL((int)kept.size(), 5, "invalid number of kept items");
+  for (std::vector<item_ptr>::size_type i = 0; i < kept.size(); ++i) {
+    UNIT_ASSERT_GREATER(kept[i]->get_int(), 20, "kept item changed after visit");
+    UNIT_ASSERT_EQUAL(kept[i]->id(), kept[i].id(), "invalid kept item id");
+  }
+  UNIT_ASSERT_FALSE(kept.front() == kept.back(), "kept items must differ");
+
+  item_view_t aview(ostore_, true);
+  UNIT_ASSERT_EQUAL((int)aview.size(), 5, "invalid item view size without siblings");
+
+  object_view<ItemA> item_a_view(ostore_);
+  UNIT_ASSERT_EQUAL((int)item_a_view.size(), 5, "invalid item a view size");
+}
+
+class counting_observer : public object_observer
+{
+public:
+  counting_observer()
+    : inserted(0), updated(0), deleted(0)
+    , bulk_inserts(0), bulk_deletes(0)
+  {}
+  virtual ~counting_observer() {}
+
+  virtual void on_insert(object*) { ++inserted; }
+  virtual void on_update(object*) { ++updated; }
+  virtual void on_delete(object*) { ++deleted; }
+
+  virtual void on_bulk_insert(object *const *objects, std::size_t n)
+  {
+    ++bulk_inserts;
+    object_observer::on_bulk_insert(objects, n);
+  }
+  virtual void on_bulk_delete(object *const *objects, std::size_t n)
+  {
+    ++bulk_deletes;
+    object_observer::on_bulk_delete(objects, n);
+  }
+
+  int inserted;
+  int updated;
+  int deleted;
+  int bulk_inserts;
+  int bulk_deletes;
+};
+
+void
+ObjectStoreTestUnit::observer_test()
+{
+  ostore_.insert_prototype<ItemA, Item>("ITEM_A");
+  ostore_.insert_prototype<ItemB, Item>("ITEM_B");
+
+  counting_observer all;
+  counting_observer items;
+  counting_observer items_only;
+  counting_observer item_a;
+
+  ostore_.register_observer(&all);
+  ostore_.register_observer<Item>(&items);
+  ostore_.register_observer(&items_only, "ITEM", false);
+  ostore_.register_observer<ItemA>(&item_a);
+
+  std::vector<Item*> objects;
+  for (int i = 0; i < 9; ++i) {
+    switch (i % 3) {
+      case 0:
+        objects.push_back(new Item);
+        break;
+      case 1:
+        objects.push_back(new ItemA);
+        break;
+      default:
+        objects.push_back(new ItemB);
+        break;
+    }
+  }
+  ostore_.insert(objects.begin(), objects.end());
+
+  UNIT_ASSERT_EQUAL(all.bulk_inserts, 1, "expected one bulk insert");
+  UNIT_ASSERT_EQUAL(all.inserted, 9, "expected 9 inserted objects");
+  UNIT_ASSERT_EQUAL(items.bulk_inserts, 1, "expected one bulk insert");
+  UNIT_ASSERT_EQUAL(items.inserted, 9, "expected 9 inserted items");
+  UNIT_ASSERT_EQUAL(items_only.inserted, 3, "expected 3 inserted items without subtypes");
+  UNIT_ASSERT_EQUAL(item_a.inserted, 3, "expected 3 inserted item a");
+
+  // single insert
+  object_ptr<ItemB> b = ostore_.insert(new ItemB);
+
+  UNIT_ASSERT_EQUAL(all.inserted, 10, "expected 10 inserted objects");
+  UNIT_ASSERT_EQUAL(all.bulk_inserts, 1, "single insert must not be a bulk insert");
+  UNIT_ASSERT_EQUAL(item_a.inserted, 3, "item b must not be delivered to item a observer");
+
+  b->set_int(7);
+
+  UNIT_ASSERT_EQUAL(all.updated, 1, "expected one update");
+  UNIT_ASSERT_EQUAL(items.updated, 1, "expected one update");
+  UNIT_ASSERT_EQUAL(items_only.updated, 0, "expected no update");
+  UNIT_ASSERT_EQUAL(item_a.updated, 0, "expected no update");
+
+  ostore_.remove(b);
+
+  UNIT_ASSERT_EQUAL(all.deleted, 1, "expected one deleted object");
+  UNIT_ASSERT_EQUAL(all.bulk_deletes, 1, "expected one bulk delete");
+  UNIT_ASSERT_EQUAL(items.deleted, 1, "expected one deleted item");
+  UNIT_ASSERT_EQUAL(item_a.bulk_deletes, 0, "item a observer must not be notified");
+
+  ostore_.unregister_observer(&items);
+  ostore_.unregister_observer(&item_a);
+
+  ostore_.insert(new ItemA);
+
+  UNIT_ASSERT_EQUAL(all.inserted, 11, "expected 11 inserted objects");
+  UNIT_ASSERT_EQUAL(items.inserted, 10, "unregistered observer must not be notified");
+  UNIT_ASSERT_EQUAL(item_a.inserted, 3, "unregistered observer must not be notified");
+
+  ostore_.unregister_observer(&all);
+  ostore_.unregister_observer(&items_only);
+}
+
 void
 ObjectStoreTestUnit::clear_test()
 {
@@ -662,3 +879,64 @@ void ObjectStoreTestUnit::test_structure()
   
   object_item_ptr optr = ostore_.insert(oi);
 }
+
+void
+ObjectStoreTestUnit::memory_test()
+{
+  typedef object_ptr<Item> item_ptr;
+  typedef std::vector<item_ptr> item_vector_t;
+
+  item_vector_t items;
+  for (int i = 0; i < 10; ++i) {
+    std::stringstream str;
+    str << "Item " << i+1;
+    items.push_back(ostore_.insert(new Item(str.str(), i+1)));
+  }
+  // long strings are held outside of the object
+  for (int i = 0; i < 5; ++i) {
+    ostore_.insert(new Item(std::string(100, 'x'), i+1));
+  }
+
+  memory_report report = ostore_.memory_usage();
+
+  UNIT_ASSERT_EQUAL(report.prototypes.size(), (size_t)std::distance(ostore_.begin(), ostore_.end()), "report must contain all prototypes");
+  UNIT_ASSERT_NULL(report.find("UNKNOWN"), "unknown prototype must not be found");
+
+  const prototype_memory *memory = report.find("ITEM");
+  UNIT_ASSERT_NOT_NULL(memory, "item prototype must be found");
+  UNIT_ASSERT_EQUAL(memory->objects, 15UL, "invalid object count");
+  UNIT_ASSERT_EQUAL(memory->loaded, 15UL, "invalid loaded object count");
+  UNIT_ASSERT_EQUAL(memory->object_size, sizeof(Item), "invalid object size");
+  UNIT_ASSERT_EQUAL(memory->object_bytes, 15 * sizeof(Item), "invalid object bytes");
+  UNIT_ASSERT_GREATER(memory->heap_bytes, 5 * 100UL, "long strings must be counted");
+  UNIT_ASSERT_GREATER(memory->proxy_bytes, 15 * sizeof(object_proxy) - 1, "proxies must be counted");
+  UNIT_ASSERT_GREATER(memory->pointer_bytes, 0UL, "object pointers must be counted");
+  UNIT_ASSERT_EQUAL(memory->total(), memory->object_bytes + memory->heap_bytes + memory->proxy_bytes + memory->pointer_bytes, "invalid total");
+
+  memory = report.find("OBJECT_ITEM");
+  UNIT_ASSERT_NOT_NULL(memory, "object item prototype must be found");
+  UNIT_ASSERT_EQUAL(memory->objects, 0UL, "object item prototype must be empty");
+
+  UNIT_ASSERT_GREATER(report.id_map_bytes, 0UL, "id map must be counted");
+  UNIT_ASSERT_GREATER(report.total(), report.id_map_bytes, "invalid total");
+
+  std::stringstream table;
+  report.write(table);
+  UNIT_ASSERT_TRUE(table.str().find("ITEM") != std::string::npos, "table must contain the item prototype");
+
+  std::stringstream graph;
+  ostore_.dump_prototypes(graph, true);
+  UNIT_ASSERT_TRUE(graph.str().find("|{objects|15}") != std::string::npos, "graph must contain the object count");
+
+  items.clear();
+
+  report = ostore_.memory_usage();
+
+  UNIT_ASSERT_EQUAL(report.find("ITEM")->pointer_bytes, 0UL, "released object pointers must not be counted");
+
+  // objects holding object pointers are never evicted
+  UNIT_ASSERT_EQUAL(ostore_.cache_pinned(), (size_t)0, "plain items must not be pinned");
+  ostore_.insert(new ObjectItem<Item>);
+  ostore_.insert(new ObjectItem<Item>);
+  UNIT_ASSERT_EQUAL(ostore_.cache_pinned(), 2 * sizeof(ObjectItem<Item>), "invalid pinned bytes");
+}
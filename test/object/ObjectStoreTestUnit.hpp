@@ -33,8 +33,11 @@ public:
   void sub_delete();
   void hierarchy();
   void view_test();
+  void view_index_test();
+  void observer_test();
   void clear_test();
   void generic_test();
+  void memory_test();
   void test_structure();
 
 private:
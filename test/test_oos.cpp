@@ -22,25 +22,32 @@
 #include "tools/BlobTestUnit.hpp"
 #include "tools/VarCharTestUnit.hpp"
 #include "tools/FactoryTestUnit.hpp"
+#include "tools/MetricsTestUnit.hpp"
 
 #include "object/ObjectStoreTestUnit.hpp"
 #include "object/ObjectPrototypeTestUnit.hpp"
 #include "object/ObjectListTestUnit.hpp"
 #include "object/ObjectVectorTestUnit.hpp"
+#include "object/ObjectProxyMapTestUnit.hpp"
+#include "object/ChangeFeedTestUnit.hpp"
 
 #include "database/SQLiteDatabaseTestUnit.hpp"
 #include "database/MySQLDatabaseTestUnit.hpp"
 #include "database/MSSQLDatabaseTestUnit.hpp"
 
 #include "json/JsonTestUnit.hpp"
+#include "json/JsonObjectTestUnit.hpp"
 
 #include "unit/test_suite.hpp"
 
+#include "allocation_counter.hpp"
+
 using namespace oos;
 
 int main(int argc, char *argv[])
 {
   test_suite::instance().init(argc, argv);
+  test_suite::instance().allocation_hook(&allocation_counters);
 
   test_suite::instance().register_unit(new FirstTestUnit());
   test_suite::instance().register_unit(new SecondTestUnit());
@@ -49,18 +56,20 @@ int main(int argc, char *argv[])
   test_suite::instance().register_unit(new BlobTestUnit());
   test_suite::instance().register_unit(new VarCharTestUnit());
   test_suite::instance().register_unit(new FactoryTestUnit());
+  test_suite::instance().register_unit(new MetricsTestUnit());
 
   test_suite::instance().register_unit(new ObjectPrototypeTestUnit());
   test_suite::instance().register_unit(new ObjectStoreTestUnit());
   test_suite::instance().register_unit(new ObjectListTestUnit());
   test_suite::instance().register_unit(new ObjectVectorTestUnit());
+  test_suite::instance().register_unit(new ObjectProxyMapTestUnit());
+  test_suite::instance().register_unit(new ChangeFeedTestUnit());
   test_suite::instance().register_unit(new MySQLDatabaseTestUnit());
   test_suite::instance().register_unit(new MSSQLDatabaseTestUnit());
   test_suite::instance().register_unit(new SQLiteDatabaseTestUnit());
 
   test_suite::instance().register_unit(new JsonTestUnit());
+  test_suite::instance().register_unit(new JsonObjectTestUnit());
 
-  test_suite::instance().run();
-  
-  return 0;
+  return (test_suite::instance().run() ? 0 : 1);
 }
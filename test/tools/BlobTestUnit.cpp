@@ -3,6 +3,8 @@
 #include "tools/blob.hpp"
 
 #include <iostream>
+#include <string>
+#include <cstring>
 
 using namespace oos;
 
@@ -12,6 +14,8 @@ BlobTestUnit::BlobTestUnit()
   : unit_test("blob", "blob test unit")
 {
   add_test("create", std::tr1::bind(&BlobTestUnit::create_blob, this), "create blob");
+  add_test("copy", std::tr1::bind(&BlobTestUnit::copy_blob, this), "copy blob");
+  add_test("append", std::tr1::bind(&BlobTestUnit::append_blob, this), "append blob");
 }
 
 BlobTestUnit::~BlobTestUnit()
@@ -19,24 +23,105 @@ BlobTestUnit::~BlobTestUnit()
 
 void BlobTestUnit::create_blob()
 {
-  /*
-  cout << "\n";
-
   blob b1;
-  
+
+  UNIT_ASSERT_TRUE(b1.empty(), "blob must be empty");
+  UNIT_ASSERT_EQUAL((int)b1.capacity(), (int)blob::INLINE_SIZE, "invalid capacity of blob");
+
   int val = 8;
-  b1.assign(val);
-  b1.assign(val);
+  UNIT_ASSERT_TRUE(b1.assign(val), "value must be assigned");
+  UNIT_ASSERT_TRUE(b1.assign(val), "value must be assigned");
 
-  cout << "size: " << b1.size() << "\n";
-  cout << "capacity: " << b1.capacity() << "\n";
+  UNIT_ASSERT_EQUAL((int)b1.size(), (int)sizeof(int), "invalid size of blob");
+  UNIT_ASSERT_EQUAL((int)b1.capacity(), (int)blob::INLINE_SIZE, "small data must be stored inline");
+  UNIT_ASSERT_TRUE(memcmp(b1.data(), &val, sizeof(int)) == 0, "invalid data of blob");
+
+  // short data is stored inside the blob
+  const char *first = reinterpret_cast<const char*>(&b1);
+  UNIT_ASSERT_TRUE(b1.data() >= first && b1.data() < first + sizeof(b1), "blob must use inline storage");
+
+  std::string large(1000, 'x');
+  blob b2(large.data(), large.size());
+
+  UNIT_ASSERT_EQUAL((int)b2.size(), 1000, "invalid size of blob");
+  UNIT_ASSERT_TRUE((int)b2.capacity() >= 1000, "invalid capacity of blob");
+  UNIT_ASSERT_EQUAL(std::string(b2.data(), b2.size()), large, "invalid data of blob");
 
-  blob b2;
-  
-  b2.assign(val);
   b2.assign(val);
+  UNIT_ASSERT_EQUAL((int)b2.size(), (int)sizeof(int), "invalid size of blob");
+  UNIT_ASSERT_TRUE(b1 == b2, "blobs must be equal");
+
+  b2.clear();
+  UNIT_ASSERT_TRUE(b2.empty(), "blob must be empty");
+}
+
+void BlobTestUnit::copy_blob()
+{
+  std::string large(4096, 'a');
+  blob b1(large.data(), large.size());
+
+  // copies share the data
+  blob b2(b1);
+  blob b3;
+  b3 = b2;
+
+  UNIT_ASSERT_EQUAL(b1.use_count(), 3L, "data must be shared");
+  UNIT_ASSERT_TRUE(b1.data() == b3.data(), "data must be shared");
+  UNIT_ASSERT_TRUE(b1 == b3, "blobs must be equal");
+
+  // the first modification copies the data
+  b2.mutable_data()[0] = 'b';
+
+  UNIT_ASSERT_EQUAL(b1.use_count(), 2L, "data must be unshared");
+  UNIT_ASSERT_EQUAL(b2.use_count(), 1L, "data must be unshared");
+  UNIT_ASSERT_TRUE(b1.data()[0] == 'a', "source data must not change");
+  UNIT_ASSERT_TRUE(b2.data()[0] == 'b', "data must be changed");
+  UNIT_ASSERT_TRUE(b1 != b2, "blobs must not be equal");
+
+  b3.append("c", 1);
+  UNIT_ASSERT_EQUAL(b1.use_count(), 1L, "data must be unshared");
+  UNIT_ASSERT_EQUAL((int)b3.size(), 4097, "invalid size of blob");
+  UNIT_ASSERT_EQUAL((int)b1.size(), 4096, "source size must not change");
+
+  // small blobs are copied
+  blob b4("small", 5);
+  blob b5(b4);
+  UNIT_ASSERT_TRUE(b4.data() != b5.data(), "small data must be copied");
+  UNIT_ASSERT_TRUE(b4 == b5, "blobs must be equal");
+
+  // releasing the last copy frees the data
+  {
+    blob b6(b1);
+    b1 = b4;
+    UNIT_ASSERT_EQUAL(b6.use_count(), 1L, "data must be unshared");
+  }
+  UNIT_ASSERT_TRUE(b1 == b4, "blobs must be equal");
+}
+
+void BlobTestUnit::append_blob()
+{
+  blob b1;
+  std::string expected;
+
+  for (int i = 0; i < 1000; ++i) {
+    b1.append(i);
+    expected.append(reinterpret_cast<const char*>(&i), sizeof(i));
+  }
+  UNIT_ASSERT_EQUAL((int)b1.size(), (int)(1000 * sizeof(int)), "invalid size of blob");
+  UNIT_ASSERT_EQUAL(std::string(b1.data(), b1.size()), expected, "invalid data of blob");
+
+  // append the blob to itself
+  blob b2("abc", 3);
+  b2.append(b2.data(), b2.size());
+  UNIT_ASSERT_EQUAL(std::string(b2.data(), b2.size()), std::string("abcabc"), "invalid data of blob");
+  for (int i = 0; i < 3; ++i) {
+    b2.append(b2.data(), b2.size());
+  }
+  UNIT_ASSERT_EQUAL((int)b2.size(), 48, "invalid size of blob");
+  UNIT_ASSERT_EQUAL(std::string(b2.data() + 42, 6), std::string("abcabc"), "invalid data of blob");
 
-  cout << "size: " << b2.size() << "\n";
-  cout << "capacity: " << b2.capacity() << "\n";
-  */
+  blob b3;
+  b3.resize(100);
+  memset(b3.mutable_data(), 'z', b3.size());
+  UNIT_ASSERT_EQUAL(std::string(b3.data(), b3.size()), std::string(100, 'z'), "invalid data of blob");
 }
@@ -10,6 +10,8 @@ public:
   virtual ~BlobTestUnit();
   
   void create_blob();
+  void copy_blob();
+  void append_blob();
 
   /**
    * Initializes a test unit
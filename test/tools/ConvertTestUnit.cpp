@@ -27,13 +27,43 @@
 #include <typeinfo>
 #include <iostream>
 #include <string>
+#include <sstream>
+#include <vector>
 #include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <clocale>
 
 using namespace oos;
 
 using std::cout;
 using std::string;
 
+namespace {
+
+// xorshift generator to get reproducible random bits
+unsigned long long next_random(unsigned long long &state)
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+template < class T >
+bool convert_fails(const char *from)
+{
+  T to;
+  try {
+    convert(from, to);
+  } catch (std::bad_cast &) {
+    return true;
+  }
+  return false;
+}
+
+}
+
 
 ConvertTestUnit::ConvertTestUnit()
   : unit_test("convert", "convert test unit")
@@ -52,6 +82,30 @@ ConvertTestUnit::ConvertTestUnit()
   add_test("to_char_pointer", std::tr1::bind(&ConvertTestUnit::convert_to_char_pointer, this), "convert to const char pointer test");
   add_test("to_string", std::tr1::bind(&ConvertTestUnit::convert_to_string, this), "convert to string test");
   add_test("to_varchar", std::tr1::bind(&ConvertTestUnit::convert_to_varchar, this), "convert to varchar test");
+  add_test("number_format", std::tr1::bind(&ConvertTestUnit::number_format, this), "locale independent number format test");
+
+  add_benchmark("format_long", std::tr1::bind(&ConvertTestUnit::format_long, this, std::tr1::placeholders::_1), "convert long to char array");
+  add_benchmark("format_long_snprintf", std::tr1::bind(&ConvertTestUnit::format_long_snprintf, this, std::tr1::placeholders::_1), "snprintf long to char array");
+  add_benchmark("format_long_varchar", std::tr1::bind(&ConvertTestUnit::format_long_varchar, this, std::tr1::placeholders::_1), "convert long to varchar");
+  add_benchmark("parse_long", std::tr1::bind(&ConvertTestUnit::parse_long, this, std::tr1::placeholders::_1), "convert char array to long");
+  add_benchmark("parse_long_strtol", std::tr1::bind(&ConvertTestUnit::parse_long_strtol, this, std::tr1::placeholders::_1), "strtol char array to long");
+  add_benchmark("format_double", std::tr1::bind(&ConvertTestUnit::format_double, this, std::tr1::placeholders::_1), "convert double to char array");
+  add_benchmark("format_double_snprintf", std::tr1::bind(&ConvertTestUnit::format_double_snprintf, this, std::tr1::placeholders::_1), "snprintf double to char array");
+  add_benchmark("format_double_varchar", std::tr1::bind(&ConvertTestUnit::format_double_varchar, this, std::tr1::placeholders::_1), "convert double to varchar");
+  add_benchmark("parse_double", std::tr1::bind(&ConvertTestUnit::parse_double, this, std::tr1::placeholders::_1), "convert char array to double");
+  add_benchmark("parse_double_strtod", std::tr1::bind(&ConvertTestUnit::parse_double_strtod, this, std::tr1::placeholders::_1), "strtod char array to double");
+
+  // values shared by the benchmarks
+  unsigned long long state = 88172645463325252ULL;
+  char buf[64];
+  for (int i = 0; i < BENCHMARK_VALUES; ++i) {
+    integers_.push_back(static_cast<long>(next_random(state) >> (next_random(state) % 64)));
+    reals_.push_back(double(static_cast<long long>(next_random(state) % 20000000) - 10000000) / 1000.0);
+    snprintf(buf, sizeof(buf), "%ld", integers_.back());
+    integer_strings_.push_back(buf);
+    snprintf(buf, sizeof(buf), "%.3f", reals_.back());
+    real_strings_.push_back(buf);
+  }
 }
 
 ConvertTestUnit::~ConvertTestUnit()
@@ -1281,3 +1335,192 @@ ConvertTestUnit::convert_to_varchar()
   CONVERT_EXPECT_SUCCESS(varchar<8>, varchar<64>, "99", "99");
   */
 }
+
+
+void
+ConvertTestUnit::number_format()
+{
+  unsigned long long state = 88172645463325252ULL;
+  char buf[512];
+  char expected[512];
+
+  // fixed precision is rounded like printf
+  for (int i = 0; i < 100000; ++i) {
+    int precision = static_cast<int>(next_random(state) % 7);
+    double value = double(static_cast<long long>(next_random(state) % 20000000) - 10000000) / 1000.0;
+    if (i % 4 == 0) {
+      // ties like 0.125
+      value = double(static_cast<long long>(next_random(state) % 2000) - 1000) / 8.0;
+    }
+    convert(value, buf, sizeof(buf), precision);
+    snprintf(expected, sizeof(expected), "%.*f", precision, value);
+    UNIT_ASSERT_EQUAL(std::string(buf), std::string(expected), "fixed precision must match printf");
+  }
+
+  // large values and high precisions
+  convert(1e300, buf, sizeof(buf), 0);
+  UNIT_ASSERT_EQUAL(strlen(buf), (size_t)301, "1e300 must have 301 digits");
+  convert(0.1, buf, sizeof(buf), 30);
+  snprintf(expected, sizeof(expected), "%.*f", 30, 0.1);
+  UNIT_ASSERT_EQUAL(std::string(buf), std::string(expected), "fixed precision must match printf");
+
+  // shortest representation reads back the same double
+  for (int i = 0; i < 10000; ++i) {
+    double value = double(static_cast<long long>(next_random(state))) / double(next_random(state) % 1000000 + 1);
+    std::string str;
+    convert(value, str, -1);
+    double result = 0;
+    convert(str.c_str(), result);
+    UNIT_ASSERT_EQUAL(result, value, "shortest representation must read back the same double");
+  }
+  std::string str;
+  convert(100.0, str, -1);
+  UNIT_ASSERT_EQUAL(str, "100", "whole numbers must not have a fraction");
+  convert(0.1, str, -1);
+  UNIT_ASSERT_EQUAL(str, "0.1", "shortest representation expected");
+
+  // integers and ranges
+  long long ll = 0;
+  convert("-9223372036854775808", ll);
+  UNIT_ASSERT_TRUE(ll == std::numeric_limits<long long>::min(), "smallest long long expected");
+  int n = 0;
+  convert("  +7", n);
+  UNIT_ASSERT_EQUAL(n, 7, "leading blanks and plus sign must be skipped");
+  convert("-0042", n);
+  UNIT_ASSERT_EQUAL(n, -42, "leading zeros must be skipped");
+  UNIT_ASSERT_TRUE(convert_fails<short>("40000"), "40000 must not fit into short");
+  UNIT_ASSERT_TRUE(convert_fails<int>("9223372036854775808"), "number must not fit into int");
+  UNIT_ASSERT_TRUE(convert_fails<unsigned int>("-1"), "negative number must not fit into unsigned int");
+  UNIT_ASSERT_TRUE(convert_fails<int>("-"), "sign without digits must fail");
+  UNIT_ASSERT_TRUE(convert_fails<float>("1e39"), "1e39 must not fit into float");
+  UNIT_ASSERT_TRUE(convert_fails<double>("1e400"), "1e400 must not fit into double");
+  double d = 0;
+  convert("007.5", d);
+  UNIT_ASSERT_EQUAL(d, 7.5, "leading zeros must be skipped");
+  convert(".25", d);
+  UNIT_ASSERT_EQUAL(d, 0.25, "number without integral part expected");
+
+  // target buffer too small
+  bool failed = false;
+  try {
+    convert(12345, buf, 5);
+  } catch (std::bad_cast &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "12345 must not fit into 5 characters");
+  convert(1234, buf, 5);
+  UNIT_ASSERT_EQUAL(std::string(buf), "1234", "1234 must fit into 5 characters");
+
+  // a locale with decimal comma doesn't change the result
+  std::string locale = setlocale(LC_NUMERIC, 0);
+  if (setlocale(LC_NUMERIC, "de_DE.UTF-8") || setlocale(LC_NUMERIC, "de_DE")) {
+    convert(1e300, buf, sizeof(buf), 2);
+    bool point = buf[strlen(buf) - 3] == '.';
+    convert(-2.5, str, 1);
+    convert("2.5", d);
+    setlocale(LC_NUMERIC, locale.c_str());
+    UNIT_ASSERT_TRUE(point, "decimal point expected");
+    UNIT_ASSERT_EQUAL(str, "-2.5", "decimal point expected");
+    UNIT_ASSERT_EQUAL(d, 2.5, "decimal point must be parsed");
+  }
+}
+
+void
+ConvertTestUnit::format_long(unsigned long long iterations)
+{
+  char buf[64];
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    convert(integers_[i % BENCHMARK_VALUES], buf, sizeof(buf));
+    benchmark_use(buf);
+  }
+}
+
+void
+ConvertTestUnit::format_long_snprintf(unsigned long long iterations)
+{
+  char buf[64];
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    snprintf(buf, sizeof(buf), "%ld", integers_[i % BENCHMARK_VALUES]);
+    benchmark_use(buf);
+  }
+}
+
+void
+ConvertTestUnit::format_long_varchar(unsigned long long iterations)
+{
+  varchar<32> str;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    convert(integers_[i % BENCHMARK_VALUES], str);
+    benchmark_use(&str);
+  }
+}
+
+void
+ConvertTestUnit::parse_long(unsigned long long iterations)
+{
+  long value = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    convert(integer_strings_[i % BENCHMARK_VALUES].c_str(), value);
+    benchmark_use(&value);
+  }
+}
+
+void
+ConvertTestUnit::parse_long_strtol(unsigned long long iterations)
+{
+  long value = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    value = strtol(integer_strings_[i % BENCHMARK_VALUES].c_str(), 0, 10);
+    benchmark_use(&value);
+  }
+}
+
+void
+ConvertTestUnit::format_double(unsigned long long iterations)
+{
+  char buf[64];
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    convert(reals_[i % BENCHMARK_VALUES], buf, sizeof(buf), 3);
+    benchmark_use(buf);
+  }
+}
+
+void
+ConvertTestUnit::format_double_snprintf(unsigned long long iterations)
+{
+  char buf[64];
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    snprintf(buf, sizeof(buf), "%.3f", reals_[i % BENCHMARK_VALUES]);
+    benchmark_use(buf);
+  }
+}
+
+void
+ConvertTestUnit::format_double_varchar(unsigned long long iterations)
+{
+  varchar<32> str;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    convert(reals_[i % BENCHMARK_VALUES], str, 3);
+    benchmark_use(&str);
+  }
+}
+
+void
+ConvertTestUnit::parse_double(unsigned long long iterations)
+{
+  double value = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    convert(real_strings_[i % BENCHMARK_VALUES].c_str(), value);
+    benchmark_use(&value);
+  }
+}
+
+void
+ConvertTestUnit::parse_double_strtod(unsigned long long iterations)
+{
+  double value = 0;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    value = strtod(real_strings_[i % BENCHMARK_VALUES].c_str(), 0);
+    benchmark_use(&value);
+  }
+}
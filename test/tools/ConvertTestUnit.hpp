@@ -3,6 +3,9 @@
 
 #include "unit/unit_test.hpp"
 
+#include <string>
+#include <vector>
+
 class ConvertTestUnit : public oos::unit_test
 {
 public:
@@ -48,7 +51,27 @@ public:
   void convert_to_string();
   void convert_to_varchar();
 
+  void number_format();
+
+  void format_long(unsigned long long iterations);
+  void format_long_snprintf(unsigned long long iterations);
+  void format_long_varchar(unsigned long long iterations);
+  void parse_long(unsigned long long iterations);
+  void parse_long_strtol(unsigned long long iterations);
+  void format_double(unsigned long long iterations);
+  void format_double_snprintf(unsigned long long iterations);
+  void format_double_varchar(unsigned long long iterations);
+  void parse_double(unsigned long long iterations);
+  void parse_double_strtod(unsigned long long iterations);
+
 private:
+  enum { BENCHMARK_VALUES = 1024 };
+
+  std::vector<long> integers_;
+  std::vector<double> reals_;
+  std::vector<std::string> integer_strings_;
+  std::vector<std::string> real_strings_;
+
   /*
   template < class T, class U >
   void convert_expect_success(const T& in, U &out)
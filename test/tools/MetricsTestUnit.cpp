@@ -0,0 +1,252 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MetricsTestUnit.hpp"
+
+#include "../Item.hpp"
+
+#include "tools/metrics.hpp"
+
+#include "object/object_store.hpp"
+#include "object/object_ptr.hpp"
+
+#include "database/session.hpp"
+#include "database/transaction.hpp"
+
+#include "json/json_document.hpp"
+#include "json/json_node.hpp"
+
+#include <sstream>
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+using namespace oos;
+using namespace std;
+
+MetricsTestUnit::MetricsTestUnit()
+  : unit_test("metrics", "metrics registry")
+{
+  add_test("counter", std::tr1::bind(&MetricsTestUnit::test_counter, this), "test sharded counter");
+  add_test("histogram", std::tr1::bind(&MetricsTestUnit::test_histogram, this), "test histogram buckets and quantiles");
+  add_test("threads", std::tr1::bind(&MetricsTestUnit::test_threads, this), "test counter with several threads");
+  add_test("store", std::tr1::bind(&MetricsTestUnit::test_store, this), "test object store metrics");
+  add_test("transaction", std::tr1::bind(&MetricsTestUnit::test_transaction, this), "test transaction metrics");
+  add_test("export", std::tr1::bind(&MetricsTestUnit::test_export, this), "test text and json export");
+}
+
+MetricsTestUnit::~MetricsTestUnit()
+{}
+
+void MetricsTestUnit::initialize()
+{
+  metrics::instance().reset();
+  metrics::enable();
+}
+
+void MetricsTestUnit::finalize()
+{
+  metrics::enable(false);
+  metrics::instance().reset();
+}
+
+void MetricsTestUnit::test_counter()
+{
+  metric_counter &counter = metrics::instance().counter("test_counter");
+  UNIT_ASSERT_EQUAL(&counter, &metrics::instance().counter("test_counter"), "same name must return the same counter");
+  UNIT_ASSERT_NOT_EQUAL(&counter, &metrics::instance().counter("test_counter", "item"), "other type must return another counter");
+
+  counter.add();
+  counter.add(41);
+  UNIT_ASSERT_EQUAL(counter.value(), 42LL, "invalid counter value");
+  counter.add(-2);
+  UNIT_ASSERT_EQUAL(counter.value(), 40LL, "invalid counter value");
+
+  metrics_snapshot snapshot = metrics::instance().snapshot();
+  const metric_value *value = snapshot.find_counter("test_counter");
+  UNIT_ASSERT_NOT_NULL(value, "counter must be in snapshot");
+  UNIT_ASSERT_EQUAL(value->value, 40LL, "invalid snapshot value");
+
+  metrics::instance().reset();
+  UNIT_ASSERT_EQUAL(counter.value(), 0LL, "counter must be reset");
+}
+
+void MetricsTestUnit::test_histogram()
+{
+  UNIT_ASSERT_EQUAL(metric_histogram::bucket(0), 0U, "invalid bucket of 0");
+  UNIT_ASSERT_EQUAL(metric_histogram::bucket(1), 1U, "invalid bucket of 1");
+  UNIT_ASSERT_EQUAL(metric_histogram::bucket(3), 2U, "invalid bucket of 3");
+  UNIT_ASSERT_EQUAL(metric_histogram::bucket(4), 3U, "invalid bucket of 4");
+  UNIT_ASSERT_EQUAL(metric_histogram::bucket(~0ULL), (unsigned)METRIC_BUCKETS - 1, "invalid bucket of max");
+  UNIT_ASSERT_EQUAL(metric_distribution::upper_bound(3), 7ULL, "invalid upper bound");
+
+  metric_histogram &histogram = metrics::instance().histogram("test_histogram");
+  for (unsigned long long i = 1; i <= 100; ++i) {
+    histogram.observe(i);
+  }
+
+  metrics_snapshot snapshot = metrics::instance().snapshot();
+  const metric_distribution *d = snapshot.find_histogram("test_histogram");
+  UNIT_ASSERT_NOT_NULL(d, "histogram must be in snapshot");
+  UNIT_ASSERT_EQUAL(d->count, 100ULL, "invalid histogram count");
+  UNIT_ASSERT_EQUAL(d->sum, 5050ULL, "invalid histogram sum");
+  UNIT_ASSERT_EQUAL(d->buckets[7], 37ULL, "invalid count of bucket 64..127");
+  // the median 50 is in the bucket 32..63
+  UNIT_ASSERT_EQUAL(d->quantile(0.5), 63ULL, "invalid median");
+  UNIT_ASSERT_EQUAL(d->quantile(1.0), 127ULL, "invalid maximum");
+}
+
+#ifndef WIN32
+namespace {
+
+const int THREAD_ADDS = 100000;
+
+void* add_counter(void *arg)
+{
+  metric_counter *counter = static_cast<metric_counter*>(arg);
+  for (int i = 0; i < THREAD_ADDS; ++i) {
+    counter->add();
+  }
+  return 0;
+}
+
+}
+#endif
+
+void MetricsTestUnit::test_threads()
+{
+#ifndef WIN32
+  metric_counter &counter = metrics::instance().counter("test_threads");
+
+  const int n = 8;
+  pthread_t threads[n];
+  for (int i = 0; i < n; ++i) {
+    UNIT_ASSERT_EQUAL(pthread_create(&threads[i], 0, add_counter, &counter), 0, "couldn't start thread");
+  }
+  for (int i = 0; i < n; ++i) {
+    pthread_join(threads[i], 0);
+  }
+
+  UNIT_ASSERT_EQUAL(counter.value(), (long long)n * THREAD_ADDS, "invalid counter value");
+#endif
+}
+
+void MetricsTestUnit::test_store()
+{
+  object_store ostore;
+  ostore.insert_prototype<Item>("item");
+
+  object_ptr<Item> item = ostore.insert(new Item("item", 1));
+  ostore.insert(new Item("item", 2));
+  item->set_int(7);
+  ostore.remove(item);
+
+  metrics_snapshot snapshot = metrics::instance().snapshot();
+  const metric_value *inserts = snapshot.find_counter("object_store_inserts", "item");
+  UNIT_ASSERT_NOT_NULL(inserts, "insert counter must be in snapshot");
+  UNIT_ASSERT_EQUAL(inserts->value, 2LL, "invalid insert count");
+  const metric_value *updates = snapshot.find_counter("object_store_updates", "item");
+  UNIT_ASSERT_NOT_NULL(updates, "update counter must be in snapshot");
+  UNIT_ASSERT_EQUAL(updates->value, 1LL, "invalid update count");
+  const metric_value *removes = snapshot.find_counter("object_store_removes", "item");
+  UNIT_ASSERT_NOT_NULL(removes, "remove counter must be in snapshot");
+  UNIT_ASSERT_EQUAL(removes->value, 1LL, "invalid remove count");
+
+  // other stores may exist, the gauges hold at least this store
+  const metric_value *proxies = snapshot.find_gauge("object_store_proxies");
+  UNIT_ASSERT_NOT_NULL(proxies, "proxy gauge must be in snapshot");
+  UNIT_ASSERT_GREATER(proxies->value, 0LL, "invalid proxy count");
+  const metric_value *bytes = snapshot.find_gauge("object_store_object_bytes");
+  UNIT_ASSERT_NOT_NULL(bytes, "object bytes gauge must be in snapshot");
+  UNIT_ASSERT_GREATER(bytes->value, 0LL, "invalid object bytes");
+  const metric_value *pinned = snapshot.find_gauge("object_store_pinned_bytes");
+  UNIT_ASSERT_NOT_NULL(pinned, "pinned bytes gauge must be in snapshot");
+  UNIT_ASSERT_EQUAL(pinned->value, 0LL, "plain items must not be pinned");
+
+  // disabled metrics don't count
+  metrics::enable(false);
+  ostore.insert(new Item("item", 3));
+  UNIT_ASSERT_EQUAL(metrics::instance().counter("object_store_inserts", "item").value(), 2LL, "disabled metrics must not count");
+}
+
+void MetricsTestUnit::test_transaction()
+{
+  object_store ostore;
+  ostore.insert_prototype<Item>("item");
+
+  session db(ostore);
+  transaction tr(db);
+  tr.begin();
+  object_ptr<Item> item = ostore.insert(new Item("item", 1));
+  ostore.insert(new Item("item", 2));
+  tr.commit();
+
+  tr.begin();
+  item->set_int(7);
+  tr.rollback();
+
+  metrics_snapshot snapshot = metrics::instance().snapshot();
+  const metric_value *commits = snapshot.find_counter("transaction_commits");
+  UNIT_ASSERT_NOT_NULL(commits, "commit counter must be in snapshot");
+  UNIT_ASSERT_EQUAL(commits->value, 1LL, "invalid commit count");
+  const metric_value *actions = snapshot.find_counter("transaction_actions");
+  UNIT_ASSERT_NOT_NULL(actions, "action counter must be in snapshot");
+  UNIT_ASSERT_GREATER(actions->value, 0LL, "invalid action count");
+  const metric_value *rollbacks = snapshot.find_counter("transaction_rollbacks");
+  UNIT_ASSERT_NOT_NULL(rollbacks, "rollback counter must be in snapshot");
+  UNIT_ASSERT_EQUAL(rollbacks->value, 1LL, "invalid rollback count");
+  const metric_distribution *latency = snapshot.find_histogram("transaction_commit_ns");
+  UNIT_ASSERT_NOT_NULL(latency, "commit latency must be in snapshot");
+  UNIT_ASSERT_EQUAL(latency->count, 1ULL, "invalid commit latency count");
+}
+
+void MetricsTestUnit::test_export()
+{
+  metrics::instance().counter("test_export", "item").add(3);
+  metrics::instance().histogram("test_export_ns").observe(5);
+
+  metrics_snapshot snapshot = metrics::instance().snapshot();
+
+  std::stringstream text;
+  snapshot.write_text(text);
+  UNIT_ASSERT_TRUE(text.str().find("test_export{type=\"item\"} 3\n") != std::string::npos, "counter line expected");
+  UNIT_ASSERT_TRUE(text.str().find("test_export_ns_bucket{le=\"7\"} 1\n") != std::string::npos, "bucket line expected");
+  UNIT_ASSERT_TRUE(text.str().find("test_export_ns_sum 5\n") != std::string::npos, "sum line expected");
+  UNIT_ASSERT_TRUE(text.str().find("test_export_ns_count 1\n") != std::string::npos, "count line expected");
+
+  std::stringstream json;
+  snapshot.write_json(json);
+  json_document doc;
+  json_node root = doc.parse(json);
+  UNIT_ASSERT_TRUE(root.is_object(), "json object expected");
+  UNIT_ASSERT_TRUE(root["counters"].is_array(), "counter array expected");
+  UNIT_ASSERT_TRUE(root["gauges"].is_array(), "gauge array expected");
+  json_node histograms = root["histograms"];
+  UNIT_ASSERT_TRUE(histograms.is_array(), "histogram array expected");
+
+  bool found = false;
+  json_node counters = root["counters"];
+  for (size_t i = 0; i < counters.size(); ++i) {
+    if (counters[i]["name"].as_string() == "test_export") {
+      UNIT_ASSERT_EQUAL(counters[i]["type"].as_string(), "item", "invalid counter type");
+      UNIT_ASSERT_EQUAL(counters[i]["value"].as_integer(), 3LL, "invalid counter value");
+      found = true;
+    }
+  }
+  UNIT_ASSERT_TRUE(found, "counter expected in json");
+}
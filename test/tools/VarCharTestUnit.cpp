@@ -14,6 +14,7 @@ VarCharTestUnit::VarCharTestUnit()
   add_test("create", std::tr1::bind(&VarCharTestUnit::create_varchar, this), "create varchar");
   add_test("copy", std::tr1::bind(&VarCharTestUnit::copy_varchar, this), "copy varchar");
   add_test("assign", std::tr1::bind(&VarCharTestUnit::assign_varchar, this), "assign varchar");
+  add_test("truncate", std::tr1::bind(&VarCharTestUnit::truncate_varchar, this), "truncate varchar");
 }
 
 VarCharTestUnit::~VarCharTestUnit()
@@ -39,8 +40,87 @@ void VarCharTestUnit::create_varchar()
 
 void VarCharTestUnit::copy_varchar()
 {
+  varchar<8> str8("Hallo");
+
+  // the characters are stored inside the varchar
+  const char *first = reinterpret_cast<const char*>(&str8);
+  UNIT_ASSERT_TRUE(str8.c_str() >= first && str8.c_str() < first + sizeof(str8), "varchar must use inline storage");
+
+  varchar<8> copy(str8);
+
+  UNIT_ASSERT_TRUE(copy == str8, "varchars must be equal");
+  UNIT_ASSERT_TRUE(copy.c_str() != str8.c_str(), "copy must use its own storage");
+
+  copy += "Welt";
+  UNIT_ASSERT_EQUAL(copy.str(), std::string("HalloWel"), "varchar must be cut at capacity");
+  UNIT_ASSERT_EQUAL(str8.str(), std::string("Hallo"), "source varchar must not change");
+
+  // a detached copy of the base class
+  oos::varchar_base base(copy);
+  UNIT_ASSERT_EQUAL((int)base.capacity(), 8, "invalid capacity of varchar");
+  UNIT_ASSERT_TRUE(base == copy, "varchars must be equal");
+
+  varchar<4> str4(std::string("HalloWelt"));
+  UNIT_ASSERT_EQUAL((int)str4.size(), 4, "varchar must be cut at capacity");
+  UNIT_ASSERT_TRUE(str4 == "Hall", "varchar must be cut at capacity");
 }
 
 void VarCharTestUnit::assign_varchar()
 {
+  varchar<8> str8;
+  varchar<4> str4;
+
+  str8 = std::string("Hallo");
+  UNIT_ASSERT_TRUE(str8 == "Hallo", "varchar isn't as expected");
+
+  str8 = "Hal";
+  str4 = str8;
+  UNIT_ASSERT_EQUAL((int)str4.capacity(), 4, "capacity must not change");
+  UNIT_ASSERT_TRUE(str4 == "Hal", "varchar isn't as expected");
+
+  str8 = "Welt";
+  str8 += str8;
+  UNIT_ASSERT_TRUE(str8 == "WeltWelt", "varchar isn't as expected");
+
+  str8.assign(str8.c_str() + 4, 4);
+  UNIT_ASSERT_TRUE(str8 == "Welt", "varchar isn't as expected");
+  UNIT_ASSERT_TRUE(str8 != "Hallo", "varchar isn't as expected");
+
+  str8.resize(2);
+  UNIT_ASSERT_EQUAL(std::string(str8.c_str()), std::string("We"), "varchar must be terminated");
+
+  str8 = "";
+  UNIT_ASSERT_EQUAL((int)str8.size(), 0, "size of varchar must be zero");
+}
+
+void VarCharTestUnit::truncate_varchar()
+{
+  varchar<8> str8("HalloWelt");
+  varchar<4> str4("Welt");
+
+  // strings are cut at the capacity
+  UNIT_ASSERT_EQUAL(str8.str(), std::string("HalloWel"), "varchar must be cut at capacity");
+  str4 = std::string("Hallo");
+  UNIT_ASSERT_EQUAL(str4.str(), std::string("Hall"), "varchar must be cut at capacity");
+
+  // a longer varchar is rejected
+  bool failed = false;
+  try {
+    str4 = str8;
+  } catch (std::logic_error &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "assigning a longer varchar must fail");
+  UNIT_ASSERT_EQUAL((int)str4.capacity(), 4, "capacity must not change");
+  UNIT_ASSERT_EQUAL(str4.str(), std::string("Hall"), "varchar must not change");
+
+  // a detached varchar_base adopts the capacity
+  oos::varchar_base base(str4);
+  base = str8;
+  UNIT_ASSERT_EQUAL((int)base.capacity(), 8, "capacity must be adopted");
+  UNIT_ASSERT_EQUAL(base.str(), std::string("HalloWel"), "varchar must not be cut");
+
+  base = str4;
+  UNIT_ASSERT_EQUAL((int)base.capacity(), 4, "capacity must be adopted");
+  UNIT_ASSERT_EQUAL(base.str(), std::string("Hall"), "varchar isn't as expected");
 }
@@ -33,6 +33,7 @@ public:
     add_test("sub1", std::tr1::bind(&FirstTestUnit::first_sub_test, this), "sub first");
     add_test("sub2", std::tr1::bind(&FirstTestUnit::second_sub_test, this), "sub second");
     add_test("sub3", std::tr1::bind(&FirstTestUnit::third_sub_test, this), "sub third");
+    add_test("benchmark", std::tr1::bind(&FirstTestUnit::benchmark_test, this), "benchmark statistics");
   }
   virtual ~FirstTestUnit() {}
   
@@ -54,6 +55,53 @@ public:
   void third_sub_test()
   {
   }
+  void benchmark_test()
+  {
+    oos::benchmark_options options;
+    options.samples = 5;
+    options.min_sample_time = 0.001;
+    options.warmup_time = 0;
+    oos::benchmark_result result = oos::measure_benchmark(std::tr1::bind(&FirstTestUnit::sum, this, std::tr1::placeholders::_1), options);
+    UNIT_ASSERT_GREATER(result.iterations, 0ULL, "iterations must be calibrated");
+    UNIT_ASSERT_EQUAL(result.samples, 5U, "five samples expected");
+    UNIT_ASSERT_FALSE(result.wall_median < result.wall_min, "median must not be less than min");
+    UNIT_ASSERT_FALSE(result.wall_p99 < result.wall_median, "p99 must not be less than median");
+    UNIT_ASSERT_TRUE(result.allocations < 0, "allocations aren't counted without hook");
+
+    result.unit = "first";
+    result.name = "sum";
+    result.allocations = 0.5;
+    oos::t_benchmark_result_vector results(1, result);
+
+    std::stringstream csv;
+    oos::write_benchmark_csv(csv, results);
+    oos::t_benchmark_result_vector csv_results;
+    UNIT_ASSERT_TRUE(oos::read_benchmark_results(csv, csv_results), "csv must be read");
+    UNIT_ASSERT_EQUAL(csv_results.size(), (size_t)1, "one result expected");
+    UNIT_ASSERT_EQUAL(csv_results[0].name, "sum", "name expected");
+    UNIT_ASSERT_EQUAL(csv_results[0].allocations, 0.5, "allocations expected");
+    UNIT_ASSERT_TRUE(csv_results[0].allocated_bytes < 0, "missing allocated bytes expected");
+
+    std::stringstream json;
+    oos::write_benchmark_json(json, results);
+    oos::t_benchmark_result_vector json_results;
+    UNIT_ASSERT_TRUE(oos::read_benchmark_results(json, json_results), "json must be read");
+    UNIT_ASSERT_EQUAL(json_results.size(), (size_t)1, "one result expected");
+    UNIT_ASSERT_EQUAL(json_results[0].unit, "first", "unit expected");
+    UNIT_ASSERT_EQUAL(json_results[0].iterations, result.iterations, "iterations expected");
+    UNIT_ASSERT_TRUE(json_results[0].allocated_bytes < 0, "missing allocated bytes expected");
+
+    std::stringstream garbage("no results");
+    UNIT_ASSERT_FALSE(oos::read_benchmark_results(garbage, json_results), "garbage must not be read");
+  }
+  void sum(unsigned long long iterations)
+  {
+    unsigned long long result = 0;
+    for (unsigned long long i = 0; i < iterations; ++i) {
+      result += i;
+      oos::benchmark_use(&result);
+    }
+  }
   /**
    * Initializes a test unit
    */